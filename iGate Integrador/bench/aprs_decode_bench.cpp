@@ -0,0 +1,322 @@
+// ============================================================================
+//  Benchmark en host: decodificador APRS
+//  Descripción: Verifica AprsDecoder con vectores dorados de cada tipo
+//               (posición sin comprimir, comprimida y con ambigüedad, Mic-E,
+//               mensajes / ack / respuesta-ack, estado, objeto, ítem,
+//               telemetría, tercero y errores de formato) y mide
+//               decodificaciones/s y reservas de memoria por paquete. Con un
+//               volcado de APRS-IS como argumento (una línea TNC2 por línea,
+//               se ignoran las que empiezan con '#') mide sobre ese tráfico y
+//               muestra la mezcla de tipos; sin él usa los vectores. Termina
+//               con 1 si algún vector falla o si hubo reservas.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/AX25 -Ilib/AprsDecoder bench/aprs_decode_bench.cpp
+//        lib/AX25/AX25.cpp lib/AprsDecoder/AprsDecoder.cpp -o aprs_decode_bench
+//    ./aprs_decode_bench [volcado-aprs-is.txt] [pasadas]
+// ============================================================================
+#include <AprsDecoder.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+// Decodifica una trama TNC2 que debe seguir vigente mientras se use 'a'
+static bool decode(const char* frame, AX25Packet& ax, AprsInfo& a) {
+  parseAX25(frame, strlen(frame), ax);
+  return decodeAprs(ax, a);
+}
+
+static bool fieldIs(const AX25Packet& ax, const AX25Field& f, const char* text) {
+  return ax.equals(f, text);
+}
+
+// ±6 millonésimas: la resolución de la longitud comprimida es 1/190463 grados
+static bool near(int32_t value, int32_t expected) {
+  return value - expected <= 6 && expected - value <= 6;
+}
+
+// ============================================================================
+//  Vectores dorados
+// ============================================================================
+static void goldenVectors() {
+  AX25Packet ax;
+  AprsInfo a;
+
+  printf("Vectores:\n");
+  bool ok = decode("TI2ABC-9>APLRT1,WIDE1-1:!0951.60N/08354.38W>LoRa tracker 12.4V", ax, a);
+  check("posición sin comprimir", ok && a.type == APRS_TYPE_POSITION && !a.compressed &&
+        !a.messaging && near(a.latitude, 9860000) && near(a.longitude, -83906333) &&
+        a.symbolTable == '/' && a.symbolCode == '>' && a.course == APRS_NO_COURSE &&
+        fieldIs(ax, a.comment, "LoRa tracker 12.4V"));
+
+  ok = decode("TI3XYZ-7>APLRG1:=0952.10S\\08355.20E&iGate", ax, a);
+  check("posición con mensajes, sur / este", ok && a.messaging && a.latitude < 0 &&
+        a.longitude > 0 && a.symbolTable == '\\' && fieldIs(ax, a.comment, "iGate"));
+
+  ok = decode("N0CALL>APRS:@092345z4903.50N/07201.75W>088/036Comentario", ax, a);
+  check("posición con hora y curso/velocidad", ok && a.messaging &&
+        fieldIs(ax, a.timestamp, "092345z") && near(a.latitude, 49058333) &&
+        near(a.longitude, -72029166) && a.course == 88 && a.speed == 36 &&
+        fieldIs(ax, a.comment, "Comentario"));
+
+  ok = decode("N0CALL>APRS:!49  .  N/072  .  W-", ax, a);
+  check("posición con ambigüedad", ok && a.latitude == 49000000 && a.longitude == -72000000);
+
+  ok = decode("N0CALL>APRS:=/5L!!<*e7>7P[Comprimida", ax, a);
+  check("posición comprimida con curso/velocidad", ok && a.compressed &&
+        near(a.latitude, 49500000) && near(a.longitude, -72750000) && a.symbolCode == '>' &&
+        a.course == 88 && a.speed == 36 && fieldIs(ax, a.comment, "Comprimida"));
+
+  ok = decode("N0CALL>APRS:!/5L!!<*e7_ {Q", ax, a);
+  check("posición comprimida sin curso", ok && a.compressed && a.course == APRS_NO_COURSE);
+
+  ok = decode("TI2ABC-9>PYUQ6P,WIDE1-1:`oRBn\"O>/]Mic-E", ax, a);
+  check("Mic-E", ok && a.type == APRS_TYPE_MICE && near(a.latitude, 9860000) &&
+        near(a.longitude, -83906333) && a.speed == 20 && a.course == 251 &&
+        a.symbolCode == '>' && a.symbolTable == '/' && a.miceMessage == 7 && !a.miceCustom &&
+        fieldIs(ax, a.comment, "]Mic-E"));
+
+  ok = decode("TI2ABC-9>AY1Q6P-2:'oRBn\"O>/", ax, a);
+  check("Mic-E con mensaje alterno", ok && a.miceCustom && a.miceMessage == 6);
+
+  ok = decode("TI4GHI>APRS,TCPIP*,qAC,T2CR::TI2ABC-9 :Hola desde APRS-IS{42", ax, a);
+  check("mensaje con número", ok && a.type == APRS_TYPE_MESSAGE &&
+        fieldIs(ax, a.addressee, "TI2ABC-9") && fieldIs(ax, a.text, "Hola desde APRS-IS") &&
+        fieldIs(ax, a.messageId, "42") && !a.ack);
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ack42", ax, a);
+  check("ack", ok && a.ack && !a.rej && fieldIs(ax, a.addressee, "TI4GHI") &&
+        fieldIs(ax, a.messageId, "42"));
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :rej7", ax, a);
+  check("rej", ok && a.rej && fieldIs(ax, a.messageId, "7"));
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :acknowledged", ax, a);
+  check("texto que empieza con \"ack\": mensaje común", ok && !a.ack && !a.rej &&
+        fieldIs(ax, a.text, "acknowledged") && a.messageId.length == 0);
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :rejoin{3", ax, a);
+  check("texto que empieza con \"rej\": mensaje con número", ok && !a.ack && !a.rej &&
+        fieldIs(ax, a.text, "rejoin") && fieldIs(ax, a.messageId, "3"));
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ack", ax, a);
+  bool emptyId = ok && !a.ack && fieldIs(ax, a.text, "ack");
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ack123456", ax, a);
+  bool longId = ok && !a.ack && fieldIs(ax, a.text, "ack123456");
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ack4 ok", ax, a);
+  check("ack sin número, con 6 o con espacio: mensaje común", emptyId && longId && ok && !a.ack);
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ackMM}AA", ax, a);
+  check("ack respuesta-ack", ok && a.ack && !a.rej && fieldIs(ax, a.messageId, "MM"));
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :rej12}", ax, a);
+  check("rej respuesta-ack sin AA", ok && a.rej && fieldIs(ax, a.messageId, "12"));
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ackMM}ABC", ax, a);
+  bool longReply = ok && !a.ack && fieldIs(ax, a.text, "ackMM}ABC");
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :ack}AA", ax, a);
+  check("respuesta-ack con 3 o sin número: mensaje común",
+        longReply && ok && !a.ack && fieldIs(ax, a.text, "ack}AA"));
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :Hola{MM}AA", ax, a);
+  check("mensaje con respuesta-ack", ok && fieldIs(ax, a.text, "Hola") &&
+        fieldIs(ax, a.messageId, "MM"));
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI   :Sin numero", ax, a);
+  check("mensaje sin número", ok && fieldIs(ax, a.text, "Sin numero") &&
+        a.messageId.length == 0);
+
+  ok = decode("TI2ABC-9>APRS::TI4GHI", ax, a);
+  check("mensaje corto", !ok && a.type == APRS_TYPE_MESSAGE && a.error == APRS_ERR_SHORT);
+
+  ok = decode("TI0RC-10>APRS:>092345zNet de control", ax, a);
+  check("estado con hora", ok && a.type == APRS_TYPE_STATUS &&
+        fieldIs(ax, a.timestamp, "092345z") && fieldIs(ax, a.comment, "Net de control"));
+
+  ok = decode("TI0RC-10>APRS:>Estacion de prueba ITCR", ax, a);
+  check("estado", ok && a.timestamp.length == 0 &&
+        fieldIs(ax, a.comment, "Estacion de prueba ITCR"));
+
+  ok = decode("TI0RC-10>APRS:;LEADER   *092345z4903.50N/07201.75W>088/036", ax, a);
+  check("objeto", ok && a.type == APRS_TYPE_OBJECT && fieldIs(ax, a.name, "LEADER") &&
+        a.alive && fieldIs(ax, a.timestamp, "092345z") && near(a.latitude, 49058333) &&
+        a.course == 88);
+
+  ok = decode("TI0RC-10>APRS:;LEADER   _092345z/5L!!<*e7>7P[", ax, a);
+  check("objeto eliminado, comprimido", ok && !a.alive && a.compressed);
+
+  ok = decode("TI0RC-10>APRS:)AID #2!4903.50N/07201.75WA", ax, a);
+  check("ítem", ok && a.type == APRS_TYPE_ITEM && fieldIs(ax, a.name, "AID #2") && a.alive &&
+        a.symbolCode == 'A');
+
+  ok = decode("TI5JKL-1>APRS:T#005,199,000,255,073,123,01101001", ax, a);
+  check("telemetría", ok && a.type == APRS_TYPE_TELEMETRY && a.sequence == 5 &&
+        a.analogCount == 5 && a.analog[0] == 199 && a.analog[2] == 255 &&
+        a.analog[4] == 123 && a.hasDigital && a.digital == 0x69);
+
+  ok = decode("TI5JKL-1>APRS:T#MIC,1.5,-2,,4", ax, a);
+  check("telemetría MIC con decimales", ok && a.analogCount == 4 && a.analog[0] == 1.5f &&
+        a.analog[1] == -2 && a.analog[2] == 0 && !a.hasDigital);
+
+  ok = decode("TI5JKL-1>APRS:T#12x,1", ax, a);
+  check("telemetría mal formada", !ok && a.error == APRS_ERR_FORMAT);
+
+  ok = decode("TI0TEC>APRS:}TI2ABC>APRS,TCPIP,TI0TEC*:>estado", ax, a);
+  AX25Packet inner;
+  parseAX25(ax.data(a.thirdParty), a.thirdParty.length, inner);
+  check("tercero", ok && a.type == APRS_TYPE_THIRD_PARTY && inner.valid &&
+        inner.equals(inner.source, "TI2ABC"));
+
+  ok = decode("N0CALL>APRS:Rx 2 !0951.60N/08354.38W>", ax, a);
+  check("'!' dentro de los primeros 40 caracteres", ok && a.type == APRS_TYPE_POSITION &&
+        near(a.latitude, 9860000));
+
+  ok = decode("N0CALL>APRS:!09x1.60N/08354.38W>", ax, a);
+  check("latitud inválida", !ok && a.error == APRS_ERR_FORMAT && !a.hasPosition);
+
+  ok = decode("N0CALL>APRS:!0951.60N/0835", ax, a);
+  check("posición truncada", !ok && a.error == APRS_ERR_SHORT);
+
+  ok = decode("N0CALL>APRS:!0951.60X/08354.38W>", ax, a);
+  check("hemisferio inválido", !ok && a.error == APRS_ERR_FORMAT);
+
+  ok = decode("N0CALL>APRS:xyz", ax, a);
+  check("tipo desconocido", !ok && a.type == APRS_TYPE_UNKNOWN && a.error == APRS_ERR_UNKNOWN);
+
+  ok = decode("sin separadores", ax, a);
+  check("trama inválida", !ok && a.error == APRS_ERR_EMPTY);
+}
+
+// ============================================================================
+//  Tráfico sin volcado: los vectores válidos en proporciones de un feed real
+// ============================================================================
+static const char* const SAMPLE[] = {
+  "TI2ABC-9>APLRT1,WIDE1-1,qAR,TI0TEC:!0951.60N/08354.38W>LoRa tracker 12.4V",
+  "TI3XYZ-7>APLRG1,qAR,TI0TEC:=0952.10N/08355.20W&LoRa iGate Cartago",
+  "N0CALL>APRS,TCPIP*,qAC,T2TEXAS:@092345z4903.50N/07201.75W>088/036Comentario",
+  "N0CALL-2>APRS,TCPIP*,qAC,T2TEXAS:=/5L!!<*e7>7P[Comprimida",
+  "TI2ABC-9>PYUQ6P,WIDE1-1,qAR,TI0TEC:`oRBn\"O>/]Mic-E",
+  "TI4GHI>APRS,TCPIP*,qAC,T2CR::TI2ABC-9 :Hola desde APRS-IS{42",
+  "TI0RC-10>APRS,TCPIP*,qAC,T2CR:>Estacion de prueba ITCR",
+  "TI0RC-10>APRS,TCPIP*,qAC,T2CR:;LEADER   *092345z4903.50N/07201.75W>088/036",
+  "TI5JKL-1>APRS,TCPIP*,qAC,T2CR:T#005,199,000,255,073,123,01101001",
+  "TI2ABC-9>APLRT1,WIDE1-1,qAR,TI0TEC:!0951.60N/08354.38W>LoRa tracker 12.4V",
+};
+
+int main(int argc, char** argv) {
+  goldenVectors();
+
+  std::vector<std::string> lines;
+  if (argc > 1) {
+    FILE* f = fopen(argv[1], "r");
+    if (f == nullptr) {
+      fprintf(stderr, "No se puede abrir %s\n", argv[1]);
+      return 1;
+    }
+    char buffer[1024];
+    while (fgets(buffer, sizeof(buffer), f) != nullptr) {
+      size_t n = strcspn(buffer, "\r\n");
+      if (n == 0 || buffer[0] == '#') continue;
+      lines.push_back(std::string(buffer, n));
+    }
+    fclose(f);
+  } else {
+    for (const char* s : SAMPLE) lines.push_back(s);
+  }
+  if (lines.empty()) {
+    fprintf(stderr, "Volcado sin paquetes\n");
+    return 1;
+  }
+  size_t passes = argc > 2 ? strtoul(argv[2], nullptr, 10)
+                           : (lines.size() < 200000 ? 2000000 / lines.size() + 1 : 1);
+
+  // Mezcla de tipos y errores (una pasada)
+  uint32_t types[APRS_TYPE_COUNT] = {0};
+  uint32_t errors[APRS_ERR_COUNT] = {0};
+  uint32_t positions = 0;
+  for (const std::string& l : lines) {
+    AX25Packet ax;
+    AprsInfo a;
+    parseAX25(l.data(), l.size(), ax);
+    decodeAprs(ax, a);
+    types[a.type]++;
+    errors[a.error]++;
+    positions += a.hasPosition;
+  }
+
+  // Medición: parseAX25 sola y parseAX25 + decodeAprs
+  size_t sink = 0;
+  countAllocs = true;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t p = 0; p < passes; p++) {
+    for (const std::string& l : lines) {
+      AX25Packet ax;
+      parseAX25(l.data(), l.size(), ax);
+      sink += ax.info.length;
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (size_t p = 0; p < passes; p++) {
+    for (const std::string& l : lines) {
+      AX25Packet ax;
+      AprsInfo a;
+      parseAX25(l.data(), l.size(), ax);
+      decodeAprs(ax, a);
+      sink += (size_t)a.latitude + a.comment.length + a.type;
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  countAllocs = false;
+
+  double total = (double)passes * lines.size();
+  double parseSecs = std::chrono::duration<double>(t1 - t0).count();
+  double decodeSecs = std::chrono::duration<double>(t2 - t1).count();
+  printf("\n%zu paquetes x %zu pasadas%s\n", lines.size(), passes,
+         argc > 1 ? "" : " (muestra sintética)");
+  printf("  parseAX25               %12.0f paquetes/s  %7.1f ns/paquete\n",
+         total / parseSecs, parseSecs * 1e9 / total);
+  printf("  parseAX25 + decodeAprs  %12.0f paquetes/s  %7.1f ns/paquete  (%.2f allocs/paquete, "
+         "chk %zu)\n",
+         total / decodeSecs, decodeSecs * 1e9 / total, allocCount / total, sink);
+
+  printf("\nTipos (%u con posición):\n", positions);
+  for (int t = 0; t < APRS_TYPE_COUNT; t++) {
+    if (types[t] > 0) {
+      printf("  %-14s %8u  %5.1f %%\n", APRS_TYPE_NAMES[t], types[t],
+             100.0 * types[t] / lines.size());
+    }
+  }
+  printf("Resultado:\n");
+  for (int e = 0; e < APRS_ERR_COUNT; e++) {
+    if (errors[e] > 0) printf("  %-16s %8u\n", APRS_ERROR_NAMES[e], errors[e]);
+  }
+
+  if (allocCount > 0) failures++;
+  printf("\n%s\n", failures == 0 ? "Todas las verificaciones OK" : "HAY FALLAS");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+// ============================================================================
+//  Benchmark en host: filtro local APRS-IS → RF
+//  Descripción: Verifica AprsFilter con vectores dorados (rango con el
+//               rectángulo y el círculo, cruce de ±180°, prefijos, lista de
+//               indicativos con comodín, tipos, exclusiones, expresión vacía
+//               y errores de compilación con su posición) y mide el tiempo de
+//               evaluación por línea con los aciertos de cada cláusula. Con un
+//               volcado de APRS-IS como argumento (una línea TNC2 por línea,
+//               se ignoran las que empiezan con '#') mide sobre ese tráfico;
+//               sin él genera uno sintético alrededor de Costa Rica. Termina
+//               con 1 si algún vector falla o si hubo reservas.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/AX25 -Ilib/AprsDecoder -Ilib/AprsFilter
+//        bench/aprs_filter_bench.cpp lib/AX25/AX25.cpp lib/AprsDecoder/AprsDecoder.cpp
+//        lib/AprsFilter/AprsFilter.cpp -o aprs_filter_bench
+//    ./aprs_filter_bench [volcado-aprs-is.txt] ["expresión"]
+// ============================================================================
+#include <AprsFilter.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+static bool passes(AprsFilter& f, const char* line, int* clause = nullptr) {
+  return f.evaluate(line, strlen(line), clause);
+}
+
+// ============================================================================
+//  Vectores dorados
+// ============================================================================
+static const char* const CENTER   = "TI2ABC-9>APLRT1,qAR,TI0TEC:!0951.60N/08354.38W>";
+static const char* const NORTH    = "TI3XYZ>APRS,TCPIP*:!1024.00N/08354.00W>61 km al norte";
+static const char* const CORNER   = "TI3XYZ>APRS,TCPIP*:!1011.00N/08330.00W>57 km en diagonal";
+static const char* const MESSAGE  = "TI4GHI>APRS,TCPIP*,qAC,T2CR::TI2ABC-9 :Hola{1";
+static const char* const SPAM     = "SPAMMER>APRS,TCPIP*::TI2ABC-9 :Compre ya";
+static const char* const STATUS   = "TI0RC-10>APRS,TCPIP*:>Estacion de prueba";
+static const char* const OBJECT   = "TI0RC-10>APRS:;LEADER   *092345z0951.60N/08354.38W>";
+static const char* const TELEM    = "TI5JKL-1>APRS:T#005,199,000,255,073,123,01101001";
+static const char* const WEATHER  = "TI6WX>APRS:!0951.60N/08354.38W_090/005g010t077";
+static const char* const NWS      = "NWSBOT>APRS::NWS-WARN :Tormenta";
+static const char* const MICE     = "TI2ABC-9>PYUQ6P,WIDE1-1:`oRBn\"O>/";
+
+static void goldenVectors() {
+  AprsFilter f;
+  int clause;
+
+  printf("Compilación:\n");
+  check("expresión vacía: pasa todo", f.compile("") == FILTER_OK && f.empty() &&
+        passes(f, CENTER) && passes(f, "basura"));
+  check("cláusula desconocida", f.compile("r/9/-84/10 x/1") == FILTER_ERR_UNKNOWN &&
+        f.errorPosition() == 11 && f.empty());
+  check("rango incompleto", f.compile("r/9.85/-83.90") == FILTER_ERR_ARGUMENT);
+  check("rango fuera de límites", f.compile("r/95/-83.90/10") == FILTER_ERR_ARGUMENT);
+  check("tipo desconocido", f.compile("t/mz") == FILTER_ERR_ARGUMENT && f.errorPosition() == 3);
+  check("tipo vacío", f.compile("t/") == FILTER_ERR_UNKNOWN);
+  check("indicativo inválido", f.compile("b/TI@X") == FILTER_ERR_ARGUMENT &&
+        f.errorPosition() == 4);
+  check("prefijo vacío", f.compile("p/TI//XE") == FILTER_ERR_ARGUMENT);
+  std::string many;
+  for (int i = 0; i <= FILTER_MAX_CLAUSES; i++) many += "p/TI ";
+  check("demasiadas cláusulas", f.compile(many.c_str()) == FILTER_ERR_TOO_MANY);
+  std::string ops = "p";
+  for (int i = 0; i <= FILTER_MAX_OPS; i++) ops += "/A";
+  check("demasiados argumentos", f.compile(ops.c_str()) == FILTER_ERR_TOO_MANY);
+  std::string longText(FILTER_MAX_TEXT + 1, 'p');
+  check("expresión demasiado larga", f.compile(longText.c_str()) == FILTER_ERR_TOO_LONG);
+  check("con error el filtro queda vacío", f.empty() && passes(f, SPAM));
+
+  printf("Rango:\n");
+  check("r/ compila", f.compile("r/9.85/-83.90/50") == FILTER_OK && f.opCount() == 1);
+  check("dentro del radio", passes(f, CENTER, &clause) && clause == 0);
+  check("Mic-E dentro del radio", passes(f, MICE));
+  check("objeto dentro del radio", passes(f, OBJECT));
+  check("fuera del rectángulo", !passes(f, NORTH, &clause) && clause == -1);
+  check("dentro del rectángulo, fuera del círculo", !passes(f, CORNER));
+  check("sin posición no coincide", !passes(f, MESSAGE));
+  check("letra en mayúscula", f.compile("R/9.85/-83.90/50") == FILTER_OK && passes(f, CENTER));
+  f.compile("r/0/179.9/100");
+  check("cruce de +180°", passes(f, "A>B:!0000.00N/17954.00W>") &&
+        passes(f, "A>B:!0000.00N/17954.00E>") && !passes(f, "A>B:!0000.00N/17000.00E>"));
+  f.compile("r/89.5/0/100");
+  check("cerca del polo: cualquier longitud", passes(f, "A>B:!8955.00N/17000.00W>"));
+
+  printf("Indicativos y tipos:\n");
+  f.compile("p/ti b/N0CALL b/XE1*");
+  check("prefijo (minúsculas en la expresión)", passes(f, CENTER, &clause) && clause == 0);
+  check("lista exacta", passes(f, "N0CALL>APRS:>x", &clause) && clause == 1 &&
+        !passes(f, "N0CALL-1>APRS:>x"));
+  check("lista con comodín", passes(f, "XE1ABC>APRS:>x", &clause) && clause == 2 &&
+        !passes(f, "XE2ABC>APRS:>x"));
+  check("p/ y b/ no decodifican", f.stats().decoded == 0);
+
+  f.compile("t/m");
+  check("t/m: mensaje", passes(f, MESSAGE) && !passes(f, CENTER) && !passes(f, STATUS));
+  f.compile("t/p");
+  check("t/p: posición y Mic-E", passes(f, CENTER) && passes(f, MICE) && !passes(f, OBJECT));
+  f.compile("t/ostwn");
+  check("t/ostwn", passes(f, OBJECT) && passes(f, STATUS) && passes(f, TELEM) &&
+        passes(f, WEATHER) && passes(f, NWS) && !passes(f, MESSAGE) && !passes(f, CENTER));
+
+  printf("Exclusiones:\n");
+  f.compile("t/m -b/SPAM*");
+  check("exclusión gana a la cláusula normal", !passes(f, SPAM, &clause) && clause == 1);
+  check("sin exclusión pasa", passes(f, MESSAGE, &clause) && clause == 0);
+  check("sin coincidencias se rechaza", !passes(f, STATUS, &clause) && clause == -1);
+  check("aciertos por cláusula", f.clause(0).hits == 1 && f.clause(1).hits == 1 &&
+        f.stats().unmatched == 1 && f.stats().passed == 1 && f.stats().rejected == 2);
+  f.compile("-p/SPAM -t/s");
+  check("solo exclusiones: pasa lo demás", passes(f, MESSAGE) && !passes(f, SPAM) &&
+        !passes(f, STATUS));
+  check("texto de la cláusula", f.clause(1).exclude &&
+        std::string(f.text() + f.clause(1).offset, f.clause(1).length) == "-t/s");
+}
+
+// ============================================================================
+//  Tráfico sintético: posiciones alrededor de Costa Rica, mensajes, estados
+//  y telemetría
+// ============================================================================
+static void syntheticFeed(std::vector<std::string>& lines) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> lat(5.0f, 15.0f), lon(78.0f, 90.0f);
+  char line[160];
+  for (int i = 0; i < 5000; i++) {
+    int kind = (int)(rng() % 10);
+    unsigned call = rng() % 500;
+    if (kind < 6) {
+      float la = lat(rng), lo = lon(rng);
+      snprintf(line, sizeof(line), "TI%uABC-%u>APRS,TCPIP*,qAC,T2CR:!%02d%05.2fN/%03d%05.2fW>Prueba",
+               call % 10, call % 16, (int)la, (la - (int)la) * 60, (int)lo, (lo - (int)lo) * 60);
+    } else if (kind < 8) {
+      snprintf(line, sizeof(line), "%s%u>APRS,TCPIP*,qAC,T2CR::TI%uXYZ   :Hola{%u",
+               call % 7 == 0 ? "SPAM" : "TI", call, call % 10, call);
+    } else if (kind < 9) {
+      snprintf(line, sizeof(line), "TI%uRC>APRS,TCPIP*,qAC,T2CR:>Estado %u", call % 10, call);
+    } else {
+      snprintf(line, sizeof(line), "TI%uTLM>APRS,TCPIP*,qAC,T2CR:T#%03u,1,2,3,4,5,00000000",
+               call % 10, call % 1000);
+    }
+    lines.push_back(line);
+  }
+}
+
+static void measure(const char* expression, const std::vector<std::string>& lines) {
+  AprsFilter f;
+  FilterError e = f.compile(expression);
+  if (e != FILTER_OK) {
+    printf("\"%s\": %s en la posición %zu\n", expression, FILTER_ERROR_NAMES[e],
+           f.errorPosition());
+    failures++;
+    return;
+  }
+  size_t passes = lines.size() < 100000 ? 1000000 / lines.size() + 1 : 1;
+
+  countAllocs = true;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t p = 0; p < passes; p++) {
+    for (const std::string& l : lines) f.evaluate(l.data(), l.size());
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  countAllocs = false;
+
+  double total = (double)passes * lines.size();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / total;
+  const FilterStats& s = f.stats();
+  printf("\n\"%s\" (%zu operaciones)\n", expression, f.opCount());
+  printf("  %7.1f ns/línea  pasan %.1f %%  rechazadas %.1f %%  sin coincidencia %.1f %%  "
+         "decodificadas %.1f %%\n", ns, 100.0 * s.passed / s.evaluated,
+         100.0 * s.rejected / s.evaluated, 100.0 * s.unmatched / s.evaluated,
+         100.0 * s.decoded / s.evaluated);
+  for (size_t i = 0; i < f.clauseCount(); i++) {
+    const FilterClause& c = f.clause(i);
+    printf("  %-24.*s %s %10u\n", (int)c.length, f.text() + c.offset,
+           c.exclude ? "rechaza" : "pasa   ", c.hits);
+  }
+}
+
+int main(int argc, char** argv) {
+  goldenVectors();
+
+  std::vector<std::string> lines;
+  if (argc > 1) {
+    FILE* file = fopen(argv[1], "r");
+    if (file == nullptr) {
+      fprintf(stderr, "No se puede abrir %s\n", argv[1]);
+      return 1;
+    }
+    char buffer[1024];
+    while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+      size_t n = strcspn(buffer, "\r\n");
+      if (n == 0 || buffer[0] == '#') continue;
+      lines.push_back(std::string(buffer, n));
+    }
+    fclose(file);
+  } else {
+    syntheticFeed(lines);
+  }
+  if (lines.empty()) {
+    fprintf(stderr, "Volcado sin paquetes\n");
+    return 1;
+  }
+  printf("\n%zu líneas%s\n", lines.size(), argc > 1 ? "" : " (tráfico sintético)");
+
+  if (argc > 2) {
+    measure(argv[2], lines);
+  } else {
+    measure("p/TI -b/SPAM*", lines);
+    measure("r/9.85/-83.90/200", lines);
+    measure("r/9.85/-83.90/200 t/m -b/SPAM* -t/t", lines);
+  }
+
+  if (allocCount > 0) failures++;
+  printf("\n%s\n", failures == 0 ? "Todas las verificaciones OK" : "HAY FALLAS");
+  return failures == 0 ? 0 : 1;
+}
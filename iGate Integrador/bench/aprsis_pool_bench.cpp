@@ -0,0 +1,442 @@
+// ============================================================================
+//  Benchmark en host: pool de servidores APRS-IS
+//  Descripción: Levanta servidores APRS-IS de prueba en 127.0.0.x (un hilo
+//               con sockets no bloqueantes, banner y logresp con demoras
+//               configurables) y ejercita AprsIsPool con sockets reales como
+//               lo hace la tarea de red: selección por latencia de login, conexión de reserva,
+//               cambio planificado al servidor más rápido, sondeos a un
+//               servidor que no responde y a uno que rechaza la conexión, y
+//               failover cuando el servidor de la sesión se cae. Compara el
+//               tiempo sin sesión contra una reconexión sin reserva. Termina
+//               con 1 si alguna verificación falla o si hubo reservas de
+//               memoria durante la prueba.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -pthread -Ilib/AprsIsPool bench/aprsis_pool_bench.cpp
+//        lib/AprsIsPool/AprsIsPool.cpp -o aprsis_pool_bench
+//    ./aprsis_pool_bench [-v]
+// ============================================================================
+#include <AprsIsPool.h>
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <new>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+static uint32_t nowMs() {
+  using namespace std::chrono;
+  static const steady_clock::time_point origin = steady_clock::now();
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now() - origin).count();
+}
+
+static bool verbose = false;
+
+// ============================================================================
+//  Servidores de prueba: cada uno escucha en su propia 127.0.0.x (el pool
+//  nunca abre dos conexiones a la misma dirección). Todo en un hilo.
+// ============================================================================
+#define STANDIN_MAX_CONNS 4
+
+struct StandInConn {
+  int      fd;
+  uint32_t acceptedAt;
+  uint32_t loginAt;        // 0 = sin login todavía
+  uint32_t lastKeepalive;
+  bool     bannerSent;
+  bool     logrespSent;
+  char     rx[256];
+  size_t   rxLength;
+};
+
+struct StandInConfig {
+  const char* name;
+  const char* address;
+  int         bannerDelayMs;   // -1 = nunca
+  int         logrespDelayMs;  // -1 = nunca
+  bool        refuse;          // Puerto cerrado: connect() rechazado
+};
+
+struct StandIn {
+  StandInConfig     cfg;
+  int               listenFd;
+  uint16_t          port;
+  std::atomic<bool> crash;           // Cierra las conexiones y deja de escuchar
+  std::atomic<int>  accepted;
+  std::atomic<int>  logins;
+  std::atomic<int>  filteredLogins;  // Login con "filter"
+  std::atomic<int>  filterCommands;  // "#filter" después del login
+  StandInConn       conns[STANDIN_MAX_CONNS];
+};
+
+static const uint32_t STANDIN_KEEPALIVE_MS = 150;
+
+static bool standInOpen(StandIn& s) {
+  s.listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(s.listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = inet_addr(s.cfg.address);
+  addr.sin_port = 0;
+  if (bind(s.listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0) return false;
+  socklen_t len = sizeof(addr);
+  getsockname(s.listenFd, (struct sockaddr*)&addr, &len);
+  s.port = ntohs(addr.sin_port);
+  if (s.cfg.refuse) {   // Puerto reservado pero sin listen(): RST inmediato
+    close(s.listenFd);
+    s.listenFd = -1;
+    return true;
+  }
+  fcntl(s.listenFd, F_SETFL, fcntl(s.listenFd, F_GETFL, 0) | O_NONBLOCK);
+  for (StandInConn& c : s.conns) c.fd = -1;
+  return listen(s.listenFd, 4) == 0;
+}
+
+static void standInSend(StandInConn& c, const char* text) {
+  if (send(c.fd, text, strlen(text), MSG_NOSIGNAL) < 0) {}
+}
+
+static void standInLine(StandIn& s, StandInConn& c, const char* line, uint32_t now) {
+  if (strncmp(line, "user ", 5) == 0) {
+    s.logins++;
+    if (strstr(line, " filter ") != nullptr) s.filteredLogins++;
+    c.loginAt = now ? now : 1;
+  } else if (strncmp(line, "#filter ", 8) == 0) {
+    s.filterCommands++;
+  }
+}
+
+static void standInTick(StandIn& s, uint32_t now) {
+  if (s.listenFd < 0) return;
+
+  if (s.crash) {
+    for (StandInConn& c : s.conns) {
+      if (c.fd >= 0) close(c.fd);
+      c.fd = -1;
+    }
+    close(s.listenFd);
+    s.listenFd = -1;
+    return;
+  }
+
+  int fd = accept(s.listenFd, nullptr, nullptr);
+  if (fd >= 0) {
+    for (StandInConn& c : s.conns) {
+      if (c.fd >= 0) continue;
+      memset(&c, 0, sizeof(c));
+      c.fd = fd;
+      c.acceptedAt = c.lastKeepalive = now;
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+      s.accepted++;
+      fd = -1;
+      break;
+    }
+    if (fd >= 0) close(fd);
+  }
+
+  for (StandInConn& c : s.conns) {
+    if (c.fd < 0) continue;
+    ssize_t n = recv(c.fd, c.rx + c.rxLength, sizeof(c.rx) - 1 - c.rxLength, MSG_DONTWAIT);
+    if (n == 0) {
+      close(c.fd);
+      c.fd = -1;
+      continue;
+    }
+    if (n > 0) {
+      c.rxLength += (size_t)n;
+      char* eol;
+      while ((eol = (char*)memchr(c.rx, '\n', c.rxLength)) != nullptr) {
+        *eol = '\0';
+        standInLine(s, c, c.rx, now);
+        size_t used = (size_t)(eol - c.rx) + 1;
+        memmove(c.rx, c.rx + used, c.rxLength - used);
+        c.rxLength -= used;
+      }
+      if (c.rxLength == sizeof(c.rx) - 1) c.rxLength = 0;
+    }
+
+    if (!c.bannerSent && s.cfg.bannerDelayMs >= 0 && now - c.acceptedAt >= (uint32_t)s.cfg.bannerDelayMs) {
+      standInSend(c, "# aprsc 2.1.14-g5e22b37 (prueba)\r\n");
+      c.bannerSent = true;
+    }
+    if (c.loginAt != 0 && !c.logrespSent && s.cfg.logrespDelayMs >= 0 &&
+        now - c.loginAt >= (uint32_t)s.cfg.logrespDelayMs) {
+      standInSend(c, "# logresp N0CALL-10 verified, server T2TEST\r\n");
+      c.logrespSent = true;
+    }
+    if (c.logrespSent && now - c.lastKeepalive >= STANDIN_KEEPALIVE_MS) {
+      standInSend(c, "# aprsc 2.1.14 15 Oct 2026 12:00:00 GMT T2TEST 127.0.0.1:14580\r\n");
+      c.lastKeepalive = now;
+    }
+  }
+}
+
+static const StandInConfig STANDINS[] = {
+  // nombre    dirección     banner logresp rechaza
+  { "rechaza", "127.0.0.2",   0,     0,     true  },
+  { "lento",   "127.0.0.3",   60,    150,   false },
+  { "rapido",  "127.0.0.4",   2,     15,    false },
+  { "mudo",    "127.0.0.5",   -1,    -1,    false },
+  { "unico",   "127.0.0.6",   2,     15,    false },
+};
+static const size_t STANDIN_COUNT = sizeof(STANDINS) / sizeof(STANDINS[0]);
+static StandIn standIns[STANDIN_COUNT];
+enum { SRV_REFUSE, SRV_SLOW, SRV_FAST, SRV_MUTE, SRV_SINGLE };
+
+static std::atomic<bool> standInsRunning(true);
+
+static void standInThread() {
+  while (standInsRunning) {
+    uint32_t now = nowMs();
+    for (StandIn& s : standIns) standInTick(s, now);
+    usleep(200);
+  }
+}
+
+// ============================================================================
+//  Lado del firmware: lo mismo que aprsSessionTick() en src/network.cpp,
+//  con un socket crudo en lugar de WiFiClient y DNS con inet_addr()
+// ============================================================================
+struct Harness {
+  AprsIsPool pool;
+  int        fd;
+  int        sessions;
+  uint32_t   eventCounts[POOL_EV_COUNT];
+  char       drain[512];
+};
+
+static void onEvent(const PoolEvent& e, void* context) {
+  Harness& h = *(Harness*)context;
+  h.eventCounts[e.id]++;
+  if (!verbose) return;
+  printf("    [%5u ms] %-8s %-9s %-13s %-7s value=%u %.*s\n", (unsigned)nowMs(),
+         POOL_ROLE_NAMES[e.role], h.pool.host(e.server), POOL_EVENT_NAMES[e.id],
+         POOL_STAGE_NAMES[e.stage], (unsigned)e.value, (int)e.length, e.text ? e.text : "");
+}
+
+static void harnessBegin(Harness& h, const size_t* servers, size_t count) {
+  memset(h.eventCounts, 0, sizeof(h.eventCounts));
+  h.fd = -1;
+  h.sessions = 0;
+
+  PoolTimings t;
+  t.connectMs       = 300;
+  t.bannerMs        = 150;
+  t.loginMs         = 300;
+  t.backoffMinMs    = 100;
+  t.backoffMaxMs    = 2000;
+  t.probeIntervalMs = 250;
+  t.idleTimeoutMs   = 1000;
+  t.keepaliveMs     = 400;
+  t.switchMarginMs  = 50;
+  h.pool.setTimings(t);
+  h.pool.setEventHandler(onEvent, &h);
+  h.pool.setLogin("N0CALL-10", "13023", "aprsis_pool_bench 1.0", "r/9.85/-83.90/200");
+
+  for (size_t i = 0; i < count; i++) {
+    char hostPort[40];
+    snprintf(hostPort, sizeof(hostPort), "%s:%u", standIns[servers[i]].cfg.address,
+             standIns[servers[i]].port);
+    h.pool.addServer(hostPort, 14580);
+  }
+}
+
+static void harnessStep(Harness& h) {
+  uint32_t now = nowMs();
+  int i;
+  while ((i = h.pool.needsAddress(now)) >= 0) h.pool.setAddress(i, inet_addr(h.pool.host(i)), now);
+  h.pool.tick(now);
+
+  if (h.fd >= 0) {
+    ssize_t n = recv(h.fd, h.drain, sizeof(h.drain), MSG_DONTWAIT);
+    bool closed = n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+    if (!closed && !h.pool.switchPending()) return;
+    close(h.fd);
+    h.fd = -1;
+    h.pool.sessionClosed(now);
+  }
+  h.fd = h.pool.takeSession(now);
+  if (h.fd >= 0) h.sessions++;
+}
+
+template <typename Pred>
+static bool runUntil(Harness& h, uint32_t timeoutMs, Pred done) {
+  uint32_t start = nowMs();
+  while (nowMs() - start < timeoutMs) {
+    harnessStep(h);
+    if (done()) return true;
+    usleep(200);
+  }
+  return false;
+}
+
+static void runFor(Harness& h, uint32_t ms) {
+  runUntil(h, ms, [] { return false; });
+}
+
+static void report(Harness& h) {
+  uint32_t now = nowMs();
+  const PoolStats& p = h.pool.stats();
+  printf("  intentos=%u failover=%u cambios=%u sin_reserva=%u failover_ms(ult/max)=%u/%u "
+         "fallos dns=%u tcp=%u banner=%u login=%u reserva=%u\n",
+         (unsigned)p.attempts, (unsigned)p.failovers, (unsigned)p.switches,
+         (unsigned)p.coldStarts, (unsigned)p.lastFailoverMs, (unsigned)p.maxFailoverMs,
+         (unsigned)p.failures[POOL_STAGE_IDLE], (unsigned)p.failures[POOL_STAGE_CONNECT],
+         (unsigned)p.failures[POOL_STAGE_BANNER], (unsigned)p.failures[POOL_STAGE_LOGIN],
+         (unsigned)p.failures[POOL_STAGE_READY]);
+  for (size_t i = 0; i < h.pool.serverCount(); i++) {
+    const PoolServerStats& s = h.pool.serverStats(i);
+    printf("  %-16s connect_ms=%-3u login_ms=%-4u uptime_ms=%-5u sesiones=%u caidas=%u "
+           "failover=%u fallos=%u sondeos=%u\n",
+           h.pool.host(i), (unsigned)s.connectMs, (unsigned)s.loginMs,
+           (unsigned)h.pool.uptime(i, now), (unsigned)s.sessions, (unsigned)s.drops,
+           (unsigned)s.failovers, (unsigned)s.failures, (unsigned)s.probes);
+  }
+}
+
+// ============================================================================
+//  Escenario 1: cuatro servidores (rechaza, lento, rápido, mudo)
+// ============================================================================
+static uint32_t poolScenario() {
+  printf("Pool de cuatro servidores\n");
+  static Harness h;
+  const size_t servers[] = { SRV_REFUSE, SRV_SLOW, SRV_FAST, SRV_MUTE };
+  harnessBegin(h, servers, 4);
+  AprsIsPool& pool = h.pool;
+
+  bool first = runUntil(h, 2000, [&] { return h.fd >= 0; });
+  check("sesión inicial en el primer servidor que responde", first && pool.active() == SRV_SLOW &&
+        pool.serverStats(SRV_REFUSE).failures >= 1);
+  check("login inicial con el filtro", standIns[SRV_SLOW].filteredLogins == 1);
+
+  bool switched = runUntil(h, 2000, [&] { return pool.stats().switches == 1 && h.fd >= 0; });
+  runFor(h, 50);   // El servidor de prueba procesa el "#filter"
+  check("reserva en el rápido y cambio planificado a él", switched && pool.active() == SRV_FAST);
+  check("la reserva se autentica sin filtro y lo envía al entregarse",
+        standIns[SRV_FAST].filteredLogins == 0 && standIns[SRV_FAST].filterCommands == 1);
+
+  bool standby = runUntil(h, 2000, [&] {
+    return pool.linkServer(POOL_ROLE_STANDBY) == SRV_SLOW &&
+           pool.linkStage(POOL_ROLE_STANDBY) == POOL_STAGE_READY;
+  });
+  check("el servidor anterior queda como reserva", standby);
+
+  runFor(h, 1500);
+  check("sondeo al mudo: falla por login sin logresp",
+        pool.serverStats(SRV_MUTE).attempts >= 1 && pool.serverStats(SRV_MUTE).probes == 0 &&
+        pool.stats().failures[POOL_STAGE_LOGIN] >= 1 && h.eventCounts[POOL_EV_NO_BANNER] >= 1);
+  check("latencias medidas: rápido < lento",
+        pool.serverStats(SRV_FAST).loginMs > 0 &&
+        pool.serverStats(SRV_FAST).loginMs < pool.serverStats(SRV_SLOW).loginMs);
+  check("sin cambios de ida y vuelta", pool.stats().switches == 1 && pool.active() == SRV_FAST);
+
+  // Caída del servidor de la sesión: la reserva la reemplaza
+  uint32_t crashAt = nowMs();
+  standIns[SRV_FAST].crash = true;
+  bool failover = runUntil(h, 2000, [&] { return pool.stats().failovers == 1 && h.fd >= 0; });
+  uint32_t gap = nowMs() - crashAt;
+  runFor(h, 50);
+  check("failover a la reserva tras la caída", failover && pool.active() == SRV_SLOW &&
+        pool.serverStats(SRV_FAST).failovers == 1 && pool.serverStats(SRV_FAST).drops == 1);
+  check("sin sesión menos de 1 s (caída → sesión nueva)", gap < 1000);
+  check("la reserva promovida también recibe el filtro", standIns[SRV_SLOW].filterCommands == 1);
+
+  runFor(h, 500);
+  report(h);
+  if (h.fd >= 0) close(h.fd);
+  pool.stop();
+  printf("  caída → sesión con reserva: %u ms (pool: %u ms desde la detección)\n",
+         (unsigned)gap, (unsigned)pool.stats().lastFailoverMs);
+  return gap;
+}
+
+// ============================================================================
+//  Escenario 2: un solo servidor (sin reserva): reconexión completa
+// ============================================================================
+static uint32_t singleScenario() {
+  printf("Un servidor, sin reserva\n");
+  static Harness h;
+  const size_t servers[] = { SRV_SINGLE };
+  harnessBegin(h, servers, 1);
+  AprsIsPool& pool = h.pool;
+
+  bool first = runUntil(h, 2000, [&] { return h.fd >= 0; });
+  runFor(h, 300);
+  check("sesión y ninguna reserva posible", first && pool.linkServer(POOL_ROLE_STANDBY) < 0);
+
+  // La conexión se corta pero el servidor sigue escuchando
+  uint32_t dropAt = nowMs();
+  for (StandInConn& c : standIns[SRV_SINGLE].conns) {
+    if (c.fd >= 0) shutdown(c.fd, SHUT_RDWR);
+  }
+  bool back = runUntil(h, 3000, [&] { return h.sessions == 2 && h.fd >= 0; });
+  uint32_t gap = nowMs() - dropAt;
+  check("reconexión completa tras la espera", back && pool.stats().coldStarts == 2 &&
+        pool.stats().failovers == 0);
+  report(h);
+  if (h.fd >= 0) close(h.fd);
+  pool.stop();
+  printf("  caída → sesión sin reserva: %u ms (espera mínima %u ms + connect + login)\n",
+         (unsigned)gap, 100u);
+  return gap;
+}
+
+int main(int argc, char** argv) {
+  verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+  for (size_t i = 0; i < STANDIN_COUNT; i++) {
+    StandIn& s = standIns[i];
+    s.cfg = STANDINS[i];
+    if (!standInOpen(s)) {
+      printf("No se pudo abrir %s en %s\n", s.cfg.name, s.cfg.address);
+      return 1;
+    }
+  }
+  std::thread server(standInThread);
+
+  countAllocs = true;
+  uint32_t withStandby = poolScenario();
+  uint32_t without = singleScenario();
+  countAllocs = false;
+
+  standInsRunning = false;
+  server.join();
+
+  printf("Resumen\n");
+  printf("  sin sesión tras una caída: %u ms con reserva, %u ms sin reserva\n",
+         (unsigned)withStandby, (unsigned)without);
+  check("reservas de memoria durante la prueba", allocCount == 0);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// ============================================================================
+//  Benchmark en host: parser / digipeater AX.25
+//  Descripción: Compara la implementación anterior basada en cadenas
+//               dinámicas (substring + concatenación) con la nueva basada en
+//               vistas y buffers fijos. Reporta tramas/s y bytes de heap
+//               solicitados por trama.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/AX25 -Ilib/DigiEngine bench/ax25_bench.cpp
+//        lib/AX25/AX25.cpp lib/DigiEngine/DigiEngine.cpp -o ax25_bench
+//    ./ax25_bench
+// ============================================================================
+#include <AX25.h>
+#include <DigiEngine.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+// ============================================================================
+//  Contador global de memoria dinámica
+// ============================================================================
+static size_t allocCount = 0;
+static size_t allocBytes = 0;
+
+void* operator new(size_t n) {
+  allocCount++;
+  allocBytes += n;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static const char* MYCALL = "TI0TEC5-7";
+
+static const char* FRAMES[] = {
+  "TI2ABC-9>APLRT1,WIDE1-1:!0951.60N/08354.38W>LoRa tracker 12.4V",
+  "TI3XYZ-7>APLRG1,WIDE1-1,WIDE2-1:=0952.10N/08355.20W&LoRa iGate Cartago",
+  "TI0RC-10>APRS,WIDE2-2:>Estacion de prueba ITCR",
+  "TI2DEF-5>APLRT1,TI0RPT*,WIDE2-1:!0950.00N/08350.00W[Ya digipeado",
+  "TI4GHI>APDR16,TCPIP*,qAC,T2CR:=0955.00N/08400.00W$Desde Internet",
+  "TI5JKL-1>APRS,RELAY,WIDE3-3:T#123,100,200,000,000,000,00000000",
+  "TI6MNO-2>APLRT1:!0949.00N/08351.00W>Sin path",
+};
+static const size_t FRAME_COUNT = sizeof(FRAMES) / sizeof(FRAMES[0]);
+
+// ============================================================================
+//  Implementación anterior (modelo con std::string en lugar de Arduino String)
+// ============================================================================
+struct LegacyPacket {
+  std::string destination, source, path, info;
+};
+
+static LegacyPacket legacyParse(const std::string& packet) {
+  LegacyPacket ax;
+  size_t sep1 = packet.find('>');
+  size_t sep2 = packet.find(':');
+  if (sep1 == std::string::npos || sep2 == std::string::npos || sep2 <= sep1) {
+    ax.info = packet;
+    return ax;
+  }
+  ax.destination = packet.substr(0, sep1);
+  std::string rest = packet.substr(sep1 + 1, sep2 - sep1 - 1);
+  size_t comma = rest.find(',');
+  if (comma != std::string::npos) {
+    ax.source = rest.substr(0, comma);
+    ax.path = rest.substr(comma + 1);
+  } else {
+    ax.source = rest;
+  }
+  ax.info = packet.substr(sep2 + 1);
+  return ax;
+}
+
+static std::string legacyDigipeat(const LegacyPacket& ax) {
+  const std::string& p = ax.path;
+  if (p.find("WIDE") == std::string::npos && p.find("TRACE") == std::string::npos &&
+      p.find("RELAY") == std::string::npos) return "";
+  if (p.find('*') != std::string::npos) return "";
+  if (p.find("TCPIP") != std::string::npos || p.find("TCPXX") != std::string::npos ||
+      p.find("NOGATE") != std::string::npos || p.find("RFONLY") != std::string::npos) return "";
+  if (ax.source == MYCALL) return "";
+
+  std::string newPath;
+  bool digipeated = false;
+  size_t pos = 0;
+  while (pos < p.length()) {
+    size_t comma = p.find(',', pos);
+    if (comma == std::string::npos) comma = p.length();
+    std::string field = p.substr(pos, comma - pos);
+    if (!digipeated && (field.compare(0, 4, "WIDE") == 0 || field.compare(0, 5, "TRACE") == 0 ||
+                        field.compare(0, 5, "RELAY") == 0)) {
+      size_t dash = field.find('-');
+      if (dash != std::string::npos && dash > 0) {
+        int n = atoi(field.substr(dash + 1).c_str());
+        if (n > 0) field = field.substr(0, dash) + "-" + std::to_string(n - 1);
+      }
+      newPath += std::string(MYCALL) + "*,";
+      digipeated = true;
+    }
+    newPath += field;
+    if (comma < p.length()) newPath += ",";
+    pos = comma + 1;
+  }
+  if (!digipeated) return "";
+  return ax.source + ">" + ax.destination + "," + newPath + ":" + ax.info;
+}
+
+// ============================================================================
+//  Medición
+// ============================================================================
+template <typename Fn>
+static void run(const char* name, size_t iterations, Fn fn) {
+  size_t sink = 0;
+  size_t count0 = allocCount, bytes0 = allocBytes;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) sink += fn(FRAMES[i % FRAME_COUNT]);
+  auto t1 = std::chrono::steady_clock::now();
+  double secs = std::chrono::duration<double>(t1 - t0).count();
+  printf("%-10s %12.0f tramas/s  %8.2f allocs/trama  %8.1f bytes/trama  (chk %zu)\n",
+         name, iterations / secs,
+         (double)(allocCount - count0) / iterations,
+         (double)(allocBytes - bytes0) / iterations, sink);
+}
+
+int main(int argc, char** argv) {
+  size_t iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 2000000;
+
+  run("anterior", iterations, [](const char* f) -> size_t {
+    std::string packet(f);
+    LegacyPacket ax = legacyParse(packet);
+    return legacyDigipeat(ax).length();
+  });
+
+  static char frame[AX25_MAX_FRAME + 1];
+  static char out[AX25_MAX_FRAME];
+  static DigiEngine engine;
+  engine.compile(DigiConfig{ true, true, 2, 0 }, MYCALL);
+  run("vistas", iterations, [](const char* f) -> size_t {
+    size_t len = strlen(f);
+    memcpy(frame, f, len);  // Simula la copia desde la FIFO del radio
+    AX25Packet ax;
+    parseAX25(frame, len, ax);
+    return engine.process(ax, out, sizeof(out)).length;
+  });
+  return 0;
+}
@@ -0,0 +1,255 @@
+// ============================================================================
+//  Benchmark en host: exploración CAD de varias combinaciones SF/BW
+//  Descripción: Vectores dorados del plan de CadScanner (símbolo, CAD,
+//               ventana y garantía por combinación, rechazo de los planes
+//               que no garantizan la principal) y simulación de la
+//               exploración con la misma API que usa la tarea de radio:
+//               preámbulos aislados en instantes aleatorios, cada CAD
+//               detecta si empieza dentro del preámbulo con
+//               SCAN_LOCK_SYMBOLS todavía por delante. Compara la fracción
+//               detectada y la latencia máxima medidas con las del plan y
+//               mide el costo de elegir la siguiente combinación. Termina
+//               con 1 si alguna verificación falla o si hubo reservas de
+//               memoria durante la prueba.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/CadScanner bench/cad_scan_bench.cpp
+//        lib/CadScanner/CadScanner.cpp -o cad_scan_bench
+//    ./cad_scan_bench
+// ============================================================================
+#include <CadScanner.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+static const uint16_t PREAMBLE = 8;
+
+static void printPlan(const CadScanner& scan) {
+  for (size_t i = 0; i < scan.count(); i++) {
+    char name[12];
+    CadScanner::format(scan.modem(i), name, sizeof(name));
+    const ScanPlan& p = scan.planned(i);
+    printf("    %-9s símbolo=%6u us cad=%6u us ventana=%7u us hueco=%7u us "
+           "cobertura=%5.1f%% tiempo=%5.1f%%%s\n",
+           name, p.symbolUs, p.cadUs, p.windowUs, p.worstGapUs, p.coveragePermille / 10.0,
+           p.dutyPermille / 10.0, p.guaranteed ? " garantizada" : "");
+  }
+}
+
+// ============================================================================
+//  Vectores dorados del plan
+// ============================================================================
+static void goldenPlan() {
+  printf("Plan\n");
+  CadScanner scan;
+  char name[12];
+
+  check("SF7/125 sola: sin exploración, cobertura total",
+        scan.add(ScanModem{ 7, 125000 }) && (scan.plan(PREAMBLE), !scan.active()) &&
+        scan.planned(0).coveragePermille == 1000 && scan.planned(0).guaranteed);
+  check("SF7/125: símbolo 1024 us, CAD 1580 us, ventana 6868 us",
+        scan.planned(0).symbolUs == 1024 && scan.planned(0).cadUs == 1580 &&
+        scan.planned(0).windowUs == 6868);
+  check("combinación repetida o SF 6: rechazada",
+        !scan.add(ScanModem{ 7, 125000 }) && !scan.add(ScanModem{ 6, 125000 }) && scan.count() == 1);
+  check("formato SF12/125 y SF9/62.5",
+        (CadScanner::format(ScanModem{ 12, 125000 }, name, sizeof(name)), strcmp(name, "SF12/125") == 0) &&
+        (CadScanner::format(ScanModem{ 9, 62500 }, name, sizeof(name)), strcmp(name, "SF9/62.5") == 0));
+  check("bloqueo SF7/125: preámbulo + cabecera = 20736 us", scan.lockTimeoutUs(0) == 20736);
+
+  // El CAD de SF12 (33 ms) es más largo que la ventana de SF7 (6.9 ms): con
+  // SF7 como principal el plan se rechaza y queda recepción continua
+  scan.add(ScanModem{ 12, 125000 });
+  bool accepted = scan.plan(PREAMBLE);
+  check("SF7 + SF12: rechazado, SF7 continua",
+        !accepted && !scan.active() && scan.count() == 1 && scan.planned(0).guaranteed &&
+        scan.planned(0).coveragePermille == 1000);
+  check("SF7 + SF12: plan rechazado con hueco de SF7 > ventana",
+        !scan.rejected().guaranteed && scan.rejected().worstGapUs > scan.rejected().windowUs &&
+        scan.rejected().coveragePermille >= 850 && scan.rejected().coveragePermille <= 920);
+
+  // Con SF12 como principal sí se acepta; la secundaria SF7 pierde preámbulos
+  scan.clear();
+  scan.add(ScanModem{ 12, 125000 });
+  scan.add(ScanModem{ 7, 125000 });
+  accepted = scan.plan(PREAMBLE);
+  printf("  SF12 + SF7\n");
+  printPlan(scan);
+  const ScanPlan& sf12 = scan.planned(0);
+  const ScanPlan& sf7 = scan.planned(1);
+  check("SF12/125: CAD 33324 us, ventana 237012 us",
+        sf12.cadUs == 33324 && sf12.windowUs == 237012);
+  check("SF12 + SF7: aceptado, SF12 garantizada, SF7 no",
+        accepted && scan.active() && sf12.guaranteed && !sf7.guaranteed);
+  check("SF12 + SF7: hueco de SF7 >= CAD de SF12", sf7.worstGapUs >= sf12.cadUs);
+  check("SF12 + SF7: cobertura de SF7 entre 85 y 92%",
+        sf7.coveragePermille >= 850 && sf7.coveragePermille <= 920);
+  check("latencia garantizada = la de SF12", scan.worstLatencyUs() == sf12.worstLatencyUs);
+
+  // Combinaciones rápidas: todas caben en la ventana de la más corta
+  scan.clear();
+  scan.add(ScanModem{ 7, 125000 });
+  scan.add(ScanModem{ 9, 125000 });
+  scan.add(ScanModem{ 10, 250000 });
+  accepted = scan.plan(PREAMBLE);
+  printf("  SF7 + SF9 + SF10/250\n");
+  printPlan(scan);
+  bool all = accepted && scan.count() == 3;
+  for (size_t i = 0; i < scan.count(); i++) all = all && scan.planned(i).guaranteed;
+  check("SF7 + SF9 + SF10/250: aceptado, todas garantizadas", all);
+}
+
+// ============================================================================
+//  Simulación: la política de next() contra preámbulos aislados
+// ============================================================================
+static uint64_t rng = 88172645463325252ULL;
+
+static uint32_t random32() {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return (uint32_t)rng;
+}
+
+struct SimResult {
+  uint32_t sent[SCAN_MAX_MODEMS];
+  uint32_t detected[SCAN_MAX_MODEMS];
+  uint32_t maxLatencyUs[SCAN_MAX_MODEMS];
+};
+
+// Un preámbulo por vez en una combinación al azar; entre preámbulos el
+// canal queda libre al menos una vuelta completa
+static SimResult simulate(CadScanner& scan, uint32_t preambles) {
+  SimResult r;
+  memset(&r, 0, sizeof(r));
+  uint32_t t = 0;
+  uint32_t cycle = 0;
+  for (size_t i = 0; i < scan.count(); i++) cycle += scan.planned(i).cadUs + scan.planned(i).windowUs;
+
+  // Arranque de la exploración antes del primer preámbulo
+  while (t < cycle) {
+    size_t i = scan.next(t);
+    t += scan.planned(i).cadUs;
+    scan.cadDone(i, t, false);
+  }
+
+  for (uint32_t n = 0; n < preambles; n++) {
+    size_t combo = random32() % scan.count();
+    const ScanPlan& p = scan.planned(combo);
+    uint32_t start = t + random32() % cycle;
+    uint32_t length = (uint32_t)((uint64_t)(PREAMBLE * 4 + 17) * p.symbolUs / 4);
+    uint32_t lastStart = start + length - SCAN_LOCK_SYMBOLS * p.symbolUs - p.cadUs;
+    r.sent[combo]++;
+
+    bool found = false;
+    while ((int32_t)(t - (start + length)) < 0) {
+      size_t i = scan.next(t);
+      uint32_t cadStart = t;
+      t += scan.planned(i).cadUs;
+      bool hit = !found && i == combo && (int32_t)(cadStart - start) >= 0 &&
+                 (int32_t)(cadStart - lastStart) <= 0;
+      scan.cadDone(i, t, hit);
+      if (hit) {
+        found = true;
+        r.detected[combo]++;
+        if (t - start > r.maxLatencyUs[combo]) r.maxLatencyUs[combo] = t - start;
+      }
+    }
+  }
+  return r;
+}
+
+static void simulation() {
+  printf("Simulación (preámbulos aislados)\n");
+  CadScanner scan;
+  scan.add(ScanModem{ 12, 125000 });
+  scan.add(ScanModem{ 7, 125000 });
+  scan.plan(PREAMBLE);
+
+  const uint32_t PREAMBLES = 20000;
+  countAllocs = true;
+  SimResult r = simulate(scan, PREAMBLES);
+  countAllocs = false;
+
+  for (size_t i = 0; i < scan.count(); i++) {
+    char name[12];
+    CadScanner::format(scan.modem(i), name, sizeof(name));
+    const ScanStats& s = scan.stats(i);
+    printf("    %-9s preámbulos=%5u detectados=%5.1f%% (plan %5.1f%%) latencia_max=%6u us "
+           "(plan %6u) vencidas=%u hueco_max=%u us\n",
+           name, r.sent[i], r.sent[i] ? r.detected[i] * 100.0 / r.sent[i] : 0.0,
+           scan.planned(i).coveragePermille / 10.0, r.maxLatencyUs[i], scan.planned(i).worstLatencyUs,
+           s.missedWindows, s.maxGapUs);
+  }
+
+  const ScanPlan& sf12 = scan.planned(0);
+  const ScanPlan& sf7 = scan.planned(1);
+  double seen7 = r.detected[1] * 1000.0 / r.sent[1];
+  check("SF12: todos los preámbulos detectados", r.detected[0] == r.sent[0]);
+  check("SF12: latencia máxima <= la del plan", r.maxLatencyUs[0] <= sf12.worstLatencyUs);
+  check("SF12: sin ventanas vencidas", scan.stats(0).missedWindows == 0);
+  check("SF7: detectados dentro de ±3% de la cobertura del plan",
+        seen7 > sf7.coveragePermille - 30 && seen7 < sf7.coveragePermille + 30);
+  check("SF7: ventanas vencidas registradas", scan.stats(1).missedWindows > 0);
+  check("hueco máximo medido = el del plan",
+        scan.stats(1).maxGapUs == sf7.worstGapUs && scan.stats(0).maxGapUs == sf12.worstGapUs);
+  check("sin reservas de memoria", allocCount == 0);
+}
+
+// ============================================================================
+//  Costo de elegir la siguiente combinación (en el ESP32 ocurre una vez por
+//  CAD, es decir cada 1.6 a 33 ms)
+// ============================================================================
+static void timing() {
+  printf("Tiempo\n");
+  CadScanner scan;
+  scan.add(ScanModem{ 12, 125000 });
+  scan.add(ScanModem{ 7, 125000 });
+  scan.add(ScanModem{ 9, 125000 });
+  scan.add(ScanModem{ 10, 250000 });
+  check("SF12 + SF7 + SF9 + SF10/250: aceptado", scan.plan(PREAMBLE) && scan.count() == 4);
+
+  const uint32_t ROUNDS = 10000000;
+  uint32_t t = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ROUNDS; n++) {
+    size_t i = scan.next(t);
+    t += scan.planned(i).cadUs;
+    scan.cadDone(i, t, false);
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  printf("  next() + cadDone() con 4 combinaciones  %.1f ns\n", ns / ROUNDS);
+}
+
+int main() {
+  goldenPlan();
+  simulation();
+  timing();
+  printf(failures ? "%d verificaciones fallaron\n" : "Todas las verificaciones OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,320 @@
+// ============================================================================
+//  Benchmark en host: captura binaria de tráfico (lib/CaptureLog)
+//  Descripción: Vectores dorados de la codificación de registros y de la
+//               traza de texto, detección de registros cortados o alterados
+//               al leer un segmento y costo de escribir cuatro horas de tráfico
+//               en archivos reales: un registro por escritura contra lotes
+//               de CAPTURE_BATCH_BYTES, con los segmentos rotando a
+//               CAPTURE_SEGMENT_BYTES como en el equipo. Los segmentos
+//               quedan en el directorio indicado (por defecto /tmp) y se
+//               pueden reproducir con bench/replay_bench.cpp. Termina con 1
+//               si alguna verificación falla o si hubo reservas de memoria
+//               al armar los lotes.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/CaptureLog bench/capture_bench.cpp
+//        lib/CaptureLog/CaptureLog.cpp -o capture_bench
+//    ./capture_bench [directorio]
+// ============================================================================
+#include <CaptureLog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// Mismos valores que include/config.h
+static const uint32_t CAPTURE_SEGMENT_BYTES = 65536;
+static const uint32_t CAPTURE_SEGMENTS = 4;
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+static CaptureRecord makeRecord(CaptureDirection dir, const char* text, uint32_t timeMs,
+                                int16_t rssi, float snr) {
+  CaptureRecord r;
+  r.timeMs = timeMs;
+  r.frequencyHz = dir == CAP_IS_RX ? 0 : 433775000UL;
+  r.rssi = rssi;
+  r.snr = snr;
+  r.direction = dir;
+  r.spreadingFactor = dir == CAP_IS_RX ? 0 : 12;
+  r.length = (uint16_t)strlen(text);
+  r.data = text;
+  return r;
+}
+
+// Segmento en memoria: cabecera + un lote
+static size_t buildSegment(const CaptureBatch& batch, uint32_t sequence, uint8_t* out) {
+  CaptureSegmentHeader header;
+  captureSegmentHeader(header, sequence, 1000);
+  memcpy(out, &header, sizeof(header));
+  memcpy(out + sizeof(header), batch.data(), batch.size());
+  return sizeof(header) + batch.size();
+}
+
+// ============================================================================
+//  Vectores dorados
+// ============================================================================
+static void golden() {
+  printf("Codificación\n");
+  const char* frame = "TI0ABC-9>APLRT1,WIDE1-1:!0956.12N/08405.33W>LoRa";
+  uint8_t buf[256];
+  char line[256];
+  CaptureRecord rx = makeRecord(CAP_RF_RX, frame, 123456, -97, 7.3f);
+  size_t n = captureEncode(rx, buf, sizeof(buf));
+  check("registro RF: 16 bytes de cabecera + trama", n == 16 + strlen(frame));
+  check("sin espacio: no codifica", captureEncode(rx, buf, n - 1) == 0);
+
+  CaptureRecord back;
+  bool ok = captureDecodeHeader(buf, back);
+  back.data = (const char*)buf + sizeof(CaptureRecordHeader);
+  check("ida y vuelta: instante, RSSI, SF, frecuencia y trama",
+        ok && captureVerify(buf, back) && back.timeMs == 123456 && back.rssi == -97 &&
+        back.spreadingFactor == 12 && back.frequencyHz == 433775000UL &&
+        back.direction == CAP_RF_RX && back.length == strlen(frame) &&
+        memcmp(back.data, frame, back.length) == 0);
+  check("SNR en cuartos de dB: 7.3 -> 7.25", back.snr == 7.25f);
+
+  captureFormatTrace(back, 0, line, sizeof(line));
+  check("traza RF", strcmp(line, "123456 RF -97 7.25 TI0ABC-9>APLRT1,WIDE1-1:!0956.12N/08405.33W>LoRa") == 0);
+  captureFormatTrace(back, 1000, line, sizeof(line));
+  check("traza RF desplazada 1000 ms", strncmp(line, "124456 RF ", 10) == 0);
+
+  CaptureRecord is = makeRecord(CAP_IS_RX, "TI5XYZ>APRS,TCPIP*::TI0ABC-9 :hola{1\r\n", 5, 0, 0);
+  captureFormatTrace(is, 0, line, sizeof(line));
+  check("traza IS: fin de línea reemplazado", strcmp(line, "5 IS TI5XYZ>APRS,TCPIP*::TI0ABC-9 :hola{1  ") == 0);
+  CaptureRecord tx = makeRecord(CAP_RF_TX, "TI0IGT>APRS:>hola", 7, 0, 0);
+  captureFormatTrace(tx, 0, line, sizeof(line));
+  check("traza TX", strcmp(line, "7 TX TI0IGT>APRS:>hola") == 0);
+  check("traza truncada al tamaño del buffer",
+        captureFormatTrace(back, 0, line, 12) == 11 && strlen(line) == 11);
+
+  static char big[CAPTURE_MAX_DATA + 1];
+  memset(big, 'x', sizeof(big));
+  CaptureRecord tooLong = makeRecord(CAP_IS_RX, "", 0, 0, 0);
+  tooLong.data = big;
+  tooLong.length = sizeof(big);
+  static uint8_t bigOut[CAPTURE_MAX_DATA + 64];
+  check("registro mayor que CAPTURE_MAX_DATA: rechazado", captureEncode(tooLong, bigOut, sizeof(bigOut)) == 0);
+}
+
+// ============================================================================
+//  Lectura: registros cortados por un reinicio o alterados
+// ============================================================================
+static void reading() {
+  printf("Lectura\n");
+  static CaptureBatch batch;
+  static uint8_t segment[sizeof(CaptureSegmentHeader) + CAPTURE_BATCH_BYTES];
+  char text[64];
+  for (uint32_t i = 0; i < 20; i++) {
+    snprintf(text, sizeof(text), "TI2A%02u-9>APLRT1:!0950.%02uN/08350.00W>", i, i);
+    batch.add(makeRecord(i % 3 == 2 ? CAP_IS_RX : CAP_RF_RX, text, 1000 + i * 250, -80 - (int)i, 2.5f));
+  }
+  size_t length = buildSegment(batch, 7, segment);
+
+  CaptureReader reader(segment, length);
+  CaptureRecord r;
+  uint32_t count = 0;
+  uint32_t lastMs = 0;
+  bool ordered = true;
+  CaptureReadResult res;
+  while ((res = reader.next(r)) == CAPTURE_READ_OK) {
+    ordered = ordered && r.timeMs >= lastMs;
+    lastMs = r.timeMs;
+    count++;
+  }
+  check("segmento completo: 20 registros en orden y fin", reader.valid() && count == 20 && ordered &&
+                                                          res == CAPTURE_READ_END);
+  check("número de secuencia en la cabecera", reader.header().sequence == 7);
+
+  // Corte en cada byte posible: nunca se entrega un registro incompleto
+  bool allCuts = true;
+  size_t boundaries = 0;
+  for (size_t cut = sizeof(CaptureSegmentHeader); cut < length; cut++) {
+    CaptureReader partial(segment, cut);
+    uint32_t got = 0;
+    size_t end = sizeof(CaptureSegmentHeader);
+    while ((res = partial.next(r)) == CAPTURE_READ_OK) {
+      got++;
+      end = partial.offset();
+    }
+    bool boundary = end == cut;
+    if (boundary) boundaries++;
+    allCuts = allCuts && got < 20 && (boundary ? res == CAPTURE_READ_END : res == CAPTURE_READ_TORN);
+  }
+  check("corte en cualquier byte: registro cortado detectado", allCuts && boundaries == 20);
+
+  CaptureReader shortHeader(segment, sizeof(CaptureSegmentHeader) - 1);
+  check("cabecera de segmento incompleta: inválido", !shortHeader.valid());
+
+  // Un byte alterado en la trama del registro 5
+  size_t at = sizeof(CaptureSegmentHeader);
+  for (int i = 0; i < 5; i++) at += captureRecordBytes(((const CaptureRecordHeader*)(segment + at))->length);
+  segment[at + sizeof(CaptureRecordHeader) + 3] ^= 0x20;
+  CaptureReader corrupt(segment, length);
+  count = 0;
+  while ((res = corrupt.next(r)) == CAPTURE_READ_OK) count++;
+  check("byte alterado: la lectura se detiene en ese registro", count == 5 && res == CAPTURE_READ_TORN);
+}
+
+// ============================================================================
+//  Escritura de varias horas de tráfico en archivos (más de lo que cabe en
+//  los segmentos, para que roten)
+// ============================================================================
+static const uint32_t HOURS = 4;
+
+struct WriteResult {
+  uint32_t records, writes, segments;
+  uint64_t bytes;
+  double   us;
+};
+
+// Misma rotación que writeBatch en src/capture.cpp; 'batched' en falso
+// escribe y vacía cada registro por separado
+static WriteResult writeHours(const char* dir, const char* prefix, bool batched) {
+  static CaptureBatch batch;
+  static uint8_t single[sizeof(CaptureRecordHeader) + CAPTURE_MAX_DATA];
+  WriteResult w;
+  memset(&w, 0, sizeof(w));
+  batch.clear();
+
+  char path[256];
+  FILE* f = nullptr;
+  uint32_t segmentBytes = 0;
+  uint32_t sequence = 0;
+  char text[160];
+  uint32_t rng = 0x2545F491UL;
+
+  auto flush = [&](const uint8_t* data, size_t len, uint32_t nowMs) {
+    if (f == nullptr || segmentBytes + len > CAPTURE_SEGMENT_BYTES) {
+      if (f != nullptr) fclose(f);
+      sequence++;
+      snprintf(path, sizeof(path), "%s/%s%u.bin", dir, prefix, sequence % CAPTURE_SEGMENTS);
+      f = fopen(path, "wb");
+      if (f == nullptr) return;
+      CaptureSegmentHeader header;
+      captureSegmentHeader(header, sequence, nowMs);
+      fwrite(&header, sizeof(header), 1, f);
+      segmentBytes = sizeof(header);
+      w.segments++;
+    }
+    fwrite(data, 1, len, f);
+    fflush(f);
+    segmentBytes += len;
+    w.bytes += len;
+    w.writes++;
+  };
+
+  auto t0 = std::chrono::steady_clock::now();
+  countAllocs = true;
+  for (uint32_t t = 0; t < HOURS * 3600000; t += 400 + rng % 1600) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    CaptureDirection dir = rng % 10 < 6 ? CAP_RF_RX : (rng % 10 < 8 ? CAP_IS_RX : CAP_RF_TX);
+    snprintf(text, sizeof(text), "TI2A%02u-9>APLRT1,WIDE1-1:!09%02u.%02uN/083%02u.%02uW>LoRa %u.%uV",
+             rng % 40, 50 + rng % 10, t / 1000 % 60, 50 + rng % 9, t / 7000 % 60, 11 + t % 3, t % 10);
+    CaptureRecord r = makeRecord(dir, text, t, (int16_t)(-70 - (int)(rng % 50)), (int)(rng % 80) / 4.0f - 8.0f);
+    w.records++;
+    if (batched) {
+      if (!batch.fits(r.length)) {
+        flush(batch.data(), batch.size(), t);
+        batch.clear();
+      }
+      batch.add(r);
+    } else {
+      size_t n = captureEncode(r, single, sizeof(single));
+      flush(single, n, t);
+    }
+  }
+  if (batched && !batch.empty()) flush(batch.data(), batch.size(), HOURS * 3600000);
+  countAllocs = false;
+  w.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  if (f != nullptr) fclose(f);
+  return w;
+}
+
+// Relee los segmentos que quedaron y cuenta los registros completos
+static uint32_t readBack(const char* dir, const char* prefix, uint32_t& segments) {
+  uint32_t records = 0;
+  segments = 0;
+  std::vector<uint8_t> data;
+  for (uint32_t i = 0; i < CAPTURE_SEGMENTS; i++) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s%u.bin", dir, prefix, i);
+    FILE* f = fopen(path, "rb");
+    if (!f) continue;
+    data.assign(CAPTURE_SEGMENT_BYTES + CAPTURE_BATCH_BYTES, 0);
+    size_t n = fread(data.data(), 1, data.size(), f);
+    fclose(f);
+    CaptureReader reader(data.data(), n);
+    if (!reader.valid()) continue;
+    segments++;
+    CaptureRecord r;
+    while (reader.next(r) == CAPTURE_READ_OK) records++;
+  }
+  return records;
+}
+
+static void writing(const char* dir) {
+  printf("Escritura (%u horas de tráfico, segmentos de %u B x %u)\n", HOURS,
+         (unsigned)CAPTURE_SEGMENT_BYTES, (unsigned)CAPTURE_SEGMENTS);
+  WriteResult single = writeHours(dir, "capsingle", false);
+  WriteResult batched = writeHours(dir, "cap", true);
+  const WriteResult* rows[] = { &single, &batched };
+  const char* names[] = { "registro a registro", "por lotes" };
+  for (int i = 0; i < 2; i++) {
+    const WriteResult& w = *rows[i];
+    printf("  %-20s registros=%u bytes=%llu escrituras=%u (%.0f B/escritura) segmentos=%u "
+           "%.2f us/registro\n",
+           names[i], w.records, (unsigned long long)w.bytes, w.writes,
+           w.writes ? (double)w.bytes / w.writes : 0.0, w.segments, w.us / w.records);
+  }
+
+  uint32_t segments = 0;
+  uint32_t kept = readBack(dir, "cap", segments);
+  printf("  quedan %u segmentos con %u registros en %s/cap*.bin\n", segments, kept, dir);
+  check("mismos registros y bytes en ambos modos",
+        single.records == batched.records && single.bytes == batched.bytes);
+  check("lotes: al menos 50 veces menos escrituras", batched.writes * 50 <= single.writes);
+  check("quedan CAPTURE_SEGMENTS segmentos legibles", segments == CAPTURE_SEGMENTS);
+  check("registros releídos = los de los últimos segmentos", kept > 0 && kept < batched.records);
+  check("sin reservas de memoria al armar los lotes", allocCount == 0);
+
+  for (uint32_t i = 0; i < CAPTURE_SEGMENTS; i++) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/capsingle%u.bin", dir, i);
+    remove(path);
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* dir = argc > 1 ? argv[1] : "/tmp";
+  golden();
+  reading();
+  writing(dir);
+  printf(failures ? "%d verificaciones fallaron\n" : "Todas las verificaciones OK\n", failures);
+  return failures ? 1 : 0;
+}
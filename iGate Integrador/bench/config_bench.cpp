@@ -0,0 +1,263 @@
+// ============================================================================
+//  Benchmark en host: carga de la configuración
+//  Descripción: Lee documentos is-cfg.json conocidos con ConfigParser y
+//               verifica los campos asignados, los errores de sintaxis (con
+//               línea y columna), los valores fuera de rango, las cadenas
+//               largas y las claves ignoradas; la lectura por trozos de 1 y
+//               de 64 bytes debe dar la misma estructura. Mide el tiempo de
+//               lectura del JSON frente a copiar la estructura binaria (lo que
+//               hace el arranque con la copia de NVS). Con un archivo como
+//               argumento también lo lee y lo reporta (termina con 1 si algo
+//               falla).
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/JsonStream -Ilib/IGateConfig bench/config_bench.cpp
+//        lib/JsonStream/JsonStream.cpp lib/IGateConfig/IGateConfig.cpp
+//        -o config_bench && ./config_bench data/is-cfg.json
+// ============================================================================
+#include <IGateConfig.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+// Valores de partida (equivalen a los de config.h en el firmware)
+static void defaults(IGateConfig& c) {
+  memset(&c, 0, sizeof(c));
+  strcpy(c.callsign, "N0CALL-1");
+  c.aprsIsActive = true;
+  strcpy(c.passcode, "-1");
+  strcpy(c.server, "rotate.aprs2.net");
+  c.port = 14580;
+  c.wifiActive = true;
+  c.apCount = 1;
+  strcpy(c.aps[0].ssid, "defecto");
+  c.frequencyHz = 433775000;
+  c.spreadingFactor = 12;
+  c.bandwidthHz = 125000;
+  c.codingRate4 = 5;
+  c.beaconIntervalS = 600;
+  strcpy(c.beaconRfPath, "WIDE1-1");
+}
+
+static bool parse(const char* text, size_t chunk, IGateConfig& c, ConfigReport& r) {
+  defaults(c);
+  ConfigParser parser(c, r);
+  size_t length = strlen(text);
+  for (size_t i = 0; i < length; i += chunk) {
+    if (!parser.feed(text + i, length - i < chunk ? length - i : chunk)) break;
+  }
+  return parser.finish();
+}
+
+static bool hasIssue(const ConfigReport& r, ConfigIssueCode code, const char* field) {
+  for (uint16_t i = 0; i < r.issueCount && i < CONFIG_MAX_ISSUES; i++) {
+    if (r.issues[i].code == code && strcmp(r.issues[i].field, field) == 0) return true;
+  }
+  return false;
+}
+
+static const char* const VALID =
+  "{\n"
+  "  \"callsign\": \"TI0ABC-10\",\n"
+  "  \"network\": { \"DHCP\": true, \"extra\": [1, 2, {\"x\": null}] },\n"
+  "  \"wifi\": { \"active\": true, \"AP\": [\n"
+  "    { \"SSID\": \"Casa\", \"password\": \"clave\\\"1\\\\\" },\n"
+  "    { \"SSID\": \"Oficina\\u0021\", \"password\": \"\" } ] },\n"
+  "  \"aprs_is\": { \"active\": true, \"passcode\": \"12345\", \"server\": \"cr.aprs2.net\",\n"
+  "               \"port\": 10152, \"filter\": \"r/9.85/-83.90/50 t/m\",\n"
+  "               \"rf_filter\": \"t/m -b/SPAM*\",\n"
+  "               \"servers\": [\"noam.aprs2.net\", \"192.168.1.20:14580\"] },\n"
+  "  \"lora\": { \"frequency_rx\": 433775000, \"spreading_factor\": 9,\n"
+  "            \"bandwidth\": 62500, \"coding_rate\": 8,\n"
+  "            \"scan\": [ { \"spreading_factor\": 12, \"bandwidth\": 125000 },\n"
+  "                      { \"spreading_factor\": 10 } ] },\n"
+  "  \"beacon\": { \"latitude\": 9.8599407, \"longitude\": -8.39063452e1,\n"
+  "              \"comment\": \"Prueba\", \"interval\": 300, \"rf\": true, \"rf_path\": \"\" }\n"
+  "}\n";
+
+static void goldenValid() {
+  printf("Documento válido\n");
+  IGateConfig a, b;
+  ConfigReport ra, rb;
+  bool okA = parse(VALID, 1, a, ra);
+  bool okB = parse(VALID, 64, b, rb);
+  check("sin problemas (trozos de 1 byte)", okA && ra.ok());
+  check("trozos de 1 y de 64 bytes: misma estructura", okB && memcmp(&a, &b, sizeof(a)) == 0);
+  check("callsign", strcmp(a.callsign, "TI0ABC-10") == 0);
+  check("aprs_is: passcode / server / port", strcmp(a.passcode, "12345") == 0 &&
+        strcmp(a.server, "cr.aprs2.net") == 0 && a.port == 10152);
+  check("aprs_is.filter / rf_filter", strcmp(a.filter, "r/9.85/-83.90/50 t/m") == 0 &&
+        strcmp(a.rfFilter, "t/m -b/SPAM*") == 0);
+  check("aprs_is.servers (host y host:puerto)", a.serverCount == 2 &&
+        strcmp(a.servers[0], "noam.aprs2.net") == 0 && strcmp(a.servers[1], "192.168.1.20:14580") == 0);
+  check("wifi.AP reemplaza la lista por defecto (2 redes)", a.apCount == 2 &&
+        strcmp(a.aps[0].ssid, "Casa") == 0);
+  check("escapes \\\" \\\\ \\u0021", strcmp(a.aps[0].password, "clave\"1\\") == 0 &&
+        strcmp(a.aps[1].ssid, "Oficina!") == 0);
+  check("lora: SF / BW / CR", a.spreadingFactor == 9 && a.bandwidthHz == 62500 &&
+        a.codingRate4 == 8);
+  check("lora.scan (BW omitido = 0, el principal)", a.scanCount == 2 &&
+        a.scan[0].spreadingFactor == 12 && a.scan[0].bandwidthHz == 125000 &&
+        a.scan[1].spreadingFactor == 10 && a.scan[1].bandwidthHz == 0);
+  check("beacon: latitud y longitud (exponente)",
+        a.beaconLat > 9.8599f && a.beaconLat < 9.8600f &&
+        a.beaconLon < -83.9063f && a.beaconLon > -83.9064f);
+  check("beacon: interval / rf / rf_path vacío", a.beaconIntervalS == 300 && a.beaconRf &&
+        a.beaconRfPath[0] == '\0');
+  check("claves ignoradas (network.*)", ra.unknownKeys == 4);
+  check("campos asignados", ra.assigned == 27);
+
+  // Un archivo parcial conserva los valores por defecto del resto
+  IGateConfig c;
+  ConfigReport rc;
+  bool okC = parse("{\"lora\":{\"spreading_factor\":10}}", 64, c, rc);
+  check("archivo parcial: conserva los valores por defecto", okC && c.spreadingFactor == 10 &&
+        strcmp(c.callsign, "N0CALL-1") == 0 && c.apCount == 1);
+}
+
+static void goldenInvalid() {
+  printf("Documentos inválidos\n");
+  IGateConfig c;
+  ConfigReport r;
+
+  parse("{\n  \"callsign\": \"TI0ABC\",\n  \"lora\": { \"coding_rate\": 5 }\n  \"x\": 1\n}", 64, c, r);
+  check("falta ',': sintaxis en línea 4, columna 3",
+        r.jsonError == JSON_ERR_SYNTAX && r.line == 4 && r.column == 3);
+
+  parse("{\"callsign\": \"TI0ABC\"", 64, c, r);
+  check("documento sin cerrar: incompleto", r.jsonError == JSON_ERR_INCOMPLETE);
+
+  parse("{\"a\":{\"b\":{\"c\":{\"d\":{\"e\":{\"f\":{\"g\":1}}}}}}}", 64, c, r);
+  check("anidamiento mayor a JSON_MAX_DEPTH", r.jsonError == JSON_ERR_DEPTH);
+
+  parse("{\"port\": 01}", 64, c, r);
+  check("número con cero a la izquierda", r.jsonError == JSON_ERR_SYNTAX);
+
+  parse("{\"lora\":{\"spreading_factor\":13,\"bandwidth\":100000,\"coding_rate\":4.5},"
+        "\"aprs_is\":{\"port\":\"14580\"}}", 64, c, r);
+  check("SF 13: fuera de rango", hasIssue(r, CFG_ISSUE_RANGE, "lora.spreading_factor"));
+  check("coding_rate 4.5: fuera de rango", hasIssue(r, CFG_ISSUE_RANGE, "lora.coding_rate"));
+  check("bandwidth 100000: no es un ancho de banda LoRa",
+        hasIssue(r, CFG_ISSUE_RANGE, "lora.bandwidth"));
+  check("port como cadena: tipo incorrecto", hasIssue(r, CFG_ISSUE_TYPE, "aprs_is.port"));
+  check("SF fuera de rango no se asigna", c.spreadingFactor == 12);
+
+  parse("{\"beacon\":{\"comment\":\"a\\u0007b\"}}", 64, c, r);
+  check("comentario con carácter de control", hasIssue(r, CFG_ISSUE_FORMAT, "beacon.comment"));
+
+  parse("{\"callsign\":\"TI0ABCDEFGH-1\",\"aprs_is\":{\"passcode\":\"abc\"},"
+        "\"beacon\":{\"rf\":true,\"rf_path\":\"WIDE1-1,\"}}", 64, c, r);
+  check("callsign de 13 caracteres: demasiado largo", hasIssue(r, CFG_ISSUE_TOO_LONG, "callsign"));
+  check("passcode no numérico", hasIssue(r, CFG_ISSUE_FORMAT, "aprs_is.passcode"));
+  check("rf_path con coma final", hasIssue(r, CFG_ISSUE_FORMAT, "beacon.rf_path"));
+
+  parse("{\"wifi\":{\"AP\":[{\"SSID\":\"a\"},{\"SSID\":\"b\"},{\"SSID\":\"c\"},{\"SSID\":\"d\"},"
+        "{\"SSID\":\"e\"}]}}", 64, c, r);
+  check("5 redes WiFi: demasiados elementos", hasIssue(r, CFG_ISSUE_TOO_MANY, "wifi.AP.SSID") &&
+        c.apCount == CONFIG_MAX_APS);
+
+  parse("{\"aprs_is\":{\"servers\":[\"ok.aprs2.net\",\"a:0\",\"b c\",\"d:1x\",\"e\",\"f\"]}}", 64, c, r);
+  check("servers: puerto 0, espacio o puerto no numérico: formato",
+        hasIssue(r, CFG_ISSUE_FORMAT, "aprs_is.servers") && r.issueCount == 5);
+  check("6 servidores: demasiados elementos", hasIssue(r, CFG_ISSUE_TOO_MANY, "aprs_is.servers") &&
+        c.serverCount == CONFIG_MAX_SERVERS);
+
+  parse("{\"wifi\":{\"AP\":[{\"password\":\"x\"}]},\"aprs_is\":{\"server\":\"\"}}", 64, c, r);
+  check("red sin SSID y servidor vacío: falta el valor",
+        hasIssue(r, CFG_ISSUE_MISSING, "wifi.AP.SSID") &&
+        hasIssue(r, CFG_ISSUE_MISSING, "aprs_is.server"));
+
+  parse("{\"lora\":{\"scan\":[{\"bandwidth\":125000},{\"spreading_factor\":9,\"bandwidth\":100000},"
+        "{\"spreading_factor\":6},{\"spreading_factor\":8},{\"spreading_factor\":11}]}}", 64, c, r);
+  check("scan sin SF, BW no LoRa y SF 6: falta / fuera de rango",
+        hasIssue(r, CFG_ISSUE_MISSING, "lora.scan") &&
+        hasIssue(r, CFG_ISSUE_RANGE, "lora.scan.bandwidth") &&
+        hasIssue(r, CFG_ISSUE_RANGE, "lora.scan.spreading_factor"));
+  check("4 combinaciones de exploración: demasiados elementos",
+        hasIssue(r, CFG_ISSUE_TOO_MANY, "lora.scan.spreading_factor") && c.scanCount == CONFIG_MAX_SCAN);
+}
+
+// ============================================================================
+//  Tiempo: lectura del JSON vs copia de la estructura (caché NVS)
+// ============================================================================
+template <typename Fn>
+static double timeUs(size_t iterations, Fn fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+}
+
+static void timing(const char* text) {
+  const size_t iterations = 20000;
+  static IGateConfig c, copy;
+  static ConfigReport r;
+  volatile uint32_t sink = 0;
+  double parseUs = timeUs(iterations, [&] {
+    parse(text, 64, c, r);
+    sink = sink + c.port;
+  });
+  double copyUs = timeUs(iterations * 100, [&] {
+    copy = c;
+    sink = sink + copy.port;
+  });
+  printf("Tiempo (%zu bytes, trozos de 64)\n", strlen(text));
+  printf("  lectura JSON + validación   %8.2f us\n", parseUs);
+  printf("  copia de la estructura      %8.3f us (%zu bytes)\n", copyUs, sizeof(IGateConfig));
+}
+
+// ============================================================================
+//  Archivo dado por argumento (p. ej. data/is-cfg.json)
+// ============================================================================
+static bool parseFile(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) {
+    printf("No se pudo abrir %s\n", path);
+    return false;
+  }
+  static IGateConfig c;
+  static ConfigReport r;
+  defaults(c);
+  ConfigParser parser(c, r);
+  char chunk[64];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0 && parser.feed(chunk, n)) {
+  }
+  fclose(f);
+  bool ok = parser.finish();
+
+  printf("%s: %u campos, %u claves ignoradas\n", path, r.assigned, r.unknownKeys);
+  if (r.jsonError != JSON_OK) {
+    printf("  error de %s en línea %lu, columna %lu\n", JSON_ERROR_NAMES[r.jsonError],
+           (unsigned long)r.line, (unsigned long)r.column);
+  }
+  for (uint16_t i = 0; i < r.issueCount && i < CONFIG_MAX_ISSUES; i++) {
+    printf("  %s: %s\n", r.issues[i].field, CONFIG_ISSUE_NAMES[r.issues[i].code]);
+  }
+  printf("  %s %s:%u filtro \"%s\", %u redes WiFi\n", c.callsign, c.server, c.port, c.filter,
+         c.apCount);
+  printf("  LoRa %lu Hz SF%u BW %lu CR 4/%u, beacon cada %lu s%s\n",
+         (unsigned long)c.frequencyHz, c.spreadingFactor, (unsigned long)c.bandwidthHz,
+         c.codingRate4, (unsigned long)c.beaconIntervalS, c.beaconRf ? " (también RF)" : "");
+  check("archivo sin problemas", ok);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  goldenValid();
+  goldenInvalid();
+  timing(VALID);
+  if (argc > 1) parseFile(argv[1]);
+
+  printf("%s\n", failures == 0 ? "Todas las verificaciones OK" : "HAY FALLAS");
+  return failures == 0 ? 0 : 1;
+}
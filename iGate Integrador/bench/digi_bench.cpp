@@ -0,0 +1,150 @@
+// ============================================================================
+//  Benchmark en host: motor de reglas del digipeater
+//  Descripción: Primero verifica los vectores dorados (path de entrada →
+//               trama digipeada y demora esperadas) para cada configuración
+//               de reglas; si alguno falla termina con código 1. Después
+//               mide tramas/s del motor completo y solo de la separación del
+//               path.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/AX25 -Ilib/DigiEngine bench/digi_bench.cpp
+//        lib/AX25/AX25.cpp lib/DigiEngine/DigiEngine.cpp -o digi_bench
+//    ./digi_bench [iteraciones]
+// ============================================================================
+#include <AX25.h>
+#include <DigiEngine.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* MYCALL = "TI0TEC5-7";
+
+// Configuraciones de reglas usadas por los vectores
+static const DigiConfig CONFIGS[] = {
+  { true,  true, 2, 0 },     // 0: propio + fill-in + WIDEn-N (n <= 2), sin demora
+  { false, true, 0, 5000 },  // 1: solo fill-in, viscoso 5 s
+  { true,  false, 3, 0 },    // 2: propio + WIDEn-N (n <= 3), sin fill-in
+};
+
+struct GoldenVector {
+  uint8_t     config;
+  const char* input;
+  const char* expected;   // nullptr = no se digipea
+  uint32_t    delayMs;
+};
+
+static const GoldenVector VECTORS[] = {
+  // Fill-in y WIDEn-N
+  { 0, "TI2ABC-9>APLRT1,WIDE1-1:!0951.60N/08354.38W>x",
+       "TI2ABC-9>APLRT1,TI0TEC5-7,WIDE1*:!0951.60N/08354.38W>x", 0 },
+  { 0, "TI3XYZ-7>APLRG1,WIDE1-1,WIDE2-1:=x",
+       "TI3XYZ-7>APLRG1,TI0TEC5-7,WIDE1*,WIDE2-1:=x", 0 },
+  { 0, "TI0RC-10>APRS,WIDE2-2:>x",
+       "TI0RC-10>APRS,TI0TEC5-7*,WIDE2-1:>x", 0 },
+  { 0, "TI2DEF-5>APLRT1,TI0RPT*,WIDE2-1:!x",
+       "TI2DEF-5>APLRT1,TI0RPT,TI0TEC5-7,WIDE2*:!x", 0 },
+  { 0, "TI2ABC>APRS,WIDE1*,WIDE2-1:x",
+       "TI2ABC>APRS,WIDE1,TI0TEC5-7,WIDE2*:x", 0 },
+  { 0, "TI9VWX>APRS,WIDE2-1,WIDE1-1:x",
+       "TI9VWX>APRS,TI0TEC5-7,WIDE2*,WIDE1-1:x", 0 },
+  // Límite de saltos y alias inválidos
+  { 0, "TI5JKL-1>APRS,WIDE3-3:T#123", nullptr, 0 },
+  { 0, "TI2ABC>APRS,WIDE2-3:x", nullptr, 0 },
+  { 0, "TI2ABC>APRS,WIDE2*:x", nullptr, 0 },
+  { 0, "TI2ABC>APRS,RELAY,WIDE2-2:x", nullptr, 0 },
+  { 0, "TI2ABC>APRS,WIDE8-1:x", nullptr, 0 },
+  // Indicativo propio y bucles
+  { 0, "TI7PQR>APRS,TI0TEC5-7,WIDE2-1:x",
+       "TI7PQR>APRS,TI0TEC5-7*,WIDE2-1:x", 0 },
+  { 0, "TI7PQR>APRS,ti0tec5-7,WIDE2-1:x",
+       "TI7PQR>APRS,TI0TEC5-7*,WIDE2-1:x", 0 },
+  { 0, "TI8STU>APRS,TI0TEC5-7*,WIDE2-1:x", nullptr, 0 },
+  { 0, "TI0TEC5-7>APRS,WIDE1-1:x", nullptr, 0 },
+  // Tráfico que no va a RF y tramas mal formadas
+  { 0, "TI4GHI>APDR16,TCPIP*,qAC,T2CR:=x", nullptr, 0 },
+  { 0, "TI2ABC>APRS,WIDE2-1,NOGATE:x", nullptr, 0 },
+  { 0, "TI2ABC>APRS,RFONLY,WIDE1-1:x", nullptr, 0 },
+  { 0, "TI6MNO-2>APLRT1:!x", nullptr, 0 },
+  { 0, "TI2ABC>APRS,,WIDE1-1:x", nullptr, 0 },
+  { 0, "sin formato", nullptr, 0 },
+  // Solo fill-in con demora viscosa
+  { 1, "TI2ABC-9>APLRT1,WIDE1-1:!x",
+       "TI2ABC-9>APLRT1,TI0TEC5-7,WIDE1*:!x", 5000 },
+  { 1, "TI0RC-10>APRS,WIDE2-2:>x", nullptr, 0 },
+  { 1, "TI7PQR>APRS,TI0TEC5-7,WIDE2-1:x", nullptr, 0 },
+  // Sin fill-in: WIDE1-1 lo toma la regla WIDEn-N
+  { 2, "TI2ABC-9>APLRT1,WIDE1-1:!x",
+       "TI2ABC-9>APLRT1,TI0TEC5-7,WIDE1*:!x", 0 },
+  { 2, "TI5JKL-1>APRS,WIDE3-3:T#123",
+       "TI5JKL-1>APRS,TI0TEC5-7*,WIDE3-2:T#123", 0 },
+};
+static const size_t VECTOR_COUNT = sizeof(VECTORS) / sizeof(VECTORS[0]);
+static const size_t CONFIG_COUNT = sizeof(CONFIGS) / sizeof(CONFIGS[0]);
+
+static bool checkVectors(DigiEngine* engines) {
+  size_t failures = 0;
+  char out[AX25_MAX_FRAME];
+  for (size_t i = 0; i < VECTOR_COUNT; i++) {
+    const GoldenVector& v = VECTORS[i];
+    AX25Packet ax;
+    parseAX25(v.input, strlen(v.input), ax);
+    DigiDecision d = engines[v.config].process(ax, out, sizeof(out));
+
+    bool ok = v.expected == nullptr
+                  ? d.length == 0
+                  : d.length == strlen(v.expected) && memcmp(out, v.expected, d.length) == 0 &&
+                        d.delayMs == v.delayMs;
+    if (!ok) {
+      failures++;
+      printf("FALLA #%zu [cfg %u] %s\n  esperado: %s (%lu ms)\n  obtenido: %.*s (%lu ms)\n",
+             i, v.config, v.input, v.expected ? v.expected : "(sin digipeat)",
+             (unsigned long)v.delayMs, (int)d.length, d.length ? out : "(sin digipeat)",
+             (unsigned long)d.delayMs);
+    }
+  }
+  printf("Vectores dorados: %zu/%zu correctos\n", VECTOR_COUNT - failures, VECTOR_COUNT);
+  return failures == 0;
+}
+
+int main(int argc, char** argv) {
+  size_t iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 5000000;
+
+  DigiEngine engines[CONFIG_COUNT];
+  for (size_t i = 0; i < CONFIG_COUNT; i++) engines[i].compile(CONFIGS[i], MYCALL);
+  if (!checkVectors(engines)) return 1;
+
+  // Tramas pre-decodificadas: se mide solo el motor
+  AX25Packet packets[VECTOR_COUNT];
+  for (size_t i = 0; i < VECTOR_COUNT; i++) {
+    parseAX25(VECTORS[i].input, strlen(VECTORS[i].input), packets[i]);
+  }
+
+  static char out[AX25_MAX_FRAME];
+  size_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    sink += engines[0].process(packets[i % VECTOR_COUNT], out, sizeof(out)).length;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  DigiPath path;
+  for (size_t i = 0; i < iterations; i++) {
+    sink += tokenizeDigiPath(packets[i % VECTOR_COUNT], path) ? path.count : 0;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double engineSec = std::chrono::duration<double>(t1 - t0).count();
+  double tokenSec  = std::chrono::duration<double>(t2 - t1).count();
+  printf("motor      %12.0f tramas/s\n", iterations / engineSec);
+  printf("separación %12.0f tramas/s  (chk %zu)\n", iterations / tokenSec, sink);
+
+  const DigiStats& st = engines[0].stats();
+  printf("cfg 0: propio=%lu fill-in=%lu WIDEn-N=%lu sin_regla=%lu bloqueadas=%lu "
+         "bucle=%lu limite=%lu invalidas=%lu\n",
+         (unsigned long)st.matched[0], (unsigned long)st.matched[1], (unsigned long)st.matched[2],
+         (unsigned long)st.noRule, (unsigned long)st.blocked, (unsigned long)st.loop,
+         (unsigned long)st.hopCapped, (unsigned long)st.invalid);
+  return 0;
+}
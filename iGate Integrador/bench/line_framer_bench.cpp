@@ -0,0 +1,272 @@
+// ============================================================================
+//  Benchmark en host: recepción por líneas de APRS-IS
+//  Descripción: Compara la lectura anterior (read() de un byte por llamada y
+//               concatenación en un String) con LineFramer (lecturas en
+//               bloque y vistas sin copia). Reporta líneas/s, bytes de heap
+//               solicitados y líneas largas descartadas.
+//
+//  Captura: sin argumentos se genera un feed sintético con la mezcla de
+//  líneas de un full feed. Para medir contra tráfico real, grabar el feed
+//  completo y pasarlo como argumento:
+//    nc rotate.aprs2.net 10152 > fullfeed.txt    (Ctrl+C tras unos minutos)
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/LineFramer bench/line_framer_bench.cpp
+//        lib/LineFramer/LineFramer.cpp -o line_framer_bench
+//    ./line_framer_bench [fullfeed.txt]
+// ============================================================================
+#include <LineFramer.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// ============================================================================
+//  Contador global de memoria dinámica
+// ============================================================================
+static size_t allocCount = 0;
+static size_t allocBytes = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) {
+    allocCount++;
+    allocBytes += n;
+  }
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ============================================================================
+//  Socket simulado: entrega la captura en segmentos de un MSS como lo haría
+//  WiFiClient (read() de un byte y read(buf, n) en bloque, ambos virtuales)
+// ============================================================================
+class CaptureClient {
+ public:
+  CaptureClient(const std::vector<char>& data, size_t segment)
+      : data_(data), segment_(segment), pos_(0), limit_(0) {}
+  virtual ~CaptureClient() {}
+
+  virtual int available() {
+    if (pos_ == limit_) limit_ = std::min(data_.size(), pos_ + segment_);
+    return (int)(limit_ - pos_);
+  }
+  virtual int read() {
+    if (available() <= 0) return -1;
+    return (uint8_t)data_[pos_++];
+  }
+  virtual int read(uint8_t* buf, size_t n) {
+    int avail = available();
+    if (avail <= 0) return -1;
+    if (n > (size_t)avail) n = (size_t)avail;
+    memcpy(buf, &data_[pos_], n);
+    pos_ += n;
+    return (int)n;
+  }
+  bool done() const { return pos_ >= data_.size(); }
+
+ private:
+  const std::vector<char>& data_;
+  size_t segment_;
+  size_t pos_;
+  size_t limit_;
+};
+
+// ============================================================================
+//  String mínimo con el crecimiento de WString de Arduino: reserva exacta
+//  (realloc) cada vez que la longitud supera la capacidad.
+// ============================================================================
+class ArduinoLikeString {
+ public:
+  ArduinoLikeString() : buf_(nullptr), len_(0), cap_(0) {}
+  ~ArduinoLikeString() { delete[] buf_; }
+
+  void operator+=(char c) {
+    if (len_ + 1 > cap_) {
+      char* grown = new char[len_ + 2];
+      if (buf_) memcpy(grown, buf_, len_);
+      delete[] buf_;
+      buf_ = grown;
+      cap_ = len_ + 1;
+    }
+    buf_[len_++] = c;
+    buf_[len_] = '\0';
+  }
+  void trim() {
+    size_t b = 0;
+    while (b < len_ && isspace((unsigned char)buf_[b])) b++;
+    size_t e = len_;
+    while (e > b && isspace((unsigned char)buf_[e - 1])) e--;
+    memmove(buf_, buf_ + b, e - b);
+    len_ = e - b;
+    buf_[len_] = '\0';
+  }
+  void clear() { len_ = 0; if (buf_) buf_[0] = '\0'; }
+  size_t length() const { return len_; }
+  const char* c_str() const { return buf_; }
+
+ private:
+  char*  buf_;
+  size_t len_;
+  size_t cap_;
+};
+
+// Consumidor común: suma de verificación para que no se optimice la lectura
+static uint32_t consume(const char* line, size_t len) {
+  uint32_t h = (uint32_t)len;
+  if (len > 0) h = h * 31 + (uint8_t)line[0] + (uint8_t)line[len - 1];
+  return h;
+}
+
+// ============================================================================
+//  Implementación anterior: un read() por byte y String creciente
+// ============================================================================
+static uint32_t legacyRun(CaptureClient& client, size_t& lines) {
+  static ArduinoLikeString buffer;
+  uint32_t sum = 0;
+  while (!client.done()) {
+    while (client.available()) {
+      char c = (char)client.read();
+      buffer += c;
+      if (c == '\n') {
+        buffer.trim();
+        if (buffer.length() > 0) {
+          sum += consume(buffer.c_str(), buffer.length());
+          lines++;
+          buffer.clear();
+        }
+      }
+    }
+  }
+  return sum;
+}
+
+// ============================================================================
+//  LineFramer: lectura en bloque y vistas
+// ============================================================================
+static uint32_t framerRun(CaptureClient& client, LineFramer& framer, size_t& lines) {
+  uint32_t sum = 0;
+  LineSlice line;
+  while (!client.done()) {
+    while (framer.next(line)) {
+      if (line.length == 0) continue;
+      sum += consume(line.data, line.length);
+      lines++;
+    }
+    int avail = client.available();
+    if (avail <= 0) continue;
+    size_t room;
+    char* dst = framer.writePtr(room);
+    int n = client.read((uint8_t*)dst, std::min(room, (size_t)avail));
+    if (n > 0) framer.commit((size_t)n);
+  }
+  while (framer.next(line)) {
+    if (line.length == 0) continue;
+    sum += consume(line.data, line.length);
+    lines++;
+  }
+  return sum;
+}
+
+// ============================================================================
+//  Feed sintético: posiciones, mensajes, objetos, telemetría y líneas de
+//  servidor, con una línea excesiva cada 5000 para ejercitar el descarte.
+// ============================================================================
+static std::vector<char> syntheticFeed(size_t lines) {
+  static const char* TEMPLATES[] = {
+    "EA4ABC-9>APRS,TCPIP*,qAC,T2EUSKADI:!4024.50N/00340.20W>%u/045 Movil",
+    "W1XYZ>APOT30,WIDE2-1,qAR,K1ABC-10:@121314z4217.25N/07107.45W_180/005g010t072r000p000P000h55b10132",
+    "DL2DEF-10>APLRG1,TCPIP*,qAC,T2GERMANY:!L8(\\]P/`[a GLoRa iGate %u",
+    "VK2XYZ-7>APDR16,TCPIP*,qAC,T2SYDNEY::VK2ABC-9 :Hola mundo{%u",
+    "KJ4ERJ-12>APWW11,TCPIP*,qAC,T2USASW:;LEADER   *092345z4903.50N/07201.75W>088/036",
+    "TI2ABC-9>APLRT1,WIDE1-1,qAR,TI0TEC5-7:T#%03u,199,000,255,073,123,01101001",
+    "# aprsc 2.1.14-g5e22b37 26 Oct 2025 12:00:00 GMT T2TEXAS 205.209.228.93:10152",
+  };
+  const size_t count = sizeof(TEMPLATES) / sizeof(TEMPLATES[0]);
+  std::vector<char> feed;
+  char line[600];
+  for (size_t i = 0; i < lines; i++) {
+    int n;
+    if (i % 5000 == 4999) {
+      memset(line, 'X', 580);
+      n = 580;
+    } else {
+      n = snprintf(line, sizeof(line), TEMPLATES[i % count], (unsigned)(i % 1000));
+    }
+    feed.insert(feed.end(), line, line + n);
+    feed.push_back('\r');
+    feed.push_back('\n');
+  }
+  return feed;
+}
+
+static std::vector<char> loadCapture(const char* path) {
+  std::vector<char> data;
+  FILE* f = fopen(path, "rb");
+  if (!f) return data;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+  return data;
+}
+
+int main(int argc, char** argv) {
+  std::vector<char> feed = (argc > 1) ? loadCapture(argv[1]) : syntheticFeed(200000);
+  if (feed.empty()) {
+    fprintf(stderr, "No se pudo leer la captura %s\n", argc > 1 ? argv[1] : "");
+    return 1;
+  }
+  const int ROUNDS = 5;
+  const size_t MSS = 1460;
+  printf("Captura: %s, %zu bytes\n", argc > 1 ? argv[1] : "sintética", feed.size());
+
+  // Implementación anterior
+  size_t legacyLines = 0;
+  uint32_t legacySum = 0;
+  allocCount = allocBytes = 0;
+  countAllocs = true;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    CaptureClient client(feed, MSS);
+    legacySum += legacyRun(client, legacyLines);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  countAllocs = false;
+  size_t legacyAllocs = allocCount, legacyBytes = allocBytes;
+
+  // LineFramer
+  size_t framerLines = 0;
+  uint32_t framerSum = 0;
+  LineFramer framer;
+  allocCount = allocBytes = 0;
+  countAllocs = true;
+  auto t2 = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    CaptureClient client(feed, MSS);
+    framerSum += framerRun(client, framer, framerLines);
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  countAllocs = false;
+
+  double legacySec = std::chrono::duration<double>(t1 - t0).count();
+  double framerSec = std::chrono::duration<double>(t3 - t2).count();
+
+  printf("Anterior  : %10.0f líneas/s  %8.1f MB/s  %zu reservas (%zu bytes)\n",
+         legacyLines / legacySec, feed.size() * ROUNDS / legacySec / 1e6, legacyAllocs, legacyBytes);
+  printf("LineFramer: %10.0f líneas/s  %8.1f MB/s  %zu reservas (%zu bytes)\n",
+         framerLines / framerSec, feed.size() * ROUNDS / framerSec / 1e6, allocCount, allocBytes);
+  printf("Líneas: anterior=%zu framer=%zu largas descartadas=%lu (suma %08x/%08x)\n",
+         legacyLines / ROUNDS, framerLines / ROUNDS,
+         (unsigned long)framer.stats().oversized / ROUNDS, legacySum, framerSum);
+  return 0;
+}
@@ -0,0 +1,416 @@
+// ============================================================================
+//  Benchmark en host: salida por líneas hacia APRS-IS
+//  Descripción: Compara el envío anterior (un String y un print() por línea,
+//               cada uno su propio segmento) con LineWriter (líneas agrupadas
+//               en un buffer fijo y un send() no bloqueante por tamaño o por
+//               plazo) sobre una conexión TCP real por loopback. Reporta
+//               send() por línea, bytes por segmento, µs de CPU por línea y
+//               reservas de memoria; verifica el plazo y el tamaño de envío,
+//               las escrituras parciales y el tiempo bloqueado con el socket
+//               lleno, y las líneas perdidas al cerrar la sesión. Termina con
+//               1 si alguna verificación falla.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/LineWriter bench/line_writer_bench.cpp
+//        lib/LineWriter/LineWriter.cpp -o line_writer_bench
+//    ./line_writer_bench
+// ============================================================================
+#include <LineWriter.h>
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <new>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+// Límite de bytes por send() (0 = sin límite): emula el snd_buf de lwIP, que
+// acepta una parte de lo pedido cuando queda poco lugar (el loopback de Linux
+// casi nunca lo hace). Reemplaza al send() de la libc también para LineWriter.
+static size_t sendLimit = 0;
+
+extern "C" ssize_t send(int fd, const void* buf, size_t n, int flags) {
+  if (sendLimit > 0 && n > sendLimit) n = sendLimit;
+  return sendto(fd, buf, n, flags, nullptr, 0);
+}
+
+static double nowUs() {
+  using namespace std::chrono;
+  return duration_cast<duration<double, std::micro>>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+//  Conexión TCP por loopback: tx es el lado del equipo, rx el del servidor
+// ============================================================================
+struct Link {
+  int tx;
+  int rx;
+};
+
+static bool linkOpen(Link& link, int bufferBytes) {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener < 0) return false;
+  if (bufferBytes > 0) setsockopt(listener, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+      getsockname(listener, (sockaddr*)&addr, &len) != 0) {
+    close(listener);
+    return false;
+  }
+
+  link.tx = socket(AF_INET, SOCK_STREAM, 0);
+  if (bufferBytes > 0) setsockopt(link.tx, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+  bool ok = connect(link.tx, (sockaddr*)&addr, sizeof(addr)) == 0;
+  link.rx = ok ? accept(listener, nullptr, nullptr) : -1;
+  close(listener);
+  if (link.rx < 0) {
+    close(link.tx);
+    return false;
+  }
+  fcntl(link.rx, F_SETFL, fcntl(link.rx, F_GETFL, 0) | O_NONBLOCK);
+  return true;
+}
+
+static void linkClose(Link& link) {
+  close(link.tx);
+  close(link.rx);
+}
+
+// Lee lo disponible del lado del servidor (hasta max bytes, 0 = todo)
+static size_t drain(Link& link, std::string& received, size_t max = 0) {
+  char buf[4096];
+  size_t total = 0;
+  for (;;) {
+    size_t want = sizeof(buf);
+    if (max > 0 && max - total < want) want = max - total;
+    if (want == 0) break;
+    ssize_t n = recv(link.rx, buf, want, 0);
+    if (n <= 0) break;
+    received.append(buf, (size_t)n);
+    total += (size_t)n;
+  }
+  return total;
+}
+
+// ============================================================================
+//  Tráfico de prueba: tramas RF como las de la cola de reenvío
+// ============================================================================
+static int makeLine(char* out, size_t size, unsigned i) {
+  static const char* TEMPLATES[] = {
+    "TI2ABC-9>APLRT1,WIDE1-1,qAR,TI0TEC5-7:!0956.12N/08403.45W>%03u/045 Movil LoRa",
+    "TI3XYZ-7>APLRG1,qAR,TI0TEC5-7:T#%03u,199,000,255,073,123,01101001",
+    "TI2DEF-10>APRS,qAR,TI0TEC5-7:>Estado de la estación %u",
+    "TI5QRS>APLRT1,WIDE2-1,qAR,TI0TEC5-7:@121314z0955.25N/08407.45W_180/005g010t072r000p000h55b10132 #%u",
+  };
+  return snprintf(out, size, TEMPLATES[i % 4], i % 1000);
+}
+
+// Registro de líneas terminadas (sin memoria dinámica)
+struct Outcome {
+  uint32_t sent;
+  uint32_t lost;
+  uint32_t lostBytes;
+  char     lastLost[LINE_WRITER_MAX_LINE + 1];
+};
+
+static void onLine(const WrittenLine& line, void* context) {
+  Outcome& o = *(Outcome*)context;
+  if (line.sent) {
+    o.sent++;
+    return;
+  }
+  o.lost++;
+  o.lostBytes += line.length;
+  memcpy(o.lastLost, line.data, line.length);
+  o.lastLost[line.length] = '\0';
+}
+
+// ============================================================================
+//  Envío anterior: String por línea y una escritura por línea
+// ============================================================================
+static void legacyScenario(size_t lines, std::string& expected, double& cpuUs, size_t& allocs) {
+  Link link;
+  if (!linkOpen(link, 0)) {
+    check("conexión loopback", false);
+    return;
+  }
+  std::string received;
+  char line[256];
+  size_t before = allocCount;
+  double start = nowUs();
+  for (size_t i = 0; i < lines; i++) {
+    makeLine(line, sizeof(line), (unsigned)i);
+    std::string packet = std::string(line) + "\n";   // aprsClient.print(String + "\n")
+    send(link.tx, packet.data(), packet.size(), 0);
+  }
+  cpuUs = nowUs() - start;
+  allocs = allocCount - before;
+  countAllocs = false;
+  while (received.size() < expected.size() && drain(link, received) > 0) {}
+  countAllocs = true;
+  linkClose(link);
+  printf("  anterior: %zu send() para %zu líneas, %.1f bytes/segmento, %.2f µs/línea, "
+         "%zu reservas\n", lines, lines, (double)expected.size() / lines, cpuUs / lines, allocs);
+}
+
+// ============================================================================
+//  LineWriter: llegan 8 tramas cada 20 ms (período de la tarea de red)
+// ============================================================================
+static void coalescedScenario(size_t lines, const std::string& expected) {
+  Link link;
+  if (!linkOpen(link, 0)) {
+    check("conexión loopback", false);
+    return;
+  }
+  static LineWriter writer;
+  static Outcome outcome;
+  writer.setPolicy(1436, 25);
+  writer.setLineHandler(onLine, &outcome);
+  bool nodelay = writer.attach(link.tx, 0);
+
+  std::string received;
+  received.reserve(expected.size());
+  size_t before = allocCount;
+  double cpuUs = 0;
+  uint32_t now = 0;
+  for (size_t i = 0; i < lines; now += 20) {
+    double start = nowUs();
+    for (size_t k = 0; k < 8 && i < lines; k++, i++) {
+      size_t room;
+      char* dst = writer.lineBuffer(room);
+      writer.commitLine((size_t)makeLine(dst, room, (unsigned)i), now);
+    }
+    writer.tick(now);
+    cpuUs += nowUs() - start;
+    drain(link, received);
+  }
+  for (int k = 0; k < 5 && writer.pending() > 0; k++, now += 20) writer.tick(now);
+  size_t allocs = allocCount - before;
+  while (received.size() < expected.size() && drain(link, received) > 0) {}
+
+  const LineWriterStats& s = writer.stats();
+  printf("  LineWriter: %u send() para %zu líneas, %.1f bytes/segmento, %.2f µs/línea, "
+         "%zu reservas (por tamaño %u, por plazo %u)\n", (unsigned)s.writes, lines,
+         s.writes ? (double)s.bytes / s.writes : 0.0, cpuUs / lines, allocs,
+         (unsigned)s.bySize, (unsigned)s.byDeadline);
+  check("TCP_NODELAY activado en attach()", nodelay);
+  check("el servidor recibe exactamente las mismas líneas", received == expected);
+  check("todas las líneas informadas como enviadas", outcome.sent == lines && outcome.lost == 0);
+  check("al menos 5 líneas por send()", s.writes > 0 && s.writes * 5 <= lines);
+  check("sin reservas de memoria en LineWriter", allocs == 0);
+  writer.detach(now);
+  linkClose(link);
+}
+
+// ============================================================================
+//  Plazo y tamaño de envío
+// ============================================================================
+static void policyScenario() {
+  Link link;
+  if (!linkOpen(link, 0)) {
+    check("conexión loopback", false);
+    return;
+  }
+  static LineWriter writer;
+  writer.setPolicy(300, 25);
+  writer.attach(link.tx, 1000);
+
+  char line[128];
+  int n = makeLine(line, sizeof(line), 1);
+  writer.append(line, n, 1000);
+  bool early = writer.tick(1010) == WRITE_IDLE && writer.untilFlush(1010) == 15;
+  bool onTime = writer.tick(1025) == WRITE_DONE && writer.stats().byDeadline == 1;
+  check("una línea sola espera el plazo (25 ms)", early && onTime);
+
+  for (unsigned i = 0; writer.pending() < 300; i++) writer.append(line, n, 2000);
+  check("al juntar flushBytes sale sin esperar el plazo",
+        writer.untilFlush(2000) == 0 && writer.tick(2000) == WRITE_DONE &&
+        writer.stats().bySize == 1);
+
+  char longLine[LINE_WRITER_MAX_LINE + 2];
+  memset(longLine, 'X', sizeof(longLine));
+  check("línea más larga que el límite rechazada",
+        !writer.append(longLine, sizeof(longLine), 3000) && writer.stats().rejected == 1);
+  writer.detach(3000);
+  check("sin sesión no acepta líneas", !writer.append(line, n, 3000));
+  linkClose(link);
+}
+
+// ============================================================================
+//  Socket lleno: el servidor no lee y send() deja de aceptar datos; el
+//  buffer queda bloqueado sin frenar al llamador. Luego el servidor lee y
+//  el resto sale en escrituras parciales.
+// ============================================================================
+static void stallScenario() {
+  Link link;
+  if (!linkOpen(link, 4096)) {
+    check("conexión loopback", false);
+    return;
+  }
+  static LineWriter writer;
+  static Outcome outcome;
+  memset(&outcome, 0, sizeof(outcome));
+  writer.setPolicy(1436, 25);
+  writer.setLineHandler(onLine, &outcome);
+  writer.attach(link.tx, 0);
+
+  std::string expected;
+  std::string received;
+  char line[256];
+  uint32_t now = 0;
+  unsigned i = 0;
+  size_t accepted = 0;
+  double worstTickUs = 0;
+  for (int round = 0; round < 2000 && !writer.blocked(); round++, now += 20) {
+    for (int k = 0; k < 8; k++, i++) {
+      int n = makeLine(line, sizeof(line), i);
+      if (!writer.append(line, n, now)) break;
+      expected.append(line, n).push_back('\n');
+      accepted++;
+    }
+    double start = nowUs();
+    writer.tick(now);
+    double us = nowUs() - start;
+    if (us > worstTickUs) worstTickUs = us;
+  }
+  bool blocked = writer.blocked();
+
+  // Con el socket lleno el buffer se llena y rechaza sin bloquear
+  uint32_t rejectedBefore = writer.stats().rejected;
+  for (int k = 0; k < 200; k++, i++) {
+    int n = makeLine(line, sizeof(line), i);
+    if (!writer.append(line, n, now)) continue;
+    expected.append(line, n).push_back('\n');
+    accepted++;
+  }
+  double start = nowUs();
+  WriteResult stuck = writer.tick(now);
+  double stuckUs = nowUs() - start;
+  check("socket lleno: tick() devuelve WRITE_BLOCKED", blocked && stuck == WRITE_BLOCKED);
+  check("buffer lleno: append() rechaza sin bloquear", writer.stats().rejected > rejectedBefore);
+
+  // 500 ms después el servidor empieza a leer; send() acepta de a 700 bytes
+  now += 500;
+  sendLimit = 700;
+  for (int round = 0; round < 10000 && (writer.pending() > 0 || received.size() < expected.size());
+       round++, now += 5) {
+    drain(link, received, 2048);
+    writer.tick(now);
+  }
+
+  sendLimit = 0;
+
+  const LineWriterStats& s = writer.stats();
+  printf("  socket lleno: %zu líneas aceptadas, %u rechazadas, %u parciales, %u bloqueos, "
+         "bloqueo máx %u ms, pendiente máx %u bytes, tick bloqueado %.1f µs (peor %.1f µs)\n",
+         accepted, (unsigned)s.rejected, (unsigned)s.partial, (unsigned)s.stalls,
+         (unsigned)s.maxStallMs, (unsigned)s.maxPending, stuckUs, worstTickUs);
+  check("tiempo bloqueado medido (>= 500 ms)", s.stalls >= 1 && s.maxStallMs >= 500);
+  check("escrituras parciales completadas después", s.partial >= 1);
+  check("el servidor recibe todo lo aceptado, en orden", received == expected);
+  check("aceptadas = enviadas", outcome.sent == accepted && outcome.lost == 0);
+  writer.detach(now);
+  linkClose(link);
+}
+
+// ============================================================================
+//  Cierre de sesión con líneas pendientes: vuelven como perdidas, enteras
+//  (incluida la que salió a medias) para poder reencolarlas
+// ============================================================================
+static void detachScenario() {
+  Link link;
+  if (!linkOpen(link, 4096)) {
+    check("conexión loopback", false);
+    return;
+  }
+  static LineWriter writer;
+  static Outcome outcome;
+  memset(&outcome, 0, sizeof(outcome));
+  writer.setPolicy(1436, 25);
+  writer.setLineHandler(onLine, &outcome);
+  writer.attach(link.tx, 0);
+
+  char line[256];
+  unsigned i = 0;
+  uint32_t now = 0;
+  for (int round = 0; round < 2000 && !writer.blocked(); round++, now += 20) {
+    for (int k = 0; k < 8; k++, i++) {
+      int n = makeLine(line, sizeof(line), i);
+      if (!writer.append(line, n, now)) break;
+    }
+    writer.tick(now);
+  }
+  size_t queued = writer.queuedLines();
+  uint32_t sentBefore = outcome.sent;
+  uint32_t accepted = writer.stats().lines;
+  char last[256];
+  makeLine(last, sizeof(last), i - 1);   // Última aceptada
+
+  writer.detach(now);
+  check("líneas pendientes entregadas como perdidas",
+        queued > 0 && outcome.lost == queued && outcome.sent == sentBefore &&
+        outcome.sent + outcome.lost == accepted);
+  check("la línea perdida llega entera al manejador", strcmp(outcome.lastLost, last) == 0);
+  check("tras detach() no queda nada pendiente", writer.pending() == 0 && writer.queuedLines() == 0);
+  linkClose(link);
+}
+
+int main() {
+  const size_t LINES = 4000;
+  std::string expected;
+  char line[256];
+  for (size_t i = 0; i < LINES; i++) {
+    makeLine(line, sizeof(line), (unsigned)i);
+    expected.append(line).push_back('\n');
+  }
+
+  printf("Ráfaga de %zu tramas (8 cada 20 ms)\n", LINES);
+  countAllocs = true;
+  double legacyUs = 0;
+  size_t legacyAllocs = 0;
+  legacyScenario(LINES, expected, legacyUs, legacyAllocs);
+  coalescedScenario(LINES, expected);
+
+  printf("Política de envío\n");
+  policyScenario();
+
+  printf("Socket lleno\n");
+  stallScenario();
+
+  printf("Cierre con líneas pendientes\n");
+  detachScenario();
+  countAllocs = false;
+
+  return failures == 0 ? 0 : 1;
+}
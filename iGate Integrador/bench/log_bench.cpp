@@ -0,0 +1,129 @@
+// ============================================================================
+//  Benchmark en host: registro de eventos
+//  Descripción: Compara el costo en la tarea que registra de armar la línea
+//               con cadenas dinámicas (timestamp + concatenación, como el
+//               registro anterior) contra encolar un evento binario en
+//               EventLog. También mide el formato diferido del consumidor y
+//               verifica con varios hilos productores que cada evento llegue
+//               una sola vez y en orden por productor (termina con 1 si no).
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -pthread -Ilib/EventLog bench/log_bench.cpp
+//        lib/EventLog/EventLog.cpp -o log_bench && ./log_bench
+// ============================================================================
+#include <EventLog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+//  Contador global de memoria dinámica
+// ============================================================================
+static size_t allocCount = 0;
+
+void* operator new(size_t n) {
+  allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static const LogEventDef EVENTS[] = {
+  { LOG_INFO,  "📡 LoRa_RX [%u] (%d dBm, %.1f dB): " },
+  { LOG_DEBUG, "⚠️  Paquete duplicado ignorado" },
+  { LOG_INFO,  "seq %u hilo %u" },
+};
+
+static const char* FRAME =
+    "TI2ABC-9>APLRT1,WIDE1-1:!0951.60N/08354.38W>LoRa tracker 12.4V 23C sats=9 hdop=1.1";
+
+// Registro anterior: timestamp en String + concatenación
+static std::string legacyTimestamp(uint32_t ms) {
+  char ts[12];
+  snprintf(ts, sizeof(ts), "[%02lu:%02lu] ", (unsigned long)(ms / 60000 % 60),
+           (unsigned long)(ms / 1000 % 60));
+  return std::string(ts);
+}
+
+template <typename Fn>
+static double timeNs(size_t iterations, Fn fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+  size_t iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+  size_t frameLength = strlen(FRAME);
+
+  // Lado productor
+  size_t sink = 0;
+  size_t allocs0 = allocCount;
+  double legacyNs = timeNs(iterations, [&](size_t i) {
+    std::string line = legacyTimestamp((uint32_t)i) + "📡 LoRa_RX [" + std::to_string(i) +
+                       "] (" + std::to_string(-97) + " dBm, " + std::to_string(7.5f) + " dB): " +
+                       FRAME;
+    sink += line.length();
+  });
+  double legacyAllocs = (double)(allocCount - allocs0) / iterations;
+
+  static EventLog log(EVENTS, 3, LOG_INFO);
+  static LogRecord record;
+  allocs0 = allocCount;
+  double eventNs = timeNs(iterations, [&](size_t i) {
+    log.log(0, FRAME, frameLength, { (unsigned)i, -97, 7.5f }, (uint32_t)i);
+    log.pop(record);   // Mantiene la cola con espacio; el costo de pop se mide aparte
+  });
+  double eventAllocs = (double)(allocCount - allocs0) / iterations;
+
+  // Lado consumidor: formato diferido
+  static char line[LOG_PAYLOAD_MAX + 160];
+  log.log(0, FRAME, frameLength, { 123u, -97, 7.5f }, 0);
+  log.pop(record);
+  double formatNs = timeNs(iterations, [&](size_t) { sink += log.format(record, line, sizeof(line)); });
+
+  printf("anterior   %8.1f ns/evento  %5.2f allocs/evento\n", legacyNs, legacyAllocs);
+  printf("EventLog   %8.1f ns/evento  %5.2f allocs/evento (registro + pop)\n", eventNs, eventAllocs);
+  printf("formato    %8.1f ns/evento  -> %s\n", formatNs, line);
+
+  // Varios productores contra un consumidor: con la cola llena el productor
+  // reintenta, así que cada evento debe llegar exactamente una vez y en
+  // orden por hilo; los reintentos quedan en el contador de descartados
+  const unsigned THREADS = 4;
+  const unsigned PER_THREAD = 200000;
+  static EventLog shared(EVENTS, 3, LOG_DEBUG);
+  std::vector<uint32_t> lastSeq(THREADS, 0);
+  std::vector<std::thread> producers;
+  for (unsigned t = 0; t < THREADS; t++) {
+    producers.emplace_back([t]() {
+      for (unsigned s = 1; s <= PER_THREAD; s++) {
+        while (!shared.log(2, nullptr, 0, { s, t }, 0)) std::this_thread::yield();
+      }
+    });
+  }
+  size_t received = 0, disorder = 0;
+  while (received < (size_t)THREADS * PER_THREAD) {
+    if (!shared.pop(record)) continue;
+    unsigned t = record.args[1].u;
+    if (t >= THREADS || record.args[0].u != lastSeq[t] + 1) disorder++;
+    else lastSeq[t] = record.args[0].u;
+    received++;
+  }
+  for (auto& p : producers) p.join();
+  EventLogStats st = shared.stats();
+  bool ok = disorder == 0 && st.recorded == received && shared.pending() == 0;
+  printf("%u hilos: recibidos=%zu reintentos=%lu desorden=%zu max_cola=%lu -> %s\n",
+         THREADS, received, (unsigned long)st.dropped, disorder,
+         (unsigned long)shared.highWater(), ok ? "OK" : "FALLA");
+  (void)sink;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+// ============================================================================
+//  Benchmark en host: perfil de iteraciones y secciones por tarea
+//  Descripción: Verifica LoopProfiler con un reloj simulado (duración de
+//               cada sección, vuelta a cero de micros(), bloqueo atribuido a
+//               la sección más larga, tiempo fuera de sección), que otro
+//               hilo (el perro guardián) vea la sección en curso de una
+//               tarea detenida, y que los percentiles coincidan con la cubeta
+//               del valor exacto de las muestras ordenadas. Mide el costo por
+//               sección y por iteración con el reloj real, sin reservas de
+//               memoria. Termina con 1 si alguna verificación falla.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -pthread -Ilib/Metrics -Ilib/LoopProfiler
+//        bench/loop_profiler_bench.cpp lib/LoopProfiler/LoopProfiler.cpp
+//        lib/Metrics/Metrics.cpp -o loop_profiler_bench
+//    ./loop_profiler_bench
+// ============================================================================
+#include <LoopProfiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static std::atomic<size_t> allocCount(0);
+static std::atomic<bool>   countAllocs(false);
+
+void* operator new(size_t n) {
+  if (countAllocs.load(std::memory_order_relaxed)) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-56s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+static uint32_t nowMicros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char* const NAMES[] = { "wifi", "sesion", "trafico", "uplink",
+                                     "salida", "beacon", "estado", "telemetria" };
+
+// ============================================================================
+//  Semántica con reloj simulado
+// ============================================================================
+static void semantics() {
+  printf("Semántica (umbral 1000 us)\n");
+  static LoopProfiler p(NAMES, 3, 1000);
+  StallReport r;
+
+  p.begin(0);
+  bool idleAtBegin = p.inIteration() && p.current() == PROFILER_NO_SECTION;
+  p.enter(0, 0);
+  p.enter(1, 100);
+  bool tracksCurrent = p.current() == 1 && p.currentSinceUs() == 100;
+  p.enter(2, 400);
+  p.enter(7, 450);                      // Fuera de rango: se ignora
+  bool stalled = p.end(500, r);
+  check("inicio de iteración fuera de sección", idleAtBegin);
+  check("sección en curso e instante de entrada publicados", tracksCurrent);
+  check("iteración bajo el umbral: sin bloqueo", !stalled && p.stalls() == 0);
+  check("duración por sección (100/300/100 us)",
+        p.section(0).maxUs() == 100 && p.section(1).maxUs() == 300 && p.section(2).maxUs() == 100 &&
+        p.section(2).count() == 1);
+  check("iteración completa 500 us", p.iterations().count() == 1 && p.iterations().maxUs() == 500);
+  check("al cerrar: fuera de iteración", !p.inIteration() && p.current() == PROFILER_NO_SECTION);
+
+  p.begin(1000);
+  p.enter(0, 1000);
+  p.enter(1, 1100);
+  p.enter(2, 3100);
+  stalled = p.end(3150, r);
+  check("bloqueo atribuido a la sección más larga",
+        stalled && r.iterationUs == 2150 && r.section == 1 && r.sectionUs == 2000 &&
+        p.stalls() == 1 && p.stallsIn(1) == 1 && p.stallsIn(0) == 0);
+
+  p.begin(UINT32_MAX - 49);
+  p.enter(2, UINT32_MAX - 49);
+  stalled = p.end(50, r);
+  check("vuelta a cero de micros()", !stalled && p.section(2).maxUs() == 100);
+
+  p.begin(5000);
+  stalled = p.end(7000, r);
+  check("bloqueo fuera de toda sección", stalled && r.section == PROFILER_NO_SECTION &&
+                                         strcmp(p.sectionName(r.section), "-") == 0 &&
+                                         p.stalls() == 2);
+
+  p.reset();
+  check("reset vacía histogramas y bloqueos",
+        p.iterations().count() == 0 && p.section(1).count() == 0 && p.stalls() == 0 &&
+        p.stallsIn(1) == 0);
+}
+
+// ============================================================================
+//  El perro guardián ve dónde quedó detenida otra tarea
+// ============================================================================
+static void watchdogView() {
+  printf("Lectura desde otro hilo (tarea detenida 50 ms en una sección)\n");
+  static LoopProfiler p(NAMES, 8, 20000);
+  std::atomic<bool> inside(false);
+
+  std::thread task([&]() {
+    p.begin(nowMicros());
+    p.enter(0, nowMicros());
+    p.enter(3, nowMicros());
+    inside.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    StallReport r;
+    p.end(nowMicros(), r);
+  });
+  while (!inside.load(std::memory_order_acquire)) std::this_thread::yield();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  uint8_t seen = p.current();
+  uint32_t stuckUs = nowMicros() - p.currentSinceUs();
+  bool running = p.inIteration();
+  task.join();
+
+  printf("  en \"%s\" hace %u us\n", p.sectionName(seen), stuckUs);
+  check("sección en curso visible: \"uplink\" >= 25 ms", running && seen == 3 && stuckUs >= 25000);
+  check("al terminar: bloqueo contado en \"uplink\"", p.stalls() == 1 && p.stallsIn(3) == 1);
+}
+
+// ============================================================================
+//  Percentiles contra el valor exacto de las muestras ordenadas
+// ============================================================================
+static uint32_t expectedPercentile(std::vector<uint32_t>& sorted, uint8_t pct) {
+  uint32_t n = (uint32_t)sorted.size();
+  uint32_t rank = (uint32_t)(((uint64_t)n * pct + 99) / 100);
+  if (rank == 0) rank = 1;
+  uint32_t exact = sorted[rank - 1];
+  uint32_t max = sorted.back();
+  for (size_t i = 0; i < LATENCY_BUCKETS - 1; i++)
+    if (exact < LATENCY_BUCKET_LIMITS_US[i]) return std::min(max, LATENCY_BUCKET_LIMITS_US[i]);
+  return max;
+}
+
+static void percentiles() {
+  printf("Percentiles (20000 secciones, log-uniforme 5 us .. 2 s)\n");
+  static LoopProfiler p(NAMES, 1, UINT32_MAX);
+  std::vector<uint32_t> samples;
+  samples.reserve(20000);
+  srand(7);
+  uint32_t now = 0;
+  StallReport r;
+  for (int i = 0; i < 20000; i++) {
+    double exponent = 0.7 + 5.6 * rand() / (double)RAND_MAX;   // 10^0.7 .. 10^6.3
+    uint32_t us = (uint32_t)pow(10.0, exponent);
+    samples.push_back(us);
+    p.begin(now);
+    p.enter(0, now);
+    now += us;
+    p.end(now, r);
+  }
+  std::sort(samples.begin(), samples.end());
+  const LatencyHistogram& h = p.section(0);
+  static const uint8_t PCTS[] = { 50, 90, 95, 99 };
+  bool ok = h.maxUs() == samples.back();
+  for (uint8_t pct : PCTS) {
+    uint32_t got = h.percentileUs(pct);
+    uint32_t want = expectedPercentile(samples, pct);
+    uint32_t rank = (uint32_t)(((uint64_t)samples.size() * pct + 99) / 100);
+    printf("  p%-2u exacto=%8u us  reportado=%8u us\n", pct, samples[rank - 1], got);
+    ok = ok && got == want && got >= samples[rank - 1];
+  }
+  check("cota de la cubeta del valor exacto, nunca por debajo", ok);
+}
+
+// ============================================================================
+//  Costo con el reloj real
+// ============================================================================
+static void overhead() {
+  printf("Costo (iteraciones de 8 secciones, reloj real)\n");
+  static LoopProfiler p(NAMES, 8, UINT32_MAX);
+  const uint32_t ITERATIONS = 500000;
+  StallReport r;
+  volatile uint32_t sink = 0;
+
+  countAllocs = true;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    for (uint8_t s = 0; s < 8; s++) sink += nowMicros();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    p.begin(nowMicros());
+    for (uint8_t s = 0; s < 8; s++) p.enter(s, nowMicros());
+    p.end(nowMicros(), r);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  countAllocs = false;
+  (void)sink;
+
+  double clockNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / (ITERATIONS * 8.0);
+  double iterNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / ITERATIONS;
+  double sectionNs = (iterNs - 10 * clockNs) / 9;   // 8 secciones + cierre
+  printf("  lectura del reloj      %6.1f ns\n", clockNs);
+  printf("  por sección (sin reloj)%6.1f ns\n", sectionNs);
+  printf("  por iteración          %6.1f ns (con 10 lecturas del reloj)\n", iterNs);
+  printf("  %u bytes por tarea\n", (unsigned)sizeof(LoopProfiler));
+  check("todas las iteraciones y secciones registradas",
+        p.iterations().count() == ITERATIONS && p.section(7).count() == ITERATIONS);
+  check("sin reservas de memoria", allocCount == 0);
+}
+
+int main() {
+  semantics();
+  watchdogView();
+  percentiles();
+  overhead();
+  printf(failures ? "%d verificaciones fallaron\n" : "Todas las verificaciones OK\n", failures);
+  return failures ? 1 : 0;
+}
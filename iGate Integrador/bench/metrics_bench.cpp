@@ -0,0 +1,94 @@
+// ============================================================================
+//  Benchmark en host: instrumentos de métricas
+//  Descripción: Mide el costo de registrar una latencia en LatencyHistogram
+//               y de contar un paquete en RateCounter (lo que se agrega por
+//               etapa en las tareas de radio y red). Verifica además los
+//               percentiles contra distribuciones conocidas y la ventana
+//               deslizante de tasas (termina con 1 si algo falla).
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Ilib/Metrics bench/metrics_bench.cpp
+//        lib/Metrics/Metrics.cpp -o metrics_bench && ./metrics_bench
+// ============================================================================
+#include <Metrics.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+template <typename Fn>
+static double timeNs(size_t iterations, Fn fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+static int failures = 0;
+
+static void check(const char* name, uint32_t got, uint32_t expected) {
+  bool ok = got == expected;
+  if (!ok) failures++;
+  printf("  %-34s %10lu (esperado %10lu) %s\n", name, (unsigned long)got,
+         (unsigned long)expected, ok ? "OK" : "FALLA");
+}
+
+int main(int argc, char** argv) {
+  size_t iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000000;
+
+  // Costo por muestra: latencias repartidas en todas las cubetas
+  static LatencyHistogram h;
+  uint32_t x = 0x2545F491UL;
+  double recordNs = timeNs(iterations, [&](size_t) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    h.record(x % 2000000);
+  });
+  static RateCounter r;
+  double addNs = timeNs(iterations, [&](size_t i) { r.add(60, (uint32_t)(i / 1000)); });
+  double percentileNs = timeNs(iterations / 100, [&](size_t) { x += h.percentileUs(95); });
+
+  printf("LatencyHistogram::record  %6.1f ns/muestra\n", recordNs);
+  printf("RateCounter::add          %6.1f ns/paquete\n", addNs);
+  printf("percentileUs(95)          %6.1f ns\n", percentileNs);
+
+  printf("Percentiles:\n");
+  // 100 muestras de 1..100 ms: p50 cae en la cubeta <50 ms, p95/p99 en <100 ms
+  LatencyHistogram u;
+  for (uint32_t ms = 1; ms <= 100; ms++) u.record(ms * 1000 - 1);
+  check("uniforme 1-100 ms: n", u.count(), 100);
+  check("uniforme 1-100 ms: p50", u.percentileUs(50), 50000);
+  check("uniforme 1-100 ms: p95", u.percentileUs(95), 99999);
+  check("uniforme 1-100 ms: max", u.maxUs(), 99999);
+  check("uniforme 1-100 ms: media", u.meanUs(), 50499);
+
+  // 99 muestras rápidas y una lenta: p99 rápido, p100 = la lenta
+  LatencyHistogram tail;
+  for (int i = 0; i < 99; i++) tail.record(150);
+  tail.record(3500000);
+  check("cola: p50", tail.percentileUs(50), 200);
+  check("cola: p99", tail.percentileUs(99), 200);
+  check("cola: p100", tail.percentileUs(100), 3500000);
+
+  // Desborde: por encima de 60 s se informa el máximo observado
+  LatencyHistogram over;
+  over.record(90000000);
+  check("desborde: p50", over.percentileUs(50), 90000000);
+  check("desborde: cubeta final", over.bucket(LATENCY_BUCKETS - 1), 1);
+  over.reset();
+  check("reset: n", over.count(), 0);
+
+  printf("Tasas (ventana %d s):\n", RATE_WINDOW_S);
+  // 3 paquetes de 100 B por segundo durante 30 s
+  RateCounter rate;
+  for (uint32_t s = 0; s < 30; s++)
+    for (int k = 0; k < 3; k++) rate.add(100, s * 1000 + k * 300);
+  check("paquetes/s x100", (uint32_t)(rate.packetsPerSecond(30000) * 100 + 0.5f), 300);
+  check("bytes/s", (uint32_t)(rate.bytesPerSecond(30000) + 0.5f), 300);
+  check("segundo en curso excluido", (uint32_t)(rate.packetsPerSecond(29500) * 100 + 0.5f), 300);
+  check("ventana vacía tras 20 s", (uint32_t)(rate.packetsPerSecond(50000) * 100 + 0.5f), 0);
+  check("totales", rate.totalPackets(), 90);
+
+  (void)x;
+  printf("%s\n", failures == 0 ? "OK" : "FALLA");
+  return failures == 0 ? 0 : 1;
+}
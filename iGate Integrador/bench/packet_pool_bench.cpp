@@ -0,0 +1,272 @@
+// ============================================================================
+//  Benchmark en host: buffers de trama con cuenta de referencias
+//  Descripción: Verifica la semántica de PacketPool (agotamiento, reserva,
+//               referencias, liberación doble) y lo somete al mismo patrón
+//               que el firmware con tres hilos: "radio" reserva y llena un
+//               buffer, lo pasa por dos colas SpscRing a "red" y "log"
+//               (cada una con su referencia) y suelta la propia. Los
+//               consumidores verifican que los bytes no cambiaron mientras
+//               los leían. Compara además el costo por trama de las tres
+//               copias anteriores (cola de recepción, cola hacia APRS-IS y
+//               captura) con el paso por referencia. Termina con 1 si alguna
+//               verificación falla o si hubo reservas de memoria durante
+//               la prueba.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -pthread -Ilib/PacketPool -Ilib/SpscRing
+//        bench/packet_pool_bench.cpp lib/PacketPool/PacketPool.cpp -o packet_pool_bench
+//    ./packet_pool_bench
+// ============================================================================
+#include <PacketPool.h>
+#include <SpscRing.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la medición)
+// ============================================================================
+static std::atomic<size_t> allocCount(0);
+static std::atomic<bool>   countAllocs(false);
+
+void* operator new(size_t n) {
+  if (countAllocs.load(std::memory_order_relaxed)) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  if (!ok) failures++;
+  printf("  %-52s %s\n", name, ok ? "OK" : "FALLA");
+}
+
+static const size_t RESERVE = 8;
+
+// ============================================================================
+//  Semántica
+// ============================================================================
+static void semantics() {
+  printf("Semántica (%u buffers de %u bytes)\n", (unsigned)PACKET_POOL_SIZE, (unsigned)PACKET_POOL_BYTES);
+  static PacketPool pool;
+  PacketBuf* held[PACKET_POOL_SIZE];
+
+  // Con reserva: se detiene cuando quedarían RESERVE libres
+  size_t optional = 0;
+  while (optional < PACKET_POOL_SIZE && (held[optional] = pool.alloc(RESERVE)) != nullptr) optional++;
+  check("con reserva: deja RESERVE libres para la recepción",
+        optional == PACKET_POOL_SIZE - RESERVE && pool.available() == RESERVE &&
+        pool.stats().deferred == 1 && pool.stats().exhausted == 0);
+
+  size_t n = optional;
+  while (n < PACKET_POOL_SIZE && (held[n] = pool.alloc()) != nullptr) n++;
+  check("sin reserva: usa todos los buffers", n == PACKET_POOL_SIZE && pool.available() == 0);
+  check("agotado: nullptr y contado",
+        pool.alloc() == nullptr && pool.stats().exhausted == 1 && pool.highWater() == PACKET_POOL_SIZE);
+
+  bool distinct = true;
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = i + 1; j < n; j++) distinct = distinct && held[i] != held[j];
+  check("buffers distintos", distinct);
+
+  // Tres referencias: el buffer vuelve recién con la última
+  PacketBuf* shared = held[0];
+  pool.retain(shared);
+  pool.retain(shared);
+  pool.release(shared);
+  pool.release(shared);
+  bool stillHeld = pool.available() == 0 && pool.refs(shared) == 1;
+  pool.release(shared);
+  check("3 referencias: libre solo tras la tercera", stillHeld && pool.available() == 1);
+  check("el liberado se reutiliza", pool.alloc() == shared);
+
+  pool.release(shared);
+  pool.release(shared);
+  check("liberación doble: ignorada y contada",
+        pool.stats().badReleases == 1 && pool.available() == 1);
+  pool.release(nullptr);
+
+  for (size_t i = 1; i < n; i++) pool.release(held[i]);
+  check("todo liberado", pool.available() == PACKET_POOL_SIZE && pool.inUse() == 0);
+}
+
+// ============================================================================
+//  Tres hilos con el patrón del firmware
+// ============================================================================
+static PacketPool                    pool;
+static SpscRing<PacketBuf*, 16>      uplinkRing;    // radio → red
+static SpscRing<PacketBuf*, 16>      captureRing;   // radio → log
+static std::atomic<bool>             producing(true);
+static std::atomic<uint32_t>         corrupt(0);
+static std::atomic<uint32_t>         consumed[2];
+
+static void fill(PacketBuf* buf, uint32_t seq) {
+  buf->rxMillis = seq;
+  buf->length = (uint16_t)(40 + seq % 200);
+  for (uint16_t i = 0; i < buf->length; i++) buf->data[i] = (char)(seq * 31 + i);
+}
+
+static bool intact(const PacketBuf* buf) {
+  uint32_t seq = buf->rxMillis;
+  if (buf->length != 40 + seq % 200) return false;
+  for (uint16_t i = 0; i < buf->length; i++)
+    if (buf->data[i] != (char)(seq * 31 + i)) return false;
+  return true;
+}
+
+static void consumer(SpscRing<PacketBuf*, 16>* ring, int id) {
+  for (;;) {
+    PacketBuf* buf;
+    if (!ring->pop(buf)) {
+      if (!producing.load(std::memory_order_acquire) && ring->size() == 0) return;
+      std::this_thread::yield();
+      continue;
+    }
+    if (!intact(buf)) corrupt++;
+    consumed[id]++;
+    pool.release(buf);
+  }
+}
+
+static void stress() {
+  printf("Tres hilos: radio → red + log\n");
+  const uint32_t FRAMES = 500000;
+  countAllocs = false;
+  std::thread net(consumer, &uplinkRing, 0);
+  std::thread log(consumer, &captureRing, 1);
+
+  countAllocs = true;
+  uint32_t sent = 0;
+  uint32_t noBuffer = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t seq = 0; seq < FRAMES; seq++) {
+    PacketBuf* buf = pool.alloc();
+    if (buf == nullptr) {   // La radio perdería la trama
+      noBuffer++;
+      std::this_thread::yield();
+      continue;
+    }
+    fill(buf, seq);
+    // Con las colas llenas espera a los consumidores: cada trama llega a
+    // los dos y los buffers de los tres hilos se cruzan todo el tiempo
+    PacketBuf** up;
+    while ((up = uplinkRing.acquire()) == nullptr) std::this_thread::yield();
+    pool.retain(buf);
+    *up = buf;
+    uplinkRing.publish();
+    PacketBuf** cap;
+    while ((cap = captureRing.acquire()) == nullptr) std::this_thread::yield();
+    pool.retain(buf);
+    *cap = buf;
+    captureRing.publish();
+    pool.release(buf);   // Referencia de la radio
+    sent++;
+  }
+  producing.store(false, std::memory_order_release);
+  net.join();
+  log.join();
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  countAllocs = false;
+
+  PacketPoolStats st = pool.stats();
+  printf("  tramas=%u sin_buffer=%u consumidas red=%u log=%u max_en_uso=%u/%u %.1f ns/trama\n",
+         sent, noBuffer, consumed[0].load(), consumed[1].load(),
+         (unsigned)pool.highWater(), (unsigned)PACKET_POOL_SIZE, s * 1e9 / FRAMES);
+  check("bytes intactos en ambos consumidores", corrupt == 0);
+  check("todas las referencias liberadas", pool.available() == PACKET_POOL_SIZE);
+  check("cada trama enviada llegó a los dos consumidores",
+        consumed[0] == sent && consumed[1] == sent);
+  check("agotamientos contados", st.exhausted == noBuffer && st.badReleases == 0);
+  check("sin reservas de memoria", allocCount == 0);
+}
+
+// ============================================================================
+//  Costo por trama: tres copias contra el paso por referencia
+// ============================================================================
+struct CopySlot {
+  uint32_t rxMillis, rxMicros;
+  int16_t  rssi;
+  float    snr;
+  uint16_t length;
+  char     data[PACKET_POOL_BYTES];
+};
+
+static void copyCost() {
+  printf("Costo por trama (un hilo, trama de 120 bytes)\n");
+  static SpscRing<CopySlot, 16>   rxCopy, upCopy, capCopy;
+  static SpscRing<PacketBuf*, 16> rxRef, upRef, capRef;
+  static PacketPool               local;
+  char fifo[120];
+  memset(fifo, 'A', sizeof(fifo));
+  const uint32_t ROUNDS = 5000000;
+  volatile uint32_t sink = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ROUNDS; n++) {
+    CopySlot* rx = rxCopy.acquire();
+    memcpy(rx->data, fifo, sizeof(fifo));
+    rx->length = sizeof(fifo);
+    rxCopy.publish();
+    CopySlot* in = rxCopy.peek();
+    CopySlot* up = upCopy.acquire();
+    memcpy(up->data, in->data, in->length);
+    up->length = in->length;
+    upCopy.publish();
+    CopySlot* cap = capCopy.acquire();
+    memcpy(cap->data, in->data, in->length);
+    cap->length = in->length;
+    capCopy.publish();
+    rxCopy.release();
+    sink += upCopy.peek()->data[n % 120] + capCopy.peek()->data[n % 120];
+    upCopy.release();
+    capCopy.release();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ROUNDS; n++) {
+    PacketBuf* buf = local.alloc();
+    memcpy(buf->data, fifo, sizeof(fifo));
+    buf->length = sizeof(fifo);
+    rxRef.push(buf);
+    PacketBuf* in = nullptr;
+    rxRef.pop(in);
+    local.retain(in);
+    upRef.push(in);
+    local.retain(in);
+    capRef.push(in);
+    local.release(in);
+    PacketBuf* a = nullptr;
+    PacketBuf* b = nullptr;
+    upRef.pop(a);
+    capRef.pop(b);
+    sink += a->data[n % 120] + b->data[n % 120];
+    local.release(a);
+    local.release(b);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  (void)sink;
+
+  double copyNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / ROUNDS;
+  double refNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / ROUNDS;
+  printf("  tres copias            %6.1f ns  (%u bytes de colas)\n", copyNs,
+         (unsigned)(3 * 16 * sizeof(CopySlot)));
+  printf("  referencias            %6.1f ns  (%u bytes de colas + %u del conjunto)\n", refNs,
+         (unsigned)(3 * 16 * sizeof(PacketBuf*)), (unsigned)sizeof(PacketPool));
+  check("conjunto local vacío al terminar", local.available() == PACKET_POOL_SIZE);
+}
+
+int main() {
+  semantics();
+  stress();
+  copyCost();
+  printf(failures ? "%d verificaciones fallaron\n" : "Todas las verificaciones OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,534 @@
+// ============================================================================
+//  Benchmark en host: reproducción de trazas RF y APRS-IS
+//  Descripción: Alimenta una traza por los sustitutos de lib/HostFakes (la
+//               radio LoRa, el cliente APRS-IS y el reloj) y la procesa con
+//               la misma lógica que el equipo: IGatePipeline para las tramas
+//               RF y las líneas candidatas a RF, LineFramer para el socket y
+//               TxScheduler para lo que se transmite, con la configuración de
+//               include/config.h. Reporta tramas/s, reservas de memoria por
+//               trama y tiempo de CPU por etapa; termina con 1 si hubo
+//               reservas durante la reproducción.
+//
+//  Traza: una línea por evento, tiempo en ms desde el inicio:
+//    <ms> RF <rssi> <snr> <trama TNC2>
+//    <ms> IS <línea APRS-IS>
+//  Las líneas que empiezan con '#' se ignoran. Sin traza se genera una
+//  sintética de 10 minutos (40 estaciones, copias digipeadas, mensajes y
+//  comentarios del servidor).
+//
+//  Captura: también acepta uno o más segmentos binarios copiados de la
+//  LittleFS del equipo (/capN.bin, ver lib/CaptureLog). Se ordenan por
+//  número de secuencia, los instantes de cada arranque se desplazan como en
+//  "capture dump" y las tramas transmitidas no se reproducen. Un registro
+//  cortado termina la lectura de su segmento. --export imprime la traza de
+//  texto equivalente y termina sin reproducir.
+//
+//  Velocidad: 0 (por defecto) procesa sin esperas; 1 reproduce en tiempo
+//  real, 10 diez veces más rápido, etc. El reloj simulado sigue siempre los
+//  tiempos de la traza. --loops repite la traza desplazada en el tiempo.
+//
+//  Compilación (desde "iGate Integrador/"):
+//    g++ -O2 -std=gnu++11 -Iinclude -Ilib/HostFakes -Ilib/AX25 -Ilib/AprsDecoder
+//        -Ilib/AprsFilter -Ilib/DupeFilter -Ilib/HeardList -Ilib/DigiEngine
+//        -Ilib/IGatePipeline -Ilib/LineFramer -Ilib/TxScheduler -Ilib/CaptureLog
+//        -Ilib/PacketPool bench/replay_bench.cpp lib/HostFakes/HostFakes.cpp lib/AX25/AX25.cpp
+//        lib/AprsDecoder/AprsDecoder.cpp lib/AprsFilter/AprsFilter.cpp
+//        lib/DupeFilter/DupeFilter.cpp lib/HeardList/HeardList.cpp
+//        lib/DigiEngine/DigiEngine.cpp lib/IGatePipeline/IGatePipeline.cpp
+//        lib/LineFramer/LineFramer.cpp lib/TxScheduler/TxScheduler.cpp
+//        lib/CaptureLog/CaptureLog.cpp lib/PacketPool/PacketPool.cpp -o replay_bench
+//    ./replay_bench [traza.txt | cap0.bin cap1.bin ...] [--speed X] [--loops N] [--export]
+//  o con PlatformIO:  pio run -e native && .pio/build/native/program [...]
+// ============================================================================
+#include <Arduino.h>
+#include <LoRa.h>
+#include <WiFiClient.h>
+#include <AprsFilter.h>
+#include <CaptureLog.h>
+#include <IGatePipeline.h>
+#include <LineFramer.h>
+#include <PacketPool.h>
+#include <TxScheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+
+// ============================================================================
+//  Contador global de memoria dinámica (solo durante la reproducción)
+// ============================================================================
+static size_t allocCount = 0;
+static bool   countAllocs = false;
+
+void* operator new(size_t n) {
+  if (countAllocs) allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ============================================================================
+//  Traza
+// ============================================================================
+struct TraceEvent {
+  uint32_t    ms;
+  bool        rf;
+  int         rssi;
+  float       snr;
+  std::string text;
+};
+
+static bool loadTrace(const char* path, std::vector<TraceEvent>& events) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[1024];
+  while (fgets(line, sizeof(line), f)) {
+    size_t n = strcspn(line, "\r\n");
+    line[n] = '\0';
+    if (n == 0 || line[0] == '#') continue;
+
+    TraceEvent ev;
+    char kind[4];
+    int used = 0;
+    unsigned long ms;
+    if (sscanf(line, "%lu %3s %n", &ms, kind, &used) < 2) continue;
+    ev.ms = (uint32_t)ms;
+    ev.rf = strcmp(kind, "RF") == 0;
+    ev.rssi = 0;
+    ev.snr = 0;
+    const char* rest = line + used;
+    if (ev.rf) {
+      int more = 0;
+      if (sscanf(rest, "%d %f %n", &ev.rssi, &ev.snr, &more) < 2) continue;
+      rest += more;
+    } else if (strcmp(kind, "IS") != 0) {
+      continue;
+    }
+    ev.text = rest;
+    events.push_back(ev);
+  }
+  fclose(f);
+  std::stable_sort(events.begin(), events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) { return a.ms < b.ms; });
+  return true;
+}
+
+// ============================================================================
+//  Segmentos de captura binaria
+// ============================================================================
+struct CaptureFile {
+  std::string          path;
+  std::vector<uint8_t> data;
+  uint32_t             sequence;
+  uint32_t             startMs;
+};
+
+// false si no se puede leer; 'isCapture' indica si empieza con CAPTURE_MAGIC
+static bool readCapture(const char* path, CaptureFile& file, bool& isCapture) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) file.data.insert(file.data.end(), chunk, chunk + n);
+  fclose(f);
+  file.path = path;
+  CaptureReader reader(file.data.data(), file.data.size());
+  isCapture = reader.valid();
+  file.sequence = reader.header().sequence;
+  file.startMs = reader.header().startMs;
+  return true;
+}
+
+// Convierte los segmentos (ya ordenados) en eventos o, con 'exportText',
+// imprime la traza de texto. Misma regla de desplazamiento que captureDump.
+static void loadCaptures(const std::vector<CaptureFile>& files, bool exportText,
+                         std::vector<TraceEvent>& events) {
+  char line[CAPTURE_MAX_DATA + 48];
+  uint32_t offsetMs = 0;
+  uint32_t lastMs = 0;
+  for (const CaptureFile& file : files) {
+    CaptureReader reader(file.data.data(), file.data.size());
+    if (file.startMs + offsetMs < lastMs) offsetMs = lastMs + 1000 - file.startMs;
+    if (exportText) {
+      printf("# segmento %lu, inicio %lu ms\n", (unsigned long)file.sequence,
+             (unsigned long)(file.startMs + offsetMs));
+    }
+
+    CaptureRecord record;
+    CaptureReadResult result;
+    uint32_t records = 0;
+    while ((result = reader.next(record)) == CAPTURE_READ_OK) {
+      records++;
+      lastMs = record.timeMs + offsetMs;
+      if (exportText) {
+        captureFormatTrace(record, offsetMs, line, sizeof(line));
+        printf("%s\n", line);
+        continue;
+      }
+      if (record.direction == CAP_RF_TX) continue;
+      bool rf = record.direction == CAP_RF_RX;
+      events.push_back(TraceEvent{ lastMs, rf, rf ? record.rssi : 0, rf ? record.snr : 0.0f,
+                                   std::string(record.data, record.length) });
+    }
+    if (result == CAPTURE_READ_TORN) {
+      fprintf(stderr, "%s: registro cortado en el byte %zu tras %u registros\n", file.path.c_str(),
+              reader.offset(), records);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) { return a.ms < b.ms; });
+}
+
+static uint32_t rng = 0x2545F491UL;
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+// Traza sintética: beacons de 40 estaciones con distintos paths, copias
+// digipeadas de parte de ellas, el beacon propio repetido por un digi,
+// comentarios del servidor, posiciones y mensajes desde APRS-IS
+static void syntheticTrace(std::vector<TraceEvent>& events) {
+  const uint32_t DURATION = 600000;
+  const char* paths[] = { "", ",WIDE1-1", ",WIDE1-1,WIDE2-1", ",WIDE2-2" };
+  char text[256];
+
+  for (unsigned s = 0; s < 40; s++) {
+    uint32_t period = 60000 + nextRandom() % 60000;
+    const char* path = paths[s % 4];
+    for (uint32_t t = nextRandom() % period; t < DURATION; t += period) {
+      snprintf(text, sizeof(text), "TI2A%02u-9>APLRT1%s:!09%02u.%02uN/083%02u.%02uW>LoRa %u.%uV",
+               s, path, 50 + s % 10, t / 1000 % 60, 50 + s % 9, t / 7000 % 60,
+               11 + t % 3, t % 10);
+      int rssi = -70 - (int)(nextRandom() % 50);
+      float snr = (int)(nextRandom() % 200) / 10.0f - 8.0f;
+      events.push_back(TraceEvent{ t, true, rssi, snr, text });
+
+      if (path[0] != '\0' && nextRandom() % 10 < 4) {   // Copia de otro digipeater
+        std::string copy = text;
+        copy.insert(copy.find(','), ",TI3DIG-1*");
+        events.push_back(TraceEvent{ t + 800 + nextRandom() % 2000, true, rssi - 10, snr - 3, copy });
+      }
+    }
+  }
+  for (uint32_t t = 5000; t < DURATION; t += 180000) {
+    snprintf(text, sizeof(text), "%s>APRS,TI3DIG-1*:=0951.60N/08354.38W&iGate", callsign);
+    events.push_back(TraceEvent{ t, true, -90, 4.0f, text });
+  }
+
+  for (uint32_t t = 0; t < DURATION; t += 20000) {
+    events.push_back(TraceEvent{ t + 300, false, 0, 0, "# aprsc 2.1.14-g5e9d2c2 16 Oct 2026 12:00:00 GMT T2TEST 1.2.3.4:14580" });
+  }
+  for (uint32_t t = 700, n = 0; t < DURATION; t += 900 + nextRandom() % 1500, n++) {
+    if (n % 8 == 0) {   // Mensaje: la mitad a estaciones escuchadas directamente
+      char dest[12];
+      snprintf(dest, sizeof(dest), "%s%02u-9", n % 16 == 0 ? "TI2A" : "TI7Q", nextRandom() % 40);
+      snprintf(text, sizeof(text), "TI5XYZ>APRS,TCPIP*,qAC,T2TEST::%-9s:hola %u{%u",
+               dest, n, n % 100);
+    } else {
+      snprintf(text, sizeof(text), "TI%uIS-%u>APRS,TCPIP*,qAC,T2TEST:=0%u56.12N/084%02u.40W-feed",
+               n % 9, n % 15, n % 10, n % 60);
+    }
+    events.push_back(TraceEvent{ t, false, 0, 0, text });
+  }
+
+  std::stable_sort(events.begin(), events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) { return a.ms < b.ms; });
+}
+
+// ============================================================================
+//  Etapas medidas: las del pipeline más las del banco (lectura de la FIFO,
+//  escritura hacia APRS-IS, framing del socket y planificación de TX)
+// ============================================================================
+enum BenchStage {
+  BENCH_FIFO = PIPE_STAGE_COUNT,
+  BENCH_UPLINK,
+  BENCH_FRAMING,
+  BENCH_SCHEDULE,
+  BENCH_STAGE_COUNT
+};
+
+static const char* const BENCH_STAGE_NAMES[BENCH_STAGE_COUNT - PIPE_STAGE_COUNT] = {
+  "fifo", "uplink", "framing", "tx"
+};
+
+struct StageClock {
+  std::chrono::steady_clock::time_point last;
+  double   ns[BENCH_STAGE_COUNT];
+  uint32_t calls[BENCH_STAGE_COUNT];
+};
+
+static StageClock stageClock;
+
+static void startStage() { stageClock.last = std::chrono::steady_clock::now(); }
+
+static void endStage(int stage) {
+  auto now = std::chrono::steady_clock::now();
+  stageClock.ns[stage] += std::chrono::duration<double, std::nano>(now - stageClock.last).count();
+  stageClock.calls[stage]++;
+  stageClock.last = now;
+}
+
+static void onPipelineStage(PipelineStage stage, void*) { endStage(stage); }
+
+// ============================================================================
+//  Reproducción
+// ============================================================================
+static const LoRaModemParams LORA_MODEM = {
+  LORA_SPREADING_FACTOR, (uint32_t)LORA_BANDWIDTH, LORA_CODING_RATE4,
+  LORA_PREAMBLE_LENGTH, false, false
+};
+static const uint32_t TX_MAX_WAIT[TX_CLASS_COUNT] = {
+  TX_DIGI_MAX_WAIT, TX_MESSAGE_MAX_WAIT, TX_BEACON_MAX_WAIT
+};
+
+static IGatePipeline pipeline(HEARD_MAX_AGE);
+static TxScheduler   txScheduler(LORA_MODEM, TX_DUTY_CYCLE_PERCENT * 600, TX_MAX_WAIT);
+static WiFiClient    aprsClient;
+static LineFramer    aprsFramer;
+static AprsFilter    rfFilter;
+
+struct Outcomes {
+  uint32_t rfFrames, isLines, duplicates, own, uplinked, digipeats, serverLines, filtered, gated;
+};
+static Outcomes out;
+
+// Igual que serviceLoRaRadio + handleLoRaFrame en la tarea de radio: la
+// FIFO se vacía en un buffer del conjunto y el resto lee esos mismos bytes
+static PacketPool packetPool;
+
+static void serviceRadio() {
+  startStage();
+  if (LoRa.parsePacket() <= 0) return;
+  PacketBuf* packet = packetPool.alloc();
+  if (packet == nullptr) return;
+  char* frame = packet->data;
+  size_t length = 0;
+  while (LoRa.available()) {
+    int b = LoRa.read();
+    if (length < AX25_MAX_FRAME) frame[length++] = (char)b;
+  }
+  int16_t rssi = (int16_t)LoRa.packetRssi();
+  float snr = LoRa.packetSnr();
+  endStage(BENCH_FIFO);
+
+  out.rfFrames++;
+  RfOutcome rf = pipeline.onRfFrame(frame, length, rssi, snr, millis());
+  if (rf.verdict == RF_DUPLICATE) {
+    out.duplicates++;
+    packetPool.release(packet);
+    return;
+  }
+  if (rf.verdict == RF_OWN) {
+    out.own++;
+    packetPool.release(packet);
+    return;
+  }
+
+  startStage();
+  if (rf.digi.length > 0 &&
+      txScheduler.enqueue(TX_CLASS_DIGI, pipeline.digiFrame(), rf.digi.length, millis(), millis())) {
+    out.digipeats++;
+  }
+  endStage(BENCH_SCHEDULE);
+
+  // Igual que forwardUplinkQueue: trama + '\n' en una sola escritura
+  frame[length] = '\n';   // PACKET_POOL_BYTES deja lugar
+  aprsClient.write((const uint8_t*)frame, length + 1);
+  packetPool.release(packet);
+  out.uplinked++;
+  endStage(BENCH_UPLINK);
+}
+
+// Igual que readAPRSLine + processAPRSTraffic en la tarea de red (con el
+// filtro local APRS_RF_FILTER), más el de scheduleQueuedFrames en la tarea
+// de radio
+static void serviceAprsIs() {
+  for (;;) {
+    startStage();
+    LineSlice line;
+    bool got = aprsFramer.next(line);
+    if (!got && aprsClient.available() > 0) {
+      size_t room;
+      char* dst = aprsFramer.writePtr(room);
+      int n = aprsClient.read((uint8_t*)dst, room);
+      if (n > 0) aprsFramer.commit((size_t)n);
+      got = aprsFramer.next(line);
+    }
+    endStage(BENCH_FRAMING);
+    if (!got) return;
+    if (line.length == 0) continue;
+    if (line.data[0] == '#') {
+      out.serverLines++;
+      continue;
+    }
+    out.isLines++;
+    if (!rfFilter.evaluate(line.data, line.length)) {
+      out.filtered++;
+      continue;
+    }
+    if (pipeline.gateToRf(line.data, line.length, HEARD_GATE_WINDOW, millis()) == GATE_PASS) {
+      startStage();
+      if (txScheduler.enqueue(TX_CLASS_MESSAGE, line.data, line.length, millis(), millis()))
+        out.gated++;
+      endStage(BENCH_SCHEDULE);
+    }
+  }
+}
+
+// Canal siempre libre: lo que el presupuesto permite sale de inmediato
+static void serviceTransmitter() {
+  startStage();
+  const TxFrame* f;
+  while ((f = txScheduler.next(millis())) != nullptr) {
+    LoRa.beginPacket();
+    LoRa.write((const uint8_t*)f->data, f->length);
+    LoRa.endPacket(true);
+    txScheduler.transmitting(millis());
+  }
+  endStage(BENCH_SCHEDULE);
+}
+
+int main(int argc, char** argv) {
+  std::vector<const char*> paths;
+  double speed = 0;
+  unsigned loops = 1;
+  bool exportText = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) speed = atof(argv[++i]);
+    else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) loops = (unsigned)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--export") == 0) exportText = true;
+    else paths.push_back(argv[i]);
+  }
+  const char* path = paths.empty() ? nullptr : paths[0];
+
+  std::vector<TraceEvent> events;
+  std::vector<CaptureFile> captures;
+  for (const char* p : paths) {
+    CaptureFile file;
+    bool isCapture = false;
+    if (!readCapture(p, file, isCapture)) {
+      fprintf(stderr, "No se pudo leer %s\n", p);
+      return 2;
+    }
+    if (isCapture) {
+      captures.push_back(std::move(file));
+    } else if (paths.size() > 1 || exportText) {
+      fprintf(stderr, "%s no es un segmento de captura\n", p);
+      return 2;
+    }
+  }
+  if (!captures.empty()) {
+    std::sort(captures.begin(), captures.end(),
+              [](const CaptureFile& a, const CaptureFile& b) { return a.sequence < b.sequence; });
+    loadCaptures(captures, exportText, events);
+    if (exportText) return 0;
+  } else if (path != nullptr) {
+    if (!loadTrace(path, events)) {
+      fprintf(stderr, "No se pudo leer %s\n", path);
+      return 2;
+    }
+  } else if (exportText) {
+    fprintf(stderr, "--export necesita segmentos de captura\n");
+    return 2;
+  } else {
+    syntheticTrace(events);
+  }
+  if (events.empty()) {
+    fprintf(stderr, "Traza vacía\n");
+    return 2;
+  }
+  uint32_t span = events.back().ms + DUP_TIMEOUT + 1000;   // Las repeticiones no son duplicadas
+
+  pipeline.begin(DigiConfig{ DIGI_OWN_CALL, DIGI_FILL_IN, DIGI_WIDE_MAX_HOPS, DIGI_VISCOUS_DELAY },
+                 callsign);
+  pipeline.setStageHook(onPipelineStage, nullptr);
+  if (rfFilter.compile(APRS_RF_FILTER) != FILTER_OK) {
+    fprintf(stderr, "APRS_RF_FILTER inválido (posición %zu)\n", rfFilter.errorPosition());
+    return 2;
+  }
+  aprsClient.connect(server, port);
+
+  countAllocs = true;
+  std::chrono::nanoseconds waited(0);
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned loop = 0; loop < loops; loop++) {
+    uint64_t base = (uint64_t)loop * span;
+    for (size_t i = 0; i < events.size(); i++) {
+      const TraceEvent& ev = events[i];
+      uint64_t atMs = base + ev.ms;
+      if (speed > 0 && atMs * 1000 > micros()) {
+        auto w0 = std::chrono::steady_clock::now();
+        uint64_t deltaUs = atMs * 1000 - (uint64_t)micros();
+        std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)(deltaUs / speed)));
+        waited += std::chrono::steady_clock::now() - w0;
+      }
+      fakeClockSetMicros(atMs * 1000);
+
+      if (ev.rf) {
+        LoRa.inject(ev.text.data(), ev.text.size(), ev.rssi, ev.snr);
+        serviceRadio();
+      } else {
+        aprsClient.feed(ev.text.data(), ev.text.size());
+        aprsClient.feed("\r\n", 2);
+        serviceAprsIs();
+      }
+      serviceTransmitter();
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  countAllocs = false;
+
+  double busyS = std::chrono::duration<double>(t1 - t0 - waited).count();
+  uint32_t frames = out.rfFrames + out.isLines + out.serverLines;
+  char speedText[16] = "máxima";
+  if (speed > 0) snprintf(speedText, sizeof(speedText), "x%g", speed);
+  char source[64];
+  if (!captures.empty()) snprintf(source, sizeof(source), "%zu segmentos de captura", captures.size());
+  else snprintf(source, sizeof(source), "%s", path ? path : "sintética");
+  printf("Traza: %s, %zu eventos x %u, velocidad %s\n", source, events.size(), loops, speedText);
+  printf("Procesado: %u tramas RF, %u líneas APRS-IS (+%u del servidor) en %.3f s de CPU\n",
+         out.rfFrames, out.isLines, out.serverLines, busyS);
+  printf("Rendimiento: %.0f tramas/s, %.2f reservas/trama (%zu)\n", frames / busyS,
+         frames ? (double)allocCount / frames : 0.0, allocCount);
+  printf("RF: duplicadas=%u propias=%u a APRS-IS=%u digipeats=%u | IS->RF filtradas=%u pasan=%u "
+         "sin_escuchar=%u no_mensaje=%u encoladas=%u\n",
+         out.duplicates, out.own, out.uplinked, out.digipeats, out.filtered,
+         pipeline.gateStats().passed,
+         pipeline.gateStats().notHeard, pipeline.gateStats().notMessage, out.gated);
+  const TxSchedulerStats& tx = txScheduler.stats();
+  printf("TX: %u tramas (%u bytes) aire=%lu ms, esperas de presupuesto=%lu, descartes digi "
+         "vieja=%lu msg vieja=%lu | APRS-IS: %u escrituras, %u bytes\n",
+         LoRa.transmitted(), LoRa.transmittedBytes(), (unsigned long)tx.airtimeTotalMs,
+         (unsigned long)tx.budgetWaits, (unsigned long)tx.classes[TX_CLASS_DIGI].droppedStale,
+         (unsigned long)tx.classes[TX_CLASS_MESSAGE].droppedStale, aprsClient.writes(),
+         aprsClient.writtenBytes());
+
+  printf("Etapa       llamadas   ns/llamada   total ms\n");
+  double totalNs = 0;
+  for (int s = 0; s < BENCH_STAGE_COUNT; s++) totalNs += stageClock.ns[s];
+  for (int s = 0; s < BENCH_STAGE_COUNT; s++) {
+    const char* name = s < PIPE_STAGE_COUNT ? PIPE_STAGE_NAMES[s]
+                                            : BENCH_STAGE_NAMES[s - PIPE_STAGE_COUNT];
+    uint32_t calls = stageClock.calls[s];
+    printf("  %-8s %10u %12.1f %10.2f (%4.1f%%)\n", name, calls,
+           calls ? stageClock.ns[s] / calls : 0.0, stageClock.ns[s] / 1e6,
+           totalNs > 0 ? stageClock.ns[s] * 100 / totalNs : 0.0);
+  }
+
+  bool ok = allocCount == 0;
+  printf("%s\n", ok ? "OK" : "FALLA: reservas de memoria durante la reproducción");
+  return ok ? 0 : 1;
+}
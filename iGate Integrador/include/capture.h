@@ -0,0 +1,28 @@
+// ============================================================================
+//  Captura de tráfico en LittleFS
+//  Registro binario de las tramas RF recibidas y transmitidas (y, con
+//  CAPTURE_IS_RX, de las líneas de APRS-IS) para analizar un incidente
+//  después. Las tareas de radio y red solo encolan un buffer de packetPool
+//  (la trama recibida se comparte, sin copiarla); la tarea de log arma los
+//  lotes y es la única que espera a la flash.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+#include <CaptureLog.h>
+#include <PacketPool.h>
+
+bool captureBegin();   // Monta LittleFS y busca la secuencia del último segmento
+
+// Solo desde la tarea de radio: la recepción toma una referencia a la trama,
+// la transmisión copia a un buffer del conjunto si queda por encima de la reserva
+void captureRx(PacketBuf* packet, uint8_t spreadingFactor);
+void captureTx(const char* data, size_t length, uint8_t spreadingFactor, uint32_t timeMs);
+// Solo desde la tarea de red
+void captureIs(const char* data, size_t length, uint32_t timeMs);
+
+// Solo desde la tarea de log
+void captureService(bool force);   // Arma el lote y lo escribe si corresponde
+void captureDump();                // Todos los segmentos como traza de texto por Serial
+
+void reportCaptureStats();
@@ -0,0 +1,267 @@
+// ============================================================================
+//  Configuración del iGate: hardware, credenciales y parámetros de operación
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+
+// ============================================================================
+//  Configuraciones generales del hardware
+// ============================================================================
+#define LED_PIN 25   // LED indicador en la placa
+
+// Parámetros del OLED
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define OLED_ADDR 0x3C
+#define OLED_I2C_CLOCK 400000UL       // Fast mode; el SSD1306 suele tolerar hasta ~1 MHz
+#define OLED_RSSI_INTERVAL    5000UL  // Lectura de WiFi.RSSI() para la pantalla
+#define OLED_BATTERY_INTERVAL 10000UL // Lectura del ADC de batería para la pantalla
+
+// Pin ADC para lectura de batería
+const int BATTERY_ADC_PIN = 35;
+
+// ============================================================================
+//  Credenciales y parámetros APRS-IS
+//  Indicativo, APRS-IS, WiFi, frecuencia/modulación LoRa y beacon son los
+//  valores por defecto: data/is-cfg.json los reemplaza al arranque (ver
+//  settings.h). El resto de este archivo queda fijado en compilación.
+// ============================================================================
+const char* const callsign = "Ti0tec5-7";       // Indicativo del iGate/digi
+const char* const passcode = "26556";           // Passcode APRS-IS
+const char* const server   = "rotate.aprs2.net";// Servidor APRS-IS
+const int         port     = 14580;             // Puerto APRS-IS
+// Servidores alternativos del pool ("host" o "host:puerto", mismo orden que
+// aprs_is.servers[] en is-cfg.json): con más de uno hay conexión de reserva
+// y failover inmediato
+const char* const APRS_SERVERS[] = { "noam.aprs2.net", "soam.aprs2.net" };
+const size_t APRS_SERVER_COUNT = sizeof(APRS_SERVERS) / sizeof(APRS_SERVERS[0]);
+#define APRS_FILTER "r/9.85/-83.90/200"         // Filtro del servidor (radio de 200 km)
+#define APRS_RF_FILTER ""                       // Filtro local APRS-IS → RF (vacío = todo;
+                                                // p. ej. "t/m -b/SPAM*", ver AprsFilter.h)
+
+// ============================================================================
+//  Redes WiFi (mismo orden que wifi.AP[] en data/is-cfg.json). Se prueban
+//  todas, ordenadas por el último RSSI observado.
+// ============================================================================
+struct WifiAPConfig {
+  const char* ssid;
+  const char* password;
+};
+
+const WifiAPConfig WIFI_APS[] = {
+  { "Ubnt1_Casa_4", "cartago4" },
+};
+const size_t WIFI_AP_COUNT = sizeof(WIFI_APS) / sizeof(WIFI_APS[0]);
+
+// ============================================================================
+//  Pines del módulo LoRa SX1276
+// ============================================================================
+#define LORA_SCK     5
+#define LORA_MISO    19
+#define LORA_MOSI    27
+#define LORA_CS      18
+#define LORA_RST     14
+#define LORA_IRQ     26
+#define LORA_BAND    433.775E6   // Frecuencia LoRa APRS de la región
+
+// Modulación (también define el tiempo en el aire de cada trama)
+#define LORA_SPREADING_FACTOR 7
+#define LORA_BANDWIDTH        125E3
+#define LORA_CODING_RATE4     5       // 4/5
+#define LORA_PREAMBLE_LENGTH  8       // Valor por defecto del SX1276
+
+// Combinaciones SF/BW que se exploran con CAD además de la principal (mismo
+// orden que lora.scan[] en is-cfg.json). Solo recepción: se transmite y se
+// digipetea únicamente en la principal. Cada una agregada reduce la
+// cobertura de las demás; el plan y la tasa de captura salen en el reporte.
+// Vacío por defecto (recepción continua en la principal). Un plan que haría
+// perder preámbulos a la principal se rechaza al arrancar: SF12/125 junto a
+// SF7/125 no cabe (su CAD dura más que la ventana de SF7), SF9/125 y
+// SF10/250 sí.
+struct LoraScanConfig {
+  uint8_t  spreadingFactor;
+  uint32_t bandwidthHz;
+};
+
+const LoraScanConfig LORA_SCAN[] = {
+};
+const size_t LORA_SCAN_COUNT = sizeof(LORA_SCAN) / sizeof(LORA_SCAN[0]);
+
+// ============================================================================
+//  Planificador de transmisión RF: presupuesto de tiempo en el aire (ciclo
+//  de trabajo en cualquier ventana de 60 s), escucha previa y espera máxima
+//  en cola por clase
+// ============================================================================
+const uint32_t      TX_DUTY_CYCLE_PERCENT = 10;      // Límite de la banda de 433 MHz
+const int           LBT_RSSI_THRESHOLD    = -105;    // dBm: por encima, canal ocupado
+const unsigned long TX_DIGI_MAX_WAIT      = 5000;    // Un digipeat tardío ya no sirve
+const unsigned long TX_MESSAGE_MAX_WAIT   = 30000;
+const unsigned long TX_BEACON_MAX_WAIT    = 60000;
+
+// ============================================================================
+//  Reglas del digipeater (se compilan una vez en radioBegin). La demora
+//  viscosa retiene fill-in / WIDEn-N y los cancela si otro digipeater
+//  repite la trama antes; el indicativo propio siempre sale sin demora.
+// ============================================================================
+const bool     DIGI_OWN_CALL      = true;   // Path con nuestro indicativo
+const bool     DIGI_FILL_IN       = true;   // WIDE1-1
+const uint8_t  DIGI_WIDE_MAX_HOPS = 2;      // WIDEn-N con n <= 2 (0 = desactivado)
+const uint32_t DIGI_VISCOUS_DELAY = 0;      // ms (0 = digipeat inmediato)
+
+// ============================================================================
+//  Estaciones escuchadas: un mensaje APRS-IS → RF solo se transmite si el
+//  destinatario se escuchó directamente (sin digipeaters) en la ventana
+// ============================================================================
+const unsigned long HEARD_GATE_WINDOW = 1800000;  // 30 minutos
+const unsigned long HEARD_MAX_AGE     = 3600000;  // Entradas más viejas se descartan
+
+// ============================================================================
+//  Parámetros del beacon APRS
+// ============================================================================
+const float BEACON_LAT = 9.8599407;
+const float BEACON_LON = -83.9063452;
+const char* const BEACON_COMMENT = "Escuela de Ingeniería Electrónica - ITCR";
+const unsigned long BEACON_INTERVAL = 180000; // 3 minutos
+const bool BEACON_RF = false;                   // Transmitir también el beacon por RF
+const char* const BEACON_RF_PATH = "WIDE1-1";
+
+// ============================================================================
+//  Energía (valores por defecto; bloques "power" y "display" de is-cfg.json).
+//  Con light sleep la CPU duerme cuando todas las tareas esperan y despierta
+//  con DIO0, con el tráfico del socket APRS-IS o con el próximo temporizador.
+//  Requiere modem sleep de WiFi y un framework compilado con CONFIG_PM_ENABLE
+//  y CONFIG_FREERTOS_USE_TICKLESS_IDLE; si no, se avisa y se sigue sin él.
+// ============================================================================
+const bool     POWER_LIGHT_SLEEP  = false;
+const uint8_t  WIFI_SLEEP_MODE    = 1;       // 0 = sin ahorro, 1 = mínimo (DTIM), 2 = máximo
+const uint16_t DISPLAY_TIMEOUT_S  = 0;       // 0 = OLED siempre encendido
+const unsigned long NET_IDLE_MAX_WAIT = 1000; // Espera máxima de la tarea de red en reposo
+const unsigned long RADIO_IDLE_MAX_WAIT = 1000;
+
+// Modelo de consumo para el estado de energía (mA, valores típicos de las
+// hojas de datos a 3.3 V; ajustar con una medición real de la placa)
+const float    POWER_CPU_ACTIVE_MA  = 40.0f;   // ESP32 a 240 MHz
+const float    POWER_CPU_IDLE_MA    = 27.0f;   // Sin light sleep, esperando
+const float    POWER_CPU_SLEEP_MA   = 0.8f;    // Light sleep
+const float    POWER_WIFI_MA[3]     = { 80.0f, 15.0f, 5.0f };  // Por WIFI_SLEEP_MODE, asociado
+const float    POWER_LORA_RX_MA     = 11.5f;   // SX1276 en recepción continua
+const float    POWER_LORA_TX_MA     = 90.0f;   // SX1276 a +17 dBm (PA_BOOST)
+const float    POWER_OLED_MA        = 8.0f;    // SSD1306 encendido
+const float    POWER_BOARD_MA       = 5.0f;    // Regulador, divisor de batería, LED
+const uint32_t POWER_WAKE_COST_US   = 500;     // Entrada y salida de light sleep
+const uint32_t BATTERY_CAPACITY_MAH = 2000;    // LP103454
+
+// ============================================================================
+//  Intervalos de reconexión, timeouts y telemetría
+// ============================================================================
+const unsigned long WIFI_RECONNECT_INTERVAL = 30000; // Tras fallar con todas las redes
+const unsigned long WIFI_FAST_TIMEOUT = 5000;        // Reconexión con BSSID/canal en caché
+const unsigned long WIFI_JOIN_TIMEOUT = 12000;       // Asociación + DHCP por red
+const unsigned long WIFI_SCAN_TIMEOUT = 8000;
+const unsigned long APRS_TIMEOUT = 120000;
+const unsigned long SERVER_PING_INTERVAL = 60000;
+const unsigned long TELEMETRY_INTERVAL = 60000;
+
+// Estado compacto de métricas (tasas, p95 RF → APRS-IS, memoria) como
+// paquete de estado APRS ">..." hacia APRS-IS; desactivado por defecto
+const bool METRICS_STATUS_TO_APRSIS = false;
+const unsigned long METRICS_STATUS_INTERVAL = 900000; // 15 minutos
+
+// Base de la memoria en régimen estable (WiFi, APRS-IS y tareas ya arriba):
+// la línea HEAP_FRAG muestra cuánto creció lo asignado desde ahí
+const unsigned long HEAP_STEADY_AFTER_MS = 120000;
+
+// ============================================================================
+//  Sesión APRS-IS: timeout de cada estado y espera entre reintentos
+//  (exponencial entre el mínimo y el máximo, con dispersión aleatoria)
+// ============================================================================
+const unsigned long APRSIS_DNS_TIMEOUT     = 5000;
+const unsigned long APRSIS_CONNECT_TIMEOUT = 5000;
+const unsigned long APRSIS_BANNER_TIMEOUT  = 5000;
+const unsigned long APRSIS_LOGIN_TIMEOUT   = 10000;
+const unsigned long APRSIS_BACKOFF_MIN     = 2000;
+const unsigned long APRSIS_BACKOFF_MAX     = 120000;
+
+// Pool de servidores: sondeo de RTT / login de uno por vez, keepalive de la
+// conexión de reserva y mejora de login que justifica cambiar de servidor
+// sin que la sesión falle
+const unsigned long APRSIS_PROBE_INTERVAL     = 120000;
+const unsigned long APRSIS_STANDBY_KEEPALIVE  = 60000;
+const unsigned long APRSIS_SWITCH_MARGIN      = 250;
+
+// Salida hacia APRS-IS: las líneas se agrupan en un buffer y salen en un
+// solo envío al juntar APRSIS_TX_FLUSH_BYTES (un MSS de lwIP) o cuando la
+// más vieja espera APRSIS_TX_COALESCE_MS
+const size_t        APRSIS_TX_FLUSH_BYTES  = 1436;
+const unsigned long APRSIS_TX_COALESCE_MS  = 25;
+
+// ============================================================================
+//  Cola RF → APRS-IS durante caídas de la sesión: edad máxima de una trama
+//  y ritmo de vaciado al reconectar (tramas/s y ráfaga)
+// ============================================================================
+const unsigned long UPLINK_MAX_AGE       = 600000; // 10 minutos
+const uint32_t      UPLINK_DRAIN_PER_SEC = 4;
+const uint32_t      UPLINK_DRAIN_BURST   = 8;
+
+// ============================================================================
+//  Captura de tráfico en LittleFS (lib/CaptureLog): registros binarios en
+//  CAPTURE_SEGMENTS segmentos rotativos de CAPTURE_SEGMENT_BYTES. Radio y red
+//  solo encolan la trama (un buffer de packetPool); la tarea de log la
+//  escribe por lotes de CAPTURE_BATCH_BYTES o cada CAPTURE_FLUSH_MS. Se
+//  exporta como traza de texto con el comando "capture dump" (ver
+//  bench/replay_bench.cpp).
+// ============================================================================
+const bool          CAPTURE_ENABLED         = true;
+const bool          CAPTURE_IS_RX           = false;  // Todo el feed APRS-IS (mucho más volumen)
+const uint32_t      CAPTURE_SEGMENT_BYTES   = 65536;
+const uint8_t       CAPTURE_SEGMENTS        = 4;
+const unsigned long CAPTURE_FLUSH_MS        = 30000;
+const uint32_t      CAPTURE_STALL_BUDGET_US = 2000;   // Escritura en flash por registro
+
+// ============================================================================
+//  Registro por Serial: nivel mínimo al arrancar (se cambia en ejecución con
+//  el comando "log <debug|info|warn|error>")
+// ============================================================================
+#define LOG_LEVEL LOG_INFO
+
+// ============================================================================
+//  Tareas FreeRTOS: radio en el núcleo de aplicación, red en el núcleo del
+//  stack WiFi y pantalla/estadísticas con la menor prioridad.
+// ============================================================================
+#define RADIO_TASK_CORE      1
+#define RADIO_TASK_PRIORITY  5
+#define RADIO_TASK_STACK     4096
+#define RADIO_TASK_PERIOD_MS 10     // Revisión de la cola TX sin IRQ
+
+#define NET_TASK_CORE        0
+#define NET_TASK_PRIORITY    3
+#define NET_TASK_STACK       6144
+#define NET_TASK_PERIOD_MS   20
+
+#define UI_TASK_CORE         1
+#define UI_TASK_PRIORITY     1
+#define UI_TASK_STACK        4096
+#define OLED_UPDATE_INTERVAL 1000
+
+#define LOG_TASK_CORE        0
+#define LOG_TASK_PRIORITY    1
+#define LOG_TASK_STACK       4096
+#define LOG_TASK_PERIOD_MS   50     // Vaciado de la cola de eventos
+#define LOG_TASK_PERIOD_SLEEP_MS 500 // Con light sleep: menos despertares
+#define TASK_REPORT_INTERVAL 60000  // Reporte de pila/CPU por Serial
+
+// Perfil de iteraciones: una iteración más larga que el umbral de su tarea
+// se registra como bloqueo con la sección que más tardó. Los de log y
+// pantalla incluyen la espera del UART al escribir los reportes.
+#define RADIO_STALL_US       20000
+#define NET_STALL_US         100000
+#define LOG_STALL_US         250000
+#define UI_STALL_US          1000000
+
+// Perro guardián de tareas del IDF: cada iteración lo alimenta; una tarea
+// colgada más de TASK_WDT_TIMEOUT_S deja su última sección en RTC y, con
+// TASK_WDT_PANIC, reinicia (el arranque siguiente la registra). Debe
+// superar las esperas máximas (NET/RADIO_IDLE_MAX_WAIT).
+#define TASK_WDT_TIMEOUT_S   10
+#define TASK_WDT_PANIC       true
@@ -0,0 +1,10 @@
+// ============================================================================
+//  Tarea de pantalla y estadísticas (menor prioridad)
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+
+bool displayBegin();
+void displayTask(void* param);
+uint32_t displayOnTimeMs();   // Tiempo acumulado con el OLED encendido
@@ -0,0 +1,160 @@
+// ============================================================================
+//  Registro de eventos por Serial
+//  Las tareas registran eventos binarios (identificador + argumentos + bytes
+//  de la trama) en una cola sin bloqueos; la tarea de log, con la menor
+//  prioridad, les da formato y los escribe por Serial. Así el tiempo de
+//  UART (~17 ms por línea de 200 bytes a 115200) no recae en radio ni red.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+#include <EventLog.h>
+
+// ============================================================================
+//  Eventos (el formato de cada uno está en LOG_EVENTS, src/log.cpp)
+// ============================================================================
+enum LogEventId : uint16_t {
+  // Arranque
+  EV_BOOT,
+  EV_TASK_CREATE_FAILED,
+  EV_LORA_INIT_FAILED,
+  EV_LORA_READY,
+  EV_SCAN_PLAN,
+  EV_SCAN_COVERAGE,
+  EV_SCAN_UNGUARANTEED,
+  EV_SCAN_REJECTED,
+  EV_SCAN_READY,
+
+  // Configuración (is-cfg.json / NVS)
+  EV_CONFIG_LOADED,
+  EV_CONFIG_NO_FILE,
+  EV_CONFIG_SYNTAX,
+  EV_CONFIG_ISSUE,
+  EV_CONFIG_MORE_ISSUES,
+
+  // Energía
+  EV_POWER_MODE,
+  EV_POWER_NO_LIGHT_SLEEP,
+  EV_POWER_WIFI_SLEEP_FORCED,
+  EV_DISPLAY_BLANK,
+  EV_DISPLAY_WAKE,
+
+  // Radio
+  EV_LORA_RX,
+  EV_LORA_RX_SCAN,
+  EV_LORA_DUPLICATE,
+  EV_DIGI,
+  EV_DIGI_DELAYED,
+  EV_DIGI_QUEUE_FULL,
+  EV_UPLINK_QUEUE_FULL,
+  EV_TX_DIGI,
+  EV_TX_MESSAGE,
+  EV_TX_BEACON,
+
+  // WiFi
+  EV_WIFI_CACHE_RTC,
+  EV_WIFI_CACHE_NVS,
+  EV_WIFI_CONNECTING,
+  EV_WIFI_CONNECTING_CHANNEL,
+  EV_WIFI_ALL_FAILED,
+  EV_WIFI_CONNECTED,
+  EV_WIFI_IP,
+  EV_WIFI_FAST_FAILED,
+  EV_WIFI_JOIN_FAILED,
+  EV_WIFI_DISCONNECTED,
+
+  // APRS-IS
+  EV_APRSIS_FAIL,
+  EV_APRSIS_RETRY,
+  EV_APRSIS_CONNECTING,
+  EV_APRSIS_CONNECTED,
+  EV_APRSIS_BANNER,
+  EV_APRSIS_NO_BANNER,
+  EV_APRSIS_AUTH_SEND,
+  EV_APRSIS_AUTH_RESP,
+  EV_APRSIS_UNVERIFIED,
+  EV_APRSIS_VERIFIED,
+  EV_APRSIS_STANDBY,
+  EV_APRSIS_PROBE,
+  EV_APRSIS_POOL_STEP,
+  EV_APRSIS_POOL_FAIL,
+  EV_APRSIS_FAILOVER,
+  EV_APRSIS_SWITCH,
+  EV_APRSIS_SYS,
+  EV_APRSIS_RX,
+  EV_RF_FILTER,
+  EV_RF_FILTER_INVALID,
+  EV_RF_FILTER_REJECT,
+  EV_RFTX_QUEUE_FULL,
+  EV_UPLINK_SENT,
+  EV_UPLINK_SENT_DEFERRED,
+  EV_APRSIS_TX_FULL,
+  EV_APRSIS_TX_LOST,
+  EV_BEACON_PREPARE,
+  EV_BEACON_TX,
+  EV_BEACON_BYTES,
+  EV_BEACON_SENT,
+  EV_TELEM_TX,
+  EV_TELEM_CFG,
+  EV_TELEM_CFG_DONE,
+  EV_SERVER_PING,
+  EV_METRICS_STATUS_TX,
+
+  // Cola RF → APRS-IS en LittleFS
+  EV_BACKLOG_SPILL,
+  EV_BACKLOG_SEGMENT_LOST,
+  EV_BACKLOG_SEGMENT_EMPTY,
+  EV_BACKLOG_NO_FS,
+
+  // Captura en LittleFS
+  EV_CAPTURE_READY,
+  EV_CAPTURE_NO_FS,
+  EV_CAPTURE_WRITE_FAILED,
+  EV_CAPTURE_STALL,
+  EV_CAPTURE_TORN,
+
+  // Perfil de tareas y perro guardián
+  EV_TASK_STALL,
+  EV_TASK_HANG,
+
+  // Log
+  EV_LOG_LEVEL,
+
+  EV_COUNT
+};
+
+// ============================================================================
+//  Función: getTimestamp()
+//  Descripción: Marca de tiempo "[mm:ss] " en un buffer por valor (sin
+//               memoria dinámica); se usa con .c_str() en los reportes.
+// ============================================================================
+struct LogTimestamp {
+  char text[12];
+  const char* c_str() const { return text; }
+};
+
+LogTimestamp getTimestamp();
+LogTimestamp formatTimestamp(uint32_t ms);
+
+// ============================================================================
+//  Registro de eventos (cualquier tarea)
+// ============================================================================
+extern EventLog eventLog;
+
+inline void logEvent(LogEventId id, std::initializer_list<LogArg> args = {}) {
+  eventLog.log(id, nullptr, 0, args, millis());
+}
+
+// Evento con los bytes de una trama o línea (se agregan al final del texto)
+inline void logPacket(LogEventId id, const char* data, size_t length,
+                      std::initializer_list<LogArg> args = {}) {
+  eventLog.log(id, data, length, args, millis());
+}
+
+// ============================================================================
+//  Tarea de log: formato y escritura por Serial y lotes de la captura en
+//  LittleFS; también atiende los comandos por Serial ("log <nivel>",
+//  "metrics", "capture dump", "profile", ver src/log.cpp)
+// ============================================================================
+void logTask(void* param);
+void reportLogStats();
@@ -0,0 +1,11 @@
+// ============================================================================
+//  Tarea de red: conexión WiFi, sesión APRS-IS, beacon y telemetría.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+
+void networkTask(void* param);
+void networkWake();
+void reportNetworkStats();
+const char* networkServer();   // Servidor APRS-IS de la sesión activa (nullptr sin sesión)
@@ -0,0 +1,25 @@
+// ============================================================================
+//  Administración de energía
+//  Light sleep automático (esp_pm + FreeRTOS tickless idle): la CPU duerme
+//  cuando todas las tareas están bloqueadas y despierta con DIO0 del SX1276
+//  (nivel alto; la ISR lo enmascara hasta que la tarea de radio limpia la
+//  IRQ), con el WiFi en modem sleep (los datos del socket llegan en cada
+//  DTIM) o con el vencimiento de la espera más próxima de alguna tarea. Para
+//  eso las tareas esperan hasta su próximo evento en lugar de revisar cada
+//  pocos milisegundos. El consumo promedio y el ciclo de trabajo se estiman
+//  con un modelo por componente (config.h) y salen en la telemetría.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+#include <esp_wifi_types.h>   // wifi_ps_type_t
+
+void powerBegin();                // Después de settingsBegin() y antes de radioBegin()
+bool powerLightSleep();           // true si el light sleep quedó activo
+wifi_ps_type_t powerWifiSleep();  // Modo de ahorro del WiFi a aplicar en wifiBegin()
+
+// Última estimación (la calcula reportPowerStats() en cada reporte)
+uint16_t powerAverageMa();
+uint16_t powerDutyPermille();     // Tiempo con la CPU despierta (‰)
+
+void reportPowerStats();
@@ -0,0 +1,46 @@
+// ============================================================================
+//  Tarea de radio: recepción LoRa por interrupción, supresión de duplicados,
+//  digipeating y transmisión de tramas APRS-IS → RF.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+#include <AX25.h>
+#include <PacketPool.h>
+#include <SpscRing.h>
+#include <TxScheduler.h>
+
+#ifndef UPLINK_QUEUE_SIZE
+#define UPLINK_QUEUE_SIZE 16  // Tramas RF → APRS-IS pendientes (potencia de 2)
+#endif
+#ifndef RF_TX_QUEUE_SIZE
+#define RF_TX_QUEUE_SIZE 8    // Tramas APRS-IS → RF pendientes (potencia de 2)
+#endif
+#ifndef PACKET_POOL_RESERVE
+#define PACKET_POOL_RESERVE 8 // Buffers que los consumidores opcionales dejan a la recepción
+#endif
+
+static_assert(PACKET_POOL_BYTES >= AX25_MAX_FRAME, "PACKET_POOL_BYTES menor que una trama");
+
+// Trama que la tarea de red entrega al planificador de transmisión RF
+struct RfTxFrame {
+  uint32_t queuedMs;                 // Instante de encolado (latencia de cola)
+  uint32_t originMicros;             // Llegada de la línea APRS-IS (métricas)
+  uint16_t length;
+  uint8_t  txClass;                  // TxClass: mensaje APRS-IS o beacon
+  char     data[AX25_MAX_FRAME];
+};
+
+// Buffers de las tramas recibidas: la FIFO del SX1276 se vacía en uno y la
+// cola hacia APRS-IS, la de almacenamiento y reenvío y la captura comparten
+// la referencia. Quien saca un buffer de una cola lo libera al terminar.
+extern PacketPool packetPool;
+
+extern SpscRing<PacketBuf*, UPLINK_QUEUE_SIZE> uplinkQueue; // radio → red (una referencia cada una)
+extern SpscRing<RfTxFrame, RF_TX_QUEUE_SIZE>   rfTxQueue;   // red → radio
+
+bool radioBegin();
+void radioTask(void* param);
+void radioWake();
+uint32_t radioTxAirtimeUs();   // Tiempo en el aire acumulado (estimación de consumo)
+void reportRadioStats();
@@ -0,0 +1,19 @@
+// ============================================================================
+//  Configuración de operación en tiempo de ejecución
+//  Se carga una vez al arranque, antes de crear las tareas, desde
+//  data/is-cfg.json en LittleFS (lector JSON por flujo, sin árbol ni memoria
+//  dinámica) y queda en una estructura fija. La última configuración válida
+//  se guarda como bloque binario en NVS junto con el hash del archivo: si el
+//  archivo no cambió, los arranques siguientes copian el bloque sin leer el
+//  JSON. Sin archivo se usan los valores por defecto de config.h; con errores,
+//  la última copia válida de NVS (o los valores por defecto).
+//  Después del arranque es de solo lectura para todas las tareas.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+#include <IGateConfig.h>
+
+extern IGateConfig settings;
+
+void settingsBegin();   // Carga y reporta el origen y el tiempo de carga
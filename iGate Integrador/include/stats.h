@@ -0,0 +1,176 @@
+// ============================================================================
+//  Métricas del sistema compartidas entre tareas
+//  Cada etapa de una trama se marca en µs contra su instante de origen (el
+//  flanco DIO0 para RF → APRS-IS, la lectura del socket para APRS-IS → RF)
+//  y la latencia se acumula en un histograma por etapa. El tráfico se cuenta
+//  por flujo con tasas deslizantes de paquetes/s y bytes/s. Todo es atómico:
+//  cada tarea escribe sus etapas y flujos, las demás solo leen.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+#include <Metrics.h>
+#include <atomic>
+
+// ============================================================================
+//  Etapas medidas (latencia desde el origen de la trama)
+// ============================================================================
+enum MetricStage {
+  STAGE_RX_PARSED,        // rx_irq → trama decodificada
+  STAGE_RX_DUP_CHECKED,   // rx_irq → revisada contra duplicados
+  STAGE_RX_HANDLED,       // rx_irq → atendida por la tarea de radio (incluye despertar)
+  STAGE_RX_DIGI_QUEUED,   // rx_irq → digipeat en el planificador
+  STAGE_RX_DIGI_TX_DONE,  // rx_irq → TxDone del digipeat
+  STAGE_RX_IS_WRITTEN,    // rx_irq → escrita en el socket APRS-IS
+  STAGE_IS_RF_QUEUED,     // línea APRS-IS → encolada hacia el radio
+  STAGE_IS_RF_TX_DONE,    // línea APRS-IS → TxDone
+  STAGE_COUNT
+};
+
+extern const char* const STAGE_NAMES[STAGE_COUNT];
+
+// Flujos de tráfico: RF → APRS-IS (lora_rx → is_tx) y APRS-IS → RF
+// (is_rx → lora_tx)
+enum TrafficFlow {
+  FLOW_LORA_RX,           // Tramas LoRa válidas (no duplicadas)
+  FLOW_LORA_TX,           // Tramas transmitidas (digipeat, mensajes, beacon)
+  FLOW_IS_RX,             // Líneas recibidas del servidor (sin comentarios '#')
+  FLOW_IS_TX,             // Líneas enviadas al servidor
+  FLOW_COUNT
+};
+
+extern const char* const FLOW_NAMES[FLOW_COUNT];
+
+struct SystemStats {
+  LatencyHistogram      stages[STAGE_COUNT];
+  RateCounter           flows[FLOW_COUNT];
+  std::atomic<uint32_t> uplinkDropped;             // Tramas RF → IS descartadas
+  std::atomic<uint32_t> rfTxDropped;               // Tramas IS → RF descartadas
+  std::atomic<bool>     wifiConnected;
+  std::atomic<bool>     aprsConnected;
+};
+
+extern SystemStats stats;
+
+inline void markStage(MetricStage stage, uint32_t originMicros) {
+  stats.stages[stage].record(micros() - originMicros);
+}
+
+// Devuelve el número de paquete del flujo (para los mensajes de log)
+inline uint32_t countTraffic(TrafficFlow flow, size_t bytes) {
+  stats.flows[flow].add(bytes, millis());
+  return stats.flows[flow].totalPackets();
+}
+
+// Copia de los contadores para mostrar sin tocar los atómicos repetidamente
+struct StatsSnapshot {
+  uint32_t loraRx;
+  uint32_t loraTx;
+  uint32_t isRx;
+  uint32_t isTx;
+  uint32_t uplinkDropped;
+  uint32_t rfTxDropped;
+  bool     wifiConnected;
+  bool     aprsConnected;
+};
+
+StatsSnapshot snapshotStats();
+
+// ============================================================================
+//  Memoria dinámica: libre mínima (la lleva el IDF), bloque contiguo más
+//  grande, fragmentación y crecimiento de lo asignado desde el régimen
+//  estable (HEAP_STEADY_AFTER_MS); sampleHeap() se llama periódicamente
+//  desde la tarea de pantalla
+// ============================================================================
+void sampleHeap();
+
+// ============================================================================
+//  Reportes: reportMetrics() imprime tasas, memoria e histogramas (comando
+//  "metrics" por Serial); formatMetricsStatus() arma el estado compacto que
+//  puede enviarse a APRS-IS
+// ============================================================================
+void   reportMetrics();
+void   resetMetrics();
+size_t formatMetricsStatus(char* out, size_t size);
+
+// ============================================================================
+//  Conversión lectura del ADC → Voltaje real de la batería
+// ============================================================================
+float getBatteryVoltage();
+
+// ============================================================================
+//  Monitor de tareas: marca de agua de pila, tiempo activo y perfil de cada
+//  iteración por secciones (LoopProfiler) con detección de bloqueos; cada
+//  iteración alimenta al perro guardián de tareas del IDF
+// ============================================================================
+enum TaskId { TASK_RADIO, TASK_NET, TASK_UI, TASK_LOG, TASK_COUNT };
+
+// Secciones con nombre de cada tarea (taskSection); los nombres están en
+// src/stats.cpp
+enum RadioSection {
+  SEC_RADIO_FIFO,         // IRQ y lectura de la FIFO
+  SEC_RADIO_FRAMES,       // Tramas recibidas (decodificación, digipeat, captura)
+  SEC_RADIO_VISCOUS,      // Digipeats viscosos vencidos
+  SEC_RADIO_SCHEDULE,     // Cola IS → RF al planificador
+  SEC_RADIO_SCAN,         // Exploración CAD
+  SEC_RADIO_TX,           // CAD / TX en curso / siguiente trama
+  SEC_RADIO_COUNT
+};
+
+enum NetSection {
+  SEC_NET_WIFI,           // wifiTick()
+  SEC_NET_SESSION,        // Sesión APRS-IS (conexión, login, conmutación)
+  SEC_NET_TRAFFIC,        // Líneas del servidor
+  SEC_NET_TELEMETRY,      // Definiciones y telemetría
+  SEC_NET_STATUS,         // Ping y estado de métricas
+  SEC_NET_BEACON,         // Beacon RF
+  SEC_NET_UPLINK,         // Cola RF → APRS-IS
+  SEC_NET_OUT,            // Escritura agrupada al socket
+  SEC_NET_COUNT
+};
+
+enum UiSection { SEC_UI_DISPLAY, SEC_UI_HEAP, SEC_UI_REPORTS, SEC_UI_COUNT };
+
+enum LogSection { SEC_LOG_COMMANDS, SEC_LOG_CAPTURE, SEC_LOG_FORMAT, SEC_LOG_COUNT };
+
+void taskRegister(TaskId id, const char* name, TaskHandle_t handle,
+                  uint8_t core, uint8_t priority);
+void taskAddBusy(TaskId id, uint32_t micros);
+void reportTaskStats();
+
+// Perro guardián: configura el del IDF y registra el bloqueo que causó el
+// reinicio anterior, si lo hubo (setup(), antes de crear las tareas)
+void taskWatchdogBegin();
+
+// Iteración perfilada: inicio (alimenta al perro guardián), entrada en una
+// sección (cierra la anterior) y cierre (registra EV_TASK_STALL si superó
+// el umbral de la tarea)
+void taskIterationBegin(TaskId id, uint32_t nowUs);
+void taskSection(TaskId id, uint8_t section);
+void taskIterationEnd(TaskId id, uint32_t nowUs);
+
+// Iteraciones y secciones por tarea: n, p50/p95/p99, máximo y bloqueos
+// (comando "profile" por Serial y reporte periódico)
+void reportTaskProfile();
+void resetTaskProfile();
+
+// Totales de todas las tareas (tiempo activo e iteraciones): estimación del
+// ciclo de trabajo de la CPU en el modo de ahorro de energía
+uint32_t taskBusyTotalUs();
+uint32_t taskIterationsTotal();
+
+// Mide el tiempo activo de una iteración de tarea (sin contar la espera) y
+// la perfila: las secciones se marcan con taskSection() dentro del alcance
+class TaskBusy {
+ public:
+  explicit TaskBusy(TaskId id) : id_(id), start_(micros()) { taskIterationBegin(id_, start_); }
+  ~TaskBusy() {
+    uint32_t now = micros();
+    taskAddBusy(id_, now - start_);
+    taskIterationEnd(id_, now);
+  }
+
+ private:
+  TaskId   id_;
+  uint32_t start_;
+};
@@ -0,0 +1,35 @@
+// ============================================================================
+//  Cola de almacenamiento y reenvío RF → APRS-IS
+//  Guarda las tramas recibidas mientras la sesión APRS-IS no está verificada:
+//  primero en RAM (la referencia al buffer de packetPool, sin copiarlo) y,
+//  cuando se llena o el conjunto baja a PACKET_POOL_RESERVE libres, en un
+//  segmento de LittleFS de solo anexado. Conserva el instante de recepción
+//  original, descarta las tramas más viejas que UPLINK_MAX_AGE y se vacía a
+//  ritmo controlado (UPLINK_DRAIN_PER_SEC). Solo la usa la tarea de red.
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+
+#include "radio.h"
+
+#ifndef UPLINK_BACKLOG_SIZE
+#define UPLINK_BACKLOG_SIZE 32          // Tramas en RAM (potencia de 2)
+#endif
+#ifndef UPLINK_SPILL_MAX_BYTES
+#define UPLINK_SPILL_MAX_BYTES 65536UL  // Tamaño máximo del segmento en LittleFS
+#endif
+
+bool uplinkBacklogBegin();                      // Monta LittleFS y borra el segmento anterior
+void uplinkBacklogPush(PacketBuf* packet);      // Toma la referencia del llamador
+// Trama devuelta por una sesión que se cerró (ya no está en un buffer)
+void uplinkBacklogRequeue(const char* data, size_t length, uint32_t rxMillis, uint32_t rxMicros);
+void uplinkBacklogExpire(unsigned long now);    // Aplica la política de edad
+
+// Siguiente trama a enviar si hay una y el ritmo de vaciado lo permite
+// (nullptr si no). La trama sigue en la cola hasta uplinkBacklogRelease().
+const PacketBuf* uplinkBacklogNext(unsigned long now);
+void uplinkBacklogRelease();
+
+uint32_t uplinkBacklogDepth();                  // Tramas en RAM + segmento
+void reportUplinkBacklogStats();
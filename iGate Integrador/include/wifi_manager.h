@@ -0,0 +1,13 @@
+// ============================================================================
+//  Conexión WiFi asíncrona por eventos, con varias redes y reconexión rápida
+//  desde caché (BSSID, canal y concesión DHCP).
+// ============================================================================
+#pragma once
+
+#include <Arduino.h>
+
+void wifiBegin();        // Registra eventos y carga la caché (RTC / NVS)
+void wifiTick();         // Avanza la máquina de estados; llamar desde la tarea de red
+bool wifiIsUp();         // true con IP asignada
+const char* wifiSsid();  // Red conectada, o nullptr (sin String: lo usa la pantalla)
+void reportWifiStats();
@@ -0,0 +1,48 @@
+// ============================================================================
+//  Librería: AX25
+//  Descripción: Implementación del parser sin memoria dinámica.
+// ============================================================================
+#include "AX25.h"
+
+#include <string.h>
+
+bool AX25Packet::equals(const AX25Field& f, const char* text) const {
+  size_t n = strlen(text);
+  return n == f.length && memcmp(raw + f.offset, text, n) == 0;
+}
+
+// ============================================================================
+//  Parser de tramas TNC2: SOURCE>DEST[,DIGI1,DIGI2...]:INFO
+// ============================================================================
+bool parseAX25(const char* frame, size_t length, AX25Packet& ax) {
+  if (length > 0xFFFF) length = 0xFFFF;
+
+  ax.raw = frame;
+  ax.rawLength = (uint16_t)length;
+  ax.valid = false;
+  ax.source = ax.destination = ax.path = AX25Field{0, 0};
+  ax.info = AX25Field{0, (uint16_t)length};
+
+  const char* gt    = (const char*)memchr(frame, '>', length);
+  const char* colon = (const char*)memchr(frame, ':', length);
+  if (gt == nullptr || colon == nullptr || colon <= gt) return false;
+
+  uint16_t sep1 = (uint16_t)(gt - frame);
+  uint16_t sep2 = (uint16_t)(colon - frame);
+
+  ax.source = AX25Field{0, sep1};
+
+  const char* comma = (const char*)memchr(gt + 1, ',', sep2 - sep1 - 1);
+  if (comma != nullptr) {
+    uint16_t c = (uint16_t)(comma - frame);
+    ax.destination = AX25Field{(uint16_t)(sep1 + 1), (uint16_t)(c - sep1 - 1)};
+    ax.path        = AX25Field{(uint16_t)(c + 1),    (uint16_t)(sep2 - c - 1)};
+  } else {
+    ax.destination = AX25Field{(uint16_t)(sep1 + 1), (uint16_t)(sep2 - sep1 - 1)};
+    ax.path        = AX25Field{sep2, 0};
+  }
+
+  ax.info  = AX25Field{(uint16_t)(sep2 + 1), (uint16_t)(length - sep2 - 1)};
+  ax.valid = true;
+  return true;
+}
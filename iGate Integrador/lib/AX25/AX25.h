@@ -0,0 +1,45 @@
+// ============================================================================
+//  Librería: AX25
+//  Descripción: Parser de tramas AX.25 en formato TNC2 (texto) sin memoria
+//               dinámica. Devuelve vistas (offset + longitud) sobre el buffer
+//               recibido; el digipeating vive en DigiEngine.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Tamaño máximo de una trama LoRa APRS (FIFO del SX1276 = 255 bytes)
+#define AX25_MAX_FRAME 255
+
+// ============================================================================
+//  Vista sobre un campo de la trama (no copia los datos)
+// ============================================================================
+struct AX25Field {
+  uint16_t offset;  // Posición del primer byte dentro de la trama
+  uint16_t length;  // Cantidad de bytes del campo
+};
+
+// ============================================================================
+//  Trama AX.25 decodificada: SOURCE>DEST,PATH:INFO
+// ============================================================================
+struct AX25Packet {
+  const char* raw;        // Buffer recibido (propiedad de quien llama)
+  uint16_t    rawLength;  // Longitud total de la trama
+  bool        valid;      // false si no se encontró '>' y ':'
+  AX25Field   source;     // Indicativo de origen (antes de '>')
+  AX25Field   destination;// Destino / tocall (entre '>' y la primera ',')
+  AX25Field   path;       // Lista de digipeaters, sin la coma inicial
+  AX25Field   info;       // Campo de información (después de ':')
+
+  const char* data(const AX25Field& f) const { return raw + f.offset; }
+  bool equals(const AX25Field& f, const char* text) const;
+};
+
+// ============================================================================
+//  Función: parseAX25()
+//  Descripción: Localiza los campos de una trama TNC2 sin copiarlos. Si la
+//               trama no tiene el formato esperado devuelve false y deja
+//               toda la trama en 'info', igual que el parser anterior.
+// ============================================================================
+bool parseAX25(const char* frame, size_t length, AX25Packet& ax);
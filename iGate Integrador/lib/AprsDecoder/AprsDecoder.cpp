@@ -0,0 +1,475 @@
+// ============================================================================
+//  Librería: AprsDecoder
+//  Descripción: Implementación del decodificador APRS (APRS 1.0.1 y las
+//               aclaraciones de 1.1 / 1.2 para telemetría y mensajes).
+// ============================================================================
+#include "AprsDecoder.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+
+const char* const APRS_TYPE_NAMES[APRS_TYPE_COUNT] = {
+  "desconocido", "posición", "mic-e", "mensaje", "estado", "objeto", "ítem",
+  "telemetría", "clima", "nmea", "tercero", "consulta", "capacidades", "usuario"
+};
+
+const char* const APRS_ERROR_NAMES[APRS_ERR_COUNT] = {
+  "ok", "vacío", "corto", "formato", "tipo desconocido"
+};
+
+// ============================================================================
+//  Utilidades
+// ============================================================================
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Dígito o espacio de ambigüedad (vale 0); -1 si no es ninguno
+static inline int ambiguousDigit(char c) {
+  if (isDigit(c)) return c - '0';
+  return c == ' ' ? 0 : -1;
+}
+
+// "DDHHMMz", "DDHHMM/" o "HHMMSSh"
+static bool isTimestamp(const char* s) {
+  for (int i = 0; i < 6; i++) {
+    if (!isDigit(s[i])) return false;
+  }
+  return s[6] == 'z' || s[6] == '/' || s[6] == 'h';
+}
+
+// Grados + centésimas de minuto → millonésimas de grado
+static inline int32_t toMicroDegrees(int degrees, int minuteHundredths) {
+  return (int32_t)degrees * 1000000 + (int32_t)minuteHundredths * 500 / 3;
+}
+
+// "DDMM.hhN": 8 caracteres
+static bool parseLatitude(const char* s, int32_t& out) {
+  int d[6];
+  static const uint8_t POS[6] = {0, 1, 2, 3, 5, 6};
+  if (s[4] != '.') return false;
+  for (int i = 0; i < 6; i++) {
+    if ((d[i] = ambiguousDigit(s[POS[i]])) < 0) return false;
+  }
+  int degrees = d[0] * 10 + d[1];
+  int minutes = (d[2] * 10 + d[3]) * 100 + d[4] * 10 + d[5];
+  if (degrees > 90 || minutes >= 6000) return false;
+  out = toMicroDegrees(degrees, minutes);
+  if (s[7] == 'S' || s[7] == 's') out = -out;
+  else if (s[7] != 'N' && s[7] != 'n') return false;
+  return true;
+}
+
+// "DDDMM.hhW": 9 caracteres
+static bool parseLongitude(const char* s, int32_t& out) {
+  int d[7];
+  static const uint8_t POS[7] = {0, 1, 2, 3, 4, 6, 7};
+  if (s[5] != '.') return false;
+  for (int i = 0; i < 7; i++) {
+    if ((d[i] = ambiguousDigit(s[POS[i]])) < 0) return false;
+  }
+  int degrees = d[0] * 100 + d[1] * 10 + d[2];
+  int minutes = (d[3] * 10 + d[4]) * 100 + d[5] * 10 + d[6];
+  if (degrees > 180 || minutes >= 6000) return false;
+  out = toMicroDegrees(degrees, minutes);
+  if (s[8] == 'W' || s[8] == 'w') out = -out;
+  else if (s[8] != 'E' && s[8] != 'e') return false;
+  return true;
+}
+
+// Cuatro dígitos base 91 ('!'..'{')
+static bool base91(const char* s, uint32_t& out) {
+  out = 0;
+  for (int i = 0; i < 4; i++) {
+    uint8_t c = (uint8_t)s[i];
+    if (c < 33 || c > 123) return false;
+    out = out * 91 + (c - 33);
+  }
+  return true;
+}
+
+static inline bool isSymbolTable(char c) {
+  return c == '/' || c == '\\' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'j');
+}
+
+// ============================================================================
+//  Posición: comprimida (13 caracteres) o sin comprimir (19) + comentario.
+//  'offset' es la posición de s dentro de la trama.
+// ============================================================================
+static AprsError decodePositionBody(const char* s, size_t n, size_t offset, AprsInfo& out) {
+  if (n > 0 && isSymbolTable(s[0]) && !isDigit(s[0])) {
+    // /YYYYXXXX$csT
+    if (n < 13) return APRS_ERR_SHORT;
+    uint32_t y, x;
+    if (!base91(s + 1, y) || !base91(s + 5, x)) return APRS_ERR_FORMAT;
+    out.latitude  = (int32_t)(90000000 - ((int64_t)y * 1000000 + 190463) / 380926);
+    out.longitude = (int32_t)(-180000000 + ((int64_t)x * 1000000 + 95231) / 190463);
+    out.symbolTable = s[0];
+    out.symbolCode = s[9];
+    char c = s[10];
+    uint8_t t = (uint8_t)(s[12] - 33);
+    // Sin curso/velocidad si c es ' ', '{' (rango) o el origen es GGA (altitud)
+    if (c >= '!' && c <= 'z' && ((t >> 3) & 3) != 2) {
+      out.course = (uint16_t)((c - 33) * 4);
+      out.speed = (uint16_t)(powf(1.08f, (float)(s[11] - 33)) - 1.0f + 0.5f);
+    }
+    out.compressed = true;
+    out.hasPosition = true;
+    out.comment = AX25Field{(uint16_t)(offset + 13), (uint16_t)(n - 13)};
+    return APRS_OK;
+  }
+
+  // DDMM.hhN/DDDMM.hhW$
+  if (n < 19) return APRS_ERR_SHORT;
+  if (!parseLatitude(s, out.latitude) || !parseLongitude(s + 9, out.longitude)) {
+    return APRS_ERR_FORMAT;
+  }
+  out.symbolTable = s[8];
+  out.symbolCode = s[18];
+  out.hasPosition = true;
+
+  // Extensión "ccc/sss" (curso / velocidad o viento de una estación de clima)
+  size_t skip = 19;
+  const char* e = s + 19;
+  if (n >= 26 && e[3] == '/' && isDigit(e[0]) && isDigit(e[1]) && isDigit(e[2]) &&
+      isDigit(e[4]) && isDigit(e[5]) && isDigit(e[6])) {
+    out.course = (uint16_t)((e[0] - '0') * 100 + (e[1] - '0') * 10 + (e[2] - '0'));
+    out.speed  = (uint16_t)((e[4] - '0') * 100 + (e[5] - '0') * 10 + (e[6] - '0'));
+    skip = 26;
+  }
+  out.comment = AX25Field{(uint16_t)(offset + skip), (uint16_t)(n - skip)};
+  return APRS_OK;
+}
+
+// ============================================================================
+//  Decodificadores por identificador de tipo. info y n cubren todo el campo
+//  de información (info[0] es el identificador); base es su posición en la
+//  trama.
+// ============================================================================
+typedef AprsError (*AprsDecodeFn)(const AX25Packet& ax, const char* info, size_t n, size_t base,
+                                  AprsInfo& out);
+
+// ! = / @
+static AprsError decodePosition(const AX25Packet&, const char* info, size_t n, size_t base,
+                                AprsInfo& out) {
+  out.messaging = info[0] == '=' || info[0] == '@';
+  size_t start = 1;
+  if (info[0] == '/' || info[0] == '@') {
+    if (n < 8) return APRS_ERR_SHORT;
+    if (!isTimestamp(info + 1)) return APRS_ERR_FORMAT;
+    out.timestamp = AX25Field{(uint16_t)(base + 1), 7};
+    start = 8;
+  }
+  return decodePositionBody(info + start, n - start, base + start, out);
+}
+
+// Dígito del destino Mic-E; bit = 1 para A-K y P-Z, custom para A-K
+static int miceDigit(char c, uint8_t& bit, bool& custom) {
+  bit = 0;
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c == 'L') return 0;
+  bit = 1;
+  if (c >= 'P' && c <= 'Y') return c - 'P';
+  if (c == 'Z') return 0;
+  custom = true;
+  if (c >= 'A' && c <= 'J') return c - 'A';
+  if (c == 'K') return 0;
+  return -1;
+}
+
+// ` '  — latitud, mensaje y hemisferios en el destino; longitud, curso y
+// velocidad en los bytes 1..6 (valor + 28)
+static AprsError decodeMicE(const AX25Packet& ax, const char* info, size_t n, size_t base,
+                            AprsInfo& out) {
+  if (n < 9 || ax.destination.length < 6) return APRS_ERR_SHORT;
+  const char* dest = ax.data(ax.destination);
+  int d[6];
+  uint8_t bits[6];
+  bool custom = false;
+  for (int i = 0; i < 6; i++) {
+    bool letter = false;
+    if ((d[i] = miceDigit(dest[i], bits[i], letter)) < 0) return APRS_ERR_FORMAT;
+    if (i < 3) custom |= letter;   // Solo los tres primeros llevan el mensaje
+  }
+  for (int i = 1; i <= 6; i++) {
+    if ((uint8_t)info[i] < 28 || (uint8_t)info[i] > 127) return APRS_ERR_FORMAT;
+  }
+
+  int latDeg = d[0] * 10 + d[1];
+  int latMin = (d[2] * 10 + d[3]) * 100 + d[4] * 10 + d[5];
+  int lonDeg = info[1] - 28;
+  if (bits[4]) lonDeg += 100;
+  if (lonDeg >= 180 && lonDeg <= 189) lonDeg -= 80;
+  else if (lonDeg >= 190 && lonDeg <= 199) lonDeg -= 190;
+  int lonMin = info[2] - 28;
+  if (lonMin >= 60) lonMin -= 60;
+  int lonHun = info[3] - 28;
+  if (latDeg > 90 || latMin >= 6000 || lonDeg > 180 || lonHun > 99) return APRS_ERR_FORMAT;
+
+  out.latitude = toMicroDegrees(latDeg, latMin);
+  if (!bits[3]) out.latitude = -out.latitude;
+  out.longitude = toMicroDegrees(lonDeg, lonMin * 100 + lonHun);
+  if (bits[5]) out.longitude = -out.longitude;
+
+  int sp = info[4] - 28, dc = info[5] - 28, se = info[6] - 28;
+  int speed = sp * 10 + dc / 10;
+  int course = (dc % 10) * 100 + se;
+  if (speed >= 800) speed -= 800;
+  if (course >= 400) course -= 400;
+  out.speed = (uint16_t)speed;
+  out.course = (uint16_t)course;
+
+  out.miceMessage = (uint8_t)(bits[0] << 2 | bits[1] << 1 | bits[2]);
+  out.miceCustom = custom;
+  out.symbolCode = info[7];
+  out.symbolTable = info[8];
+  out.messaging = true;
+  out.hasPosition = true;
+  out.comment = AX25Field{(uint16_t)(base + 9), (uint16_t)(n - 9)};
+  return APRS_OK;
+}
+
+// "ack" / "rej" seguido de 1 a 5 caracteres alfanuméricos y, en la forma
+// respuesta-ack ("ackMM}AA"), '}' y hasta 2 más; nada después. Devuelve la
+// longitud del número antes de '}', o 0 si es texto común ("acknowledged")
+static size_t ackIdLength(const char* text, size_t length) {
+  if (length < 4 || length > 11) return 0;
+  if (memcmp(text, "ack", 3) != 0 && memcmp(text, "rej", 3) != 0) return 0;
+  size_t id = 3;
+  while (id < length && isalnum((unsigned char)text[id])) id++;
+  if (id == 3 || id > 8) return 0;
+  if (id == length) return id - 3;
+  if (text[id] != '}' || length - id - 1 > 2) return 0;
+  for (size_t i = id + 1; i < length; i++) {
+    if (!isalnum((unsigned char)text[i])) return 0;
+  }
+  return id - 3;
+}
+
+// :DESTINO  :texto{id  /  :DESTINO  :ackid[}AA]  /  :DESTINO  :rejid[}AA]
+static AprsError decodeMessage(const AX25Packet&, const char* info, size_t n, size_t base,
+                               AprsInfo& out) {
+  if (n < 11) return APRS_ERR_SHORT;
+  if (info[10] != ':') return APRS_ERR_FORMAT;
+  size_t call = 9;                            // Destinatario relleno con espacios
+  while (call > 0 && info[call] == ' ') call--;
+  if (call == 0) return APRS_ERR_FORMAT;
+  out.addressee = AX25Field{(uint16_t)(base + 1), (uint16_t)call};
+
+  const char* text = info + 11;
+  size_t length = n - 11;
+  size_t ackId = ackIdLength(text, length);
+  if (ackId > 0) {
+    out.ack = text[0] == 'a';
+    out.rej = !out.ack;
+    out.messageId = AX25Field{(uint16_t)(base + 14), (uint16_t)ackId};
+    out.text = out.messageId;
+    return APRS_OK;
+  }
+
+  // Número de mensaje al final: "{12345" o "{MM}AA" (respuesta-ack)
+  size_t textLength = length;
+  for (size_t i = length; i > 0 && length - i < 9; i--) {
+    if (text[i - 1] == '{') {
+      size_t id = i, idEnd = length;
+      const char* brace = (const char*)memchr(text + id, '}', length - id);
+      if (brace != nullptr) idEnd = (size_t)(brace - text);
+      if (idEnd > id && idEnd - id <= 5) {
+        out.messageId = AX25Field{(uint16_t)(base + 11 + id), (uint16_t)(idEnd - id)};
+        textLength = i - 1;
+      }
+      break;
+    }
+  }
+  out.text = AX25Field{(uint16_t)(base + 11), (uint16_t)textLength};
+  return APRS_OK;
+}
+
+// >texto  o  >DDHHMMztexto
+static AprsError decodeStatus(const AX25Packet&, const char* info, size_t n, size_t base,
+                              AprsInfo& out) {
+  size_t start = 1;
+  if (n >= 8 && isTimestamp(info + 1) && info[7] == 'z') {
+    out.timestamp = AX25Field{(uint16_t)(base + 1), 7};
+    start = 8;
+  }
+  out.comment = AX25Field{(uint16_t)(base + start), (uint16_t)(n - start)};
+  return APRS_OK;
+}
+
+// ;NOMBRE___*DDHHMMzposición
+static AprsError decodeObject(const AX25Packet&, const char* info, size_t n, size_t base,
+                              AprsInfo& out) {
+  if (n < 18 + 13) return APRS_ERR_SHORT;
+  if (info[10] != '*' && info[10] != '_') return APRS_ERR_FORMAT;
+  if (!isTimestamp(info + 11)) return APRS_ERR_FORMAT;
+  size_t name = 9;
+  while (name > 0 && info[name] == ' ') name--;
+  if (name == 0) return APRS_ERR_FORMAT;
+  out.name = AX25Field{(uint16_t)(base + 1), (uint16_t)name};
+  out.alive = info[10] == '*';
+  out.timestamp = AX25Field{(uint16_t)(base + 11), 7};
+  return decodePositionBody(info + 18, n - 18, base + 18, out);
+}
+
+// )NOMBRE!posición  (nombre de 3 a 9 caracteres)
+static AprsError decodeItem(const AX25Packet&, const char* info, size_t n, size_t base,
+                            AprsInfo& out) {
+  size_t end = 4;
+  while (end < n && end <= 10 && info[end] != '!' && info[end] != '_') end++;
+  if (end >= n || end > 10) return APRS_ERR_FORMAT;
+  out.name = AX25Field{(uint16_t)(base + 1), (uint16_t)(end - 1)};
+  out.alive = info[end] == '!';
+  return decodePositionBody(info + end + 1, n - end - 1, base + end + 1, out);
+}
+
+// Número decimal con signo y fracción opcionales (valores analógicos 1.2)
+static bool parseDecimal(const char* s, size_t n, float& out) {
+  size_t i = 0;
+  bool negative = n > 0 && s[0] == '-';
+  if (negative) i++;
+  if (i >= n) return false;
+  float value = 0, scale = 0;
+  for (; i < n; i++) {
+    if (isDigit(s[i])) {
+      value = value * 10 + (s[i] - '0');
+      if (scale > 0) scale *= 10;
+    } else if (s[i] == '.' && scale == 0) {
+      scale = 1;
+    } else {
+      return false;
+    }
+  }
+  if (scale > 1) value /= scale;
+  out = negative ? -value : value;
+  return true;
+}
+
+// T#sss,a1,a2,a3,a4,a5,bbbbbbbb  (sss puede ser "MIC")
+static AprsError decodeTelemetry(const AX25Packet&, const char* info, size_t n, size_t,
+                                 AprsInfo& out) {
+  if (n < 3 || info[1] != '#') return APRS_ERR_FORMAT;
+  size_t i = 2;
+  if (n >= 5 && memcmp(info + 2, "MIC", 3) == 0) {
+    i = 5;
+  } else {
+    uint32_t seq = 0;
+    size_t start = i;
+    while (i < n && isDigit(info[i])) seq = seq * 10 + (info[i++] - '0');
+    if (i == start || seq > 0xFFFF) return APRS_ERR_FORMAT;
+    out.sequence = (uint16_t)seq;
+  }
+  if (i < n && info[i] == ',') i++;
+
+  while (i < n && out.analogCount < APRS_TELEMETRY_ANALOG) {
+    const char* comma = (const char*)memchr(info + i, ',', n - i);
+    size_t end = comma != nullptr ? (size_t)(comma - info) : n;
+    float value = 0;
+    if (end > i && !parseDecimal(info + i, end - i, value)) return APRS_ERR_FORMAT;
+    out.analog[out.analogCount++] = value;
+    i = end + 1;
+  }
+
+  if (i + 8 <= n) {
+    uint8_t bits = 0;
+    for (size_t b = 0; b < 8; b++) {
+      if (info[i + b] != '0' && info[i + b] != '1') return APRS_ERR_FORMAT;
+      bits = (uint8_t)(bits << 1 | (info[i + b] - '0'));
+    }
+    out.digital = bits;
+    out.hasDigital = true;
+  }
+  return out.analogCount > 0 ? APRS_OK : APRS_ERR_SHORT;
+}
+
+// }trama TNC2
+static AprsError decodeThirdParty(const AX25Packet&, const char*, size_t n, size_t base,
+                                  AprsInfo& out) {
+  out.thirdParty = AX25Field{(uint16_t)(base + 1), (uint16_t)(n - 1)};
+  return APRS_OK;
+}
+
+// Tipos que solo se clasifican: el cuerpo queda en comment
+static AprsError decodeBody(const AX25Packet&, const char*, size_t n, size_t base,
+                            AprsInfo& out) {
+  out.comment = AX25Field{(uint16_t)(base + 1), (uint16_t)(n - 1)};
+  return APRS_OK;
+}
+
+// ============================================================================
+//  Tabla de identificadores de tipo y despacho directo por carácter
+// ============================================================================
+struct AprsHandler {
+  char         dti;
+  AprsType     type;
+  AprsDecodeFn decode;
+};
+
+static const AprsHandler HANDLERS[] = {
+  { '!',  APRS_TYPE_POSITION,     decodePosition },
+  { '=',  APRS_TYPE_POSITION,     decodePosition },
+  { '/',  APRS_TYPE_POSITION,     decodePosition },
+  { '@',  APRS_TYPE_POSITION,     decodePosition },
+  { '`',  APRS_TYPE_MICE,         decodeMicE },
+  { '\'', APRS_TYPE_MICE,         decodeMicE },
+  { ':',  APRS_TYPE_MESSAGE,      decodeMessage },
+  { '>',  APRS_TYPE_STATUS,       decodeStatus },
+  { ';',  APRS_TYPE_OBJECT,       decodeObject },
+  { ')',  APRS_TYPE_ITEM,         decodeItem },
+  { 'T',  APRS_TYPE_TELEMETRY,    decodeTelemetry },
+  { '_',  APRS_TYPE_WEATHER,      decodeBody },
+  { '$',  APRS_TYPE_NMEA,         decodeBody },
+  { '}',  APRS_TYPE_THIRD_PARTY,  decodeThirdParty },
+  { '?',  APRS_TYPE_QUERY,        decodeBody },
+  { '<',  APRS_TYPE_CAPABILITIES, decodeBody },
+  { '{',  APRS_TYPE_USER_DEFINED, decodeBody },
+};
+static const size_t HANDLER_COUNT = sizeof(HANDLERS) / sizeof(HANDLERS[0]);
+
+// Índice directo carácter → HANDLERS + 1 (0 = sin decodificador), armado una
+// sola vez al iniciar el programa
+static struct AprsDispatch {
+  uint8_t slot[128];
+  AprsDispatch() {
+    memset(slot, 0, sizeof(slot));
+    for (size_t i = 0; i < HANDLER_COUNT; i++) slot[(uint8_t)HANDLERS[i].dti] = (uint8_t)(i + 1);
+  }
+} dispatch;
+
+// ============================================================================
+//  Función: decodeAprs()
+//  Descripción: Despacha por el primer carácter del campo de información. Si
+//               no es un identificador conocido, APRS admite una posición con
+//               '!' dentro de los primeros 40 caracteres (TNC sin formato).
+// ============================================================================
+bool decodeAprs(const AX25Packet& ax, AprsInfo& out) {
+  memset(&out, 0, sizeof(out));
+  out.course = APRS_NO_COURSE;
+  out.speed = APRS_NO_COURSE;
+
+  if (!ax.valid || ax.info.length == 0) {
+    out.error = APRS_ERR_EMPTY;
+    return false;
+  }
+  const char* info = ax.data(ax.info);
+  size_t n = ax.info.length;
+  size_t base = ax.info.offset;
+
+  uint8_t c = (uint8_t)info[0];
+  uint8_t slot = c < 128 ? dispatch.slot[c] : 0;
+  if (slot > 0) {
+    const AprsHandler& h = HANDLERS[slot - 1];
+    out.type = h.type;
+    out.error = h.decode(ax, info, n, base, out);
+  } else {
+    const char* bang = (const char*)memchr(info, '!', n < 40 ? n : 40);
+    if (bang != nullptr) {
+      size_t skip = (size_t)(bang - info);
+      out.type = APRS_TYPE_POSITION;
+      out.error = decodePositionBody(bang + 1, n - skip - 1, base + skip + 1, out);
+    } else {
+      out.error = APRS_ERR_UNKNOWN;
+    }
+  }
+  if (out.error != APRS_OK) out.hasPosition = false;
+  return out.error == APRS_OK;
+}
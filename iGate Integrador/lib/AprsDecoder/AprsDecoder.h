@@ -0,0 +1,104 @@
+// ============================================================================
+//  Librería: AprsDecoder
+//  Descripción: Decodificador del campo de información APRS sobre la vista
+//               info de AX25Packet, sin copias ni memoria dinámica. El
+//               primer carácter (identificador de tipo) elige el
+//               decodificador en una tabla; los textos quedan como vistas
+//               AX25Field sobre la trama original y las coordenadas en
+//               millonésimas de grado. Cubre:
+//                 - posición sin comprimir y comprimida (! = / @)
+//                 - Mic-E (` ') con la latitud en el destino
+//                 - mensajes, ack y rej (:)
+//                 - estado (>), objetos (;) e ítems ())
+//                 - telemetría T#
+//               Los demás tipos solo se clasifican (cuerpo en comment).
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AX25.h>
+
+enum AprsType : uint8_t {
+  APRS_TYPE_UNKNOWN,       // Identificador no reconocido
+  APRS_TYPE_POSITION,      // ! = / @ (y ! dentro de los primeros 40 caracteres)
+  APRS_TYPE_MICE,          // ` '
+  APRS_TYPE_MESSAGE,       // :DESTINO  :texto{id  (incluye ack / rej)
+  APRS_TYPE_STATUS,        // >
+  APRS_TYPE_OBJECT,        // ;
+  APRS_TYPE_ITEM,          // )
+  APRS_TYPE_TELEMETRY,     // T#
+  APRS_TYPE_WEATHER,       // _ (sin posición)
+  APRS_TYPE_NMEA,          // $
+  APRS_TYPE_THIRD_PARTY,   // } (trama TNC2 encapsulada en thirdParty)
+  APRS_TYPE_QUERY,         // ?
+  APRS_TYPE_CAPABILITIES,  // <
+  APRS_TYPE_USER_DEFINED,  // {
+  APRS_TYPE_COUNT
+};
+
+extern const char* const APRS_TYPE_NAMES[APRS_TYPE_COUNT];
+
+enum AprsError : uint8_t {
+  APRS_OK,
+  APRS_ERR_EMPTY,          // Trama inválida o sin campo de información
+  APRS_ERR_SHORT,          // Más corto que el formato del tipo
+  APRS_ERR_FORMAT,         // Dígitos, hemisferio o símbolo fuera de formato
+  APRS_ERR_UNKNOWN,        // Identificador de tipo no reconocido
+  APRS_ERR_COUNT
+};
+
+extern const char* const APRS_ERROR_NAMES[APRS_ERR_COUNT];
+
+#define APRS_TELEMETRY_ANALOG 5
+#define APRS_NO_COURSE 0xFFFF   // course / speed ausentes
+
+struct AprsInfo {
+  AprsType  type;
+  AprsError error;
+
+  // Posición (POSITION, MICE, OBJECT, ITEM)
+  bool      hasPosition;
+  bool      compressed;
+  bool      messaging;       // '=' / '@': la estación acepta mensajes
+  int32_t   latitude;        // Millonésimas de grado, norte positivo
+  int32_t   longitude;       // Millonésimas de grado, este positivo
+  char      symbolTable;
+  char      symbolCode;
+  uint16_t  course;          // Grados (APRS_NO_COURSE si no viene)
+  uint16_t  speed;           // Nudos
+  AX25Field timestamp;       // "DDHHMMz", "DDHHMM/" o "HHMMSSh"
+  AX25Field comment;         // Resto después de la posición
+
+  // Mic-E: 0..7 (0 = emergencia); custom indica el juego alterno
+  uint8_t   miceMessage;
+  bool      miceCustom;
+
+  // Mensaje
+  AX25Field addressee;       // Sin los espacios de relleno
+  AX25Field text;            // Texto sin el número de mensaje
+  AX25Field messageId;       // Después de '{' o de "ack" / "rej"
+  bool      ack;
+  bool      rej;
+
+  // Objeto / ítem
+  AX25Field name;            // Sin los espacios de relleno
+  bool      alive;           // '*' / '!' vivo, '_' eliminado
+
+  // Estado: el texto va en comment (timestamp aparte)
+
+  // Telemetría
+  uint16_t  sequence;
+  uint8_t   analogCount;
+  float     analog[APRS_TELEMETRY_ANALOG];
+  bool      hasDigital;
+  uint8_t   digital;         // Bit 7 = primer carácter
+
+  // Tercero: vista de la trama encapsulada (se decodifica con parseAX25)
+  AX25Field thirdParty;
+};
+
+// Clasifica y decodifica ax.info; false si error != APRS_OK. type queda
+// asignado aunque la decodificación falle.
+bool decodeAprs(const AX25Packet& ax, AprsInfo& out);
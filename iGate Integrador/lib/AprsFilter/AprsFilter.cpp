@@ -0,0 +1,292 @@
+// ============================================================================
+//  Librería: AprsFilter
+//  Descripción: Implementación del compilador y del evaluador de filtros.
+// ============================================================================
+#include "AprsFilter.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* const FILTER_ERROR_NAMES[FILTER_ERR_COUNT] = {
+  "ok", "cláusula no admitida", "argumento inválido", "demasiadas cláusulas",
+  "demasiado largo"
+};
+
+static const float KM_PER_DEGREE = 111.195f;   // Un grado de latitud (radio medio)
+static const float DEG_TO_RAD_F  = 0.017453293f;
+
+// Letras de t/ en el orden de FilterTypeBit
+static const char TYPE_LETTERS[] = "POIMQSTUNW";
+
+AprsFilter::AprsFilter() {
+  compile("");
+}
+
+void AprsFilter::resetStats() {
+  memset(&stats_, 0, sizeof(stats_));
+  for (size_t i = 0; i < clauseCount_; i++) clauses_[i].hits = 0;
+}
+
+void AprsFilter::clear() {
+  clauseCount_ = 0;
+  opCount_ = 0;
+  excludeOps_ = 0;
+  needsDecode_ = false;
+  hasInclude_ = false;
+  errorPosition_ = 0;
+}
+
+FilterError AprsFilter::fail(FilterError e, size_t position) {
+  clear();
+  errorPosition_ = position;
+  return e;
+}
+
+// Las exclusiones van al principio: la primera que coincida rechaza sin
+// evaluar el resto
+bool AprsFilter::addOp(const Op& op) {
+  if (opCount_ >= FILTER_MAX_OPS) return false;
+  size_t at = op.exclude ? excludeOps_++ : opCount_;
+  memmove(&ops_[at + 1], &ops_[at], (opCount_ - at) * sizeof(Op));
+  ops_[at] = op;
+  opCount_++;
+  needsDecode_ |= op.code == OP_RANGE || op.code == OP_TYPE;
+  hasInclude_ |= !op.exclude;
+  return true;
+}
+
+// ============================================================================
+//  Función: compile()
+//  Descripción: Separa la expresión en cláusulas por espacios y compila cada
+//               una; cualquier error deja el filtro vacío.
+// ============================================================================
+FilterError AprsFilter::compile(const char* expression) {
+  memset(&stats_, 0, sizeof(stats_));
+  clear();
+
+  size_t n = strlen(expression);
+  if (n > FILTER_MAX_TEXT) {
+    text_[0] = upper_[0] = '\0';
+    return fail(FILTER_ERR_TOO_LONG, FILTER_MAX_TEXT);
+  }
+  memcpy(text_, expression, n + 1);
+  for (size_t i = 0; i <= n; i++) {
+    char c = text_[i];
+    upper_[i] = (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+  }
+
+  size_t i = 0;
+  while (i < n) {
+    if (text_[i] == ' ') {
+      i++;
+      continue;
+    }
+    size_t end = i;
+    while (end < n && text_[end] != ' ') end++;
+    bool exclude = text_[i] == '-';
+    FilterError e = compileClause(exclude ? i + 1 : i, end, exclude);
+    if (e != FILTER_OK) return e;
+    i = end;
+  }
+  return FILTER_OK;
+}
+
+static bool isCallChar(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || c == '-';
+}
+
+// Número decimal terminado en '/' o en el fin de la cláusula
+static bool parseNumber(const char* s, size_t end, size_t& i, float& out) {
+  char* stop;
+  out = strtof(s + i, &stop);
+  size_t next = (size_t)(stop - s);
+  if (next == i || next > end || (next < end && s[next] != '/')) return false;
+  i = next < end ? next + 1 : next;
+  return true;
+}
+
+FilterError AprsFilter::compileClause(size_t start, size_t end, bool exclude) {
+  size_t origin = exclude ? start - 1 : start;
+  if (clauseCount_ >= FILTER_MAX_CLAUSES) return fail(FILTER_ERR_TOO_MANY, origin);
+  if (end - start < 3 || text_[start + 1] != '/') return fail(FILTER_ERR_UNKNOWN, origin);
+
+  Op op;
+  memset(&op, 0, sizeof(op));
+  op.clause = (uint8_t)clauseCount_;
+  op.exclude = exclude;
+  size_t i = start + 2;
+
+  switch (upper_[start]) {
+    case 'R': {
+      float lat, lon, km;
+      if (!parseNumber(upper_, end, i, lat) || !parseNumber(upper_, end, i, lon) ||
+          !parseNumber(upper_, end, i, km) || i != end || lat < -90 || lat > 90 ||
+          lon < -180 || lon > 180 || km <= 0) {
+        return fail(FILTER_ERR_ARGUMENT, start);
+      }
+      op.code = OP_RANGE;
+      op.lat = lat;
+      op.lon = lon;
+      op.cosLat = cosf(lat * DEG_TO_RAD_F);
+      float dLat = km / KM_PER_DEGREE;
+      float half = sinf(dLat * DEG_TO_RAD_F / 2);
+      op.haversine = half * half;
+
+      // Rectángulo que contiene el círculo: descarta casi todo con enteros
+      op.latMin = (int32_t)(fmaxf(lat - dLat, -90.0f) * 1e6f);
+      op.latMax = (int32_t)(fminf(lat + dLat, 90.0f) * 1e6f);
+      float dLon = op.cosLat > 0.01f ? dLat / op.cosLat : 180.0f;
+      if (dLon >= 180.0f || lat + dLat >= 90.0f || lat - dLat <= -90.0f) {
+        op.lonMin = -180000000;   // Cerca de un polo: cualquier longitud
+        op.lonMax = 180000000;
+      } else {
+        float lonMin = lon - dLon, lonMax = lon + dLon;
+        op.wraps = lonMin < -180.0f || lonMax > 180.0f;
+        if (lonMin < -180.0f) lonMin += 360.0f;
+        if (lonMax > 180.0f) lonMax -= 360.0f;
+        op.lonMin = (int32_t)(lonMin * 1e6f);
+        op.lonMax = (int32_t)(lonMax * 1e6f);
+      }
+      if (!addOp(op)) return fail(FILTER_ERR_TOO_MANY, origin);
+      break;
+    }
+
+    case 'P':
+    case 'B': {
+      op.code = upper_[start] == 'P' ? OP_PREFIX : OP_BUDDY;
+      while (i < end) {
+        size_t arg = i;
+        while (i < end && upper_[i] != '/') i++;
+        size_t length = i - arg;
+        op.wildcard = op.code == OP_BUDDY && length > 0 && upper_[i - 1] == '*';
+        if (op.wildcard) length--;
+        if (length == 0 || length > 9) return fail(FILTER_ERR_ARGUMENT, arg);
+        for (size_t k = arg; k < arg + length; k++) {
+          if (!isCallChar(upper_[k])) return fail(FILTER_ERR_ARGUMENT, k);
+        }
+        op.offset = (uint8_t)arg;
+        op.length = (uint8_t)length;
+        if (!addOp(op)) return fail(FILTER_ERR_TOO_MANY, arg);
+        if (i < end) i++;   // '/'
+      }
+      break;
+    }
+
+    case 'T':
+      op.code = OP_TYPE;
+      for (; i < end; i++) {
+        const char* letter = strchr(TYPE_LETTERS, upper_[i]);
+        if (upper_[i] == '\0' || letter == nullptr) return fail(FILTER_ERR_ARGUMENT, i);
+        op.types |= (uint16_t)(1 << (letter - TYPE_LETTERS));
+      }
+      if (op.types == 0) return fail(FILTER_ERR_ARGUMENT, start);
+      if (!addOp(op)) return fail(FILTER_ERR_TOO_MANY, origin);
+      break;
+
+    default:
+      return fail(FILTER_ERR_UNKNOWN, origin);
+  }
+
+  FilterClause& c = clauses_[clauseCount_++];
+  c.offset = (uint8_t)origin;
+  c.length = (uint8_t)(end - origin);
+  c.exclude = exclude;
+  c.hits = 0;
+  return FILTER_OK;
+}
+
+// ============================================================================
+//  Evaluación
+// ============================================================================
+static uint16_t typeBits(const AX25Packet& ax, const AprsInfo& a) {
+  switch (a.type) {
+    case APRS_TYPE_POSITION:
+    case APRS_TYPE_MICE:
+      return FILTER_TYPE_POSITION | (a.symbolCode == '_' ? FILTER_TYPE_WEATHER : 0);
+    case APRS_TYPE_OBJECT:       return FILTER_TYPE_OBJECT;
+    case APRS_TYPE_ITEM:         return FILTER_TYPE_ITEM;
+    case APRS_TYPE_MESSAGE: {
+      bool nws = a.addressee.length >= 4 && memcmp(ax.data(a.addressee), "NWS-", 4) == 0;
+      return FILTER_TYPE_MESSAGE | (nws ? FILTER_TYPE_NWS : 0);
+    }
+    case APRS_TYPE_QUERY:        return FILTER_TYPE_QUERY;
+    case APRS_TYPE_STATUS:       return FILTER_TYPE_STATUS;
+    case APRS_TYPE_TELEMETRY:    return FILTER_TYPE_TELEMETRY;
+    case APRS_TYPE_USER_DEFINED: return FILTER_TYPE_USER;
+    case APRS_TYPE_WEATHER:      return FILTER_TYPE_WEATHER;
+    default:                     return 0;
+  }
+}
+
+bool AprsFilter::matches(const Op& op, const AX25Packet& ax, const AprsInfo& aprs) const {
+  switch (op.code) {
+    case OP_PREFIX:
+      return ax.source.length >= op.length &&
+             memcmp(ax.data(ax.source), upper_ + op.offset, op.length) == 0;
+
+    case OP_BUDDY:
+      return (op.wildcard ? ax.source.length >= op.length : ax.source.length == op.length) &&
+             memcmp(ax.data(ax.source), upper_ + op.offset, op.length) == 0;
+
+    case OP_TYPE:
+      return (typeBits(ax, aprs) & op.types) != 0;
+
+    case OP_RANGE: {
+      if (!aprs.hasPosition) return false;
+      if (aprs.latitude < op.latMin || aprs.latitude > op.latMax) return false;
+      bool inLon = op.wraps ? aprs.longitude >= op.lonMin || aprs.longitude <= op.lonMax
+                            : aprs.longitude >= op.lonMin && aprs.longitude <= op.lonMax;
+      if (!inLon) return false;
+      // Dentro del rectángulo: distancia exacta sobre la esfera (haversine)
+      float lat = aprs.latitude * 1e-6f;
+      float sinLat = sinf((lat - op.lat) * DEG_TO_RAD_F / 2);
+      float sinLon = sinf((aprs.longitude * 1e-6f - op.lon) * DEG_TO_RAD_F / 2);
+      float h = sinLat * sinLat + op.cosLat * cosf(lat * DEG_TO_RAD_F) * sinLon * sinLon;
+      return h <= op.haversine;
+    }
+  }
+  return false;
+}
+
+// ============================================================================
+//  Función: evaluate()
+//  Descripción: Recorre las operaciones en orden (exclusiones primero); la
+//               primera que coincide decide. Decodifica el campo de
+//               información solo si alguna cláusula usa tipo o posición.
+// ============================================================================
+bool AprsFilter::evaluate(const char* data, size_t length, int* clause) {
+  stats_.evaluated++;
+  int decided = -1;
+  bool pass = true;
+
+  if (opCount_ > 0) {
+    AX25Packet ax;
+    parseAX25(data, length, ax);
+    AprsInfo aprs;
+    aprs.type = APRS_TYPE_UNKNOWN;
+    aprs.hasPosition = false;
+    if (needsDecode_) {
+      decodeAprs(ax, aprs);
+      stats_.decoded++;
+    }
+
+    pass = !hasInclude_;
+    if (ax.valid) {
+      for (size_t i = 0; i < opCount_; i++) {
+        if (matches(ops_[i], ax, aprs)) {
+          decided = ops_[i].clause;
+          pass = !ops_[i].exclude;
+          break;
+        }
+      }
+    }
+    if (decided >= 0) clauses_[decided].hits++;
+    else stats_.unmatched++;
+  }
+
+  if (pass) stats_.passed++;
+  else stats_.rejected++;
+  if (clause != nullptr) *clause = decided;
+  return pass;
+}
@@ -0,0 +1,140 @@
+// ============================================================================
+//  Librería: AprsFilter
+//  Descripción: Filtro local con la sintaxis de aprsc para el tráfico
+//               APRS-IS → RF. La expresión se compila una sola vez en un
+//               arreglo plano de operaciones (una por argumento de cada
+//               cláusula) y cada línea se evalúa contra él sin memoria
+//               dinámica; AprsDecoder solo se usa si alguna cláusula
+//               necesita el tipo o la posición. Cláusulas admitidas:
+//                 r/lat/lon/km     posición dentro del radio (rectángulo
+//                                  precalculado + distancia haversine)
+//                 p/aa/bb...       indicativo de origen que empieza con aa, bb
+//                 b/call1/call2*   indicativo de origen exacto ('*' al final
+//                                  = comodín)
+//                 t/poimqstunw     tipo de paquete
+//                 -cláusula        exclusión
+//               Una línea pasa si alguna cláusula normal coincide y ninguna
+//               exclusión coincide; si solo hay exclusiones, pasa todo lo
+//               demás y con la expresión vacía pasa todo.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AX25.h>
+#include <AprsDecoder.h>
+
+// Parámetros fijados en compilación
+#ifndef FILTER_MAX_TEXT
+#define FILTER_MAX_TEXT 127          // Igual que CONFIG_FILTER_LEN
+#endif
+#ifndef FILTER_MAX_CLAUSES
+#define FILTER_MAX_CLAUSES 12
+#endif
+#ifndef FILTER_MAX_OPS
+#define FILTER_MAX_OPS 32            // Argumentos de todas las cláusulas
+#endif
+
+enum FilterError : uint8_t {
+  FILTER_OK,
+  FILTER_ERR_UNKNOWN,     // Cláusula no admitida (solo r p b t)
+  FILTER_ERR_ARGUMENT,    // Número, tipo o indicativo mal formado
+  FILTER_ERR_TOO_MANY,    // Más de FILTER_MAX_CLAUSES / FILTER_MAX_OPS
+  FILTER_ERR_TOO_LONG,    // Más de FILTER_MAX_TEXT caracteres
+  FILTER_ERR_COUNT
+};
+
+extern const char* const FILTER_ERROR_NAMES[FILTER_ERR_COUNT];
+
+// Bits de t/ (uno por letra)
+enum FilterTypeBit : uint16_t {
+  FILTER_TYPE_POSITION  = 1 << 0,   // p: posición y Mic-E
+  FILTER_TYPE_OBJECT    = 1 << 1,   // o
+  FILTER_TYPE_ITEM      = 1 << 2,   // i
+  FILTER_TYPE_MESSAGE   = 1 << 3,   // m: mensajes, ack y rej
+  FILTER_TYPE_QUERY     = 1 << 4,   // q
+  FILTER_TYPE_STATUS    = 1 << 5,   // s
+  FILTER_TYPE_TELEMETRY = 1 << 6,   // t
+  FILTER_TYPE_USER      = 1 << 7,   // u
+  FILTER_TYPE_NWS       = 1 << 8,   // n: mensajes a NWS-*
+  FILTER_TYPE_WEATHER   = 1 << 9,   // w: '_' o posición con símbolo de clima
+};
+
+struct FilterClause {
+  uint8_t  offset;       // Texto de la cláusula dentro de text()
+  uint8_t  length;
+  bool     exclude;
+  uint32_t hits;         // Líneas que esta cláusula decidió (pasa / rechaza)
+};
+
+struct FilterStats {
+  uint32_t evaluated;
+  uint32_t passed;
+  uint32_t rejected;     // Por una exclusión o sin coincidencias
+  uint32_t unmatched;    // Ninguna cláusula coincidió
+  uint32_t decoded;      // Líneas que necesitaron AprsDecoder
+};
+
+class AprsFilter {
+ public:
+  AprsFilter();
+
+  // Compila la expresión; con error queda vacía (pasa todo) y
+  // errorPosition() indica el carácter del problema
+  FilterError compile(const char* expression);
+
+  // true si la línea TNC2 pasa; clause (opcional) recibe la cláusula que
+  // decidió o -1
+  bool evaluate(const char* data, size_t length, int* clause = nullptr);
+
+  bool                empty() const { return opCount_ == 0; }
+  const char*         text() const { return text_; }
+  size_t              errorPosition() const { return errorPosition_; }
+  size_t              clauseCount() const { return clauseCount_; }
+  const FilterClause& clause(size_t i) const { return clauses_[i]; }
+  size_t              opCount() const { return opCount_; }
+  const FilterStats&  stats() const { return stats_; }
+  void                resetStats();
+
+ private:
+  enum OpCode : uint8_t {
+    OP_RANGE,    // r/
+    OP_PREFIX,   // p/
+    OP_BUDDY,    // b/
+    OP_TYPE,     // t/
+  };
+
+  struct Op {
+    OpCode   code;
+    uint8_t  clause;
+    bool     exclude;
+    bool     wildcard;     // b/ terminado en '*'
+    uint8_t  offset;       // Indicativo o prefijo en upper_
+    uint8_t  length;
+    uint16_t types;        // t/: FilterTypeBit
+    // r/: rectángulo en millonésimas de grado (descarte con enteros) y
+    // centro para la distancia exacta (haversine del radio precalculado)
+    int32_t  latMin, latMax, lonMin, lonMax;
+    bool     wraps;        // El rectángulo cruza ±180°
+    float    lat, lon, cosLat, haversine;
+  };
+
+  void        clear();
+  FilterError fail(FilterError e, size_t position);
+  FilterError compileClause(size_t start, size_t end, bool exclude);
+  bool        addOp(const Op& op);
+  bool        matches(const Op& op, const AX25Packet& ax, const AprsInfo& aprs) const;
+
+  char         text_[FILTER_MAX_TEXT + 1];    // Expresión original
+  char         upper_[FILTER_MAX_TEXT + 1];   // En mayúsculas (indicativos)
+  FilterClause clauses_[FILTER_MAX_CLAUSES];
+  size_t       clauseCount_;
+  Op           ops_[FILTER_MAX_OPS];          // Exclusiones primero
+  size_t       opCount_;
+  size_t       excludeOps_;
+  bool         needsDecode_;
+  bool         hasInclude_;
+  size_t       errorPosition_;
+  FilterStats  stats_;
+};
@@ -0,0 +1,541 @@
+// ============================================================================
+//  Librería: AprsIsPool
+//  Descripción: Implementación de las conexiones, la selección de servidores
+//               y el failover.
+// ============================================================================
+#include "AprsIsPool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+const char* const POOL_ROLE_NAMES[POOL_ROLE_COUNT] = { "primario", "reserva", "sondeo" };
+
+const char* const POOL_STAGE_NAMES[POOL_STAGE_COUNT] = {
+  "DNS", "CONNECT", "BANNER", "LOGIN", "READY"
+};
+
+const char* const POOL_EVENT_NAMES[POOL_EV_COUNT] = {
+  "conectando", "conectado", "banner", "sin banner", "login", "respuesta", "no verificado",
+  "autenticado", "sondeo", "falla", "failover", "cambio"
+};
+
+static const uint32_t SCORE_UNKNOWN = 0x7FFFFFFF;   // Sin medir: después de los medidos
+
+static bool due(uint32_t now, uint32_t at) {
+  return (int32_t)(now - at) >= 0;
+}
+
+// Promedio móvil 3/4 + 1/4 (el primer valor se toma tal cual)
+static uint32_t smooth(uint32_t average, uint32_t sample) {
+  return average == 0 ? (sample ? sample : 1) : (average * 3 + sample + 2) / 4;
+}
+
+AprsIsPool::AprsIsPool()
+    : count_(0), active_(-1), activeSince_(0), lostServer_(-1), lostAt_(0), switching_(false),
+      switchPending_(false), probeAt_(0), filter_(""), onEvent_(nullptr), context_(nullptr),
+      random_(0x9E3779B9) {
+  memset(servers_, 0, sizeof(servers_));
+  memset(&timings_, 0, sizeof(timings_));
+  memset(&stats_, 0, sizeof(stats_));
+  login_[0] = '\0';
+  for (Link& l : links_) {
+    l.fd = -1;
+    l.server = -1;
+    l.stage = POOL_STAGE_IDLE;
+  }
+}
+
+void AprsIsPool::setEventHandler(PoolEventFn fn, void* context) {
+  onEvent_ = fn;
+  context_ = context;
+}
+
+void AprsIsPool::setLogin(const char* callsign, const char* passcode, const char* software,
+                          const char* filter) {
+  snprintf(login_, sizeof(login_), "user %s pass %s vers %s", callsign, passcode, software);
+  filter_ = filter;
+}
+
+void AprsIsPool::emit(PoolEventId id, PoolRole role, int server, uint32_t value,
+                      const char* text, size_t length) {
+  if (onEvent_ == nullptr) return;
+  PoolEvent e;
+  e.id = id;
+  e.role = role;
+  e.stage = links_[role].stage;
+  e.server = (uint8_t)server;
+  e.value = value;
+  e.text = text;
+  e.length = length;
+  onEvent_(e, context_);
+}
+
+// ============================================================================
+//  Lista de servidores y DNS
+// ============================================================================
+int AprsIsPool::addServer(const char* hostPort, uint16_t defaultPort) {
+  if (count_ >= POOL_MAX_SERVERS) return -1;
+  const char* colon = strchr(hostPort, ':');
+  size_t hostLength = colon ? (size_t)(colon - hostPort) : strlen(hostPort);
+  if (hostLength == 0 || hostLength > POOL_HOST_LEN) return -1;
+
+  uint16_t port = defaultPort;
+  if (colon != nullptr) {
+    char* end;
+    unsigned long n = strtoul(colon + 1, &end, 10);
+    if (end == colon + 1 || *end != '\0' || n == 0 || n > 65535) return -1;
+    port = (uint16_t)n;
+  }
+
+  for (size_t i = 0; i < count_; i++) {
+    if (servers_[i].port == port && strlen(servers_[i].host) == hostLength &&
+        strncasecmp(servers_[i].host, hostPort, hostLength) == 0) {
+      return -1;
+    }
+  }
+
+  Server& s = servers_[count_];
+  memset(&s, 0, sizeof(s));
+  memcpy(s.host, hostPort, hostLength);
+  s.host[hostLength] = '\0';
+  s.port = port;
+  s.resolve = true;
+  return (int)count_++;
+}
+
+int AprsIsPool::needsAddress(uint32_t now) const {
+  for (size_t i = 0; i < count_; i++) {
+    const Server& s = servers_[i];
+    if (!s.resolve || !due(now, s.retryAt) || (int)i == active_) continue;
+    bool busy = false;
+    for (const Link& l : links_) busy |= l.server == (int)i;
+    if (!busy) return (int)i;
+  }
+  return -1;
+}
+
+void AprsIsPool::setAddress(size_t i, uint32_t address, uint32_t now) {
+  Server& s = servers_[i];
+  s.address = address;
+  if (address != 0) {
+    s.resolve = false;
+    return;
+  }
+  s.stats.failures++;
+  stats_.failures[POOL_STAGE_IDLE]++;
+  backoff((int)i, now);
+}
+
+// Espera exponencial por servidor con dispersión (xorshift, sin random())
+void AprsIsPool::backoff(int i, uint32_t now) {
+  Server& s = servers_[i];
+  s.backoffMs = s.backoffMs == 0 ? timings_.backoffMinMs : s.backoffMs * 2;
+  if (s.backoffMs > timings_.backoffMaxMs) s.backoffMs = timings_.backoffMaxMs;
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  s.retryAt = now + s.backoffMs + random_ % (s.backoffMs / 4 + 1);
+  s.resolve = true;   // rotate.aprs2.net: el próximo intento puede ir a otro servidor
+}
+
+// ============================================================================
+//  Selección: menor latencia de login medida; sin medir, en el orden de la
+//  lista. Nunca dos conexiones al mismo servidor (ni a la misma dirección).
+// ============================================================================
+uint32_t AprsIsPool::score(int i) const {
+  uint32_t login = servers_[i].stats.loginMs;
+  return login != 0 ? login : SCORE_UNKNOWN;
+}
+
+bool AprsIsPool::eligible(int i, uint32_t now) const {
+  const Server& s = servers_[i];
+  if (s.address == 0 || s.resolve || !due(now, s.retryAt)) return false;
+  if (active_ >= 0 && (i == active_ || servers_[active_].address == s.address)) return false;
+  for (const Link& l : links_) {
+    if (l.server >= 0 && (l.server == i || servers_[l.server].address == s.address)) return false;
+  }
+  return true;
+}
+
+int AprsIsPool::pick(uint32_t now) const {
+  int best = -1;
+  for (size_t i = 0; i < count_; i++) {
+    if (eligible((int)i, now) && (best < 0 || score((int)i) < score(best))) best = (int)i;
+  }
+  return best;
+}
+
+int AprsIsPool::pickProbe(uint32_t now) const {
+  int oldest = -1;
+  for (size_t i = 0; i < count_; i++) {
+    if (!eligible((int)i, now)) continue;
+    const Server& s = servers_[i];
+    if (oldest < 0) {
+      oldest = (int)i;
+    } else {
+      const Server& o = servers_[oldest];
+      if (o.probed && (!s.probed || (int32_t)(s.probedAt - o.probedAt) < 0)) oldest = (int)i;
+    }
+  }
+  return oldest;
+}
+
+uint64_t AprsIsPool::uptime(size_t i, uint32_t now) const {
+  uint64_t total = servers_[i].stats.uptimeMs;
+  if ((int)i == active_) total += now - activeSince_;
+  return total;
+}
+
+// ============================================================================
+//  Función: tick()
+//  Descripción: Avanza cada conexión un paso y decide qué abrir: sin sesión,
+//               un intento al mejor servidor (salvo que la reserva ya esté
+//               lista); con sesión, la reserva y el sondeo periódico.
+// ============================================================================
+void AprsIsPool::tick(uint32_t now) {
+  for (uint8_t r = 0; r < POOL_ROLE_COUNT; r++) linkTick((PoolRole)r, now);
+
+  Link& primary = links_[POOL_ROLE_PRIMARY];
+  Link& standby = links_[POOL_ROLE_STANDBY];
+  Link& probe = links_[POOL_ROLE_PROBE];
+
+  if (active_ < 0) {
+    switchPending_ = false;
+    if (primary.server < 0 && standby.stage != POOL_STAGE_READY) {
+      int s = pick(now);
+      if (s >= 0) linkStart(POOL_ROLE_PRIMARY, s, now);
+    }
+    return;
+  }
+
+  // Un intento que terminó cuando la reserva ya había cubierto la sesión
+  if (primary.stage == POOL_STAGE_READY) {
+    if (standby.server < 0) linkMove(POOL_ROLE_PRIMARY, POOL_ROLE_STANDBY);
+    else linkClose(POOL_ROLE_PRIMARY);
+  }
+
+  if (standby.server < 0) {
+    int s = pick(now);
+    if (s >= 0) linkStart(POOL_ROLE_STANDBY, s, now);
+  }
+
+  if (timings_.probeIntervalMs > 0 && probe.server < 0 && due(now, probeAt_)) {
+    probeAt_ = now + timings_.probeIntervalMs;
+    int s = pickProbe(now);
+    if (s >= 0) linkStart(POOL_ROLE_PROBE, s, now);
+  }
+
+  switchPending_ = timings_.switchMarginMs > 0 && standby.stage == POOL_STAGE_READY &&
+                   score(standby.server) + timings_.switchMarginMs < score(active_);
+}
+
+// ============================================================================
+//  Función: takeSession()
+//  Descripción: Entrega la reserva (failover o cambio planificado) o, si no
+//               hay, el intento primario ya autenticado.
+// ============================================================================
+int AprsIsPool::takeSession(uint32_t now) {
+  if (active_ >= 0) return -1;
+
+  PoolRole role;
+  if (links_[POOL_ROLE_STANDBY].stage == POOL_STAGE_READY) role = POOL_ROLE_STANDBY;
+  else if (links_[POOL_ROLE_PRIMARY].stage == POOL_STAGE_READY) role = POOL_ROLE_PRIMARY;
+  else return -1;
+
+  Link& l = links_[role];
+  if (!l.filtered && filter_[0] != '\0') {
+    char command[16 + POOL_LOGIN_MAX];
+    int n = snprintf(command, sizeof(command), "#filter %s\n", filter_);
+    if (n <= 0 || (size_t)n >= sizeof(command) || !sendText(l, command, (size_t)n, now)) {
+      linkFail(role, now, "No se pudo enviar el filtro");
+      return -1;
+    }
+  }
+
+  int fd = l.fd;
+  int server = l.server;
+  l.fd = -1;   // El socket pasa al llamador
+  l.server = -1;
+  l.stage = POOL_STAGE_IDLE;
+
+  active_ = server;
+  activeSince_ = now;
+  servers_[server].stats.sessions++;
+
+  if (lostServer_ >= 0) {
+    uint32_t gap = now - lostAt_;
+    stats_.lastGapMs = gap;
+    if (gap > stats_.maxGapMs) stats_.maxGapMs = gap;
+  }
+
+  if (role == POOL_ROLE_STANDBY && switching_) {
+    stats_.switches++;
+    emit(POOL_EV_SWITCH, role, server, servers_[server].stats.loginMs);
+  } else if (role == POOL_ROLE_STANDBY) {
+    uint32_t gap = lostServer_ >= 0 ? now - lostAt_ : 0;
+    stats_.failovers++;
+    stats_.lastFailoverMs = gap;
+    if (gap > stats_.maxFailoverMs) stats_.maxFailoverMs = gap;
+    if (lostServer_ >= 0) servers_[lostServer_].stats.failovers++;
+    emit(POOL_EV_FAILOVER, role, server, gap);
+  } else {
+    stats_.coldStarts++;
+  }
+  lostServer_ = -1;
+  switching_ = false;
+  switchPending_ = false;
+  return fd;
+}
+
+void AprsIsPool::sessionClosed(uint32_t now) {
+  if (active_ < 0) return;
+  Server& s = servers_[active_];
+  s.stats.uptimeMs += now - activeSince_;
+  switching_ = switchPending_;
+  if (!switching_) {
+    s.stats.drops++;
+    backoff(active_, now);   // La reserva nueva no vuelve de inmediato al que falló
+  }
+  lostServer_ = active_;
+  lostAt_ = now;
+  active_ = -1;
+  switchPending_ = false;
+}
+
+void AprsIsPool::stop() {
+  for (uint8_t r = 0; r < POOL_ROLE_COUNT; r++) linkClose((PoolRole)r);
+  switchPending_ = false;
+}
+
+// ============================================================================
+//  Conexiones
+// ============================================================================
+void AprsIsPool::linkStart(PoolRole role, int server, uint32_t now) {
+  Link& l = links_[role];
+  Server& s = servers_[server];
+  s.stats.attempts++;
+  stats_.attempts++;
+  if (role == POOL_ROLE_PROBE) {
+    s.probed = true;
+    s.probedAt = now;
+  }
+
+  l.server = server;
+  l.stage = POOL_STAGE_CONNECT;
+  l.filtered = false;
+  l.started = l.since = now;
+  emit(POOL_EV_CONNECTING, role, server, s.port);
+
+  l.fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (l.fd < 0) {
+    linkFail(role, now, "Sin sockets libres");
+    return;
+  }
+  fcntl(l.fd, F_SETFL, fcntl(l.fd, F_GETFL, 0) | O_NONBLOCK);
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(s.port);
+  addr.sin_addr.s_addr = s.address;
+  if (connect(l.fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+    linkFail(role, now, "connect() rechazado");
+  }
+}
+
+void AprsIsPool::linkClose(PoolRole role) {
+  Link& l = links_[role];
+  if (l.fd >= 0) close(l.fd);
+  l.fd = -1;
+  l.server = -1;
+  l.stage = POOL_STAGE_IDLE;
+}
+
+void AprsIsPool::linkMove(PoolRole from, PoolRole to) {
+  linkClose(to);
+  links_[to] = links_[from];
+  links_[from].fd = -1;
+  links_[from].server = -1;
+  links_[from].stage = POOL_STAGE_IDLE;
+}
+
+void AprsIsPool::linkFail(PoolRole role, uint32_t now, const char* reason) {
+  Link& l = links_[role];
+  int server = l.server;
+  servers_[server].stats.failures++;
+  stats_.failures[l.stage]++;
+  backoff(server, now);
+  emit(POOL_EV_FAIL, role, server, servers_[server].retryAt - now, reason);
+  linkClose(role);
+}
+
+// 1 = línea en link.line (sin "\r\n"), 0 = falta el '\n', -1 = cerrada.
+// Lee con MSG_PEEK y consume exactamente hasta el '\n': lo que siga queda
+// en el socket para quien reciba la sesión.
+int AprsIsPool::readLine(Link& l, uint32_t now, size_t& length) {
+  ssize_t n = recv(l.fd, l.line, POOL_LINE_MAX, MSG_PEEK | MSG_DONTWAIT);
+  if (n == 0) return -1;
+  if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+
+  const char* eol = (const char*)memchr(l.line, '\n', (size_t)n);
+  size_t take = eol != nullptr ? (size_t)(eol - l.line) + 1 : 0;
+  if (take == 0 && (size_t)n < POOL_LINE_MAX) return 0;
+  if (take == 0) take = POOL_LINE_MAX;   // Línea más larga que el buffer: se corta
+  if (recv(l.fd, l.line, take, MSG_DONTWAIT) != (ssize_t)take) return -1;
+
+  length = eol != nullptr ? take - 1 : take;
+  while (length > 0 && l.line[length - 1] == '\r') length--;
+  l.line[length] = '\0';
+  l.lastRx = now;
+  return 1;
+}
+
+bool AprsIsPool::sendText(Link& l, const char* text, size_t length, uint32_t now) {
+  if (send(l.fd, text, length, MSG_DONTWAIT) != (ssize_t)length) return false;
+  l.lastTx = now;
+  return true;
+}
+
+bool AprsIsPool::sendLogin(PoolRole role, uint32_t now) {
+  Link& l = links_[role];
+  char line[POOL_LOGIN_MAX + 2];
+  l.filtered = role == POOL_ROLE_PRIMARY && filter_[0] != '\0';
+  int n = snprintf(line, sizeof(line) - 1, "%s%s%s", login_, l.filtered ? " filter " : "",
+                   l.filtered ? filter_ : "");
+  if (n <= 0) return false;
+  if ((size_t)n > sizeof(line) - 2) n = (int)(sizeof(line) - 2);
+  emit(POOL_EV_LOGIN_SENT, role, l.server, 0, line, (size_t)n);
+  line[n++] = '\n';
+  return sendText(l, line, (size_t)n, now);
+}
+
+// ============================================================================
+//  Función: linkTick()
+//  Descripción: Un paso de la conexión: connect() → banner → login →
+//               logresp, cada etapa con su timeout. La reserva lista
+//               descarta los comentarios del servidor, envía keepalive y se
+//               descarta si el servidor deja de hablar.
+// ============================================================================
+void AprsIsPool::linkTick(PoolRole role, uint32_t now) {
+  Link& l = links_[role];
+  uint32_t inStage = now - l.since;
+  size_t length;
+
+  switch (l.stage) {
+    case POOL_STAGE_IDLE:
+      return;
+
+    case POOL_STAGE_CONNECT: {
+      fd_set writeSet;
+      FD_ZERO(&writeSet);
+      FD_SET(l.fd, &writeSet);
+      struct timeval noWait = { 0, 0 };
+      if (select(l.fd + 1, nullptr, &writeSet, nullptr, &noWait) <= 0) {
+        if (inStage > timings_.connectMs) linkFail(role, now, "Timeout de conexión TCP");
+        return;
+      }
+      int sockErr = 0;
+      socklen_t len = sizeof(sockErr);
+      getsockopt(l.fd, SOL_SOCKET, SO_ERROR, &sockErr, &len);
+      if (sockErr != 0) {
+        linkFail(role, now, "Fallo conexión APRS-IS");
+        return;
+      }
+      PoolServerStats& st = servers_[l.server].stats;
+      st.lastConnectMs = now - l.started;
+      st.connectMs = smooth(st.connectMs, st.lastConnectMs);
+      l.stage = POOL_STAGE_BANNER;
+      l.since = now;
+      emit(POOL_EV_CONNECTED, role, l.server, st.lastConnectMs);
+      return;
+    }
+
+    case POOL_STAGE_BANNER: {
+      int r = readLine(l, now, length);
+      if (r < 0) {
+        linkFail(role, now, "El servidor cerró la conexión");
+        return;
+      }
+      if (r > 0) emit(POOL_EV_BANNER, role, l.server, 0, l.line, length);
+      else if (inStage <= timings_.bannerMs) return;
+      else emit(POOL_EV_NO_BANNER, role, l.server, 0);
+
+      if (!sendLogin(role, now)) {
+        linkFail(role, now, "No se pudo enviar el login");
+        return;
+      }
+      l.stage = POOL_STAGE_LOGIN;
+      l.since = now;
+      return;
+    }
+
+    case POOL_STAGE_LOGIN: {
+      // La primera línea "# logresp" decide
+      int r;
+      while ((r = readLine(l, now, length)) > 0) {
+        emit(POOL_EV_LOGIN_RESP, role, l.server, 0, l.line, length);
+        if (strstr(l.line, "logresp") == nullptr) continue;
+        if (strstr(l.line, "unverified") != nullptr) emit(POOL_EV_UNVERIFIED, role, l.server, 0);
+        linkReady(role, now);
+        return;
+      }
+      if (r < 0) linkFail(role, now, "El servidor cerró la conexión");
+      else if (inStage > timings_.loginMs) linkFail(role, now, "Problema con autenticación (sin logresp)");
+      return;
+    }
+
+    case POOL_STAGE_READY: {
+      if (role != POOL_ROLE_STANDBY) return;   // El intento primario lo recibe takeSession()
+      int r;
+      while ((r = readLine(l, now, length)) > 0) {}
+      if (r < 0) {
+        linkFail(role, now, "Conexión perdida");
+      } else if (now - l.lastRx > timings_.idleTimeoutMs) {
+        linkFail(role, now, "Sin datos del servidor");
+      } else if (now - l.lastTx > timings_.keepaliveMs) {
+        static const char KEEPALIVE[] = "# standby\n";
+        if (!sendText(l, KEEPALIVE, sizeof(KEEPALIVE) - 1, now)) linkFail(role, now, "Keepalive fallido");
+      }
+      return;
+    }
+
+    default:
+      return;
+  }
+}
+
+// Login aceptado: mide, y el sondeo se cierra o reemplaza a la reserva
+void AprsIsPool::linkReady(PoolRole role, uint32_t now) {
+  Link& l = links_[role];
+  Server& s = servers_[l.server];
+  s.stats.lastLoginMs = now - l.started;
+  s.stats.loginMs = smooth(s.stats.loginMs, s.stats.lastLoginMs);
+  s.backoffMs = 0;
+  l.stage = POOL_STAGE_READY;
+  l.since = l.lastRx = l.lastTx = now;
+
+  if (role != POOL_ROLE_PROBE) {
+    emit(POOL_EV_READY, role, l.server, s.stats.lastLoginMs);
+    return;
+  }
+
+  s.stats.probes++;
+  emit(POOL_EV_PROBED, role, l.server, s.stats.lastLoginMs);
+  Link& standby = links_[POOL_ROLE_STANDBY];
+  bool better = standby.stage == POOL_STAGE_READY && timings_.switchMarginMs > 0 &&
+                score(l.server) + timings_.switchMarginMs < score(standby.server);
+  if (standby.server < 0 || better) {
+    linkMove(POOL_ROLE_PROBE, POOL_ROLE_STANDBY);
+    emit(POOL_EV_READY, POOL_ROLE_STANDBY, links_[POOL_ROLE_STANDBY].server, s.stats.lastLoginMs);
+  } else {
+    linkClose(role);
+  }
+}
@@ -0,0 +1,229 @@
+// ============================================================================
+//  Librería: AprsIsPool
+//  Descripción: Conjunto de servidores APRS-IS con selección por latencia y
+//               failover en caliente. Hasta tres conexiones no bloqueantes
+//               (sockets BSD: lwIP en el ESP32, POSIX en el host):
+//                 primario  intento de sesión cuando no hay ninguna
+//                 reserva   segunda conexión ya autenticada contra otro
+//                           servidor; si la sesión cae se entrega de
+//                           inmediato en lugar de reconectar desde cero
+//                 sondeo    connect + login periódico a los demás servidores
+//                           para medir el RTT de connect() y la latencia de
+//                           login; si el sondeado es mejor que la reserva,
+//                           la reemplaza
+//               La sesión entregada (takeSession()) pasa a ser del firmware;
+//               la resolución DNS también la hace el firmware (needsAddress()
+//               / setAddress()). Sin memoria dinámica.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Parámetros fijados en compilación
+#ifndef POOL_MAX_SERVERS
+#define POOL_MAX_SERVERS 5
+#endif
+#ifndef POOL_HOST_LEN
+#define POOL_HOST_LEN 63             // Igual que CONFIG_HOST_LEN
+#endif
+#ifndef POOL_LOGIN_MAX
+#define POOL_LOGIN_MAX 255           // "user ... pass ... vers ... filter ..."
+#endif
+#ifndef POOL_LINE_MAX
+#define POOL_LINE_MAX 191            // Banner, logresp y comentarios de la reserva
+#endif
+
+enum PoolRole : uint8_t {
+  POOL_ROLE_PRIMARY,
+  POOL_ROLE_STANDBY,
+  POOL_ROLE_PROBE,
+  POOL_ROLE_COUNT
+};
+
+// Etapa de una conexión (también indica dónde falló)
+enum PoolStage : uint8_t {
+  POOL_STAGE_IDLE,
+  POOL_STAGE_CONNECT,   // connect() TCP en curso
+  POOL_STAGE_BANNER,    // Esperando el banner "# ..."
+  POOL_STAGE_LOGIN,     // Login enviado, esperando "# logresp"
+  POOL_STAGE_READY,     // Autenticada (la reserva espera aquí)
+  POOL_STAGE_COUNT
+};
+
+enum PoolEventId : uint8_t {
+  POOL_EV_CONNECTING,   // value = puerto
+  POOL_EV_CONNECTED,    // value = ms de connect()
+  POOL_EV_BANNER,       // text = banner
+  POOL_EV_NO_BANNER,
+  POOL_EV_LOGIN_SENT,   // text = línea de login (sin '\n')
+  POOL_EV_LOGIN_RESP,   // text = respuesta del servidor
+  POOL_EV_UNVERIFIED,   // logresp "unverified": solo recepción
+  POOL_EV_READY,        // value = ms desde connect() hasta logresp
+  POOL_EV_PROBED,       // Sondeo completo; value = ms de login
+  POOL_EV_FAIL,         // stage = etapa, text = motivo, value = espera (ms)
+  POOL_EV_FAILOVER,     // Reserva entregada tras caer la sesión; value = ms sin sesión
+  POOL_EV_SWITCH,       // Reserva entregada por ser mejor; value = ms de login
+  POOL_EV_COUNT
+};
+
+extern const char* const POOL_ROLE_NAMES[POOL_ROLE_COUNT];
+extern const char* const POOL_STAGE_NAMES[POOL_STAGE_COUNT];
+extern const char* const POOL_EVENT_NAMES[POOL_EV_COUNT];
+
+// text es válido solo durante la llamada (salvo en POOL_EV_FAIL: literal)
+struct PoolEvent {
+  PoolEventId id;
+  PoolRole    role;
+  PoolStage   stage;
+  uint8_t     server;
+  uint32_t    value;
+  const char* text;
+  size_t      length;
+};
+
+typedef void (*PoolEventFn)(const PoolEvent& event, void* context);
+
+struct PoolTimings {
+  uint32_t connectMs;        // Timeout de cada etapa
+  uint32_t bannerMs;
+  uint32_t loginMs;
+  uint32_t backoffMinMs;     // Espera por servidor tras una falla (exponencial)
+  uint32_t backoffMaxMs;
+  uint32_t probeIntervalMs;  // Entre sondeos (uno por vez, 0 = sin sondeos)
+  uint32_t idleTimeoutMs;    // Reserva sin datos del servidor: se descarta
+  uint32_t keepaliveMs;      // Comentario de la reserva hacia el servidor
+  uint32_t switchMarginMs;   // Mejora de login que justifica cambiar de
+                             // servidor sin falla (0 = nunca)
+};
+
+struct PoolServerStats {
+  uint32_t connectMs;        // RTT de connect(), promedio móvil (0 = sin medir)
+  uint32_t loginMs;          // connect() → logresp, promedio móvil
+  uint32_t lastConnectMs;
+  uint32_t lastLoginMs;
+  uint32_t attempts;         // Conexiones iniciadas (cualquier rol)
+  uint32_t failures;         // Conexiones fallidas o sin DNS
+  uint32_t probes;           // Sondeos completos
+  uint32_t sessions;         // Veces que fue la sesión activa
+  uint32_t drops;            // Sesiones perdidas (sin contar cambios planificados)
+  uint32_t failovers;        // Sesiones perdidas cubiertas por la reserva
+  uint64_t uptimeMs;         // Tiempo como sesión activa (sin la actual)
+};
+
+struct PoolStats {
+  uint32_t attempts;
+  uint32_t failures[POOL_STAGE_COUNT];   // Por etapa; IDLE = DNS, READY = reserva caída
+  uint32_t failovers;        // Sesión perdida → reserva entregada
+  uint32_t switches;         // Cambio planificado a un servidor mejor
+  uint32_t coldStarts;       // Sesión nueva sin reserva (conexión completa)
+  uint32_t lastGapMs;        // Sesión perdida → siguiente sesión entregada
+  uint32_t maxGapMs;
+  uint32_t lastFailoverMs;   // Igual, solo cuando la cubrió la reserva
+  uint32_t maxFailoverMs;
+};
+
+class AprsIsPool {
+ public:
+  AprsIsPool();
+
+  void setTimings(const PoolTimings& timings) { timings_ = timings; }
+  void setEventHandler(PoolEventFn fn, void* context);
+  // La sesión inicial se autentica con el filtro; la reserva y los sondeos
+  // sin él (no reciben tráfico) y la reserva lo envía con "#filter" al
+  // entregarse
+  void setLogin(const char* callsign, const char* passcode, const char* software,
+                const char* filter);
+
+  // "host" o "host:puerto"; -1 si no cabe, está mal formado o repetido
+  int    addServer(const char* hostPort, uint16_t defaultPort);
+  size_t serverCount() const { return count_; }
+  const char* host(size_t i) const { return servers_[i].host; }
+  uint16_t    port(size_t i) const { return servers_[i].port; }
+
+  // DNS: servidor que necesita (re)resolver su nombre o -1; setAddress()
+  // con 0 cuenta una falla y aplica la espera
+  int  needsAddress(uint32_t now) const;
+  void setAddress(size_t i, uint32_t address, uint32_t now);   // IPv4, orden de red
+
+  // Avanza las conexiones, elige servidores y lanza sondeos
+  void tick(uint32_t now);
+
+  // Socket de una sesión autenticada (el llamador queda dueño) o -1
+  int  takeSession(uint32_t now);
+  // El llamador cerró la sesión (caída, timeout o switchPending())
+  void sessionClosed(uint32_t now);
+  // La reserva es mejor que la sesión por más de switchMarginMs
+  bool switchPending() const { return switchPending_; }
+  // Cierra reserva, sondeo e intento en curso (WiFi caído)
+  void stop();
+
+  int       active() const { return active_; }
+  int       linkServer(PoolRole role) const { return links_[role].server; }
+  PoolStage linkStage(PoolRole role) const { return links_[role].stage; }
+  uint64_t  uptime(size_t i, uint32_t now) const;   // Incluye la sesión actual
+  const PoolServerStats& serverStats(size_t i) const { return servers_[i].stats; }
+  const PoolStats&       stats() const { return stats_; }
+
+ private:
+  struct Server {
+    char            host[POOL_HOST_LEN + 1];
+    uint16_t        port;
+    uint32_t        address;     // 0 = sin resolver
+    bool            resolve;     // Resolver antes del próximo intento
+    uint32_t        retryAt;
+    uint32_t        backoffMs;
+    uint32_t        probedAt;
+    bool            probed;
+    PoolServerStats stats;
+  };
+
+  struct Link {
+    int       fd;
+    int       server;      // -1 = libre
+    PoolStage stage;
+    bool      filtered;    // El login llevó el filtro
+    uint32_t  started;     // Inicio del intento
+    uint32_t  since;       // Entrada a la etapa
+    uint32_t  lastRx;
+    uint32_t  lastTx;
+    char      line[POOL_LINE_MAX + 1];
+  };
+
+  bool     eligible(int i, uint32_t now) const;
+  int      pick(uint32_t now) const;
+  int      pickProbe(uint32_t now) const;
+  uint32_t score(int i) const;
+  void     backoff(int i, uint32_t now);
+
+  void linkStart(PoolRole role, int server, uint32_t now);
+  void linkTick(PoolRole role, uint32_t now);
+  void linkReady(PoolRole role, uint32_t now);
+  void linkFail(PoolRole role, uint32_t now, const char* reason);
+  void linkClose(PoolRole role);
+  void linkMove(PoolRole from, PoolRole to);
+  int  readLine(Link& link, uint32_t now, size_t& length);
+  bool sendText(Link& link, const char* text, size_t length, uint32_t now);
+  bool sendLogin(PoolRole role, uint32_t now);
+
+  void emit(PoolEventId id, PoolRole role, int server, uint32_t value,
+            const char* text = nullptr, size_t length = 0);
+
+  Server      servers_[POOL_MAX_SERVERS];
+  size_t      count_;
+  Link        links_[POOL_ROLE_COUNT];
+  int         active_;          // Servidor de la sesión entregada (-1 = ninguna)
+  uint32_t    activeSince_;
+  int         lostServer_;      // Servidor de la última sesión perdida
+  uint32_t    lostAt_;
+  bool        switching_;       // La última sesión se cerró por un cambio
+  bool        switchPending_;
+  uint32_t    probeAt_;
+  PoolTimings timings_;
+  PoolStats   stats_;
+  char        login_[POOL_LOGIN_MAX + 1];   // Sin el filtro
+  const char* filter_;
+  PoolEventFn onEvent_;
+  void*       context_;
+  uint32_t    random_;
+};
@@ -0,0 +1,184 @@
+// ============================================================================
+//  Librería: CadScanner
+//  Descripción: Implementación de la política de exploración y del cálculo
+//               del peor caso.
+// ============================================================================
+#include "CadScanner.h"
+
+#include <stdio.h>
+#include <string.h>
+
+CadScanner::CadScanner() {
+  clear();
+}
+
+void CadScanner::clear() {
+  memset(modems_, 0, sizeof(modems_));
+  memset(plans_, 0, sizeof(plans_));
+  memset(&rejected_, 0, sizeof(rejected_));
+  preamble_ = 8;
+  count_ = 0;
+  current_ = 0;
+  currentStart_ = 0;
+  resetStats();
+}
+
+void CadScanner::resetStats() {
+  memset(stats_, 0, sizeof(stats_));
+  memset(lastStart_, 0, sizeof(lastStart_));
+  memset(started_, 0, sizeof(started_));
+}
+
+bool CadScanner::add(const ScanModem& modem) {
+  if (count_ >= SCAN_MAX_MODEMS || modem.spreadingFactor < 7 || modem.spreadingFactor > 12 ||
+      modem.bandwidthHz < 7800 || modem.bandwidthHz > 500000) {
+    return false;
+  }
+  for (size_t i = 0; i < count_; i++) {
+    if (modems_[i].spreadingFactor == modem.spreadingFactor &&
+        modems_[i].bandwidthHz == modem.bandwidthHz) {
+      return false;
+    }
+  }
+  modems_[count_++] = modem;
+  return true;
+}
+
+size_t CadScanner::format(const ScanModem& modem, char* out, size_t size) {
+  unsigned khz = (unsigned)(modem.bandwidthHz / 1000);
+  unsigned tenths = (unsigned)(modem.bandwidthHz % 1000 / 100);
+  int n = tenths ? snprintf(out, size, "SF%u/%u.%u", modem.spreadingFactor, khz, tenths)
+                 : snprintf(out, size, "SF%u/%u", modem.spreadingFactor, khz);
+  return n < 0 ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+}
+
+// ============================================================================
+//  Plan: ventana de cada combinación y simulación de la política de plazos
+//  (la misma de next()) sobre un canal sin recepciones. El preámbulo en el
+//  aire dura preambleSymbols + 4.25 símbolos; un CAD que empieza dentro de
+//  él detecta si termina con SCAN_LOCK_SYMBOLS todavía por delante. La
+//  principal es la del tráfico propio: si la exploración le haría perder
+//  preámbulos, el plan se rechaza y queda recepción continua.
+// ============================================================================
+bool CadScanner::plan(uint16_t preambleSymbols) {
+  preamble_ = preambleSymbols;
+  memset(&rejected_, 0, sizeof(rejected_));
+  simulate();
+  if (count_ < 2 || plans_[0].guaranteed) return true;
+
+  rejected_ = plans_[0];
+  count_ = 1;
+  simulate();
+  return false;
+}
+
+void CadScanner::simulate() {
+  for (size_t i = 0; i < count_; i++) {
+    ScanPlan& p = plans_[i];
+    uint64_t chips = 1ULL << modems_[i].spreadingFactor;
+    p.symbolUs = (uint32_t)(chips * 1000000ULL / modems_[i].bandwidthHz);
+    p.cadUs = (uint32_t)((chips + 32) * 1000000ULL / modems_[i].bandwidthHz) + SCAN_SWITCH_US;
+    int64_t window = (int64_t)(preamble_ * 4 + 17 - SCAN_LOCK_SYMBOLS * 4) * p.symbolUs / 4 -
+                     p.cadUs;
+    p.windowUs = window > 0 ? (uint32_t)window : 0;
+  }
+
+  if (count_ < 2) {   // Recepción continua: sin exploración
+    if (count_ == 1) {
+      ScanPlan& p = plans_[0];
+      p.worstGapUs = p.worstLatencyUs = 0;
+      p.coveragePermille = p.dutyPermille = 1000;
+      p.guaranteed = true;
+    }
+    return;
+  }
+
+  // Régimen permanente: se descarta el arranque (una ventana máxima) y se
+  // miden varias vueltas de la combinación más lenta
+  uint64_t cycle = 0;
+  uint32_t maxWindow = 0;
+  for (size_t i = 0; i < count_; i++) {
+    cycle += plans_[i].cadUs;
+    if (plans_[i].windowUs > maxWindow) maxWindow = plans_[i].windowUs;
+  }
+  const uint64_t warmup = maxWindow + cycle;
+  const uint64_t horizon = warmup + 8 * (maxWindow + cycle);
+
+  uint64_t last[SCAN_MAX_MODEMS] = {};
+  uint64_t gapMax[SCAN_MAX_MODEMS] = {};
+  uint64_t uncovered[SCAN_MAX_MODEMS] = {};
+  uint64_t span[SCAN_MAX_MODEMS] = {};
+  uint64_t busy[SCAN_MAX_MODEMS] = {};
+  uint64_t t = 0;
+  while (t < horizon) {
+    size_t pick = 0;
+    for (size_t i = 1; i < count_; i++) {
+      if (last[i] + plans_[i].windowUs < last[pick] + plans_[pick].windowUs) pick = i;
+    }
+    if (last[pick] >= warmup) {
+      uint64_t gap = t - last[pick];
+      if (gap > gapMax[pick]) gapMax[pick] = gap;
+      if (gap > plans_[pick].windowUs) uncovered[pick] += gap - plans_[pick].windowUs;
+      span[pick] += gap;
+    }
+    last[pick] = t;
+    busy[pick] += plans_[pick].cadUs;
+    t += plans_[pick].cadUs;
+  }
+
+  for (size_t i = 0; i < count_; i++) {
+    ScanPlan& p = plans_[i];
+    p.worstGapUs = (uint32_t)gapMax[i];
+    p.worstLatencyUs = p.worstGapUs + p.cadUs;
+    p.guaranteed = span[i] > 0 && p.worstGapUs <= p.windowUs;
+    p.coveragePermille = span[i] > 0 ? (uint16_t)(1000 - uncovered[i] * 1000 / span[i]) : 0;
+    p.dutyPermille = (uint16_t)(busy[i] * 1000 / t);
+  }
+}
+
+uint32_t CadScanner::worstLatencyUs() const {
+  uint32_t worst = 0;
+  for (size_t i = 0; i < count_; i++) {
+    if (plans_[i].guaranteed && plans_[i].worstLatencyUs > worst) worst = plans_[i].worstLatencyUs;
+  }
+  return worst;
+}
+
+uint32_t CadScanner::lockTimeoutUs(size_t i) const {
+  // Preámbulo (+4.25 de sincronización) y los 8 símbolos de la cabecera
+  return (uint32_t)((uint64_t)(preamble_ * 4 + 17 + 32) * plans_[i].symbolUs / 4);
+}
+
+// ============================================================================
+//  Exploración: plazo más cercano; las nunca exploradas van primero
+// ============================================================================
+size_t CadScanner::next(uint32_t nowUs) {
+  size_t pick = 0;
+  int32_t best = 0;
+  for (size_t i = 0; i < count_; i++) {
+    int32_t slack = started_[i] ? (int32_t)(lastStart_[i] + plans_[i].windowUs - nowUs) : INT32_MIN;
+    if (i == 0 || slack < best) {
+      pick = i;
+      best = slack;
+    }
+  }
+
+  ScanStats& s = stats_[pick];
+  if (started_[pick]) {
+    uint32_t gap = nowUs - lastStart_[pick];
+    if (gap > s.maxGapUs) s.maxGapUs = gap;
+    if (gap > plans_[pick].windowUs) s.missedWindows++;
+  }
+  started_[pick] = true;
+  lastStart_[pick] = nowUs;
+  current_ = pick;
+  currentStart_ = nowUs;
+  return pick;
+}
+
+void CadScanner::cadDone(size_t i, uint32_t nowUs, bool detected) {
+  ScanStats& s = stats_[i];
+  s.cads++;
+  if (i == current_) s.cadTimeUs += nowUs - currentStart_;
+  if (detected) s.detections++;
+}
@@ -0,0 +1,113 @@
+// ============================================================================
+//  Librería: CadScanner
+//  Descripción: Exploración de varias combinaciones SF/BW con CAD (Channel
+//               Activity Detection) del SX1276. Elige la combinación del
+//               siguiente CAD por plazo más cercano: cada una tiene una
+//               ventana (lo que dura su preámbulo menos el CAD y los
+//               símbolos que el receptor necesita para sincronizar) y debe
+//               volver a explorarse antes de que venza. plan() simula esa
+//               misma política para calcular, por combinación, la latencia
+//               de detección en el peor caso y la fracción de preámbulos
+//               que alcanzan a detectarse; en ejecución se cuentan CAD,
+//               detecciones, tramas capturadas y ventanas vencidas. No toca
+//               el radio: quien lo usa configura el módem y corre el CAD.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Parámetros fijados en compilación
+#ifndef SCAN_MAX_MODEMS
+#define SCAN_MAX_MODEMS 4            // La principal y hasta 3 más
+#endif
+#ifndef SCAN_LOCK_SYMBOLS
+#define SCAN_LOCK_SYMBOLS 4          // Preámbulo que debe quedar tras el CAD
+#endif
+#ifndef SCAN_SWITCH_US
+#define SCAN_SWITCH_US 300           // Cambio de SF/BW + arranque del CAD (SPI y PLL)
+#endif
+
+struct ScanModem {
+  uint8_t  spreadingFactor;   // 7..12
+  uint32_t bandwidthHz;
+};
+
+// ============================================================================
+//  Resultado de plan() por combinación
+// ============================================================================
+struct ScanPlan {
+  uint32_t symbolUs;          // Duración de un símbolo
+  uint32_t cadUs;             // CAD más el cambio de módem
+  uint32_t windowUs;          // Separación máxima entre CAD que garantiza detección
+  uint32_t worstGapUs;        // Separación máxima entre CAD con la política de plazos
+  uint32_t worstLatencyUs;    // Inicio del preámbulo → fin del CAD que lo detecta
+  uint16_t coveragePermille;  // Preámbulos detectables (‰), canal sin otras recepciones
+  uint16_t dutyPermille;      // Tiempo de exploración dedicado a esta combinación
+  bool     guaranteed;        // worstGapUs <= windowUs
+};
+
+struct ScanStats {
+  uint32_t cads;
+  uint32_t detections;        // CAD con preámbulo detectado
+  uint32_t frames;            // Tramas recibidas tras una detección
+  uint32_t falseDetections;   // Detección sin cabecera válida a tiempo
+  uint32_t rxErrors;          // Cabecera válida pero sin trama (CRC / timeout)
+  uint32_t missedWindows;     // CAD que empezaron después de vencida la ventana
+  uint32_t maxGapUs;          // Separación máxima medida entre CAD
+  uint64_t cadTimeUs;         // Tiempo total en CAD
+};
+
+class CadScanner {
+ public:
+  CadScanner();
+
+  // La primera combinación es la principal (la de transmisión); false si
+  // no cabe, está repetida o el SF / BW no es válido
+  bool add(const ScanModem& modem);
+  void clear();
+
+  // Calcula ventanas y peor caso para un preámbulo de preambleSymbols. Si
+  // la principal pierde preámbulos (no garantizada) rechaza el plan: quita
+  // las demás, deja recepción continua y devuelve false; rejected() guarda
+  // el plan que tenía la principal
+  bool plan(uint16_t preambleSymbols);
+  const ScanPlan& rejected() const { return rejected_; }
+
+  bool   active() const { return count_ > 1; }   // Con una sola no hay exploración
+  size_t count() const { return count_; }
+  const ScanModem& modem(size_t i) const { return modems_[i]; }
+  const ScanPlan&  planned(size_t i) const { return plans_[i]; }
+  const ScanStats& stats(size_t i) const { return stats_[i]; }
+  uint32_t worstLatencyUs() const;   // Máximo entre las garantizadas
+  // Preámbulo + sincronización + cabecera: si no hay cabecera válida en
+  // ese tiempo desde la detección, fue una detección falsa
+  uint32_t lockTimeoutUs(size_t i) const;
+
+  // Combinación del siguiente CAD (registra su inicio). Las pausas de la
+  // exploración (recepción o transmisión) cuentan en la separación: son
+  // cobertura perdida y aparecen como ventanas vencidas.
+  size_t next(uint32_t nowUs);
+  void   cadDone(size_t i, uint32_t nowUs, bool detected);
+  void   received(size_t i) { stats_[i].frames++; }
+  void   falseDetection(size_t i) { stats_[i].falseDetections++; }
+  void   rxError(size_t i) { stats_[i].rxErrors++; }
+  void   resetStats();
+
+  // "SF12/125" (BW en kHz, con decimales si hace falta: "SF9/62.5")
+  static size_t format(const ScanModem& modem, char* out, size_t size);
+
+ private:
+  void simulate();
+
+  ScanModem modems_[SCAN_MAX_MODEMS];
+  ScanPlan  plans_[SCAN_MAX_MODEMS];
+  ScanStats stats_[SCAN_MAX_MODEMS];
+  ScanPlan  rejected_;
+  uint32_t  lastStart_[SCAN_MAX_MODEMS];
+  bool      started_[SCAN_MAX_MODEMS];
+  uint16_t  preamble_;
+  size_t    count_;
+  size_t    current_;
+  uint32_t  currentStart_;
+};
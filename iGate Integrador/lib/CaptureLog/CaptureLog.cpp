@@ -0,0 +1,148 @@
+// ============================================================================
+//  Librería: CaptureLog
+//  Descripción: Codificación, lotes y lectura de registros de captura.
+// ============================================================================
+#include "CaptureLog.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static_assert(sizeof(CaptureRecordHeader) == 16, "CaptureRecordHeader debe ocupar 16 bytes");
+static_assert(sizeof(CaptureSegmentHeader) == 16, "CaptureSegmentHeader debe ocupar 16 bytes");
+
+const char* const CAPTURE_DIRECTION_NAMES[CAP_DIRECTION_COUNT] = {
+  "rf_rx", "rf_tx", "is_rx"
+};
+
+// Prefijos de la traza de texto por dirección
+static const char* const TRACE_KINDS[CAP_DIRECTION_COUNT] = { "RF", "TX", "IS" };
+
+static uint8_t sum(const uint8_t* data, size_t length, uint8_t acc) {
+  for (size_t i = 0; i < length; i++) acc = (uint8_t)(acc + data[i]);
+  return acc;
+}
+
+static uint8_t checksum(const CaptureRecordHeader& h, const void* data) {
+  CaptureRecordHeader copy = h;
+  copy.check = 0;
+  uint8_t acc = sum((const uint8_t*)&copy, sizeof(copy), 0);
+  return (uint8_t)~sum((const uint8_t*)data, h.length, acc);
+}
+
+size_t captureEncode(const CaptureRecord& record, uint8_t* out, size_t room) {
+  if (record.length > CAPTURE_MAX_DATA || record.direction >= CAP_DIRECTION_COUNT) return 0;
+  size_t bytes = captureRecordBytes(record.length);
+  if (bytes > room) return 0;
+
+  CaptureRecordHeader h;
+  h.length = record.length;
+  h.direction = record.direction;
+  h.spreadingFactor = record.spreadingFactor;
+  h.timeMs = record.timeMs;
+  h.frequencyHz = record.frequencyHz;
+  h.rssi = record.rssi;
+  float q = roundf(record.snr * 4.0f);
+  h.snrQ4 = (int8_t)(q > 127 ? 127 : (q < -128 ? -128 : q));
+  h.check = checksum(h, record.data);
+
+  memcpy(out, &h, sizeof(h));
+  memcpy(out + sizeof(h), record.data, record.length);
+  return bytes;
+}
+
+void captureSegmentHeader(CaptureSegmentHeader& header, uint32_t sequence, uint32_t startMs) {
+  header.magic = CAPTURE_MAGIC;
+  header.version = CAPTURE_VERSION;
+  header.headerBytes = sizeof(CaptureSegmentHeader);
+  header.sequence = sequence;
+  header.startMs = startMs;
+}
+
+bool captureSegmentValid(const CaptureSegmentHeader& header) {
+  return header.magic == CAPTURE_MAGIC && header.version == CAPTURE_VERSION &&
+         header.headerBytes == sizeof(CaptureSegmentHeader);
+}
+
+bool captureDecodeHeader(const uint8_t* in, CaptureRecord& record) {
+  CaptureRecordHeader h;
+  memcpy(&h, in, sizeof(h));
+  if (h.length > CAPTURE_MAX_DATA || h.direction >= CAP_DIRECTION_COUNT) return false;
+  record.timeMs = h.timeMs;
+  record.frequencyHz = h.frequencyHz;
+  record.rssi = h.rssi;
+  record.snr = h.snrQ4 / 4.0f;
+  record.direction = h.direction;
+  record.spreadingFactor = h.spreadingFactor;
+  record.length = h.length;
+  record.data = nullptr;
+  return true;
+}
+
+bool captureVerify(const uint8_t* header, const CaptureRecord& record) {
+  CaptureRecordHeader h;
+  memcpy(&h, header, sizeof(h));
+  return h.check == checksum(h, record.data);
+}
+
+size_t captureFormatTrace(const CaptureRecord& record, uint32_t offsetMs, char* out, size_t size) {
+  if (size == 0) return 0;
+  const char* kind = record.direction < CAP_DIRECTION_COUNT ? TRACE_KINDS[record.direction] : "??";
+  unsigned long ms = (unsigned long)offsetMs + record.timeMs;
+  int n = record.direction == CAP_RF_RX
+              ? snprintf(out, size, "%lu %s %d %.2f ", ms, kind, record.rssi, record.snr)
+              : snprintf(out, size, "%lu %s ", ms, kind);
+  if (n < 0) return 0;
+  size_t used = (size_t)n < size ? (size_t)n : size - 1;
+
+  // Los bytes de control (fin de línea incluido) romperían la traza de texto
+  for (size_t i = 0; i < record.length && used + 1 < size; i++) {
+    char c = record.data[i];
+    out[used++] = (c == '\r' || c == '\n' || c == '\0') ? ' ' : c;
+  }
+  out[used] = '\0';
+  return used;
+}
+
+// ============================================================================
+//  Lote
+// ============================================================================
+void CaptureBatch::clear() {
+  used_ = 0;
+  records_ = 0;
+  oldestMs_ = 0;
+}
+
+bool CaptureBatch::add(const CaptureRecord& record) {
+  size_t n = captureEncode(record, buf_ + used_, sizeof(buf_) - used_);
+  if (n == 0) return false;
+  if (records_ == 0) oldestMs_ = record.timeMs;
+  used_ += n;
+  records_++;
+  return true;
+}
+
+// ============================================================================
+//  Lector
+// ============================================================================
+CaptureReader::CaptureReader(const uint8_t* data, size_t length)
+    : data_(data), length_(length), offset_(0), valid_(false) {
+  memset(&header_, 0, sizeof(header_));
+  if (length < sizeof(header_)) return;
+  memcpy(&header_, data, sizeof(header_));
+  valid_ = captureSegmentValid(header_);
+  offset_ = sizeof(header_);
+}
+
+CaptureReadResult CaptureReader::next(CaptureRecord& record) {
+  if (!valid_ || offset_ >= length_) return CAPTURE_READ_END;
+  const uint8_t* header = data_ + offset_;
+  if (length_ - offset_ < sizeof(CaptureRecordHeader) || !captureDecodeHeader(header, record) ||
+      length_ - offset_ < captureRecordBytes(record.length)) {
+    return CAPTURE_READ_TORN;
+  }
+  record.data = (const char*)header + sizeof(CaptureRecordHeader);
+  if (!captureVerify(header, record)) return CAPTURE_READ_TORN;
+  offset_ += captureRecordBytes(record.length);
+  return CAPTURE_READ_OK;
+}
@@ -0,0 +1,143 @@
+// ============================================================================
+//  Librería: CaptureLog
+//  Descripción: Formato binario de la captura de tráfico en LittleFS. Cada
+//               segmento empieza con una cabecera (número de secuencia) y
+//               sigue con registros de solo anexado con prefijo de longitud:
+//               una cabecera fija de 16 bytes (instante, RSSI, SNR,
+//               frecuencia, SF y dirección) y los bytes de la trama tal como
+//               llegaron. La suma de verificación de cada registro detecta
+//               una escritura cortada por un reinicio: la lectura se detiene
+//               ahí y el resto del segmento se da por perdido.
+//               CaptureBatch arma los registros en un buffer fijo para que
+//               la flash se escriba por lotes; CaptureReader los recorre
+//               desde memoria (herramienta de reproducción en el PC).
+//               No toca el sistema de archivos ni reserva memoria.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef CAPTURE_BATCH_BYTES
+#define CAPTURE_BATCH_BYTES 4096     // Un bloque de LittleFS por escritura
+#endif
+#ifndef CAPTURE_MAX_DATA
+#define CAPTURE_MAX_DATA 512         // Trama o línea APRS-IS más larga
+#endif
+
+#define CAPTURE_MAGIC   0x50414349UL   // "ICAP"
+#define CAPTURE_VERSION 1
+
+enum CaptureDirection : uint8_t {
+  CAP_RF_RX,    // Trama recibida por LoRa (antes de duplicados y filtros)
+  CAP_RF_TX,    // Trama transmitida (digipeat, mensaje APRS-IS → RF o beacon)
+  CAP_IS_RX,    // Línea recibida de APRS-IS
+  CAP_DIRECTION_COUNT
+};
+
+extern const char* const CAPTURE_DIRECTION_NAMES[CAP_DIRECTION_COUNT];
+
+// Cabecera de cada segmento
+struct CaptureSegmentHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerBytes;   // sizeof(CaptureSegmentHeader)
+  uint32_t sequence;      // Creciente: ordena los segmentos al exportar
+  uint32_t startMs;       // millis() al abrir el segmento
+};
+
+// Cabecera de cada registro en flash (seguida de length bytes)
+struct CaptureRecordHeader {
+  uint16_t length;
+  uint8_t  direction;
+  uint8_t  spreadingFactor;   // 0 en APRS-IS
+  uint32_t timeMs;            // millis() del arranque
+  uint32_t frequencyHz;       // 0 en APRS-IS
+  int16_t  rssi;              // dBm
+  int8_t   snrQ4;             // SNR en cuartos de dB (resolución del SX1276)
+  uint8_t  check;             // Suma de la cabecera y los datos (complemento)
+};
+
+// Registro decodificado (data apunta al buffer de origen)
+struct CaptureRecord {
+  uint32_t    timeMs;
+  uint32_t    frequencyHz;
+  int16_t     rssi;
+  float       snr;
+  uint8_t     direction;
+  uint8_t     spreadingFactor;
+  uint16_t    length;
+  const char* data;
+};
+
+// Bytes que ocupa un registro de 'length' bytes de datos
+inline size_t captureRecordBytes(size_t length) { return sizeof(CaptureRecordHeader) + length; }
+
+// Codifica un registro; devuelve los bytes escritos o 0 si no cabe en 'room'
+size_t captureEncode(const CaptureRecord& record, uint8_t* out, size_t room);
+
+// Cabecera de segmento lista para escribir / verificación al leerla
+void captureSegmentHeader(CaptureSegmentHeader& header, uint32_t sequence, uint32_t startMs);
+bool captureSegmentValid(const CaptureSegmentHeader& header);
+
+// Decodifica la cabecera de 'in' y completa 'record' sin datos; false si la
+// cabecera no es válida (longitud o dirección imposibles)
+bool captureDecodeHeader(const uint8_t* in, CaptureRecord& record);
+// Verifica la suma con los datos ya leídos (data apunta a length bytes)
+bool captureVerify(const uint8_t* header, const CaptureRecord& record);
+
+// Línea de traza de texto, el formato de bench/replay_bench.cpp:
+//   <ms> RF <rssi> <snr> <trama>    <ms> IS <línea>
+//   <ms> TX <trama>                 (la reproducción la ignora)
+size_t captureFormatTrace(const CaptureRecord& record, uint32_t offsetMs, char* out, size_t size);
+
+// ============================================================================
+//  Lote de registros para una sola escritura
+// ============================================================================
+class CaptureBatch {
+ public:
+  CaptureBatch() { clear(); }
+
+  // false si el registro no cabe en lo que queda del lote
+  bool add(const CaptureRecord& record);
+  bool fits(size_t length) const { return used_ + captureRecordBytes(length) <= sizeof(buf_); }
+  void clear();
+
+  const uint8_t* data() const { return buf_; }
+  size_t   size() const { return used_; }
+  uint32_t records() const { return records_; }
+  uint32_t oldestMs() const { return oldestMs_; }   // Instante del primer registro
+  bool     empty() const { return records_ == 0; }
+
+ private:
+  uint8_t  buf_[CAPTURE_BATCH_BYTES];
+  size_t   used_;
+  uint32_t records_;
+  uint32_t oldestMs_;
+};
+
+// ============================================================================
+//  Lectura de un segmento completo en memoria
+// ============================================================================
+enum CaptureReadResult : uint8_t {
+  CAPTURE_READ_OK,
+  CAPTURE_READ_END,       // Fin del segmento
+  CAPTURE_READ_TORN,      // Registro cortado o con suma inválida: fin de lo legible
+};
+
+class CaptureReader {
+ public:
+  CaptureReader(const uint8_t* data, size_t length);
+
+  bool valid() const { return valid_; }   // Cabecera de segmento correcta
+  const CaptureSegmentHeader& header() const { return header_; }
+  CaptureReadResult next(CaptureRecord& record);
+  size_t offset() const { return offset_; }
+
+ private:
+  const uint8_t*       data_;
+  size_t               length_;
+  size_t               offset_;
+  bool                 valid_;
+  CaptureSegmentHeader header_;
+};
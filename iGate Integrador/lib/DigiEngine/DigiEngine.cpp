@@ -0,0 +1,234 @@
+// ============================================================================
+//  Librería: DigiEngine
+//  Descripción: Implementación del motor de reglas del digipeater.
+// ============================================================================
+#include "DigiEngine.h"
+
+#include <string.h>
+
+const char* const DIGI_RULE_NAMES[] = { "propio", "fill-in", "WIDEn-N" };
+
+// Escritor acotado sobre el buffer de salida; marca desbordamiento
+struct FrameWriter {
+  char*  out;
+  size_t size;
+  size_t pos;
+  bool   overflow;
+
+  void put(const char* p, size_t len) {
+    if (pos + len > size) { overflow = true; return; }
+    memcpy(out + pos, p, len);
+    pos += len;
+  }
+  void put(char c) { put(&c, 1); }
+};
+
+static bool slotIs(const char* frame, const DigiPathSlot& s, const char* text) {
+  size_t n = strlen(text);
+  return s.length == n && memcmp(frame + s.offset, text, n) == 0;
+}
+
+// ============================================================================
+//  Separación del path en una pasada
+// ============================================================================
+bool tokenizeDigiPath(const AX25Packet& ax, DigiPath& path) {
+  path.count = 0;
+  path.firstUnused = 0;
+
+  const char* p = ax.data(ax.path);
+  size_t len = ax.path.length;
+  size_t start = 0;
+  int lastUsed = -1;
+
+  while (start < len) {
+    const char* comma = (const char*)memchr(p + start, ',', len - start);
+    size_t end = comma ? (size_t)(comma - p) : len;
+    size_t fieldLen = end - start;
+    if (fieldLen == 0 || fieldLen > DIGI_CALL_LEN + 1 || path.count >= DIGI_MAX_PATH) return false;
+
+    DigiPathSlot& s = path.slots[path.count];
+    bool star = p[end - 1] == '*';
+    if (star) fieldLen--;
+    if (fieldLen == 0) return false;
+
+    s.offset = (uint16_t)(ax.path.offset + start);
+    s.length = (uint8_t)fieldLen;
+    s.aliasLength = s.length;
+    s.ssid = 0;
+    const char* dash = (const char*)memchr(p + start, '-', fieldLen);
+    if (dash != nullptr) {
+      s.aliasLength = (uint8_t)(dash - (p + start));
+      unsigned ssid = 0;
+      for (const char* d = dash + 1; d < p + start + fieldLen; d++) {
+        if (*d < '0' || *d > '9') { ssid = 0xFF; break; }
+        ssid = ssid * 10 + (unsigned)(*d - '0');
+      }
+      s.ssid = ssid > 15 ? 0xFF : (uint8_t)ssid;  // 0xFF: SSID no numérico
+    }
+    if (star) lastUsed = path.count;
+    path.count++;
+    start = end + 1;
+  }
+
+  for (uint8_t i = 0; i < path.count; i++) path.slots[i].used = (int)i <= lastUsed;
+  path.firstUnused = (uint8_t)(lastUsed + 1);
+  return true;
+}
+
+// ============================================================================
+//  Compilación de reglas
+// ============================================================================
+DigiEngine::DigiEngine() : ruleCount_(0), mycallLength_(0) {
+  mycall_[0] = '\0';
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+bool DigiEngine::compile(const DigiConfig& config, const char* mycall) {
+  ruleCount_ = 0;
+  size_t n = strlen(mycall);
+  if (n == 0 || n > DIGI_CALL_LEN) return false;
+  for (size_t i = 0; i < n; i++) {
+    char c = mycall[i];
+    mycall_[i] = (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+  }
+  mycall_[n] = '\0';
+  mycallLength_ = (uint8_t)n;
+
+  // Orden de evaluación: la ruta explícita gana sobre los alias
+  if (config.ownCall) rules_[ruleCount_++] = DigiRule{ DIGI_RULE_OWN_CALL, 0, 0 };
+  if (config.fillIn)  rules_[ruleCount_++] = DigiRule{ DIGI_RULE_FILL_IN, 1, config.viscousDelayMs };
+  if (config.wideMaxHops > 0) {
+    uint8_t hops = config.wideMaxHops > 7 ? 7 : config.wideMaxHops;
+    rules_[ruleCount_++] = DigiRule{ DIGI_RULE_WIDE_N, hops, config.viscousDelayMs };
+  }
+  return true;
+}
+
+bool DigiEngine::isMycall(const char* p, size_t length) const {
+  if (length != mycallLength_) return false;
+  for (size_t i = 0; i < length; i++) {
+    char c = p[i];
+    if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+    if (c != mycall_[i]) return false;
+  }
+  return true;
+}
+
+// ============================================================================
+//  Función: process()
+//  Descripción: Solo se mira el primer elemento sin usar del path. La trama
+//               de salida conserva los elementos ya usados (con un único '*'
+//               en el último, como en TNC2) y reemplaza el elemento aplicado:
+//                 MYCALL   → MYCALL*
+//                 WIDE1-1  → MYCALL,WIDE1*
+//                 WIDEn-N  → MYCALL*,WIDEn-(N-1)   /   MYCALL,WIDEn* si N = 1
+// ============================================================================
+DigiDecision DigiEngine::process(const AX25Packet& ax, char* out, size_t outSize) {
+  DigiDecision d = { 0, 0, -1 };
+  stats_.evaluated++;
+
+  DigiPath path;
+  if (!ax.valid || ruleCount_ == 0 || !tokenizeDigiPath(ax, path)) {
+    stats_.invalid++;
+    return d;
+  }
+  if (isMycall(ax.data(ax.source), ax.source.length)) {
+    stats_.loop++;
+    return d;
+  }
+
+  const char* raw = ax.raw;
+  for (uint8_t i = 0; i < path.count; i++) {
+    const DigiPathSlot& s = path.slots[i];
+    if (slotIs(raw, s, "TCPIP") || slotIs(raw, s, "TCPXX") ||
+        slotIs(raw, s, "NOGATE") || slotIs(raw, s, "RFONLY")) {
+      stats_.blocked++;
+      return d;
+    }
+    if (s.used && isMycall(raw + s.offset, s.length)) {
+      stats_.loop++;
+      return d;
+    }
+  }
+  if (path.firstUnused >= path.count) {
+    stats_.noRule++;
+    return d;
+  }
+
+  // Primer elemento sin usar frente a la tabla de reglas
+  const DigiPathSlot& next = path.slots[path.firstUnused];
+  const char* field = raw + next.offset;
+  bool isWide = next.aliasLength == 5 && memcmp(field, "WIDE", 4) == 0 &&
+                field[4] >= '1' && field[4] <= '7' && next.ssid != 0xFF;
+  uint8_t wideN = isWide ? (uint8_t)(field[4] - '0') : 0;
+
+  int8_t applied = -1;
+  for (uint8_t r = 0; r < ruleCount_ && applied < 0; r++) {
+    const DigiRule& rule = rules_[r];
+    switch (rule.type) {
+      case DIGI_RULE_OWN_CALL:
+        if (isMycall(field, next.length)) applied = (int8_t)r;
+        break;
+      case DIGI_RULE_FILL_IN:
+        if (isWide && wideN == 1 && next.ssid == 1) applied = (int8_t)r;
+        break;
+      case DIGI_RULE_WIDE_N:
+        if (!isWide || next.ssid == 0 || next.ssid > wideN) break;
+        if (wideN > rule.maxHops) {
+          stats_.hopCapped++;
+          return d;
+        }
+        applied = (int8_t)r;
+        break;
+    }
+  }
+  if (applied < 0) {
+    stats_.noRule++;
+    return d;
+  }
+
+  // Escritura de la trama digipeada
+  FrameWriter w{out, outSize, 0, false};
+  w.put(ax.data(ax.source), ax.source.length);
+  w.put('>');
+  w.put(ax.data(ax.destination), ax.destination.length);
+
+  for (uint8_t i = 0; i < path.count; i++) {
+    const DigiPathSlot& s = path.slots[i];
+    w.put(',');
+    if (i != path.firstUnused) {         // Los usados van sin '*': lo lleva el nuestro
+      w.put(raw + s.offset, s.length);
+      continue;
+    }
+
+    w.put(mycall_, mycallLength_);
+    if (rules_[applied].type == DIGI_RULE_OWN_CALL) {
+      w.put('*');
+      continue;
+    }
+
+    uint8_t remaining = (uint8_t)(s.ssid - 1);
+    if (remaining > 0) w.put('*');
+    w.put(',');
+    w.put(raw + s.offset, s.aliasLength);   // WIDEn
+    if (remaining == 0) {
+      w.put('*');                            // Alias agotado: último usado
+    } else {
+      w.put('-');
+      w.put((char)('0' + remaining));
+    }
+  }
+  w.put(':');
+  w.put(ax.data(ax.info), ax.info.length);
+
+  if (w.overflow) {
+    stats_.invalid++;
+    return d;
+  }
+
+  stats_.matched[applied]++;
+  d.length = w.pos;
+  d.delayMs = rules_[applied].delayMs;
+  d.rule = applied;
+  return d;
+}
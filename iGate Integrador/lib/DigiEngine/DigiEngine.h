@@ -0,0 +1,112 @@
+// ============================================================================
+//  Librería: DigiEngine
+//  Descripción: Motor de reglas del digipeater. El path se separa una sola
+//               vez en ranuras fijas y se evalúa contra una tabla de reglas
+//               compilada al arranque desde la configuración:
+//                 - indicativo propio (ruta explícita, sin demora)
+//                 - fill-in WIDE1-1
+//                 - WIDEn-N con límite de saltos
+//               Cualquiera de las dos últimas puede llevar demora viscosa:
+//               quien llama retiene la trama y la cancela si escucha que
+//               otro digipeater la repitió antes. Sin memoria dinámica.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AX25.h>
+
+// Parámetros fijados en compilación
+#ifndef DIGI_MAX_PATH
+#define DIGI_MAX_PATH 8             // Elementos del path (AX.25 admite 8)
+#endif
+#define DIGI_MAX_RULES 4
+#define DIGI_CALL_LEN  9            // CALL-SSID
+
+// ============================================================================
+//  Configuración de la que se compilan las reglas
+// ============================================================================
+struct DigiConfig {
+  bool     ownCall;         // Digipear tramas con nuestro indicativo en el path
+  bool     fillIn;          // WIDE1-1 (fill-in)
+  uint8_t  wideMaxHops;     // WIDEn-N con n <= wideMaxHops (0 = desactivado)
+  uint32_t viscousDelayMs;  // Demora de fill-in / WIDEn-N (0 = inmediato)
+};
+
+enum DigiRuleType : uint8_t {
+  DIGI_RULE_OWN_CALL,
+  DIGI_RULE_FILL_IN,
+  DIGI_RULE_WIDE_N,
+};
+
+extern const char* const DIGI_RULE_NAMES[];
+
+struct DigiRule {
+  DigiRuleType type;
+  uint8_t      maxHops;     // Solo WIDEn-N
+  uint32_t     delayMs;
+};
+
+// ============================================================================
+//  Path separado en ranuras (vistas sobre la trama)
+// ============================================================================
+struct DigiPathSlot {
+  uint16_t offset;      // Dentro de la trama
+  uint8_t  length;      // Sin el '*'
+  uint8_t  aliasLength; // Hasta el '-' (o length si no hay SSID)
+  uint8_t  ssid;        // 0 si no hay
+  bool     used;        // Ya digipeado (hasta el último '*')
+};
+
+struct DigiPath {
+  uint8_t      count;
+  uint8_t      firstUnused;  // count si todos están usados
+  DigiPathSlot slots[DIGI_MAX_PATH];
+};
+
+// Separa el path; false si tiene más de DIGI_MAX_PATH elementos o alguno vacío
+bool tokenizeDigiPath(const AX25Packet& ax, DigiPath& path);
+
+// ============================================================================
+//  Resultado de la evaluación
+// ============================================================================
+struct DigiDecision {
+  size_t   length;   // Bytes escritos en 'out' (0 = no se digipea)
+  uint32_t delayMs;  // Demora viscosa antes de transmitir
+  int8_t   rule;     // Índice de la regla aplicada (-1 = ninguna)
+};
+
+struct DigiStats {
+  uint32_t evaluated;
+  uint32_t matched[DIGI_MAX_RULES];
+  uint32_t noRule;      // Path sin elemento aplicable
+  uint32_t blocked;     // TCPIP / TCPXX / NOGATE / RFONLY
+  uint32_t loop;        // Nuestro indicativo ya usado en el path
+  uint32_t hopCapped;   // WIDEn-N con n por encima del límite
+  uint32_t invalid;     // Trama o path mal formados, o salida sin espacio
+};
+
+class DigiEngine {
+ public:
+  DigiEngine();
+
+  // Compila las reglas (en orden de evaluación); false si mycall no es válido
+  bool compile(const DigiConfig& config, const char* mycall);
+
+  // Evalúa la trama y, si alguna regla aplica, escribe la trama digipeada
+  DigiDecision process(const AX25Packet& ax, char* out, size_t outSize);
+
+  uint8_t ruleCount() const { return ruleCount_; }
+  const DigiRule& rule(uint8_t i) const { return rules_[i]; }
+  const DigiStats& stats() const { return stats_; }
+
+ private:
+  bool isMycall(const char* p, size_t length) const;
+
+  DigiRule  rules_[DIGI_MAX_RULES];
+  uint8_t   ruleCount_;
+  char      mycall_[DIGI_CALL_LEN + 1];  // En mayúsculas
+  uint8_t   mycallLength_;
+  DigiStats stats_;
+};
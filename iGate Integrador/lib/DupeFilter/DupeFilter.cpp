@@ -0,0 +1,99 @@
+// ============================================================================
+//  Librería: DupeFilter
+//  Descripción: Implementación de la tabla de duplicados.
+// ============================================================================
+#include "DupeFilter.h"
+
+#include <string.h>
+
+static const uint32_t FNV_OFFSET = 2166136261UL;
+static const uint32_t FNV_PRIME  = 16777619UL;
+
+static uint32_t fnv1a(uint32_t h, const char* p, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)p[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+// ============================================================================
+//  Hash del contenido del paquete (sin path). Si la trama no pudo
+//  decodificarse, 'info' contiene la trama completa.
+// ============================================================================
+uint32_t dupeHash(const AX25Packet& ax) {
+  static const char SEP = '\0';
+  uint32_t h = FNV_OFFSET;
+  h = fnv1a(h, ax.data(ax.source), ax.source.length);
+  h = fnv1a(h, &SEP, 1);
+  h = fnv1a(h, ax.data(ax.destination), ax.destination.length);
+  h = fnv1a(h, &SEP, 1);
+  h = fnv1a(h, ax.data(ax.info), ax.info.length);
+  return h ? h : 1;  // 0 está reservado para entradas libres
+}
+
+DupeFilter::DupeFilter() { clear(); }
+
+void DupeFilter::clear() {
+  memset(table_, 0, sizeof(table_));
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+bool DupeFilter::check(const AX25Packet& ax, uint32_t nowMs) {
+  return checkHash(dupeHash(ax), nowMs);
+}
+
+// ============================================================================
+//  Búsqueda + inserción en una sola pasada sobre una ventana de sondeo fija.
+//  Las entradas nunca vuelven a quedar libres (solo caducan), por lo que la
+//  búsqueda puede detenerse en la primera entrada libre.
+// ============================================================================
+bool DupeFilter::checkHash(uint32_t hash, uint32_t nowMs) {
+  const uint32_t mask = DUP_TABLE_SIZE - 1;
+  uint32_t nowBucket = bucketOf(nowMs);
+  int freeSlot = -1;
+  int oldest = -1;
+
+  for (uint32_t i = 0; i < DUP_MAX_PROBE; i++) {
+    uint32_t idx = (hash + i) & mask;
+    Entry& e = table_[idx];
+
+    if (e.hash == 0) {
+      if (freeSlot < 0) freeSlot = (int)idx;
+      break;
+    }
+    if (expired(e, nowBucket)) {
+      if (freeSlot < 0) freeSlot = (int)idx;
+      continue;
+    }
+    if (e.hash == hash) {
+      stats_.hits++;
+      return true;  // Duplicado detectado
+    }
+    if (oldest < 0 || nowBucket - e.bucket > nowBucket - table_[oldest].bucket)
+      oldest = (int)idx;
+  }
+
+  // Insertar nuevo hash: primero huecos libres o caducados, si no el más viejo
+  int slot = freeSlot;
+  if (slot < 0) {
+    slot = oldest;
+    stats_.evictions++;
+  } else if (table_[slot].hash != 0) {
+    stats_.reused++;
+  }
+
+  table_[slot].hash = hash;
+  table_[slot].bucket = nowBucket;
+  stats_.misses++;
+  return false;
+}
+
+uint16_t DupeFilter::liveEntries(uint32_t nowMs) const {
+  uint32_t nowBucket = bucketOf(nowMs);
+  uint16_t count = 0;
+  for (uint32_t i = 0; i < DUP_TABLE_SIZE; i++) {
+    if (table_[i].hash != 0 && !expired(table_[i], nowBucket)) count++;
+  }
+  return count;
+}
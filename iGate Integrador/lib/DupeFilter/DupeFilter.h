@@ -0,0 +1,76 @@
+// ============================================================================
+//  Librería: DupeFilter
+//  Descripción: Tabla de supresión de duplicados de capacidad fija con
+//               direccionamiento abierto. La clave es un hash FNV-1a de
+//               origen + destino + info (se ignora el path, que cambian los
+//               digipeaters). Las entradas envejecen por intervalos de tiempo
+//               y la tabla nunca reserva memoria dinámica.
+// ============================================================================
+#pragma once
+
+#include <stdint.h>
+
+#include <AX25.h>
+
+// Parámetros fijados en compilación (ver build_flags en platformio.ini)
+#ifndef DUP_TABLE_SIZE
+#define DUP_TABLE_SIZE 64        // Entradas de la tabla (potencia de 2)
+#endif
+#ifndef DUP_TIMEOUT
+#define DUP_TIMEOUT 30000UL      // Ventana de duplicados en ms
+#endif
+#ifndef DUP_BUCKET_MS
+#define DUP_BUCKET_MS 1000UL     // Resolución del envejecimiento en ms
+#endif
+#ifndef DUP_MAX_PROBE
+#define DUP_MAX_PROBE 8          // Sondeos máximos por búsqueda (O(1))
+#endif
+
+static_assert((DUP_TABLE_SIZE & (DUP_TABLE_SIZE - 1)) == 0,
+              "DUP_TABLE_SIZE debe ser potencia de 2");
+static_assert(DUP_MAX_PROBE <= DUP_TABLE_SIZE,
+              "DUP_MAX_PROBE no puede superar DUP_TABLE_SIZE");
+
+// ============================================================================
+//  Contadores de la tabla
+// ============================================================================
+struct DupeStats {
+  uint32_t hits;       // Duplicados detectados
+  uint32_t misses;     // Paquetes nuevos insertados
+  uint32_t evictions;  // Entradas vigentes desplazadas por falta de espacio
+  uint32_t reused;     // Entradas caducadas reutilizadas
+};
+
+// ============================================================================
+//  Función: dupeHash()
+//  Descripción: Hash FNV-1a de 32 bits sobre origen, destino e info.
+// ============================================================================
+uint32_t dupeHash(const AX25Packet& ax);
+
+class DupeFilter {
+ public:
+  DupeFilter();
+
+  // Devuelve true si el paquete ya se vio dentro de DUP_TIMEOUT; si no,
+  // lo registra y devuelve false.
+  bool check(const AX25Packet& ax, uint32_t nowMs);
+  bool checkHash(uint32_t hash, uint32_t nowMs);
+
+  const DupeStats& stats() const { return stats_; }
+  uint16_t liveEntries(uint32_t nowMs) const;
+  void clear();
+
+ private:
+  struct Entry {
+    uint32_t hash;    // 0 = libre (nunca usado)
+    uint32_t bucket;  // Intervalo de tiempo en que se registró
+  };
+
+  static uint32_t bucketOf(uint32_t nowMs) { return nowMs / DUP_BUCKET_MS; }
+  static bool expired(const Entry& e, uint32_t nowBucket) {
+    return nowBucket - e.bucket >= (DUP_TIMEOUT + DUP_BUCKET_MS - 1) / DUP_BUCKET_MS;
+  }
+
+  Entry     table_[DUP_TABLE_SIZE];
+  DupeStats stats_;
+};
@@ -0,0 +1,189 @@
+// ============================================================================
+//  Librería: EventLog
+//  Descripción: Implementación de la cola de eventos y del formato diferido.
+// ============================================================================
+#include "EventLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+const char* const LOG_LEVEL_NAMES[LOG_LEVEL_COUNT] = { "debug", "info", "warn", "error" };
+
+EventLog::EventLog(const LogEventDef* defs, size_t count, LogLevel level)
+    : defs_(defs), count_(count), level_(level), enqueuePos_(0), dequeuePos_(0),
+      highWater_(0), recorded_(0), dropped_(0), filtered_(0), truncated_(0) {
+  for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+// ============================================================================
+//  Función: log()
+//  Descripción: Reserva una celda con compare-and-swap sobre la posición de
+//               escritura, copia el evento y lo publica avanzando la
+//               secuencia de la celda. Nunca espera: con la cola llena el
+//               evento se cuenta como descartado.
+// ============================================================================
+bool EventLog::log(uint16_t id, const char* payload, size_t length,
+                   std::initializer_list<LogArg> args, uint32_t nowMs) {
+  if (id >= count_) return false;
+  if (defs_[id].level < level_.load(std::memory_order_relaxed)) {
+    filtered_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  Cell* cell;
+  uint32_t pos = enqueuePos_.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &cells_[pos & (LOG_RING_SIZE - 1)];
+    uint32_t seq = cell->sequence.load(std::memory_order_acquire);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = enqueuePos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  LogRecord& r = cell->record;
+  r.timeMs = nowMs;
+  r.id = id;
+  size_t n = 0;
+  for (const LogArg& a : args) {
+    if (n == LOG_MAX_ARGS) break;
+    r.args[n++] = a;
+  }
+  r.truncated = length > LOG_PAYLOAD_MAX;
+  r.payloadLength = (uint16_t)(r.truncated ? LOG_PAYLOAD_MAX : length);
+  if (r.payloadLength > 0) memcpy(r.payload, payload, r.payloadLength);
+  if (r.truncated) truncated_.fetch_add(1, std::memory_order_relaxed);
+
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  recorded_.fetch_add(1, std::memory_order_relaxed);
+
+  // Productores de ambos núcleos compiten: solo se escribe si es mayor
+  uint32_t used = pos + 1 - dequeuePos_.load(std::memory_order_relaxed);
+  uint32_t high = highWater_.load(std::memory_order_relaxed);
+  while (used > high &&
+         !highWater_.compare_exchange_weak(high, used, std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+bool EventLog::pop(LogRecord& record) {
+  uint32_t pos = dequeuePos_.load(std::memory_order_relaxed);
+  Cell& cell = cells_[pos & (LOG_RING_SIZE - 1)];
+  if (cell.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+
+  // Solo se copia la parte usada de la trama
+  const LogRecord& r = cell.record;
+  record.timeMs = r.timeMs;
+  record.id = r.id;
+  record.payloadLength = r.payloadLength;
+  record.truncated = r.truncated;
+  memcpy(record.args, r.args, sizeof(record.args));
+  memcpy(record.payload, r.payload, r.payloadLength);
+
+  cell.sequence.store(pos + LOG_RING_SIZE, std::memory_order_release);
+  dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+  return true;
+}
+
+// ============================================================================
+//  Función: format()
+//  Descripción: Recorre el formato del evento y resuelve cada conversión
+//               por separado con snprintf, usando el miembro de LogArg que
+//               corresponde al tipo de la conversión.
+// ============================================================================
+size_t EventLog::format(const LogRecord& record, char* out, size_t outSize) const {
+  if (outSize == 0) return 0;
+  size_t pos = 0;
+  auto room = [&]() -> size_t { return pos < outSize ? outSize - pos : 0; };
+  auto advance = [&](int written) {
+    if (written > 0) pos += (size_t)written;
+    if (pos >= outSize) pos = outSize - 1;
+  };
+
+  const char* f = record.id < count_ ? defs_[record.id].format : "evento %u";
+  LogArg unknown[1] = { LogArg((unsigned)record.id) };
+  const LogArg* args = record.id < count_ ? record.args : unknown;
+  size_t argCount = record.id < count_ ? LOG_MAX_ARGS : 1;
+  size_t next = 0;
+
+  while (*f != '\0' && room() > 1) {
+    if (*f != '%') {
+      out[pos++] = *f++;
+      continue;
+    }
+    if (f[1] == '%') {
+      out[pos++] = '%';
+      f += 2;
+      continue;
+    }
+
+    // Especificación sin modificadores de longitud: se agrega 'l' para enteros
+    char spec[16];
+    size_t n = 0;
+    spec[n++] = *f++;
+    while (*f != '\0' && strchr("-+ #0123456789.lh", *f) != nullptr) {
+      if (*f != 'l' && *f != 'h' && n < sizeof(spec) - 3) spec[n++] = *f;
+      f++;
+    }
+    char conv = *f;
+    if (conv == '\0') break;
+    f++;
+
+    LogArg a = next < argCount ? args[next] : LogArg();
+    next++;
+    switch (conv) {
+      case 'f': case 'e': case 'g':
+        spec[n++] = conv; spec[n] = '\0';
+        advance(snprintf(out + pos, room(), spec, (double)a.f));
+        break;
+      case 's':
+        spec[n++] = 's'; spec[n] = '\0';
+        advance(snprintf(out + pos, room(), spec, a.s != nullptr ? a.s : "(null)"));
+        break;
+      case 'u': case 'x': case 'X':
+        spec[n++] = 'l'; spec[n++] = conv; spec[n] = '\0';
+        advance(snprintf(out + pos, room(), spec, (unsigned long)a.u));
+        break;
+      case 'c':
+        spec[n++] = 'c'; spec[n] = '\0';
+        advance(snprintf(out + pos, room(), spec, (int)a.i));
+        break;
+      default:   // d, i
+        spec[n++] = 'l'; spec[n++] = 'd'; spec[n] = '\0';
+        advance(snprintf(out + pos, room(), spec, (long)a.i));
+        break;
+    }
+  }
+
+  // Trama al final del texto
+  size_t copy = record.payloadLength;
+  if (copy > room() - 1) copy = room() - 1;
+  memcpy(out + pos, record.payload, copy);
+  pos += copy;
+  if (record.truncated && room() > 4) {
+    memcpy(out + pos, "...", 3);
+    pos += 3;
+  }
+  out[pos] = '\0';
+  return pos;
+}
+
+EventLogStats EventLog::stats() const {
+  EventLogStats s;
+  s.recorded = recorded_.load(std::memory_order_relaxed);
+  s.dropped = dropped_.load(std::memory_order_relaxed);
+  s.filtered = filtered_.load(std::memory_order_relaxed);
+  s.truncated = truncated_.load(std::memory_order_relaxed);
+  return s;
+}
+
+size_t EventLog::pending() const {
+  return enqueuePos_.load(std::memory_order_relaxed) - dequeuePos_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,144 @@
+// ============================================================================
+//  Librería: EventLog
+//  Descripción: Registro de eventos binarios con formato diferido. Quien
+//               registra solo copia a una cola circular sin bloqueos (varios
+//               productores, un consumidor) el identificador del evento, el
+//               instante, hasta LOG_MAX_ARGS argumentos y, si hace falta, los
+//               bytes de la trama. El texto lo arma después el consumidor
+//               (una tarea de baja prioridad) a partir de la tabla de
+//               definiciones. Filtro de nivel en tiempo de ejecución y
+//               contador de eventos descartados por cola llena.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <initializer_list>
+
+// Parámetros fijados en compilación
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 32            // Eventos en espera (potencia de 2)
+#endif
+#ifndef LOG_PAYLOAD_MAX
+#define LOG_PAYLOAD_MAX 192         // Bytes de trama copiados por evento
+#endif
+#define LOG_MAX_ARGS 4
+
+static_assert(LOG_RING_SIZE >= 2 && (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0,
+              "LOG_RING_SIZE debe ser potencia de 2");
+
+enum LogLevel : uint8_t {
+  LOG_DEBUG,
+  LOG_INFO,
+  LOG_WARN,
+  LOG_ERROR,
+  LOG_LEVEL_COUNT
+};
+
+extern const char* const LOG_LEVEL_NAMES[LOG_LEVEL_COUNT];
+
+// ============================================================================
+//  Argumento de un evento: entero, real o cadena estática (literal o tabla
+//  constante; el puntero se lee cuando se formatea, no cuando se registra)
+// ============================================================================
+union LogArg {
+  int32_t     i;
+  uint32_t    u;
+  float       f;
+  const char* s;
+
+  LogArg(int v) : i((int32_t)v) {}
+  LogArg(long v) : i((int32_t)v) {}
+  LogArg(unsigned v) : u((uint32_t)v) {}
+  LogArg(unsigned long v) : u((uint32_t)v) {}
+  LogArg(float v) : f(v) {}
+  LogArg(double v) : f((float)v) {}
+  LogArg(const char* v) : s(v) {}
+  LogArg() : u(0) {}
+};
+
+// ============================================================================
+//  Definición de un evento: nivel y formato printf. Conversiones admitidas:
+//  d i u x X c (enteros), f e g (reales) y s (cadena estática). Los bytes de
+//  la trama, si los hay, se agregan al final del texto.
+// ============================================================================
+struct LogEventDef {
+  LogLevel    level;
+  const char* format;
+};
+
+struct LogRecord {
+  uint32_t timeMs;
+  uint16_t id;
+  uint16_t payloadLength;
+  bool     truncated;          // La trama no cabía en LOG_PAYLOAD_MAX
+  LogArg   args[LOG_MAX_ARGS];
+  char     payload[LOG_PAYLOAD_MAX];
+};
+
+struct EventLogStats {
+  uint32_t recorded;    // Eventos encolados
+  uint32_t dropped;     // Cola llena
+  uint32_t filtered;    // Por debajo del nivel activo
+  uint32_t truncated;   // Trama recortada
+};
+
+class EventLog {
+ public:
+  EventLog(const LogEventDef* defs, size_t count, LogLevel level);
+
+  // --------------------------------------------------------------------------
+  //  Lado productor (cualquier tarea; no usar desde una interrupción)
+  // --------------------------------------------------------------------------
+
+  // Encola el evento; false si se filtró por nivel o la cola está llena
+  bool log(uint16_t id, const char* payload, size_t length,
+           std::initializer_list<LogArg> args, uint32_t nowMs);
+
+  void     setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+  LogLevel level() const { return (LogLevel)level_.load(std::memory_order_relaxed); }
+
+  // --------------------------------------------------------------------------
+  //  Lado consumidor (una sola tarea)
+  // --------------------------------------------------------------------------
+
+  // Copia el evento más antiguo; false si la cola está vacía
+  bool pop(LogRecord& record);
+
+  // Texto del evento (sin marca de tiempo ni salto de línea); devuelve la
+  // longitud escrita, siempre terminada en '\0'
+  size_t format(const LogRecord& record, char* out, size_t outSize) const;
+
+  LogLevel eventLevel(uint16_t id) const { return id < count_ ? defs_[id].level : LOG_ERROR; }
+
+  // --------------------------------------------------------------------------
+  //  Estadísticas (lectura desde cualquier tarea)
+  // --------------------------------------------------------------------------
+  EventLogStats stats() const;
+  size_t   pending() const;
+  uint32_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+  size_t   capacity() const { return LOG_RING_SIZE; }
+
+ private:
+  // Cola acotada de Vyukov: cada celda lleva su número de secuencia, que
+  // indica si está libre para la vuelta actual del productor o publicada
+  // para el consumidor
+  struct Cell {
+    std::atomic<uint32_t> sequence;
+    LogRecord             record;
+  };
+
+  const LogEventDef*    defs_;
+  size_t                count_;
+  std::atomic<uint8_t>  level_;
+  Cell                  cells_[LOG_RING_SIZE];
+  std::atomic<uint32_t> enqueuePos_;
+  std::atomic<uint32_t> dequeuePos_;      // Solo lo escribe el consumidor
+  std::atomic<uint32_t> highWater_;
+  std::atomic<uint32_t> recorded_;
+  std::atomic<uint32_t> dropped_;
+  std::atomic<uint32_t> filtered_;
+  std::atomic<uint32_t> truncated_;
+};
@@ -0,0 +1,170 @@
+// ============================================================================
+//  Librería: HeardList
+//  Descripción: Implementación de la tabla de estaciones escuchadas.
+// ============================================================================
+#include "HeardList.h"
+
+#include <string.h>
+
+static char upper(char c) { return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c; }
+
+uint32_t HeardList::hashCall(const char* call, size_t length) {
+  uint32_t h = 2166136261UL;  // FNV-1a
+  for (size_t i = 0; i < length; i++) {
+    h ^= (uint8_t)upper(call[i]);
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+static bool sameCall(const char* stored, const char* call, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (stored[i] != upper(call[i])) return false;
+  }
+  return stored[length] == '\0';
+}
+
+// ============================================================================
+//  Saltos según el path (elementos hasta el último '*')
+// ============================================================================
+uint8_t ax25HopCount(const AX25Packet& ax) {
+  const char* path = ax.data(ax.path);
+  uint8_t element = 0;
+  uint8_t hops = 0;
+  for (size_t i = 0; i < ax.path.length; i++) {
+    if (i == 0 || path[i - 1] == ',') element++;
+    if (path[i] == '*') hops = element;
+  }
+  return hops;
+}
+
+// ============================================================================
+//  Tabla
+// ============================================================================
+HeardList::HeardList(uint32_t maxAgeMs) : maxAgeMs_(maxAgeMs) { clear(); }
+
+void HeardList::clear() {
+  memset(slots_, 0, sizeof(slots_));
+  memset(buckets_, NONE, sizeof(buckets_));
+  memset(&stats_, 0, sizeof(stats_));
+  for (uint8_t i = 0; i < HEARD_TABLE_SIZE; i++) {
+    slots_[i].nextInBucket = (i + 1 < HEARD_TABLE_SIZE) ? i + 1 : NONE;  // Lista libre
+  }
+  freeList_ = 0;
+  newest_ = oldest_ = NONE;
+  count_ = 0;
+}
+
+uint8_t HeardList::lookup(const char* call, size_t length, uint32_t hash) const {
+  uint8_t i = buckets_[hash & (HEARD_BUCKETS - 1)];
+  while (i != NONE && !sameCall(slots_[i].station.callsign, call, length)) {
+    i = slots_[i].nextInBucket;
+  }
+  return i;
+}
+
+void HeardList::unlinkLru(uint8_t index) {
+  Slot& s = slots_[index];
+  if (s.newer != NONE) slots_[s.newer].older = s.older; else newest_ = s.older;
+  if (s.older != NONE) slots_[s.older].newer = s.newer; else oldest_ = s.newer;
+}
+
+void HeardList::pushNewest(uint8_t index) {
+  Slot& s = slots_[index];
+  s.newer = NONE;
+  s.older = newest_;
+  if (newest_ != NONE) slots_[newest_].newer = index;
+  newest_ = index;
+  if (oldest_ == NONE) oldest_ = index;
+}
+
+void HeardList::remove(uint8_t index) {
+  const HeardStation& st = slots_[index].station;
+  uint8_t* link = &buckets_[hashCall(st.callsign, strlen(st.callsign)) & (HEARD_BUCKETS - 1)];
+  while (*link != index) link = &slots_[*link].nextInBucket;
+  *link = slots_[index].nextInBucket;
+
+  unlinkLru(index);
+  slots_[index].nextInBucket = freeList_;
+  freeList_ = index;
+  count_--;
+}
+
+// La lista LRU está ordenada por último instante: basta mirar la más antigua
+void HeardList::expireOldest(uint32_t nowMs) {
+  while (oldest_ != NONE && nowMs - slots_[oldest_].station.lastHeardMs > maxAgeMs_) {
+    remove(oldest_);
+    stats_.expired++;
+  }
+}
+
+// ============================================================================
+//  Función: update()
+//  Descripción: Inserta o refresca la estación de origen y la mueve al
+//               frente de la lista LRU. Si la tabla está llena se expulsa la
+//               menos reciente.
+// ============================================================================
+void HeardList::update(const AX25Packet& ax, const AprsInfo& aprs, int16_t rssi, float snr,
+                       uint32_t nowMs) {
+  if (!ax.valid || ax.source.length == 0 || ax.source.length > HEARD_CALL_LEN) return;
+  expireOldest(nowMs);
+
+  const char* call = ax.data(ax.source);
+  size_t length = ax.source.length;
+  uint32_t hash = hashCall(call, length);
+  uint8_t index = lookup(call, length, hash);
+
+  if (index == NONE) {
+    if (freeList_ == NONE) {
+      remove(oldest_);
+      stats_.evictedLru++;
+    }
+    index = freeList_;
+    freeList_ = slots_[index].nextInBucket;
+
+    HeardStation& st = slots_[index].station;
+    memset(&st, 0, sizeof(st));
+    for (size_t i = 0; i < length; i++) st.callsign[i] = upper(call[i]);
+
+    uint8_t& bucket = buckets_[hash & (HEARD_BUCKETS - 1)];
+    slots_[index].nextInBucket = bucket;
+    bucket = index;
+    count_++;
+    stats_.inserts++;
+  } else {
+    unlinkLru(index);
+  }
+  pushNewest(index);
+
+  HeardStation& st = slots_[index].station;
+  st.lastHeardMs = nowMs;
+  st.rssi = rssi;
+  st.snr = snr;
+  st.hops = ax25HopCount(ax);
+  if (st.hops == 0) {
+    st.heardDirect = true;
+    st.lastDirectMs = nowMs;
+  }
+  if (aprs.hasPosition) {
+    st.hasPosition = true;
+    st.latitude = aprs.latitude;
+    st.longitude = aprs.longitude;
+  }
+  stats_.updates++;
+}
+
+const HeardStation* HeardList::find(const char* callsign, size_t length, uint32_t nowMs) {
+  stats_.lookups++;
+  expireOldest(nowMs);
+  if (length == 0 || length > HEARD_CALL_LEN) return nullptr;
+
+  uint8_t index = lookup(callsign, length, hashCall(callsign, length));
+  if (index == NONE) return nullptr;
+  stats_.hits++;
+  return &slots_[index].station;
+}
+
+bool HeardList::heardDirect(const char* callsign, size_t length, uint32_t windowMs, uint32_t nowMs) {
+  const HeardStation* st = find(callsign, length, nowMs);
+  return st != nullptr && st->heardDirect && nowMs - st->lastDirectMs <= windowMs;
+}
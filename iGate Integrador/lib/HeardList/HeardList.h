@@ -0,0 +1,113 @@
+// ============================================================================
+//  Librería: HeardList
+//  Descripción: Tabla de estaciones escuchadas por RF de capacidad fija:
+//               indicativo, último instante, RSSI/SNR, saltos y posición si
+//               la trae el AprsInfo del llamador. Búsqueda O(1) por hash con
+//               encadenamiento en arreglos fijos y expulsión por antigüedad
+//               (LRU) cuando la tabla se llena o la entrada caduca. Se usa
+//               para decidir qué tráfico APRS-IS → RF vale la pena transmitir.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AX25.h>
+#include <AprsDecoder.h>
+
+// Parámetros fijados en compilación
+#ifndef HEARD_TABLE_SIZE
+#define HEARD_TABLE_SIZE 64       // Estaciones (máximo 254)
+#endif
+#ifndef HEARD_BUCKETS
+#define HEARD_BUCKETS 64          // Cubetas del hash (potencia de 2)
+#endif
+
+static_assert(HEARD_TABLE_SIZE >= 2 && HEARD_TABLE_SIZE < 255,
+              "HEARD_TABLE_SIZE debe estar entre 2 y 254");
+static_assert((HEARD_BUCKETS & (HEARD_BUCKETS - 1)) == 0,
+              "HEARD_BUCKETS debe ser potencia de 2");
+
+#define HEARD_CALL_LEN 9          // CALL-SSID: 6 + '-' + 2
+
+// ============================================================================
+//  Estación escuchada
+// ============================================================================
+struct HeardStation {
+  char     callsign[HEARD_CALL_LEN + 1];  // En mayúsculas, terminado en '\0'
+  uint32_t lastHeardMs;
+  int16_t  rssi;          // dBm
+  float    snr;           // dB
+  uint8_t  hops;          // De la última trama; 0 = escuchada directamente
+  bool     heardDirect;   // Alguna vez sin digipeaters (ver lastDirectMs)
+  uint32_t lastDirectMs;
+  bool     hasPosition;   // De AprsInfo (incluye Mic-E)
+  int32_t  latitude;      // Millonésimas de grado, + norte
+  int32_t  longitude;     // Millonésimas de grado, + este
+};
+
+// ============================================================================
+//  Contadores de la tabla
+// ============================================================================
+struct HeardStats {
+  uint32_t updates;       // Tramas registradas
+  uint32_t inserts;       // Estaciones nuevas
+  uint32_t lookups;
+  uint32_t hits;          // Búsquedas con estación vigente
+  uint32_t evictedLru;    // Expulsadas por tabla llena
+  uint32_t expired;       // Expulsadas por antigüedad
+};
+
+// ============================================================================
+//  Función: ax25HopCount()
+//  Descripción: Saltos usados según el path: elementos hasta el último
+//               marcado con '*' (0 si nadie la digipeó).
+// ============================================================================
+uint8_t ax25HopCount(const AX25Packet& ax);
+
+class HeardList {
+ public:
+  // maxAgeMs: una estación sin escucharse por más tiempo se descarta
+  explicit HeardList(uint32_t maxAgeMs);
+
+  // Registra una trama recibida por RF (origen, saltos y posición); aprs es
+  // la decodificación que ya hizo el llamador, no se vuelve a decodificar
+  void update(const AX25Packet& ax, const AprsInfo& aprs, int16_t rssi, float snr,
+              uint32_t nowMs);
+
+  // Estación vigente o nullptr; el indicativo no necesita terminar en '\0'
+  const HeardStation* find(const char* callsign, size_t length, uint32_t nowMs);
+
+  // true si la estación se escuchó sin digipeaters dentro de windowMs
+  bool heardDirect(const char* callsign, size_t length, uint32_t windowMs, uint32_t nowMs);
+
+  uint16_t size() const { return count_; }
+  const HeardStats& stats() const { return stats_; }
+  void clear();
+
+ private:
+  static const uint8_t NONE = 0xFF;
+
+  struct Slot {
+    HeardStation station;
+    uint8_t      nextInBucket;
+    uint8_t      newer;       // Lista LRU: hacia la más reciente
+    uint8_t      older;       // Lista LRU: hacia la más antigua
+  };
+
+  static uint32_t hashCall(const char* call, size_t length);
+  uint8_t lookup(const char* call, size_t length, uint32_t hash) const;
+  void    unlinkLru(uint8_t index);
+  void    pushNewest(uint8_t index);
+  void    remove(uint8_t index);
+  void    expireOldest(uint32_t nowMs);
+
+  Slot       slots_[HEARD_TABLE_SIZE];
+  uint8_t    buckets_[HEARD_BUCKETS];
+  uint8_t    freeList_;
+  uint8_t    newest_;
+  uint8_t    oldest_;
+  uint16_t   count_;
+  uint32_t   maxAgeMs_;
+  HeardStats stats_;
+};
@@ -0,0 +1,20 @@
+// ============================================================================
+//  Librería: HostFakes
+//  Descripción: Sustituto de Arduino.h para el entorno native. Solo el
+//               reloj: millis()/micros() avanzan cuando el programa lo
+//               indica, así una traza se reproduce con sus tiempos
+//               originales a cualquier velocidad.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+
+// Control del reloj simulado
+void fakeClockSetMicros(uint64_t us);
+void fakeClockAdvanceMicros(uint64_t us);
@@ -0,0 +1,127 @@
+// ============================================================================
+//  Librería: HostFakes
+//  Descripción: Implementación del reloj simulado, del radio LoRa y del
+//               cliente TCP de prueba.
+// ============================================================================
+#include "Arduino.h"
+#include "LoRa.h"
+#include "WiFiClient.h"
+
+// ============================================================================
+//  Reloj simulado
+// ============================================================================
+static uint64_t clockMicros = 0;
+
+uint32_t millis() { return (uint32_t)(clockMicros / 1000); }
+uint32_t micros() { return (uint32_t)clockMicros; }
+void     delay(uint32_t ms) { clockMicros += (uint64_t)ms * 1000; }
+
+void fakeClockSetMicros(uint64_t us) { clockMicros = us; }
+void fakeClockAdvanceMicros(uint64_t us) { clockMicros += us; }
+
+// ============================================================================
+//  Radio LoRa
+// ============================================================================
+LoRaClass LoRa;
+
+LoRaClass::LoRaClass()
+    : head_(0), count_(0), rxLength_(0), rxPos_(0), channelRssi_(-120), txLength_(0),
+      lastTxLength_(0), txPackets_(0), txBytes_(0), overflows_(0) {}
+
+bool LoRaClass::inject(const char* data, size_t length, int rssi, float snr) {
+  if (count_ >= FAKE_LORA_QUEUE) {
+    overflows_++;
+    return false;
+  }
+  if (length > FAKE_LORA_MAX_PACKET) length = FAKE_LORA_MAX_PACKET;
+  Packet& p = queue_[(head_ + count_) % FAKE_LORA_QUEUE];
+  memcpy(p.data, data, length);
+  p.length = (uint16_t)length;
+  p.rssi = (int16_t)rssi;
+  p.snr = snr;
+  count_++;
+  return true;
+}
+
+int LoRaClass::parsePacket() {
+  if (count_ == 0) return 0;
+  const Packet& p = queue_[head_];
+  rx_ = p;
+  head_ = (head_ + 1) % FAKE_LORA_QUEUE;
+  count_--;
+  rxLength_ = rx_.length;
+  rxPos_ = 0;
+  return rxLength_;
+}
+
+size_t LoRaClass::write(const uint8_t* data, size_t length) {
+  if (length > sizeof(tx_) - txLength_) length = sizeof(tx_) - txLength_;
+  memcpy(tx_ + txLength_, data, length);
+  txLength_ += length;
+  return length;
+}
+
+int LoRaClass::endPacket(bool async) {
+  (void)async;
+  memcpy(lastTx_, tx_, txLength_);
+  lastTxLength_ = txLength_;
+  txPackets_++;
+  txBytes_ += txLength_;
+  return 1;
+}
+
+// ============================================================================
+//  Cliente TCP
+// ============================================================================
+WiFiClient::WiFiClient()
+    : start_(0), end_(0), maxRead_(0), connected_(false), writes_(0), writtenBytes_(0),
+      lastWriteLength_(0) {}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  (void)host;
+  (void)port;
+  connected_ = true;
+  start_ = end_ = 0;
+  return 1;
+}
+
+size_t WiFiClient::feed(const char* data, size_t length) {
+  if (start_ > 0 && end_ + length > sizeof(rx_)) {   // Compacta lo pendiente
+    memmove(rx_, rx_ + start_, end_ - start_);
+    end_ -= start_;
+    start_ = 0;
+  }
+  if (length > sizeof(rx_) - end_) length = sizeof(rx_) - end_;
+  memcpy(rx_ + end_, data, length);
+  end_ += length;
+  return length;
+}
+
+int WiFiClient::read() {
+  return start_ < end_ ? (uint8_t)rx_[start_++] : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+  size_t n = end_ - start_;
+  if (n > size) n = size;
+  if (maxRead_ > 0 && n > maxRead_) n = maxRead_;
+  if (n == 0) return -1;
+  memcpy(buffer, rx_ + start_, n);
+  start_ += n;
+  if (start_ == end_) start_ = end_ = 0;
+  return (int)n;
+}
+
+size_t WiFiClient::write(const uint8_t* data, size_t length) {
+  if (!connected_) return 0;
+  size_t keep = length < sizeof(lastWrite_) ? length : sizeof(lastWrite_);
+  memcpy(lastWrite_, data, keep);
+  lastWriteLength_ = keep;
+  writes_++;
+  writtenBytes_ += length;
+  return length;
+}
+
+size_t WiFiClient::print(const char* text) {
+  return write((const uint8_t*)text, strlen(text));
+}
@@ -0,0 +1,74 @@
+// ============================================================================
+//  Librería: HostFakes
+//  Descripción: Sustituto de la librería LoRa (sandeepmistry) para el
+//               entorno native. Las tramas inyectadas esperan en una cola
+//               fija y se leen con la misma secuencia que en el equipo
+//               (parsePacket / available / read / packetRssi / packetSnr);
+//               lo transmitido se cuenta y se guarda la última trama.
+//               Sin memoria dinámica, para no falsear las reservas por
+//               trama que mide la reproducción.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef FAKE_LORA_QUEUE
+#define FAKE_LORA_QUEUE 8
+#endif
+#define FAKE_LORA_MAX_PACKET 255
+
+class LoRaClass {
+ public:
+  LoRaClass();
+
+  // API usada por el firmware
+  int   begin(long frequency) { (void)frequency; return 1; }
+  void  receive() {}
+  int   parsePacket();
+  int   available() const { return rxLength_ - rxPos_; }
+  int   read() { return rxPos_ < rxLength_ ? (uint8_t)rx_.data[rxPos_++] : -1; }
+  int   packetRssi() const { return rx_.rssi; }
+  float packetSnr() const { return rx_.snr; }
+  int   rssi() const { return channelRssi_; }
+  int   beginPacket() { txLength_ = 0; return 1; }
+  size_t write(const uint8_t* data, size_t length);
+  int   endPacket(bool async = false);
+
+  // Control desde el programa de prueba
+  bool inject(const char* data, size_t length, int rssi, float snr);
+  void setChannelRssi(int rssi) { channelRssi_ = rssi; }
+
+  uint32_t    transmitted() const { return txPackets_; }
+  uint32_t    transmittedBytes() const { return txBytes_; }
+  const char* lastTx(size_t& length) const {
+    length = lastTxLength_;
+    return lastTx_;
+  }
+  uint32_t    injectOverflows() const { return overflows_; }
+
+ private:
+  struct Packet {
+    uint16_t length;
+    int16_t  rssi;
+    float    snr;
+    char     data[FAKE_LORA_MAX_PACKET];
+  };
+
+  Packet   queue_[FAKE_LORA_QUEUE];
+  uint8_t  head_;
+  uint8_t  count_;
+  Packet   rx_;          // Paquete en lectura (parsePacket lo carga)
+  int      rxLength_;
+  int      rxPos_;
+  int      channelRssi_;
+  char     tx_[FAKE_LORA_MAX_PACKET];
+  size_t   txLength_;
+  char     lastTx_[FAKE_LORA_MAX_PACKET];
+  size_t   lastTxLength_;
+  uint32_t txPackets_;
+  uint32_t txBytes_;
+  uint32_t overflows_;
+};
+
+extern LoRaClass LoRa;
@@ -0,0 +1,54 @@
+// ============================================================================
+//  Librería: HostFakes
+//  Descripción: Sustituto de WiFiClient para el entorno native. Lo que el
+//               programa inyecta con feed() se entrega por available/read
+//               como si llegara del servidor APRS-IS; lo escrito se cuenta
+//               (bytes y escrituras) y se guarda la última línea. Buffer
+//               fijo, sin memoria dinámica.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef FAKE_CLIENT_BUFFER
+#define FAKE_CLIENT_BUFFER 4096
+#endif
+#define FAKE_CLIENT_LAST_WRITE 512
+
+class WiFiClient {
+ public:
+  WiFiClient();
+
+  // API usada por el firmware
+  int     connect(const char* host, uint16_t port);
+  uint8_t connected() const { return connected_; }
+  void    stop() { connected_ = false; }
+  int     available() const { return (int)(end_ - start_); }
+  int     read();
+  int     read(uint8_t* buffer, size_t size);
+  size_t  write(const uint8_t* data, size_t length);
+  size_t  print(const char* text);
+
+  // Control desde el programa de prueba
+  size_t feed(const char* data, size_t length);   // Bytes aceptados
+  void   setMaxRead(size_t n) { maxRead_ = n; }    // Fragmenta las lecturas (0 = sin límite)
+
+  uint32_t    writes() const { return writes_; }
+  uint32_t    writtenBytes() const { return writtenBytes_; }
+  const char* lastWrite(size_t& length) const {
+    length = lastWriteLength_;
+    return lastWrite_;
+  }
+
+ private:
+  char     rx_[FAKE_CLIENT_BUFFER];
+  size_t   start_;
+  size_t   end_;
+  size_t   maxRead_;
+  bool     connected_;
+  uint32_t writes_;
+  uint32_t writtenBytes_;
+  char     lastWrite_[FAKE_CLIENT_LAST_WRITE];
+  size_t   lastWriteLength_;
+};
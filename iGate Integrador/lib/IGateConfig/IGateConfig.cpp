@@ -0,0 +1,286 @@
+// ============================================================================
+//  Librería: IGateConfig
+//  Descripción: Implementación de la tabla de campos y de la validación.
+// ============================================================================
+#include "IGateConfig.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const char* const CONFIG_ISSUE_NAMES[CFG_ISSUE_COUNT] = {
+  "tipo incorrecto", "demasiado largo", "fuera de rango", "demasiados elementos",
+  "formato inválido", "falta el valor"
+};
+
+void ConfigReport::add(ConfigIssueCode code, const char* field) {
+  if (issueCount < CONFIG_MAX_ISSUES) {
+    ConfigIssue& i = issues[issueCount];
+    i.code = code;
+    strncpy(i.field, field, sizeof(i.field) - 1);
+    i.field[sizeof(i.field) - 1] = '\0';
+  }
+  issueCount++;
+}
+
+// ============================================================================
+//  Tabla de campos: ruta JSON → miembro de IGateConfig
+// ============================================================================
+enum FieldType : uint8_t {
+  F_STRING,
+  F_BOOL,
+  F_U8,
+  F_U16,
+  F_U32,
+  F_FLOAT,
+};
+
+struct FieldDef {
+  const char* path;
+  FieldType   type;
+  uint16_t    offset;
+  uint16_t    size;       // Bytes del miembro (cadenas: incluye el '\0')
+  double      min;        // Rango de los números
+  double      max;
+  uint8_t     arrayMax;   // 0 = no es un arreglo
+  uint16_t    stride;     // Bytes entre elementos del arreglo
+  uint16_t    arrayOffset;  // Inicio del arreglo (se vacía al leer el primero)
+  uint16_t    countOffset;  // Contador de elementos (uint8_t)
+  uint8_t     list;         // Bit en listsFromFile_
+};
+
+#define FIELD(path, type, member, min, max) \
+  { path, type, offsetof(IGateConfig, member), sizeof(((IGateConfig*)0)->member), min, max, \
+    0, 0, 0, 0, 0 }
+#define AP_FIELD(path, member)                                                       \
+  { path, F_STRING, offsetof(IGateConfig, aps) + offsetof(WifiApSettings, member), \
+    sizeof(((WifiApSettings*)0)->member), 0, 0, CONFIG_MAX_APS, sizeof(WifiApSettings), \
+    offsetof(IGateConfig, aps), offsetof(IGateConfig, apCount), 1 << 0 }
+#define SERVER_FIELD(path)                                                           \
+  { path, F_STRING, offsetof(IGateConfig, servers), CONFIG_HOST_LEN + 1, 0, 0,      \
+    CONFIG_MAX_SERVERS, CONFIG_HOST_LEN + 1, offsetof(IGateConfig, servers),         \
+    offsetof(IGateConfig, serverCount), 1 << 1 }
+#define SCAN_FIELD(path, type, member, min, max)                                     \
+  { path, type, offsetof(IGateConfig, scan) + offsetof(LoraScanSettings, member),   \
+    sizeof(((LoraScanSettings*)0)->member), min, max, CONFIG_MAX_SCAN,               \
+    sizeof(LoraScanSettings), offsetof(IGateConfig, scan),                           \
+    offsetof(IGateConfig, scanCount), 1 << 2 }
+
+static const FieldDef FIELDS[] = {
+  FIELD("callsign",              F_STRING, callsign,        0, 0),
+  FIELD("aprs_is.active",        F_BOOL,   aprsIsActive,    0, 0),
+  FIELD("aprs_is.passcode",      F_STRING, passcode,        0, 0),
+  FIELD("aprs_is.server",        F_STRING, server,          0, 0),
+  FIELD("aprs_is.port",          F_U16,    port,            1, 65535),
+  SERVER_FIELD("aprs_is.servers"),
+  FIELD("aprs_is.filter",        F_STRING, filter,          0, 0),
+  FIELD("aprs_is.rf_filter",     F_STRING, rfFilter,        0, 0),
+  FIELD("wifi.active",           F_BOOL,   wifiActive,      0, 0),
+  AP_FIELD("wifi.AP.SSID",       ssid),
+  AP_FIELD("wifi.AP.password",   password),
+  FIELD("lora.frequency_rx",     F_U32,    frequencyHz,     137000000, 1020000000),
+  FIELD("lora.spreading_factor", F_U8,     spreadingFactor, 7, 12),
+  FIELD("lora.bandwidth",        F_U32,    bandwidthHz,     7800, 500000),
+  FIELD("lora.coding_rate",      F_U8,     codingRate4,     5, 8),
+  SCAN_FIELD("lora.scan.spreading_factor", F_U8, spreadingFactor, 7, 12),
+  SCAN_FIELD("lora.scan.bandwidth",        F_U32, bandwidthHz,    0, 500000),
+  FIELD("beacon.latitude",       F_FLOAT,  beaconLat,       -90, 90),
+  FIELD("beacon.longitude",      F_FLOAT,  beaconLon,       -180, 180),
+  FIELD("beacon.comment",        F_STRING, beaconComment,   0, 0),
+  FIELD("beacon.interval",       F_U32,    beaconIntervalS, 60, 86400),
+  FIELD("beacon.rf",             F_BOOL,   beaconRf,        0, 0),
+  FIELD("beacon.rf_path",        F_STRING, beaconRfPath,    0, 0),
+  FIELD("power.light_sleep",     F_BOOL,   lightSleep,      0, 0),
+  FIELD("power.wifi_sleep",      F_U8,     wifiSleep,       0, 2),
+  FIELD("display.timeout",       F_U16,    displayTimeoutS, 0, 3600),
+};
+
+static const uint32_t LORA_BANDWIDTHS[] = {
+  7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000
+};
+
+// ============================================================================
+//  Lector
+// ============================================================================
+ConfigParser::ConfigParser(IGateConfig& config, ConfigReport& report)
+    : config_(config), report_(report), json_(onValue, this), listsFromFile_(0) {
+  memset(&report_, 0, sizeof(report_));
+}
+
+bool ConfigParser::onValue(const char* path, int index, const JsonValue& value, void* context) {
+  return ((ConfigParser*)context)->assign(path, index, value);
+}
+
+bool ConfigParser::assign(const char* path, int index, const JsonValue& value) {
+  const FieldDef* f = nullptr;
+  for (const FieldDef& d : FIELDS) {
+    if (strcmp(d.path, path) == 0) {
+      f = &d;
+      break;
+    }
+  }
+  if (f == nullptr || (f->arrayMax == 0) != (index < 0)) {
+    report_.unknownKeys++;
+    return true;   // Claves de otras versiones o sin uso (network.DHCP): se ignoran
+  }
+
+  uint8_t* base = (uint8_t*)&config_;
+  if (f->arrayMax > 0) {
+    if (index >= f->arrayMax) {
+      report_.add(CFG_ISSUE_TOO_MANY, path);
+      return true;
+    }
+    uint8_t& count = base[f->countOffset];
+    if (!(listsFromFile_ & f->list)) {   // La lista del archivo reemplaza a la de fábrica
+      memset(base + f->arrayOffset, 0, f->arrayMax * f->stride);
+      count = 0;
+      listsFromFile_ |= f->list;
+    }
+    if (index + 1 > count) count = (uint8_t)(index + 1);
+    base += index * f->stride;
+  }
+  uint8_t* dst = base + f->offset;
+
+  switch (f->type) {
+    case F_STRING:
+      if (value.type != JSON_STRING) break;
+      if (value.truncated || value.length >= f->size) {
+        report_.add(CFG_ISSUE_TOO_LONG, path);
+        return true;
+      }
+      memcpy(dst, value.text, value.length + 1);
+      report_.assigned++;
+      return true;
+
+    case F_BOOL:
+      if (value.type != JSON_BOOL) break;
+      *(bool*)dst = value.boolean;
+      report_.assigned++;
+      return true;
+
+    default: {
+      if (value.type != JSON_NUMBER) break;
+      double n = strtod(value.text, nullptr);
+      bool integer = f->type != F_FLOAT;
+      if (n < f->min || n > f->max || (integer && n != (double)(uint32_t)n)) {
+        report_.add(CFG_ISSUE_RANGE, path);
+        return true;
+      }
+      if (f->type == F_U8) *(uint8_t*)dst = (uint8_t)n;
+      else if (f->type == F_U16) *(uint16_t*)dst = (uint16_t)n;
+      else if (f->type == F_U32) *(uint32_t*)dst = (uint32_t)n;
+      else *(float*)dst = (float)n;
+      report_.assigned++;
+      return true;
+    }
+  }
+  report_.add(CFG_ISSUE_TYPE, path);
+  return true;
+}
+
+bool ConfigParser::finish() {
+  json_.finish();
+  report_.jsonError = json_.error();
+  report_.line = json_.line();
+  report_.column = json_.column();
+  if (report_.jsonError != JSON_OK) return false;
+  validateConfig(config_, report_);
+  return report_.ok();
+}
+
+// ============================================================================
+//  Validación
+// ============================================================================
+static bool isAlnum(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+// CALL[-SSID]: base alfanumérica, SSID de 1 o 2 caracteres
+static bool validCallsign(const char* s) {
+  size_t base = 0;
+  while (isAlnum(s[base])) base++;
+  if (base == 0) return false;
+  if (s[base] == '\0') return true;
+  if (s[base] != '-') return false;
+  size_t ssid = 0;
+  while (isAlnum(s[base + 1 + ssid])) ssid++;
+  return ssid >= 1 && ssid <= 2 && s[base + 1 + ssid] == '\0';
+}
+
+static bool validPasscode(const char* s) {
+  if (strcmp(s, "-1") == 0) return true;   // Solo recepción
+  size_t n = 0;
+  while (s[n] >= '0' && s[n] <= '9') n++;
+  return n >= 1 && n <= 5 && s[n] == '\0';
+}
+
+// Texto que va dentro de una línea APRS-IS: sin caracteres de control ni
+// saltos de línea (UTF-8 sí se admite, p. ej. el comentario del beacon)
+static bool printable(const char* s) {
+  for (; *s; s++) {
+    if ((uint8_t)*s < 0x20 || (uint8_t)*s == 0x7F) return false;
+  }
+  return true;
+}
+
+// "host" o "host:puerto" (lista de servidores del pool APRS-IS)
+static bool validHostPort(const char* s) {
+  if (s[0] == '\0' || s[0] == ':' || !printable(s) || strchr(s, ' ') != nullptr) return false;
+  const char* colon = strchr(s, ':');
+  if (colon == nullptr) return true;
+  char* end;
+  unsigned long port = strtoul(colon + 1, &end, 10);
+  return end != colon + 1 && *end == '\0' && port >= 1 && port <= 65535;
+}
+
+// "WIDE1-1,WIDE2-1": elementos CALL[-SSID] separados por comas
+static bool validPath(const char* s) {
+  char element[CONFIG_PATH_LEN + 1];
+  while (*s) {
+    size_t n = strcspn(s, ",");
+    if (n == 0 || n > CONFIG_CALL_LEN) return false;
+    memcpy(element, s, n);
+    element[n] = '\0';
+    if (!validCallsign(element)) return false;
+    s += n;
+    if (*s == ',') s++;
+    if (*s == '\0' && s[-1] == ',') return false;
+  }
+  return true;
+}
+
+void validateConfig(const IGateConfig& c, ConfigReport& report) {
+  if (c.callsign[0] == '\0') report.add(CFG_ISSUE_MISSING, "callsign");
+  else if (!validCallsign(c.callsign)) report.add(CFG_ISSUE_FORMAT, "callsign");
+
+  if (c.aprsIsActive) {
+    if (c.server[0] == '\0') report.add(CFG_ISSUE_MISSING, "aprs_is.server");
+    if (c.port == 0) report.add(CFG_ISSUE_RANGE, "aprs_is.port");
+    if (!validPasscode(c.passcode)) report.add(CFG_ISSUE_FORMAT, "aprs_is.passcode");
+  }
+  if (!printable(c.server)) report.add(CFG_ISSUE_FORMAT, "aprs_is.server");
+  for (uint8_t i = 0; i < c.serverCount; i++) {
+    if (!validHostPort(c.servers[i])) report.add(CFG_ISSUE_FORMAT, "aprs_is.servers");
+  }
+  if (!printable(c.filter)) report.add(CFG_ISSUE_FORMAT, "aprs_is.filter");
+  if (!printable(c.rfFilter)) report.add(CFG_ISSUE_FORMAT, "aprs_is.rf_filter");
+
+  if (c.wifiActive) {
+    if (c.apCount == 0) report.add(CFG_ISSUE_MISSING, "wifi.AP");
+    for (uint8_t i = 0; i < c.apCount; i++) {
+      if (c.aps[i].ssid[0] == '\0') report.add(CFG_ISSUE_MISSING, "wifi.AP.SSID");
+    }
+  }
+
+  bool bandwidth = false;
+  for (uint32_t bw : LORA_BANDWIDTHS) bandwidth |= c.bandwidthHz == bw;
+  if (!bandwidth) report.add(CFG_ISSUE_RANGE, "lora.bandwidth");
+  for (uint8_t i = 0; i < c.scanCount; i++) {
+    if (c.scan[i].spreadingFactor == 0) report.add(CFG_ISSUE_MISSING, "lora.scan");
+    bandwidth = c.scan[i].bandwidthHz == 0;
+    for (uint32_t bw : LORA_BANDWIDTHS) bandwidth |= c.scan[i].bandwidthHz == bw;
+    if (!bandwidth) report.add(CFG_ISSUE_RANGE, "lora.scan.bandwidth");
+  }
+
+  if (!printable(c.beaconComment)) report.add(CFG_ISSUE_FORMAT, "beacon.comment");
+  if (c.beaconRf && !validPath(c.beaconRfPath)) report.add(CFG_ISSUE_FORMAT, "beacon.rf_path");
+}
@@ -0,0 +1,151 @@
+// ============================================================================
+//  Librería: IGateConfig
+//  Descripción: Configuración de operación del iGate en una estructura de
+//               tamaño fijo (se copia tal cual a NVS) y su lectura desde
+//               is-cfg.json con JsonStream: cada ruta JSON se asigna a un
+//               campo por una tabla (tipo, desplazamiento, tamaño y rango).
+//               Las claves desconocidas se ignoran y quedan contadas; los
+//               valores fuera de rango, las cadenas largas y las
+//               inconsistencias se reportan por campo con validateConfig().
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <JsonStream.h>
+
+// Versión del formato binario: cambiarla invalida las copias en NVS
+#define CONFIG_VERSION 5
+
+#define CONFIG_MAX_APS      4
+#define CONFIG_MAX_SERVERS  4      // Servidores APRS-IS además de server:port
+#define CONFIG_MAX_SCAN     3      // Combinaciones SF/BW exploradas además de la principal
+#define CONFIG_CALL_LEN     9      // CALL-SSID
+#define CONFIG_PASSCODE_LEN 6      // "-1" o hasta 5 dígitos
+#define CONFIG_HOST_LEN     63
+#define CONFIG_SSID_LEN     32
+#define CONFIG_WIFI_PASS_LEN 63
+#define CONFIG_FILTER_LEN   127    // Filtro del servidor APRS-IS ("r/9.85/-83.90/200")
+#define CONFIG_COMMENT_LEN  63
+#define CONFIG_PATH_LEN     31
+#define CONFIG_MAX_ISSUES   8      // Problemas guardados (los demás solo se cuentan)
+
+struct WifiApSettings {
+  char ssid[CONFIG_SSID_LEN + 1];
+  char password[CONFIG_WIFI_PASS_LEN + 1];
+};
+
+struct LoraScanSettings {
+  uint8_t  spreadingFactor;
+  uint32_t bandwidthHz;     // 0 = el de lora.bandwidth
+};
+
+struct IGateConfig {
+  char     callsign[CONFIG_CALL_LEN + 1];
+
+  // APRS-IS
+  bool     aprsIsActive;
+  char     passcode[CONFIG_PASSCODE_LEN + 1];
+  char     server[CONFIG_HOST_LEN + 1];
+  uint16_t port;
+  uint8_t  serverCount;   // Alternativas para el pool ("host" o "host:puerto")
+  char     servers[CONFIG_MAX_SERVERS][CONFIG_HOST_LEN + 1];
+  char     filter[CONFIG_FILTER_LEN + 1];
+  char     rfFilter[CONFIG_FILTER_LEN + 1];   // Filtro local APRS-IS → RF (AprsFilter)
+
+  // WiFi (en orden de preferencia; se prueban todas)
+  bool           wifiActive;
+  uint8_t        apCount;
+  WifiApSettings aps[CONFIG_MAX_APS];
+
+  // Radio LoRa
+  uint32_t frequencyHz;
+  uint8_t  spreadingFactor;
+  uint32_t bandwidthHz;
+  uint8_t  codingRate4;    // 5..8 = 4/5..4/8
+  uint8_t  scanCount;      // Con alguna, exploración por CAD (solo recepción)
+  LoraScanSettings scan[CONFIG_MAX_SCAN];
+
+  // Beacon
+  float    beaconLat;
+  float    beaconLon;
+  char     beaconComment[CONFIG_COMMENT_LEN + 1];
+  uint32_t beaconIntervalS;
+  bool     beaconRf;
+  char     beaconRfPath[CONFIG_PATH_LEN + 1];
+
+  // Energía
+  bool     lightSleep;        // Light sleep automático entre eventos
+  uint8_t  wifiSleep;         // 0 = sin ahorro, 1 = modem sleep mínimo, 2 = máximo
+  uint16_t displayTimeoutS;   // OLED apagado tras N s sin tráfico (0 = siempre)
+};
+
+// ============================================================================
+//  Problemas de lectura / validación
+// ============================================================================
+enum ConfigIssueCode : uint8_t {
+  CFG_ISSUE_TYPE,         // Tipo JSON distinto al esperado
+  CFG_ISSUE_TOO_LONG,     // Cadena más larga que el campo
+  CFG_ISSUE_RANGE,        // Número fuera de rango
+  CFG_ISSUE_TOO_MANY,     // Más elementos que los que caben en el arreglo
+  CFG_ISSUE_FORMAT,       // Indicativo, passcode, path o filtro mal formado
+  CFG_ISSUE_MISSING,      // Campo obligatorio vacío
+  CFG_ISSUE_COUNT
+};
+
+extern const char* const CONFIG_ISSUE_NAMES[CFG_ISSUE_COUNT];
+
+struct ConfigIssue {
+  ConfigIssueCode code;
+  char            field[32];   // Ruta JSON (p. ej. "lora.spreading_factor")
+};
+
+struct ConfigReport {
+  uint16_t    issueCount;      // Todos, aunque solo se guarden CONFIG_MAX_ISSUES
+  ConfigIssue issues[CONFIG_MAX_ISSUES];
+  uint16_t    unknownKeys;     // Claves ignoradas
+  uint16_t    assigned;        // Campos asignados desde el archivo
+  JsonError   jsonError;
+  uint32_t    line;            // Posición del error de sintaxis
+  uint32_t    column;
+
+  bool ok() const { return jsonError == JSON_OK && issueCount == 0; }
+  void add(ConfigIssueCode code, const char* field);
+};
+
+// ============================================================================
+//  Lector por flujo: parte de los valores que ya tenga 'config' (los valores
+//  por defecto del firmware) y sobrescribe los presentes en el archivo.
+// ============================================================================
+class ConfigParser {
+ public:
+  ConfigParser(IGateConfig& config, ConfigReport& report);
+
+  bool feed(const char* data, size_t length) { return json_.feed(data, length); }
+
+  // Cierra el documento y valida el resultado; true si no hubo problemas
+  bool finish();
+
+ private:
+  static bool onValue(const char* path, int index, const JsonValue& value, void* context);
+  bool assign(const char* path, int index, const JsonValue& value);
+
+  IGateConfig&  config_;
+  ConfigReport& report_;
+  JsonStream    json_;
+  uint8_t       listsFromFile_; // Listas del archivo que ya reemplazaron a las de fábrica
+};
+
+// Revisa consistencia y formatos; agrega los problemas al reporte
+void validateConfig(const IGateConfig& config, ConfigReport& report);
+
+// FNV-1a incremental (identifica el archivo del que salió una copia en NVS)
+inline uint32_t configHash(uint32_t hash, const char* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+#define CONFIG_HASH_SEED 2166136261UL
@@ -0,0 +1,93 @@
+// ============================================================================
+//  Librería: IGatePipeline
+//  Descripción: Implementación de la lógica del iGate.
+// ============================================================================
+#include "IGatePipeline.h"
+
+#include <string.h>
+
+const char* const PIPE_STAGE_NAMES[PIPE_STAGE_COUNT] = {
+  "parse", "dupes", "heard", "digi", "gate"
+};
+
+IGatePipeline::IGatePipeline(uint32_t heardMaxAgeMs)
+    : heardList_(heardMaxAgeMs), callsign_(""), hook_(nullptr), hookContext_(nullptr) {
+  memset(&gateStats_, 0, sizeof(gateStats_));
+}
+
+void IGatePipeline::begin(const DigiConfig& digi, const char* callsign) {
+  callsign_ = callsign;
+  digiEngine_.compile(digi, callsign);
+}
+
+// ============================================================================
+//  Función: onRfFrame()
+//  Descripción: Duplicados antes que nada (una trama repetida no cuenta como
+//               escuchada ni se digipea otra vez); luego las tramas propias
+//               se descartan y el resto actualiza la tabla de estaciones y
+//               pasa por las reglas del digipeater. Una trama de una
+//               combinación de solo recepción (txModem = false) se queda en
+//               los duplicados: la estación no escucharía nuestra respuesta.
+// ============================================================================
+RfOutcome IGatePipeline::onRfFrame(const char* data, size_t length, int16_t rssi, float snr,
+                                   uint32_t nowMs, bool txModem) {
+  RfOutcome out;
+  out.digi.length = 0;
+  out.digi.delayMs = 0;
+  out.digi.rule = -1;
+
+  AX25Packet ax;
+  parseAX25(data, length, ax);
+  stage(PIPE_PARSED);
+
+  out.hash = dupeHash(ax);
+  bool duplicate = dupeFilter_.checkHash(out.hash, nowMs);
+  stage(PIPE_DUP_CHECKED);
+  if (duplicate) {
+    out.verdict = RF_DUPLICATE;
+    return out;
+  }
+
+  if (ax.equals(ax.source, callsign_)) {
+    out.verdict = RF_OWN;
+    return out;
+  }
+  out.verdict = RF_ACCEPTED;
+  if (!txModem) return out;
+
+  AprsInfo aprs;
+  decodeAprs(ax, aprs);                       // Sin posición si no decodifica
+  heardList_.update(ax, aprs, rssi, snr, nowMs);
+  stage(PIPE_HEARD_UPDATED);
+
+  out.digi = digiEngine_.process(ax, digiFrame_, sizeof(digiFrame_));
+  stage(PIPE_DIGI_DONE);
+  return out;
+}
+
+// ============================================================================
+//  Función: gateToRf()
+//  Descripción: Un mensaje APRS-IS pasa a RF solo si es un mensaje APRS
+//               (":DESTINO  :texto") y el destinatario se escuchó sin
+//               digipeaters dentro de windowMs.
+// ============================================================================
+GateVerdict IGatePipeline::gateToRf(const char* data, size_t length, uint32_t windowMs,
+                                    uint32_t nowMs) {
+  AX25Packet ax;
+  parseAX25(data, length, ax);
+  AprsInfo aprs;
+  GateVerdict verdict = GATE_PASS;
+
+  if (!decodeAprs(ax, aprs) || aprs.type != APRS_TYPE_MESSAGE) {
+    verdict = GATE_NOT_MESSAGE;
+  } else if (!heardList_.heardDirect(ax.data(aprs.addressee), aprs.addressee.length, windowMs,
+                                     nowMs)) {
+    verdict = GATE_NOT_HEARD;
+  }
+
+  if (verdict == GATE_PASS) gateStats_.passed++;
+  else if (verdict == GATE_NOT_HEARD) gateStats_.notHeard++;
+  else gateStats_.notMessage++;
+  stage(PIPE_GATED);
+  return verdict;
+}
@@ -0,0 +1,112 @@
+// ============================================================================
+//  Librería: IGatePipeline
+//  Descripción: Lógica del iGate independiente del hardware, la misma en la
+//               tarea de radio y en la reproducción de trazas en el PC:
+//                 - RF: decodificación AX.25, duplicados, estaciones
+//                   escuchadas y digipeating
+//                 - APRS-IS → RF: solo mensajes a estaciones escuchadas
+//                   directamente
+//               El tiempo llega como parámetro y un gancho opcional avisa
+//               el fin de cada etapa para medirla (latencia en el equipo,
+//               tiempo de CPU en la reproducción). Sin memoria dinámica.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AX25.h>
+#include <AprsDecoder.h>
+#include <DigiEngine.h>
+#include <DupeFilter.h>
+#include <HeardList.h>
+
+// ============================================================================
+//  Etapas del procesamiento de una trama RF
+// ============================================================================
+enum PipelineStage : uint8_t {
+  PIPE_PARSED,         // Trama decodificada
+  PIPE_DUP_CHECKED,    // Revisada contra la tabla de duplicados
+  PIPE_HEARD_UPDATED,  // Estación registrada como escuchada
+  PIPE_DIGI_DONE,      // Reglas del digipeater evaluadas
+  PIPE_GATED,          // Línea APRS-IS evaluada para RF
+  PIPE_STAGE_COUNT
+};
+
+extern const char* const PIPE_STAGE_NAMES[PIPE_STAGE_COUNT];
+
+typedef void (*PipelineStageHook)(PipelineStage stage, void* context);
+
+// ============================================================================
+//  Resultado de una trama RF
+// ============================================================================
+enum RfVerdict : uint8_t {
+  RF_DUPLICATE,   // Ya vista dentro de DUP_TIMEOUT: no se reenvía
+  RF_OWN,         // Trama propia: no se reenvía ni se digipea
+  RF_ACCEPTED,    // Se reenvía a APRS-IS (y quizá se digipea)
+};
+
+struct RfOutcome {
+  RfVerdict    verdict;
+  uint32_t     hash;   // dupeHash: identifica la trama para la demora viscosa
+  DigiDecision digi;   // length 0 = no se digipea; trama en digiFrame()
+};
+
+// ============================================================================
+//  Resultado de una línea APRS-IS candidata a RF
+// ============================================================================
+enum GateVerdict : uint8_t {
+  GATE_PASS,         // Mensaje a una estación escuchada directamente
+  GATE_NOT_MESSAGE,  // No es un mensaje APRS (":DESTINO  :texto")
+  GATE_NOT_HEARD,    // Destinatario no escuchado directo en la ventana
+};
+
+struct GateStats {
+  uint32_t passed;
+  uint32_t notHeard;
+  uint32_t notMessage;
+};
+
+class IGatePipeline {
+ public:
+  // heardMaxAgeMs: antigüedad máxima de la tabla de estaciones escuchadas
+  explicit IGatePipeline(uint32_t heardMaxAgeMs);
+
+  // Compila las reglas del digipeater; callsign debe seguir vigente
+  void begin(const DigiConfig& digi, const char* callsign);
+
+  // Gancho llamado al final de cada etapa (nullptr para desactivarlo)
+  void setStageHook(PipelineStageHook hook, void* context) {
+    hook_ = hook;
+    hookContext_ = context;
+  }
+
+  // txModem = false: recibida en una combinación SF/BW en la que no se
+  // transmite (no actualiza estaciones escuchadas ni se digipea)
+  RfOutcome onRfFrame(const char* data, size_t length, int16_t rssi, float snr,
+                      uint32_t nowMs, bool txModem = true);
+
+  // Trama a digipear de la última llamada a onRfFrame()
+  const char* digiFrame() const { return digiFrame_; }
+
+  GateVerdict gateToRf(const char* data, size_t length, uint32_t windowMs, uint32_t nowMs);
+
+  const DupeFilter& dupeFilter() const { return dupeFilter_; }
+  HeardList&        heardList() { return heardList_; }
+  const DigiEngine& digiEngine() const { return digiEngine_; }
+  const GateStats&  gateStats() const { return gateStats_; }
+
+ private:
+  void stage(PipelineStage s) {
+    if (hook_ != nullptr) hook_(s, hookContext_);
+  }
+
+  DupeFilter        dupeFilter_;
+  HeardList         heardList_;
+  DigiEngine        digiEngine_;
+  const char*       callsign_;
+  char              digiFrame_[AX25_MAX_FRAME];
+  GateStats         gateStats_;
+  PipelineStageHook hook_;
+  void*             hookContext_;
+};
@@ -0,0 +1,297 @@
+// ============================================================================
+//  Librería: JsonStream
+//  Descripción: Implementación del lector JSON por flujo.
+// ============================================================================
+#include "JsonStream.h"
+
+#include <string.h>
+
+const char* const JSON_ERROR_NAMES[] = {
+  "ok", "sintaxis", "anidamiento", "incompleto", "valor rechazado"
+};
+
+JsonStream::JsonStream(JsonValueFn onValue, void* context)
+    : onValue_(onValue), context_(context) {
+  reset();
+}
+
+void JsonStream::reset() {
+  state_ = EXPECT_VALUE;
+  stringIsKey_ = false;
+  unicodeDigits_ = 0;
+  unicodeValue_ = 0;
+  depth_ = 0;
+  path_[0] = '\0';
+  pathLength_ = 0;
+  tokenLength_ = 0;
+  tokenTruncated_ = false;
+  error_ = JSON_OK;
+  line_ = 1;
+  column_ = 0;
+  values_ = 0;
+}
+
+bool JsonStream::feed(const char* data, size_t length) {
+  if (error_ != JSON_OK) return false;
+  for (size_t i = 0; i < length; i++) {
+    char c = data[i];
+    if (c == '\n') {
+      line_++;
+      column_ = 0;
+    } else {
+      column_++;
+    }
+    if (!step(c)) return false;
+  }
+  return true;
+}
+
+bool JsonStream::finish() {
+  if (error_ != JSON_OK) return false;
+  if (state_ == IN_LITERAL && depth_ == 0 && !endLiteral()) return false;
+  if (state_ != DONE) return fail(JSON_ERR_INCOMPLETE);
+  return true;
+}
+
+bool JsonStream::fail(JsonError e) {
+  error_ = e;
+  return false;
+}
+
+void JsonStream::putToken(char c) {
+  if (tokenLength_ < JSON_MAX_TOKEN) token_[tokenLength_++] = c;
+  else tokenTruncated_ = true;
+}
+
+int JsonStream::innermostIndex() const {
+  for (int d = depth_ - 1; d >= 0; d--) {
+    if (levels_[d].array) return levels_[d].index;
+  }
+  return -1;
+}
+
+void JsonStream::afterValue() {
+  state_ = depth_ == 0 ? DONE : AFTER_VALUE;
+}
+
+// ============================================================================
+//  Contenedores y ruta
+// ============================================================================
+bool JsonStream::openContainer(bool array) {
+  if (depth_ >= JSON_MAX_DEPTH) return fail(JSON_ERR_DEPTH);
+  Level& l = levels_[depth_++];
+  l.array = array;
+  l.index = 0;
+  l.pathLength = pathLength_;
+  l.empty = true;
+  state_ = array ? EXPECT_VALUE : EXPECT_KEY;
+  return true;
+}
+
+bool JsonStream::closeContainer(bool array) {
+  if (depth_ == 0 || levels_[depth_ - 1].array != array) return fail(JSON_ERR_SYNTAX);
+  pathLength_ = levels_[--depth_].pathLength;
+  path_[pathLength_] = '\0';
+  afterValue();
+  return true;
+}
+
+bool JsonStream::pushKey() {
+  Level& l = levels_[depth_ - 1];
+  l.empty = false;
+  size_t length = l.pathLength;
+  if (length > 0) {
+    if (length >= JSON_MAX_PATH) return fail(JSON_ERR_DEPTH);
+    path_[length++] = '.';
+  }
+  if (tokenTruncated_ || length + tokenLength_ > JSON_MAX_PATH) return fail(JSON_ERR_DEPTH);
+  memcpy(path_ + length, token_, tokenLength_);
+  pathLength_ = (uint8_t)(length + tokenLength_);
+  path_[pathLength_] = '\0';
+  state_ = EXPECT_COLON;
+  return true;
+}
+
+// ============================================================================
+//  Valores escalares
+// ============================================================================
+bool JsonStream::endScalar(JsonValueType type) {
+  token_[tokenLength_] = '\0';
+  JsonValue v;
+  v.type = type;
+  v.text = token_;
+  v.length = tokenLength_;
+  v.truncated = tokenTruncated_;
+  v.boolean = type == JSON_BOOL && token_[0] == 't';
+  values_++;
+  if (!onValue_(path_, innermostIndex(), v, context_)) return fail(JSON_ERR_HANDLER);
+  afterValue();
+  return true;
+}
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+static bool validNumber(const char* s, size_t n) {
+  size_t i = 0;
+  if (i < n && s[i] == '-') i++;
+  if (i >= n) return false;
+  if (s[i] == '0') {
+    i++;
+  } else if (s[i] >= '1' && s[i] <= '9') {
+    while (i < n && s[i] >= '0' && s[i] <= '9') i++;
+  } else {
+    return false;
+  }
+  if (i < n && s[i] == '.') {
+    size_t start = ++i;
+    while (i < n && s[i] >= '0' && s[i] <= '9') i++;
+    if (i == start) return false;
+  }
+  if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+    i++;
+    if (i < n && (s[i] == '+' || s[i] == '-')) i++;
+    size_t start = i;
+    while (i < n && s[i] >= '0' && s[i] <= '9') i++;
+    if (i == start) return false;
+  }
+  return i == n;
+}
+
+bool JsonStream::endLiteral() {
+  token_[tokenLength_] = '\0';
+  if (tokenTruncated_) return fail(JSON_ERR_SYNTAX);
+  if (strcmp(token_, "true") == 0 || strcmp(token_, "false") == 0) return endScalar(JSON_BOOL);
+  if (strcmp(token_, "null") == 0) return endScalar(JSON_NULL);
+  if (!validNumber(token_, tokenLength_)) return fail(JSON_ERR_SYNTAX);
+  return endScalar(JSON_NUMBER);
+}
+
+bool JsonStream::beginValue(char c) {
+  if (depth_ > 0 && levels_[depth_ - 1].array) {
+    if (c == ']' && levels_[depth_ - 1].empty) return closeContainer(true);
+    levels_[depth_ - 1].empty = false;
+  }
+  tokenLength_ = 0;
+  tokenTruncated_ = false;
+
+  if (c == '{') return openContainer(false);
+  if (c == '[') return openContainer(true);
+  if (c == '"') {
+    stringIsKey_ = false;
+    state_ = IN_STRING;
+    return true;
+  }
+  if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+    putToken(c);
+    state_ = IN_LITERAL;
+    return true;
+  }
+  return fail(JSON_ERR_SYNTAX);
+}
+
+// ============================================================================
+//  Máquina de estados: un carácter por llamada
+// ============================================================================
+static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+bool JsonStream::step(char c) {
+  switch (state_) {
+    case IN_STRING:
+      if (c == '"') {
+        token_[tokenLength_] = '\0';
+        return stringIsKey_ ? pushKey() : endScalar(JSON_STRING);
+      }
+      if (c == '\\') {
+        state_ = IN_ESCAPE;
+        return true;
+      }
+      if ((uint8_t)c < 0x20) return fail(JSON_ERR_SYNTAX);
+      putToken(c);
+      return true;
+
+    case IN_ESCAPE: {
+      const char* from = "\"\\/bfnrt";
+      const char* to   = "\"\\/\b\f\n\r\t";
+      const char* p = strchr(from, c);
+      state_ = IN_STRING;
+      if (c == 'u') {
+        unicodeDigits_ = 0;
+        unicodeValue_ = 0;
+        state_ = IN_UNICODE;
+        return true;
+      }
+      if (c == '\0' || p == nullptr) return fail(JSON_ERR_SYNTAX);
+      putToken(to[p - from]);
+      return true;
+    }
+
+    case IN_UNICODE: {
+      uint8_t digit;
+      if (c >= '0' && c <= '9') digit = c - '0';
+      else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+      else return fail(JSON_ERR_SYNTAX);
+      unicodeValue_ = (uint16_t)(unicodeValue_ << 4 | digit);
+      if (++unicodeDigits_ == 4) {
+        putToken(unicodeValue_ < 0x80 ? (char)unicodeValue_ : '?');
+        state_ = IN_STRING;
+      }
+      return true;
+    }
+
+    case IN_LITERAL:
+      if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+          c == '+' || c == '-' || c == '.') {
+        putToken(c);
+        return true;
+      }
+      if (!endLiteral()) return false;
+      return step(c);   // El delimitador se procesa en AFTER_VALUE / DONE
+
+    default:
+      break;
+  }
+
+  if (isSpace(c)) return true;
+
+  switch (state_) {
+    case EXPECT_VALUE:
+      return beginValue(c);
+
+    case EXPECT_KEY:
+      if (c == '"') {
+        tokenLength_ = 0;
+        tokenTruncated_ = false;
+        stringIsKey_ = true;
+        state_ = IN_STRING;
+        return true;
+      }
+      if (c == '}' && levels_[depth_ - 1].empty) return closeContainer(false);
+      return fail(JSON_ERR_SYNTAX);
+
+    case EXPECT_COLON:
+      if (c != ':') return fail(JSON_ERR_SYNTAX);
+      state_ = EXPECT_VALUE;
+      return true;
+
+    case AFTER_VALUE: {
+      Level& l = levels_[depth_ - 1];
+      if (c == ',') {
+        if (l.array) {
+          l.index++;
+          pathLength_ = l.pathLength;
+          path_[pathLength_] = '\0';
+          state_ = EXPECT_VALUE;
+        } else {
+          state_ = EXPECT_KEY;
+        }
+        return true;
+      }
+      if (c == '}') return closeContainer(false);
+      if (c == ']') return closeContainer(true);
+      return fail(JSON_ERR_SYNTAX);
+    }
+
+    default:   // DONE: solo espacios después del documento
+      return fail(JSON_ERR_SYNTAX);
+  }
+}
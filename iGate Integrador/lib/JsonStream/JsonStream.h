@@ -0,0 +1,123 @@
+// ============================================================================
+//  Librería: JsonStream
+//  Descripción: Lector JSON por flujo, sin árbol (estilo SAX) y sin memoria
+//               dinámica. Se alimenta por trozos con feed() (p. ej. lecturas
+//               de 64 bytes de un archivo) y por cada valor escalar llama a
+//               una función con la ruta de claves separada por puntos
+//               ("wifi.AP.SSID") y el índice del arreglo más interno. Las
+//               cadenas admiten los escapes de JSON; \uXXXX fuera de ASCII
+//               se reemplaza por '?'. Los errores quedan con línea y columna.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Parámetros fijados en compilación
+#ifndef JSON_MAX_DEPTH
+#define JSON_MAX_DEPTH 6             // Objetos / arreglos anidados
+#endif
+#ifndef JSON_MAX_PATH
+#define JSON_MAX_PATH 64             // Ruta completa "a.b.c"
+#endif
+#ifndef JSON_MAX_TOKEN
+#define JSON_MAX_TOKEN 128           // Cadena o número más largo
+#endif
+
+enum JsonValueType : uint8_t {
+  JSON_STRING,
+  JSON_NUMBER,
+  JSON_BOOL,
+  JSON_NULL,
+};
+
+// Valor escalar entregado: text es válido solo durante la llamada
+struct JsonValue {
+  JsonValueType type;
+  const char*   text;       // Terminado en '\0' (sin comillas ni escapes)
+  size_t        length;
+  bool          truncated;  // Más largo que JSON_MAX_TOKEN
+  bool          boolean;    // Solo JSON_BOOL
+};
+
+// index: posición en el arreglo más interno (-1 si no hay arreglo en la
+// ruta). Devolver false aborta la lectura con JSON_ERR_HANDLER.
+typedef bool (*JsonValueFn)(const char* path, int index, const JsonValue& value,
+                            void* context);
+
+enum JsonError : uint8_t {
+  JSON_OK,
+  JSON_ERR_SYNTAX,      // Carácter inesperado
+  JSON_ERR_DEPTH,       // Más de JSON_MAX_DEPTH niveles o ruta muy larga
+  JSON_ERR_INCOMPLETE,  // El documento terminó antes de cerrarse
+  JSON_ERR_HANDLER,     // La función de valores lo rechazó
+};
+
+extern const char* const JSON_ERROR_NAMES[];
+
+class JsonStream {
+ public:
+  JsonStream(JsonValueFn onValue, void* context);
+
+  // false en cuanto hay un error; las llamadas siguientes se ignoran
+  bool feed(const char* data, size_t length);
+  // Fin del documento: false si quedó incompleto o con error
+  bool finish();
+  void reset();
+
+  JsonError error() const { return error_; }
+  uint32_t  line() const { return line_; }
+  uint32_t  column() const { return column_; }
+  uint32_t  values() const { return values_; }
+
+ private:
+  enum State : uint8_t {
+    EXPECT_VALUE,       // Inicio de un valor
+    EXPECT_KEY,         // Tras '{' o ',' en un objeto
+    EXPECT_COLON,
+    AFTER_VALUE,        // Espera ',' o el cierre del contenedor
+    IN_STRING,
+    IN_ESCAPE,
+    IN_UNICODE,
+    IN_LITERAL,         // Número, true, false o null
+    DONE,
+  };
+
+  struct Level {
+    bool     array;
+    int16_t  index;        // Elemento actual (arreglos)
+    uint8_t  pathLength;   // Longitud de la ruta al entrar al nivel
+    bool     empty;        // Aún sin elementos (admite cierre inmediato)
+  };
+
+  bool step(char c);
+  bool fail(JsonError e);
+  bool beginValue(char c);
+  bool endScalar(JsonValueType type);
+  bool endLiteral();
+  bool pushKey();
+  bool openContainer(bool array);
+  bool closeContainer(bool array);
+  void afterValue();
+  void putToken(char c);
+  int  innermostIndex() const;
+
+  JsonValueFn onValue_;
+  void*       context_;
+
+  State     state_;
+  bool      stringIsKey_;
+  uint8_t   unicodeDigits_;
+  uint16_t  unicodeValue_;
+  Level     levels_[JSON_MAX_DEPTH];
+  uint8_t   depth_;
+  char      path_[JSON_MAX_PATH + 1];
+  uint8_t   pathLength_;
+  char      token_[JSON_MAX_TOKEN + 1];
+  size_t    tokenLength_;
+  bool      tokenTruncated_;
+  JsonError error_;
+  uint32_t  line_;
+  uint32_t  column_;
+  uint32_t  values_;
+};
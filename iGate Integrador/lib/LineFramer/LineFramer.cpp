@@ -0,0 +1,84 @@
+// ============================================================================
+//  Librería: LineFramer
+//  Descripción: Implementación del separador de líneas.
+// ============================================================================
+#include "LineFramer.h"
+
+#include <string.h>
+
+LineFramer::LineFramer() {
+  memset(&stats_, 0, sizeof(stats_));
+  reset();
+}
+
+void LineFramer::reset() {
+  start_ = scan_ = end_ = 0;
+  discarding_ = false;
+}
+
+char* LineFramer::writePtr(size_t& room) {
+  if (start_ == end_) {
+    start_ = scan_ = end_ = 0;
+  } else if (end_ == LINE_FRAMER_CAPACITY && start_ > 0) {
+    // Solo se mueve la línea parcial (a lo sumo LINE_FRAMER_MAX_LINE bytes)
+    size_t partial = end_ - start_;
+    memmove(buf_, buf_ + start_, partial);
+    scan_ -= start_;
+    start_ = 0;
+    end_ = partial;
+  }
+  room = LINE_FRAMER_CAPACITY - end_;
+  return buf_ + end_;
+}
+
+void LineFramer::commit(size_t n) {
+  if (n > LINE_FRAMER_CAPACITY - end_) n = LINE_FRAMER_CAPACITY - end_;
+  end_ += n;
+  stats_.bytes += n;
+}
+
+// ============================================================================
+//  Función: next()
+//  Descripción: Busca el '\n' solo en los bytes nuevos (scan_), reemplaza el
+//               fin de línea por '\0' y entrega la vista. Si la línea en
+//               curso ya supera el límite sin '\n', se descarta lo recibido y
+//               se sigue descartando hasta el próximo '\n'.
+// ============================================================================
+bool LineFramer::next(LineSlice& line) {
+  for (;;) {
+    char* nl = (char*)memchr(buf_ + scan_, '\n', end_ - scan_);
+    if (nl == nullptr) {
+      scan_ = end_;
+      if (discarding_) {
+        start_ = scan_ = end_;       // Sigue la línea larga: nada que guardar
+      } else if (end_ - start_ > LINE_FRAMER_MAX_LINE) {
+        stats_.oversized++;
+        discarding_ = true;
+        start_ = scan_ = end_;
+      }
+      return false;
+    }
+
+    size_t lineEnd = nl - buf_;
+    size_t lineStart = start_;
+    start_ = scan_ = lineEnd + 1;
+
+    if (discarding_) {               // Cola de una línea larga
+      discarding_ = false;
+      continue;
+    }
+
+    size_t length = lineEnd - lineStart;
+    if (length > 0 && buf_[lineEnd - 1] == '\r') length--;
+    if (length > LINE_FRAMER_MAX_LINE) {
+      stats_.oversized++;
+      continue;
+    }
+
+    buf_[lineStart + length] = '\0';
+    line.data = buf_ + lineStart;
+    line.length = (uint16_t)length;
+    stats_.lines++;
+    return true;
+  }
+}
@@ -0,0 +1,67 @@
+// ============================================================================
+//  Librería: LineFramer
+//  Descripción: Separador de líneas para el tráfico entrante de APRS-IS.
+//               El buffer de recepción es fijo y se llena con lecturas en
+//               bloque (writePtr() + commit()); next() entrega líneas
+//               completas como vistas dentro del mismo buffer, sin copias ni
+//               memoria dinámica. Las líneas que superan LINE_FRAMER_MAX_LINE
+//               se descartan hasta el siguiente '\n' y quedan contadas.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Parámetros fijados en compilación
+#ifndef LINE_FRAMER_CAPACITY
+#define LINE_FRAMER_CAPACITY 1024   // Bytes del buffer de recepción
+#endif
+#ifndef LINE_FRAMER_MAX_LINE
+#define LINE_FRAMER_MAX_LINE 510    // Límite de APRS-IS: 512 bytes con "\r\n"
+#endif
+
+static_assert(LINE_FRAMER_MAX_LINE < LINE_FRAMER_CAPACITY,
+              "LINE_FRAMER_MAX_LINE debe ser menor que LINE_FRAMER_CAPACITY");
+
+// ============================================================================
+//  Línea entregada: apunta al buffer del framer, sin "\r\n" y terminada en
+//  '\0'. Es válida hasta la siguiente llamada a writePtr() o reset().
+// ============================================================================
+struct LineSlice {
+  const char* data;
+  uint16_t    length;
+};
+
+// ============================================================================
+//  Contadores del framer
+// ============================================================================
+struct LineFramerStats {
+  uint32_t bytes;      // Bytes recibidos
+  uint32_t lines;      // Líneas entregadas
+  uint32_t oversized;  // Líneas descartadas por exceder el límite
+};
+
+class LineFramer {
+ public:
+  LineFramer();
+
+  // Espacio libre contiguo para una lectura en bloque. Compacta la línea
+  // parcial al inicio del buffer cuando hace falta (invalida las vistas).
+  char* writePtr(size_t& room);
+  void  commit(size_t n);
+
+  // Siguiente línea completa; false si falta el '\n'
+  bool next(LineSlice& line);
+
+  size_t pending() const { return end_ - start_; }
+  const LineFramerStats& stats() const { return stats_; }
+  void reset();
+
+ private:
+  char            buf_[LINE_FRAMER_CAPACITY];
+  size_t          start_;       // Inicio de la línea en curso
+  size_t          scan_;        // Hasta dónde ya se buscó el '\n'
+  size_t          end_;         // Fin de los datos recibidos
+  bool            discarding_;  // Descartando el resto de una línea larga
+  LineFramerStats stats_;
+};
@@ -0,0 +1,200 @@
+// ============================================================================
+//  Librería: LineWriter
+//  Descripción: Implementación del buffer de salida por líneas.
+// ============================================================================
+#include "LineWriter.h"
+
+#include <errno.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+LineWriter::LineWriter()
+    : fd_(-1), flushBytes_(LINE_WRITER_CAPACITY / 2), deadlineMs_(0),
+      onLine_(nullptr), context_(nullptr) {
+  memset(&stats_, 0, sizeof(stats_));
+  clear();
+}
+
+void LineWriter::setPolicy(size_t flushBytes, uint32_t deadlineMs) {
+  flushBytes_ = flushBytes > 0 ? flushBytes : 1;
+  deadlineMs_ = deadlineMs;
+}
+
+void LineWriter::setLineHandler(LineDoneFn fn, void* context) {
+  onLine_ = fn;
+  context_ = context;
+}
+
+void LineWriter::clear() {
+  first_ = start_ = end_ = 0;
+  head_ = count_ = 0;
+  firstAt_ = 0;
+  blocked_ = false;
+  blockedAt_ = 0;
+}
+
+bool LineWriter::attach(int fd, uint32_t now) {
+  if (fd_ >= 0) detach(now);
+  fd_ = fd;
+  int one = 1;
+  return setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) == 0;
+}
+
+void LineWriter::detach(uint32_t now) {
+  if (blocked_) endStall(now);
+  while (count_ > 0) finish(false);
+  clear();
+  fd_ = -1;
+}
+
+// ============================================================================
+//  Escritura de líneas
+// ============================================================================
+void LineWriter::compact() {
+  // Se conserva la línea más vieja completa (puede haber salido a medias y
+  // el manejador la recibe entera si se pierde)
+  size_t keep = end_ - first_;
+  memmove(buf_, buf_ + first_, keep);
+  for (size_t i = 0; i < count_; i++) {
+    Line& line = lines_[(head_ + i) % LINE_WRITER_MAX_LINES];
+    line.end = (uint16_t)(line.end - first_);
+  }
+  start_ -= first_;
+  end_ = keep;
+  first_ = 0;
+}
+
+char* LineWriter::lineBuffer(size_t& room) {
+  room = 0;
+  if (fd_ < 0 || count_ == LINE_WRITER_MAX_LINES) return buf_ + end_;
+  if (first_ > 0 && LINE_WRITER_CAPACITY - end_ <= LINE_WRITER_MAX_LINE) compact();
+  room = LINE_WRITER_CAPACITY - end_;
+  if (room > LINE_WRITER_MAX_LINE + 1) room = LINE_WRITER_MAX_LINE + 1;
+  return buf_ + end_;
+}
+
+bool LineWriter::commitLine(size_t length, uint32_t now, uint8_t kind, uint32_t stamp,
+                            uint32_t origin) {
+  if (fd_ < 0 || count_ == LINE_WRITER_MAX_LINES || length > LINE_WRITER_MAX_LINE ||
+      length + 1 > LINE_WRITER_CAPACITY - end_) {
+    stats_.rejected++;
+    return false;
+  }
+
+  if (end_ == start_) firstAt_ = now;
+  buf_[end_ + length] = '\n';
+  end_ += length + 1;
+
+  Line& line = lines_[(head_ + count_) % LINE_WRITER_MAX_LINES];
+  line.end = (uint16_t)end_;
+  line.kind = kind;
+  line.stamp = stamp;
+  line.origin = origin;
+  count_++;
+
+  stats_.lines++;
+  if (pending() > stats_.maxPending) stats_.maxPending = (uint16_t)pending();
+  return true;
+}
+
+bool LineWriter::append(const char* data, size_t length, uint32_t now, uint8_t kind,
+                        uint32_t stamp, uint32_t origin) {
+  size_t room;
+  char* dst = lineBuffer(room);
+  if (length >= room) {
+    stats_.rejected++;
+    return false;
+  }
+  memcpy(dst, data, length);
+  return commitLine(length, now, kind, stamp, origin);
+}
+
+// ============================================================================
+//  Envío
+// ============================================================================
+WriteResult LineWriter::tick(uint32_t now) {
+  if (fd_ < 0 || pending() == 0) return WRITE_IDLE;
+  if (blocked_) return send(now);
+  if (pending() >= flushBytes_) {
+    stats_.bySize++;
+    return send(now);
+  }
+  if (now - firstAt_ >= deadlineMs_) {
+    stats_.byDeadline++;
+    return send(now);
+  }
+  return WRITE_IDLE;
+}
+
+WriteResult LineWriter::flush(uint32_t now) {
+  if (fd_ < 0 || pending() == 0) return WRITE_IDLE;
+  if (!blocked_) stats_.forced++;
+  return send(now);
+}
+
+uint32_t LineWriter::untilFlush(uint32_t now) const {
+  if (fd_ < 0 || pending() == 0 || blocked_) return 0xFFFFFFFF;
+  if (pending() >= flushBytes_) return 0;
+  uint32_t elapsed = now - firstAt_;
+  return elapsed >= deadlineMs_ ? 0 : deadlineMs_ - elapsed;
+}
+
+void LineWriter::endStall(uint32_t now) {
+  uint32_t stall = now - blockedAt_;
+  stats_.stallMs += stall;
+  if (stall > stats_.maxStallMs) stats_.maxStallMs = stall;
+  blocked_ = false;
+}
+
+void LineWriter::finish(bool sent) {
+  const Line& line = lines_[head_];
+  WrittenLine done;
+  done.data = buf_ + first_;
+  done.length = (uint16_t)(line.end - first_ - 1);
+  done.kind = line.kind;
+  done.sent = sent;
+  done.stamp = line.stamp;
+  done.origin = line.origin;
+  if (sent) stats_.sent++;
+  else stats_.lost++;
+
+  first_ = line.end;
+  head_ = (head_ + 1) % LINE_WRITER_MAX_LINES;
+  count_--;
+  if (onLine_ != nullptr) onLine_(done, context_);
+}
+
+WriteResult LineWriter::send(uint32_t now) {
+  while (start_ < end_) {
+    size_t want = end_ - start_;
+    ssize_t n = ::send(fd_, buf_ + start_, want, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n <= 0) {
+      if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        stats_.errors++;
+        return WRITE_ERROR;
+      }
+      if (!blocked_) {
+        blocked_ = true;
+        blockedAt_ = now;
+        stats_.stalls++;
+      }
+      return WRITE_BLOCKED;
+    }
+
+    if (blocked_) endStall(now);
+    stats_.writes++;
+    stats_.bytes += (uint32_t)n;
+    if ((size_t)n < want) stats_.partial++;
+    start_ += (size_t)n;
+    while (count_ > 0 && lines_[head_].end <= start_) finish(true);
+  }
+
+  first_ = start_ = end_ = 0;
+  return WRITE_DONE;
+}
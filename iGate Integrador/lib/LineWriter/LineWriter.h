@@ -0,0 +1,149 @@
+// ============================================================================
+//  Librería: LineWriter
+//  Descripción: Buffer de salida por líneas para la sesión APRS-IS (la
+//               contraparte de LineFramer). Las líneas se escriben directo
+//               en un buffer fijo (lineBuffer() + commitLine(), o append())
+//               y salen juntas en un solo send() cuando el buffer alcanza
+//               flushBytes o cuando la línea más vieja espera deadlineMs.
+//               El envío no bloquea (MSG_DONTWAIT): una escritura parcial
+//               deja el resto para el próximo tick() y el tiempo que el
+//               socket no acepta datos queda medido. Como la agrupación la
+//               hace el buffer, attach() desactiva Nagle (TCP_NODELAY) para
+//               que cada envío salga sin esperar el ACK del anterior.
+//               Cada línea termina en el manejador como enviada (escrita
+//               completa en el socket) o perdida (sin escribir o a medias al
+//               cerrar la sesión). Sin memoria dinámica.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Parámetros fijados en compilación
+#ifndef LINE_WRITER_CAPACITY
+#define LINE_WRITER_CAPACITY 2048   // Bytes del buffer de salida
+#endif
+#ifndef LINE_WRITER_MAX_LINES
+#define LINE_WRITER_MAX_LINES 32    // Líneas pendientes a la vez
+#endif
+#ifndef LINE_WRITER_MAX_LINE
+#define LINE_WRITER_MAX_LINE 510    // Límite de APRS-IS: 512 bytes con "\r\n"
+#endif
+
+static_assert(LINE_WRITER_MAX_LINE < LINE_WRITER_CAPACITY,
+              "LINE_WRITER_MAX_LINE debe ser menor que LINE_WRITER_CAPACITY");
+static_assert(LINE_WRITER_CAPACITY <= 65535, "Los índices de línea son de 16 bits");
+
+enum WriteResult : uint8_t {
+  WRITE_IDLE,       // Nada que enviar o todavía no corresponde
+  WRITE_DONE,       // Buffer vaciado
+  WRITE_BLOCKED,    // El socket no aceptó todo; se reintenta en el próximo tick()
+  WRITE_ERROR,      // send() falló: la sesión está caída
+};
+
+// ============================================================================
+//  Línea terminada: data apunta al buffer (sin el '\n') y es válida solo
+//  durante la llamada. kind, stamp y origin son valores del llamador.
+// ============================================================================
+struct WrittenLine {
+  const char* data;
+  uint16_t    length;
+  uint8_t     kind;
+  bool        sent;       // false: perdida al cerrar la sesión
+  uint32_t    stamp;
+  uint32_t    origin;
+};
+
+typedef void (*LineDoneFn)(const WrittenLine& line, void* context);
+
+// ============================================================================
+//  Contadores del buffer
+// ============================================================================
+struct LineWriterStats {
+  uint32_t lines;        // Líneas aceptadas
+  uint32_t sent;         // Escritas completas en el socket
+  uint32_t lost;         // Sin escribir o a medias al cerrar la sesión
+  uint32_t rejected;     // Sin lugar, más largas que el límite o sin sesión
+  uint32_t bytes;        // Bytes aceptados por send()
+  uint32_t writes;       // send() con datos aceptados (un segmento con TCP_NODELAY,
+                         // salvo que supere el MSS)
+  uint32_t partial;      // send() que aceptaron solo una parte
+  uint32_t bySize;       // Envíos por llegar a flushBytes
+  uint32_t byDeadline;   // Envíos por vencer deadlineMs
+  uint32_t forced;       // Envíos pedidos con flush()
+  uint32_t stalls;       // Veces que el socket dejó de aceptar datos (EAGAIN)
+  uint32_t stallMs;      // Tiempo total con datos pendientes y el socket lleno
+  uint32_t maxStallMs;
+  uint32_t errors;
+  uint16_t maxPending;   // Máximo de bytes pendientes
+};
+
+class LineWriter {
+ public:
+  LineWriter();
+
+  void setPolicy(size_t flushBytes, uint32_t deadlineMs);
+  void setLineHandler(LineDoneFn fn, void* context);
+
+  // Toma el socket de la sesión (el llamador sigue siendo el dueño) y
+  // desactiva Nagle; false si no se pudo desactivar (el buffer funciona igual)
+  bool attach(int fd, uint32_t now);
+  // Suelta el socket: las líneas pendientes se entregan como perdidas
+  void detach(uint32_t now);
+  bool attached() const { return fd_ >= 0; }
+
+  // Espacio para formatear una línea en el lugar: room incluye el byte del
+  // terminador, como en snprintf(p, room, ...). Sin sesión o sin lugar,
+  // room = 0. La línea se confirma con commitLine() (se agrega el '\n').
+  char* lineBuffer(size_t& room);
+  bool  commitLine(size_t length, uint32_t now, uint8_t kind = 0, uint32_t stamp = 0,
+                   uint32_t origin = 0);
+  // Copia una línea (sin '\n'); false si no hay lugar
+  bool  append(const char* data, size_t length, uint32_t now, uint8_t kind = 0,
+               uint32_t stamp = 0, uint32_t origin = 0);
+
+  // Envía si se llegó a flushBytes, venció el plazo o hay un envío a medias
+  WriteResult tick(uint32_t now);
+  // Envía ya lo pendiente
+  WriteResult flush(uint32_t now);
+
+  // ms hasta que vence el plazo (0 = ya vencido); 0xFFFFFFFF sin pendientes
+  // o bloqueado (el reintento queda a cargo del período del llamador)
+  uint32_t untilFlush(uint32_t now) const;
+
+  size_t pending() const { return end_ - start_; }
+  size_t queuedLines() const { return count_; }
+  bool   blocked() const { return blocked_; }
+  const LineWriterStats& stats() const { return stats_; }
+
+ private:
+  struct Line {
+    uint16_t end;        // Índice después del '\n'
+    uint8_t  kind;
+    uint32_t stamp;
+    uint32_t origin;
+  };
+
+  WriteResult send(uint32_t now);
+  void        finish(bool sent);   // Entrega la línea más vieja
+  void        compact();
+  void        endStall(uint32_t now);
+  void        clear();
+
+  char            buf_[LINE_WRITER_CAPACITY];
+  size_t          first_;      // Inicio de la línea más vieja sin terminar
+  size_t          start_;      // Siguiente byte a enviar
+  size_t          end_;        // Fin de los datos
+  Line            lines_[LINE_WRITER_MAX_LINES];
+  size_t          head_;
+  size_t          count_;
+  int             fd_;
+  size_t          flushBytes_;
+  uint32_t        deadlineMs_;
+  uint32_t        firstAt_;    // Llegada del primer byte pendiente
+  bool            blocked_;
+  uint32_t        blockedAt_;
+  LineDoneFn      onLine_;
+  void*           context_;
+  LineWriterStats stats_;
+};
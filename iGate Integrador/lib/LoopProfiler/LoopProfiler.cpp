@@ -0,0 +1,82 @@
+// ============================================================================
+//  Librería: LoopProfiler
+//  Descripción: Cierre de secciones e iteraciones y detección de bloqueos.
+// ============================================================================
+#include "LoopProfiler.h"
+
+LoopProfiler::LoopProfiler(const char* const* names, uint8_t count, uint32_t stallUs)
+    : names_(names),
+      count_(count <= PROFILER_MAX_SECTIONS ? count : PROFILER_MAX_SECTIONS),
+      stallUs_(stallUs),
+      running_(false),
+      current_(PROFILER_NO_SECTION),
+      iterationStart_(0),
+      sectionStart_(0),
+      worst_(PROFILER_NO_SECTION),
+      worstUs_(0) {
+  stalls_.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < PROFILER_MAX_SECTIONS; i++) stallsIn_[i].store(0, std::memory_order_relaxed);
+}
+
+const char* LoopProfiler::sectionName(uint8_t section) const {
+  return section < count_ ? names_[section] : "-";
+}
+
+void LoopProfiler::begin(uint32_t nowUs) {
+  worst_ = PROFILER_NO_SECTION;
+  worstUs_ = 0;
+  iterationStart_.store(nowUs, std::memory_order_relaxed);
+  sectionStart_.store(nowUs, std::memory_order_relaxed);
+  current_.store(PROFILER_NO_SECTION, std::memory_order_relaxed);
+  running_.store(true, std::memory_order_release);
+}
+
+// La duración de la sección abierta se acumula en su histograma y compite
+// por ser la más larga de la iteración
+void LoopProfiler::closeSection(uint32_t nowUs) {
+  uint8_t s = current_.load(std::memory_order_relaxed);
+  if (s == PROFILER_NO_SECTION) return;
+  uint32_t elapsed = nowUs - sectionStart_.load(std::memory_order_relaxed);
+  sections_[s].record(elapsed);
+  if (worst_ == PROFILER_NO_SECTION || elapsed > worstUs_) {
+    worst_ = s;
+    worstUs_ = elapsed;
+  }
+}
+
+void LoopProfiler::enter(uint8_t section, uint32_t nowUs) {
+  if (section >= count_) return;
+  closeSection(nowUs);
+  sectionStart_.store(nowUs, std::memory_order_relaxed);
+  current_.store(section, std::memory_order_release);
+}
+
+// ============================================================================
+//  Función: end()
+//  Descripción: Cierra la sección abierta y la iteración. Si la iteración
+//               supera el umbral la cuenta como bloqueo, atribuido a la
+//               sección más larga, y devuelve el detalle para el registro.
+// ============================================================================
+bool LoopProfiler::end(uint32_t nowUs, StallReport& out) {
+  closeSection(nowUs);
+  current_.store(PROFILER_NO_SECTION, std::memory_order_relaxed);
+  running_.store(false, std::memory_order_release);
+
+  uint32_t elapsed = nowUs - iterationStart_.load(std::memory_order_relaxed);
+  iteration_.record(elapsed);
+  if (elapsed <= stallUs_) return false;
+
+  stalls_.fetch_add(1, std::memory_order_relaxed);
+  if (worst_ != PROFILER_NO_SECTION) stallsIn_[worst_].fetch_add(1, std::memory_order_relaxed);
+  out.iterationUs = elapsed;
+  out.section = worst_;
+  out.sectionUs = worstUs_;
+  return true;
+}
+
+void LoopProfiler::reset() {
+  iteration_.reset();
+  for (LatencyHistogram& h : sections_) h.reset();
+  stalls_.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < PROFILER_MAX_SECTIONS; i++) stallsIn_[i].store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,91 @@
+// ============================================================================
+//  Librería: LoopProfiler
+//  Descripción: Perfil de las iteraciones de una tarea y de sus secciones
+//               con nombre, sin memoria dinámica. La tarea marca el inicio
+//               de la iteración, entra en cada sección (entrar en una cierra
+//               la anterior) y la cierra al final; cada duración va a un
+//               LatencyHistogram (media, máximo y percentiles). Una
+//               iteración que supera el umbral se cuenta como bloqueo y se
+//               informa con la sección más larga de esa iteración.
+//               La sección en curso y su instante de entrada se publican
+//               en atómicos: el perro guardián (otra tarea o una
+//               interrupción) puede leer dónde quedó colgada la tarea.
+//               Un solo escritor (la tarea dueña); el reloj lo pasa el
+//               llamador en µs (micros() en el firmware), con vuelta a cero.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include <Metrics.h>
+
+#ifndef PROFILER_MAX_SECTIONS
+#define PROFILER_MAX_SECTIONS 8      // Secciones por tarea
+#endif
+
+// Fuera de toda sección: entre iteraciones o antes de la primera entrada
+static const uint8_t PROFILER_NO_SECTION = 0xFF;
+
+// Bloqueo detectado al cerrar una iteración
+struct StallReport {
+  uint32_t iterationUs;     // Duración de la iteración completa
+  uint8_t  section;         // Sección más larga (PROFILER_NO_SECTION si ninguna)
+  uint32_t sectionUs;       // Duración de esa sección
+};
+
+class LoopProfiler {
+ public:
+  // names: nombres estáticos de las secciones (count <= PROFILER_MAX_SECTIONS)
+  LoopProfiler(const char* const* names, uint8_t count, uint32_t stallUs);
+
+  // --------------------------------------------------------------------------
+  //  Lado de la tarea dueña
+  // --------------------------------------------------------------------------
+  void begin(uint32_t nowUs);
+  void enter(uint8_t section, uint32_t nowUs);
+  // Cierra la iteración; true (y out completo) si superó el umbral
+  bool end(uint32_t nowUs, StallReport& out);
+
+  // --------------------------------------------------------------------------
+  //  Lectura desde otras tareas o desde la interrupción del perro guardián
+  // --------------------------------------------------------------------------
+  uint8_t  current() const { return current_.load(std::memory_order_relaxed); }
+  uint32_t currentSinceUs() const { return sectionStart_.load(std::memory_order_relaxed); }
+  bool     inIteration() const { return running_.load(std::memory_order_relaxed); }
+  uint32_t iterationStartUs() const { return iterationStart_.load(std::memory_order_relaxed); }
+
+  uint8_t     sectionCount() const { return count_; }
+  const char* sectionName(uint8_t section) const;
+  uint32_t    stallUs() const { return stallUs_; }
+
+  const LatencyHistogram& iterations() const { return iteration_; }
+  const LatencyHistogram& section(uint8_t s) const { return sections_[s]; }
+  uint32_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+  // Bloqueos en los que la sección fue la más larga de la iteración
+  uint32_t stallsIn(uint8_t s) const { return stallsIn_[s].load(std::memory_order_relaxed); }
+
+  void reset();
+
+ private:
+  void closeSection(uint32_t nowUs);
+
+  const char* const*    names_;
+  uint8_t               count_;
+  uint32_t              stallUs_;
+
+  LatencyHistogram      iteration_;
+  LatencyHistogram      sections_[PROFILER_MAX_SECTIONS];
+  std::atomic<uint32_t> stalls_;
+  std::atomic<uint32_t> stallsIn_[PROFILER_MAX_SECTIONS];
+
+  // Estado de la iteración en curso
+  std::atomic<bool>     running_;
+  std::atomic<uint8_t>  current_;
+  std::atomic<uint32_t> iterationStart_;
+  std::atomic<uint32_t> sectionStart_;
+  uint8_t               worst_;
+  uint32_t              worstUs_;
+};
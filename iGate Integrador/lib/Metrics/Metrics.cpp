@@ -0,0 +1,103 @@
+// ============================================================================
+//  Librería: Metrics
+//  Descripción: Implementación del histograma de latencias y de las tasas.
+// ============================================================================
+#include "Metrics.h"
+
+const uint32_t LATENCY_BUCKET_LIMITS_US[LATENCY_BUCKETS - 1] = {
+  100, 200, 500,                        // µs
+  1000, 2000, 5000,                     // ms
+  10000, 20000, 50000,
+  100000, 200000, 500000,
+  1000000, 2000000, 5000000,            // s
+  10000000, 20000000, 60000000,
+};
+
+// ============================================================================
+//  Histograma de latencias
+// ============================================================================
+LatencyHistogram::LatencyHistogram() { reset(); }
+
+void LatencyHistogram::reset() {
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) buckets_[i].store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  sumUs_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::record(uint32_t micros) {
+  size_t i = 0;
+  while (i < LATENCY_BUCKETS - 1 && micros >= LATENCY_BUCKET_LIMITS_US[i]) i++;
+  buckets_[i].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sumUs_.fetch_add(micros, std::memory_order_relaxed);
+  if (micros > max_.load(std::memory_order_relaxed)) max_.store(micros, std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::meanUs() const {
+  uint32_t n = count();
+  return n ? (uint32_t)(sumUs_.load(std::memory_order_relaxed) / n) : 0;
+}
+
+uint32_t LatencyHistogram::percentileUs(uint8_t p) const {
+  uint32_t n = count();
+  if (n == 0) return 0;
+  uint32_t rank = (uint32_t)(((uint64_t)n * p + 99) / 100);   // 1..n
+  if (rank == 0) rank = 1;
+
+  uint32_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS - 1; i++) {
+    seen += bucket(i);
+    if (seen >= rank) {
+      uint32_t limit = LATENCY_BUCKET_LIMITS_US[i];
+      uint32_t max = maxUs();
+      return max < limit ? max : limit;    // Nunca por encima de lo observado
+    }
+  }
+  return maxUs();
+}
+
+// ============================================================================
+//  Tasa de paquetes y bytes por segundo
+// ============================================================================
+RateCounter::RateCounter() : packets_(0), bytes_(0) {
+  for (Slot& s : slots_) {
+    s.second.store(UINT32_MAX, std::memory_order_relaxed);
+    s.packets.store(0, std::memory_order_relaxed);
+    s.bytes.store(0, std::memory_order_relaxed);
+  }
+}
+
+void RateCounter::add(size_t bytes, uint32_t nowMs) {
+  uint32_t second = nowMs / 1000;
+  Slot& s = slots_[second % (RATE_WINDOW_S + 1)];
+  if (s.second.load(std::memory_order_relaxed) != second) {
+    s.packets.store(0, std::memory_order_relaxed);
+    s.bytes.store(0, std::memory_order_relaxed);
+    s.second.store(second, std::memory_order_release);
+  }
+  s.packets.fetch_add(1, std::memory_order_relaxed);
+  s.bytes.fetch_add((uint32_t)bytes, std::memory_order_relaxed);
+  packets_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add((uint32_t)bytes, std::memory_order_relaxed);
+}
+
+// El segundo en curso queda fuera: está incompleto
+uint32_t RateCounter::windowSum(uint32_t nowMs, bool bytes) const {
+  uint32_t current = nowMs / 1000;
+  uint32_t sum = 0;
+  for (const Slot& s : slots_) {
+    uint32_t age = current - s.second.load(std::memory_order_acquire);
+    if (age == 0 || age > RATE_WINDOW_S) continue;
+    sum += bytes ? s.bytes.load(std::memory_order_relaxed) : s.packets.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+float RateCounter::packetsPerSecond(uint32_t nowMs) const {
+  return windowSum(nowMs, false) / (float)RATE_WINDOW_S;
+}
+
+float RateCounter::bytesPerSecond(uint32_t nowMs) const {
+  return windowSum(nowMs, true) / (float)RATE_WINDOW_S;
+}
@@ -0,0 +1,82 @@
+// ============================================================================
+//  Librería: Metrics
+//  Descripción: Instrumentos de medición de tamaño fijo, sin memoria
+//               dinámica y seguros para un escritor y lectores en otras
+//               tareas (contadores atómicos relajados):
+//                 - LatencyHistogram: latencias en µs en cubetas fijas
+//                   1-2-5 (100 µs .. 60 s), con media, máximo y percentiles
+//                 - RateCounter: paquetes y bytes por segundo en una ventana
+//                   deslizante de RATE_WINDOW_S segundos, más los totales
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+// Parámetros fijados en compilación
+#define LATENCY_BUCKETS 19           // 18 límites + desborde
+#ifndef RATE_WINDOW_S
+#define RATE_WINDOW_S 10             // Segundos completos promediados
+#endif
+
+// Límite superior (exclusivo) de cada cubeta, en µs; la última no tiene
+extern const uint32_t LATENCY_BUCKET_LIMITS_US[LATENCY_BUCKETS - 1];
+
+// ============================================================================
+//  Histograma de latencias
+// ============================================================================
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void record(uint32_t micros);
+  void reset();
+
+  uint32_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint32_t bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+  uint32_t maxUs() const { return max_.load(std::memory_order_relaxed); }
+  uint32_t meanUs() const;
+
+  // Cota superior del percentil p (0..100) según las cubetas; en la de
+  // desborde devuelve el máximo observado. 0 si no hay muestras.
+  uint32_t percentileUs(uint8_t p) const;
+
+ private:
+  std::atomic<uint32_t> buckets_[LATENCY_BUCKETS];
+  std::atomic<uint32_t> count_;
+  std::atomic<uint64_t> sumUs_;
+  std::atomic<uint32_t> max_;
+};
+
+// ============================================================================
+//  Tasa de paquetes y bytes por segundo
+// ============================================================================
+class RateCounter {
+ public:
+  RateCounter();
+
+  void add(size_t bytes, uint32_t nowMs);
+
+  uint32_t totalPackets() const { return packets_.load(std::memory_order_relaxed); }
+  uint32_t totalBytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  // Promedio de los últimos RATE_WINDOW_S segundos completos
+  float packetsPerSecond(uint32_t nowMs) const;
+  float bytesPerSecond(uint32_t nowMs) const;
+
+ private:
+  // Una ranura por segundo: se reutiliza cuando su segundo queda fuera
+  struct Slot {
+    std::atomic<uint32_t> second;
+    std::atomic<uint32_t> packets;
+    std::atomic<uint32_t> bytes;
+  };
+
+  uint32_t windowSum(uint32_t nowMs, bool bytes) const;
+
+  Slot                  slots_[RATE_WINDOW_S + 1];
+  std::atomic<uint32_t> packets_;
+  std::atomic<uint32_t> bytes_;
+};
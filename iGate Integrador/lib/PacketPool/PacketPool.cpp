@@ -0,0 +1,83 @@
+// ============================================================================
+//  Librería: PacketPool
+//  Descripción: Reserva y liberación sin bloqueos sobre la máscara de libres.
+// ============================================================================
+#include "PacketPool.h"
+
+static const uint32_t ALL_FREE =
+    PACKET_POOL_SIZE == 32 ? 0xFFFFFFFFUL : ((1UL << PACKET_POOL_SIZE) - 1);
+
+static size_t countBits(uint32_t mask) { return (size_t)__builtin_popcount(mask); }
+
+PacketPool::PacketPool()
+    : free_(ALL_FREE), highWater_(0), allocs_(0), exhausted_(0), deferred_(0), badReleases_(0) {
+  for (size_t i = 0; i < PACKET_POOL_SIZE; i++) {
+    bufs_[i].refs_.store(0, std::memory_order_relaxed);
+    bufs_[i].index_ = (uint8_t)i;
+    bufs_[i].length = 0;
+  }
+}
+
+// ============================================================================
+//  Función: alloc()
+//  Descripción: Toma el libre de índice más bajo con compare-and-swap sobre
+//               la máscara; si otra tarea ganó la carrera, reintenta con la
+//               máscara nueva. Cuenta el rechazo como agotamiento (sin
+//               reserva) o como diferido (la reserva lo impidió).
+// ============================================================================
+PacketBuf* PacketPool::alloc(size_t keepFree) {
+  uint32_t mask = free_.load(std::memory_order_acquire);
+  for (;;) {
+    size_t freeCount = countBits(mask);
+    if (freeCount == 0 || freeCount <= keepFree) {
+      if (freeCount == 0 && keepFree == 0) exhausted_.fetch_add(1, std::memory_order_relaxed);
+      else deferred_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    uint32_t bit = mask & (~mask + 1);   // Bit libre más bajo
+    if (free_.compare_exchange_weak(mask, mask & ~bit, std::memory_order_acq_rel,
+                                    std::memory_order_acquire)) {
+      PacketBuf* buf = &bufs_[__builtin_ctz(bit)];
+      buf->refs_.store(1, std::memory_order_relaxed);
+      allocs_.fetch_add(1, std::memory_order_relaxed);
+      uint32_t used = (uint32_t)(PACKET_POOL_SIZE - freeCount + 1);
+      // Otro productor puede subir la marca a la vez: solo se escribe si es mayor
+      uint32_t high = highWater_.load(std::memory_order_relaxed);
+      while (used > high &&
+             !highWater_.compare_exchange_weak(high, used, std::memory_order_relaxed)) {
+      }
+      return buf;
+    }
+  }
+}
+
+void PacketPool::retain(PacketBuf* buf) {
+  buf->refs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// La última referencia publica el buffer (release) antes de marcarlo libre:
+// quien lo reserve después ve terminadas todas las lecturas anteriores. Un
+// release() de más se deshace y se cuenta (es un error del llamador).
+void PacketPool::release(PacketBuf* buf) {
+  if (buf == nullptr) return;
+  uint8_t refs = buf->refs_.fetch_sub(1, std::memory_order_acq_rel);
+  if (refs == 0) {
+    buf->refs_.fetch_add(1, std::memory_order_relaxed);
+    badReleases_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (refs == 1) free_.fetch_or(1UL << buf->index_, std::memory_order_release);
+}
+
+size_t PacketPool::available() const {
+  return countBits(free_.load(std::memory_order_relaxed));
+}
+
+PacketPoolStats PacketPool::stats() const {
+  PacketPoolStats s;
+  s.allocs = allocs_.load(std::memory_order_relaxed);
+  s.exhausted = exhausted_.load(std::memory_order_relaxed);
+  s.deferred = deferred_.load(std::memory_order_relaxed);
+  s.badReleases = badReleases_.load(std::memory_order_relaxed);
+  return s;
+}
@@ -0,0 +1,81 @@
+// ============================================================================
+//  Librería: PacketPool
+//  Descripción: Conjunto fijo de buffers de trama con cuenta de referencias,
+//               reservado una sola vez (almacenamiento estático, sin heap).
+//               La tarea de radio vacía la FIFO del SX1276 directamente en un
+//               buffer y lo pasa por referencia: la cola hacia APRS-IS, la
+//               cola de almacenamiento y reenvío y la captura leen los mismos
+//               bytes, y el buffer vuelve al conjunto cuando el último
+//               consumidor lo libera. Los libres se marcan en una máscara
+//               atómica de 32 bits: alloc() y release() no bloquean y pueden
+//               llamarse desde cualquier tarea (no desde una interrupción).
+//               Los consumidores opcionales piden con una reserva (keepFree)
+//               para no dejar a la recepción sin buffers.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#ifndef PACKET_POOL_SIZE
+#define PACKET_POOL_SIZE 24        // Buffers (máximo 32: una máscara de bits)
+#endif
+#ifndef PACKET_POOL_BYTES
+#define PACKET_POOL_BYTES 256      // Datos por buffer (AX25_MAX_FRAME + 1)
+#endif
+
+static_assert(PACKET_POOL_SIZE >= 1 && PACKET_POOL_SIZE <= 32, "PACKET_POOL_SIZE debe estar entre 1 y 32");
+
+// Buffer compartido: los metadatos de recepción viajan con los bytes. Solo
+// quien lo reservó escribe, y antes de pasarlo a otra tarea.
+struct PacketBuf {
+  uint32_t rxMillis;        // Instante de recepción
+  uint32_t rxMicros;        // Flanco DIO0 o lectura del socket (métricas)
+  int16_t  rssi;            // dBm (0 fuera de RF)
+  float    snr;             // dB
+  uint16_t length;          // Bytes útiles en data
+  uint8_t  tag;             // Libre para el productor (combinación SF/BW)
+  char     data[PACKET_POOL_BYTES];
+
+ private:
+  friend class PacketPool;
+  std::atomic<uint8_t> refs_;
+  uint8_t              index_;
+};
+
+struct PacketPoolStats {
+  uint32_t allocs;          // Buffers entregados
+  uint32_t exhausted;       // Pedidos sin reserva (recepción) sin buffer libre
+  uint32_t deferred;        // Pedidos con reserva rechazados para protegerla
+  uint32_t badReleases;     // release() de un buffer ya libre (error de uso)
+};
+
+class PacketPool {
+ public:
+  PacketPool();
+
+  // Buffer con una referencia, o nullptr si quedarían menos de keepFree libres
+  PacketBuf* alloc(size_t keepFree = 0);
+  // Una referencia más (otro consumidor que lo liberará por su cuenta)
+  void retain(PacketBuf* buf);
+  // Suelta una referencia; con la última el buffer vuelve a estar libre
+  void release(PacketBuf* buf);
+
+  size_t capacity() const { return PACKET_POOL_SIZE; }
+  size_t available() const;                // Libres en este momento
+  size_t inUse() const { return capacity() - available(); }
+  size_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+  uint8_t refs(const PacketBuf* buf) const { return buf->refs_.load(std::memory_order_relaxed); }
+  PacketPoolStats stats() const;
+
+ private:
+  PacketBuf             bufs_[PACKET_POOL_SIZE];
+  std::atomic<uint32_t> free_;             // Bit i = bufs_[i] libre
+  std::atomic<uint32_t> highWater_;
+  std::atomic<uint32_t> allocs_;
+  std::atomic<uint32_t> exhausted_;
+  std::atomic<uint32_t> deferred_;
+  std::atomic<uint32_t> badReleases_;
+};
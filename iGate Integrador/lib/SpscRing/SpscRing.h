@@ -0,0 +1,97 @@
+// ============================================================================
+//  Librería: SpscRing
+//  Descripción: Cola circular sin bloqueos para un productor y un consumidor
+//               (SPSC). Los elementos se escriben y leen en sitio: el
+//               productor reserva un slot con acquire() y lo publica con
+//               publish(); el consumidor lo obtiene con peek() y lo libera
+//               con release(). Lleva contadores de desbordes y ocupación
+//               máxima para dimensionar la cola.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N debe ser potencia de 2");
+
+ public:
+  SpscRing() : head_(0), tail_(0), overflows_(0), highWater_(0) {}
+
+  // --------------------------------------------------------------------------
+  //  Lado productor
+  // --------------------------------------------------------------------------
+
+  // Slot libre para escribir, o nullptr si la cola está llena (desborde)
+  T* acquire() {
+    uint32_t h = head_.load(std::memory_order_relaxed);
+    uint32_t t = tail_.load(std::memory_order_acquire);
+    if (h - t >= N) {
+      overflows_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &slots_[h & (N - 1)];
+  }
+
+  // Hace visible al consumidor el slot obtenido con acquire()
+  void publish() {
+    uint32_t h = head_.load(std::memory_order_relaxed) + 1;
+    head_.store(h, std::memory_order_release);
+    // Un solo productor escribe highWater_: cargar y guardar no pierde máximos
+    uint32_t used = h - tail_.load(std::memory_order_relaxed);
+    if (used > highWater_.load(std::memory_order_relaxed))
+      highWater_.store(used, std::memory_order_relaxed);
+  }
+
+  bool push(const T& item) {
+    T* slot = acquire();
+    if (slot == nullptr) return false;
+    *slot = item;
+    publish();
+    return true;
+  }
+
+  // --------------------------------------------------------------------------
+  //  Lado consumidor
+  // --------------------------------------------------------------------------
+
+  // Elemento más antiguo, o nullptr si la cola está vacía
+  T* peek() {
+    uint32_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire)) return nullptr;
+    return &slots_[t & (N - 1)];
+  }
+
+  // Libera el elemento obtenido con peek()
+  void release() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  bool pop(T& item) {
+    T* slot = peek();
+    if (slot == nullptr) return false;
+    item = *slot;
+    release();
+    return true;
+  }
+
+  // --------------------------------------------------------------------------
+  //  Estadísticas (lectura desde cualquier tarea)
+  // --------------------------------------------------------------------------
+  size_t   size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  size_t   capacity() const { return N; }
+  uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+  uint32_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+ private:
+  T slots_[N];
+  std::atomic<uint32_t> head_;       // Próximo slot a escribir (productor)
+  std::atomic<uint32_t> tail_;       // Próximo slot a leer (consumidor)
+  std::atomic<uint32_t> overflows_;  // Elementos descartados por cola llena
+  std::atomic<uint32_t> highWater_;  // Ocupación máxima observada
+};
@@ -0,0 +1,174 @@
+// ============================================================================
+//  Librería: TxScheduler
+//  Descripción: Implementación del planificador de transmisión RF.
+// ============================================================================
+#include "TxScheduler.h"
+
+#include <string.h>
+
+const char* const TX_CLASS_NAMES[TX_CLASS_COUNT] = { "digi", "msg", "beacon" };
+
+// ============================================================================
+//  Tiempo en el aire (Semtech AN1200.13):
+//    Tsym     = 2^SF / BW
+//    Npayload = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20H) / (4(SF - 2DE))), 0) * CR
+//    T        = (Npreamble + 4.25) * Tsym + Npayload * Tsym
+// ============================================================================
+uint32_t loraAirtimeUs(const LoRaModemParams& modem, size_t payloadLength) {
+  int32_t sf = modem.spreadingFactor;
+  uint32_t symbolUs = (uint32_t)((((uint64_t)1) << sf) * 1000000ULL / modem.bandwidthHz);
+  int32_t de = symbolUs > 16000 ? 1 : 0;
+  int32_t h  = modem.implicitHeader ? 1 : 0;
+
+  int32_t num = 8 * (int32_t)payloadLength - 4 * sf + 28 + (modem.crc ? 16 : 0) - 20 * h;
+  int32_t den = 4 * (sf - 2 * de);
+  int32_t blocks = num > 0 ? (num + den - 1) / den : 0;
+  uint32_t payloadSymbols = 8 + (uint32_t)blocks * modem.codingRate4;
+
+  // (Npreamble + 4.25) * Tsym, en cuartos de símbolo para no perder precisión
+  uint32_t preambleUs = (uint32_t)(((uint64_t)modem.preambleLength * 4 + 17) * symbolUs / 4);
+  return preambleUs + payloadSymbols * symbolUs;
+}
+
+TxScheduler::TxScheduler(const LoRaModemParams& modem, uint32_t budgetMsPerMinute,
+                         const uint32_t maxWaitMs[TX_CLASS_COUNT])
+    : modem_(modem), budgetMs_(budgetMsPerMinute), backoffUntil_(0),
+      backoffActive_(false), budgetBlocked_(false), rng_(0x2545F491UL) {
+  memcpy(maxWaitMs_, maxWaitMs, sizeof(maxWaitMs_));
+  memset(queues_, 0, sizeof(queues_));
+  memset(airtime_, 0, sizeof(airtime_));
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+bool TxScheduler::enqueue(TxClass txClass, const char* data, size_t length,
+                          uint32_t enqueuedMs, uint32_t nowMs, uint32_t originMicros) {
+  dropStale(nowMs);
+
+  ClassQueue& q = queues_[txClass];
+  TxClassStats& cs = stats_.classes[txClass];
+  if (q.count >= TX_QUEUE_DEPTH) {
+    cs.droppedFull++;
+    return false;
+  }
+  if (length > AX25_MAX_FRAME) length = AX25_MAX_FRAME;
+
+  TxFrame& f = q.frames[(q.head + q.count) % TX_QUEUE_DEPTH];
+  memcpy(f.data, data, length);
+  f.length       = (uint16_t)length;
+  f.txClass      = txClass;
+  f.busyCount    = 0;
+  f.enqueuedMs   = enqueuedMs;
+  f.originMicros = originMicros;
+  f.airtimeMs    = (loraAirtimeUs(modem_, length) + 999) / 1000;
+  q.count++;
+  cs.enqueued++;
+  return true;
+}
+
+TxFrame* TxScheduler::head(uint8_t* txClass) {
+  for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+    ClassQueue& q = queues_[c];
+    if (q.count == 0) continue;
+    if (txClass != nullptr) *txClass = c;
+    return &q.frames[q.head];
+  }
+  return nullptr;
+}
+
+void TxScheduler::popHead(ClassQueue& q) {
+  q.head = (q.head + 1) % TX_QUEUE_DEPTH;
+  q.count--;
+}
+
+void TxScheduler::dropStale(uint32_t nowMs) {
+  for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+    ClassQueue& q = queues_[c];
+    while (q.count > 0 && nowMs - q.frames[q.head].enqueuedMs > maxWaitMs_[c]) {
+      stats_.classes[c].droppedStale++;
+      popHead(q);
+    }
+  }
+}
+
+// ============================================================================
+//  Función: next()
+//  Descripción: Prioridad estricta: si la trama de mayor prioridad no cabe
+//               en el presupuesto, no se adelanta ninguna de menor prioridad.
+// ============================================================================
+const TxFrame* TxScheduler::next(uint32_t nowMs) {
+  dropStale(nowMs);
+
+  if (backoffActive_) {
+    if ((int32_t)(nowMs - backoffUntil_) < 0) return nullptr;
+    backoffActive_ = false;
+  }
+
+  TxFrame* f = head(nullptr);
+  if (f == nullptr) return nullptr;
+
+  if (airtimeLastMinute(nowMs) + f->airtimeMs > budgetMs_) {
+    if (!budgetBlocked_) stats_.budgetWaits++;
+    budgetBlocked_ = true;
+    return nullptr;
+  }
+  budgetBlocked_ = false;
+  return f;
+}
+
+uint32_t TxScheduler::randomSlots(uint32_t window) {
+  // xorshift32: suficiente para dispersar reintentos entre estaciones
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return rng_ % window;
+}
+
+void TxScheduler::channelBusy(uint32_t nowMs) {
+  stats_.channelBusy++;
+
+  uint8_t c;
+  TxFrame* f = head(&c);
+  if (f == nullptr) return;
+
+  uint8_t exponent = ++f->busyCount;
+  if (f->busyCount >= TX_LBT_MAX_ATTEMPTS) {
+    stats_.classes[c].droppedBusy++;
+    popHead(queues_[c]);
+  }
+  if (exponent > TX_LBT_MAX_EXPONENT) exponent = TX_LBT_MAX_EXPONENT;
+
+  backoffUntil_ = nowMs + (1 + randomSlots(1UL << exponent)) * TX_LBT_SLOT_MS;
+  backoffActive_ = true;
+}
+
+void TxScheduler::transmitting(uint32_t nowMs) {
+  uint8_t c;
+  TxFrame* f = head(&c);
+  if (f == nullptr) return;
+
+  TxClassStats& cs = stats_.classes[c];
+  uint32_t latency = nowMs - f->enqueuedMs;
+  cs.sent++;
+  cs.latencySumMs += latency;
+  if (latency > cs.latencyMaxMs) cs.latencyMaxMs = latency;
+
+  uint32_t second = nowMs / 1000;
+  AirtimeSlot& slot = airtime_[second % 60];
+  if (slot.second != second) {
+    slot.second = second;
+    slot.airtimeMs = 0;
+  }
+  slot.airtimeMs += f->airtimeMs;
+  stats_.airtimeTotalMs += f->airtimeMs;
+
+  popHead(queues_[c]);
+}
+
+uint32_t TxScheduler::airtimeLastMinute(uint32_t nowMs) const {
+  uint32_t second = nowMs / 1000;
+  uint32_t total = 0;
+  for (size_t i = 0; i < 60; i++) {
+    if (second - airtime_[i].second < 60) total += airtime_[i].airtimeMs;
+  }
+  return total;
+}
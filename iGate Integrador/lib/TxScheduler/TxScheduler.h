@@ -0,0 +1,153 @@
+// ============================================================================
+//  Librería: TxScheduler
+//  Descripción: Planificador de transmisión RF. Mantiene una cola fija por
+//               clase de prioridad (digipeat > mensajes APRS-IS → RF >
+//               beacons), controla el presupuesto de tiempo en el aire por
+//               minuto calculado a partir de SF/BW/CR y aplica una espera
+//               aleatoria exponencial cuando la escucha previa (LBT) detecta
+//               el canal ocupado. No toca el radio: quien lo usa hace la
+//               detección de canal y la transmisión.
+// ============================================================================
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AX25.h>
+
+// Parámetros fijados en compilación
+#ifndef TX_QUEUE_DEPTH
+#define TX_QUEUE_DEPTH 4            // Tramas en espera por clase
+#endif
+#ifndef TX_LBT_SLOT_MS
+#define TX_LBT_SLOT_MS 100UL        // Ranura de la espera aleatoria
+#endif
+#ifndef TX_LBT_MAX_EXPONENT
+#define TX_LBT_MAX_EXPONENT 5       // Ventana máxima: 2^5 ranuras
+#endif
+#ifndef TX_LBT_MAX_ATTEMPTS
+#define TX_LBT_MAX_ATTEMPTS 8       // Canal ocupado N veces: se descarta la trama
+#endif
+
+// ============================================================================
+//  Clases de tráfico, de mayor a menor prioridad
+// ============================================================================
+enum TxClass : uint8_t {
+  TX_CLASS_DIGI,      // Digipeat: solo sirve si sale enseguida
+  TX_CLASS_MESSAGE,   // Mensajes APRS-IS → RF
+  TX_CLASS_BEACON,    // Beacon propio
+  TX_CLASS_COUNT
+};
+
+extern const char* const TX_CLASS_NAMES[TX_CLASS_COUNT];
+
+// ============================================================================
+//  Parámetros del módem LoRa para el cálculo de tiempo en el aire
+// ============================================================================
+struct LoRaModemParams {
+  uint8_t  spreadingFactor;  // 6..12
+  uint32_t bandwidthHz;      // 7800..500000
+  uint8_t  codingRate4;      // Denominador de 4/x (5..8)
+  uint16_t preambleLength;   // Símbolos
+  bool     crc;
+  bool     implicitHeader;
+};
+
+// ============================================================================
+//  Función: loraAirtimeUs()
+//  Descripción: Tiempo en el aire de una trama según la fórmula de Semtech
+//               (AN1200.13), incluida la optimización de baja tasa que el
+//               SX1276 activa con símbolos de más de 16 ms.
+// ============================================================================
+uint32_t loraAirtimeUs(const LoRaModemParams& modem, size_t payloadLength);
+
+// ============================================================================
+//  Trama en cola
+// ============================================================================
+struct TxFrame {
+  uint32_t enqueuedMs;   // Entrada al sistema (para la latencia de cola)
+  uint32_t originMicros; // Marca de origen de quien la encoló (métricas)
+  uint32_t airtimeMs;
+  uint16_t length;
+  uint8_t  txClass;
+  uint8_t  busyCount;    // Veces que el LBT encontró el canal ocupado
+  char     data[AX25_MAX_FRAME];
+};
+
+// ============================================================================
+//  Contadores por clase y globales
+// ============================================================================
+struct TxClassStats {
+  uint32_t enqueued;
+  uint32_t sent;
+  uint32_t droppedFull;    // Cola de la clase llena
+  uint32_t droppedStale;   // Superó la espera máxima de la clase
+  uint32_t droppedBusy;    // Canal ocupado en TX_LBT_MAX_ATTEMPTS intentos
+  uint32_t latencySumMs;   // Espera en cola de las tramas enviadas
+  uint32_t latencyMaxMs;
+};
+
+struct TxSchedulerStats {
+  TxClassStats classes[TX_CLASS_COUNT];
+  uint32_t     channelBusy;      // Detecciones de canal ocupado
+  uint32_t     budgetWaits;      // Veces que el presupuesto retuvo una trama
+  uint32_t     airtimeTotalMs;
+};
+
+class TxScheduler {
+ public:
+  // budgetMsPerMinute: tiempo en el aire permitido en cualquier ventana de
+  // 60 s; maxWaitMs: espera máxima en cola por clase.
+  TxScheduler(const LoRaModemParams& modem, uint32_t budgetMsPerMinute,
+              const uint32_t maxWaitMs[TX_CLASS_COUNT]);
+
+  // Copia la trama a la cola de su clase; false si está llena
+  bool enqueue(TxClass txClass, const char* data, size_t length,
+               uint32_t enqueuedMs, uint32_t nowMs, uint32_t originMicros = 0);
+
+  // Trama de mayor prioridad lista para el LBT, o nullptr si no hay, si
+  // corre una espera aleatoria o si no cabe en el presupuesto.
+  const TxFrame* next(uint32_t nowMs);
+
+  // Resultado del LBT sobre la trama entregada por next()
+  void channelBusy(uint32_t nowMs);
+  void transmitting(uint32_t nowMs);   // Cobra el presupuesto y la saca de la cola
+
+  void seed(uint32_t value) { rng_ = value ? value : 1; }  // Semilla de la espera aleatoria
+  // Modulación leída de la configuración (antes de encolar tramas)
+  void setModem(const LoRaModemParams& modem) { modem_ = modem; }
+
+  uint32_t airtimeLastMinute(uint32_t nowMs) const;
+  uint32_t budgetMsPerMinute() const { return budgetMs_; }
+  size_t   queued(TxClass txClass) const { return queues_[txClass].count; }
+  const TxSchedulerStats& stats() const { return stats_; }
+
+ private:
+  struct ClassQueue {
+    TxFrame frames[TX_QUEUE_DEPTH];
+    uint8_t head;
+    uint8_t count;
+  };
+
+  // Historial de tiempo en el aire en ranuras de 1 s (ventana de 60 s)
+  struct AirtimeSlot {
+    uint32_t second;
+    uint32_t airtimeMs;
+  };
+
+  void dropStale(uint32_t nowMs);
+  void popHead(ClassQueue& q);
+  TxFrame* head(uint8_t* txClass);
+  uint32_t randomSlots(uint32_t window);
+
+  LoRaModemParams  modem_;
+  uint32_t         budgetMs_;
+  uint32_t         maxWaitMs_[TX_CLASS_COUNT];
+  ClassQueue       queues_[TX_CLASS_COUNT];
+  AirtimeSlot      airtime_[60];
+  uint32_t         backoffUntil_;
+  bool             backoffActive_;
+  bool             budgetBlocked_;
+  uint32_t         rng_;
+  TxSchedulerStats stats_;
+};
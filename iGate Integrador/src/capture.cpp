@@ -0,0 +1,338 @@
+// ============================================================================
+//  Captura de tráfico en LittleFS
+//  Los segmentos ocupan CAPTURE_SEGMENTS ranuras fijas ("/cap0.bin"...); el
+//  número de secuencia de su cabecera decide cuál es el más viejo. Cada
+//  arranque abre un segmento nuevo en la primera escritura, así un segmento
+//  nunca mezcla dos arranques (los instantes son millis()). Un lote sale en
+//  una sola escritura al llenarse (un bloque de LittleFS) o cuando su
+//  registro más viejo tiene CAPTURE_FLUSH_MS: pocas confirmaciones de
+//  metadatos por trama, que es lo que desgasta la flash.
+// ============================================================================
+#include "capture.h"
+
+#include <LittleFS.h>
+#include <atomic>
+#include <esp_task_wdt.h>
+
+#include "config.h"
+#include "log.h"
+#include "radio.h"
+#include "settings.h"
+#include "stats.h"
+
+#ifndef CAPTURE_RF_QUEUE_SIZE
+#define CAPTURE_RF_QUEUE_SIZE 16   // Tramas RF en espera de la tarea de log (potencia de 2)
+#endif
+#ifndef CAPTURE_IS_QUEUE_SIZE
+#define CAPTURE_IS_QUEUE_SIZE 8    // Líneas APRS-IS en espera (potencia de 2)
+#endif
+
+// Instante, RSSI, SNR y bytes viajan en el buffer; la entrada tiene una referencia
+struct CaptureEntry {
+  PacketBuf* packet;
+  uint8_t    direction;
+  uint8_t    spreadingFactor;
+};
+
+static SpscRing<CaptureEntry, CAPTURE_RF_QUEUE_SIZE> rfQueue;   // radio → log
+static SpscRing<CaptureEntry, CAPTURE_IS_QUEUE_SIZE> isQueue;   // red → log
+
+static CaptureBatch batch;       // Solo la tarea de log
+static bool     fsReady = false;
+static bool     segmentOpen = false;
+
+// Métricas y segmento actual (leídos por la tarea de pantalla)
+static std::atomic<uint32_t> segmentSequence(0);   // Último usado (0 = ninguno)
+static std::atomic<uint32_t> segmentBytes(0);
+static std::atomic<uint32_t> recordsWritten(0);
+static std::atomic<uint32_t> bytesWritten(0);
+static std::atomic<uint32_t> flushes(0);
+static std::atomic<uint32_t> flushUsTotal(0);
+static std::atomic<uint32_t> flushUsMax(0);
+static std::atomic<uint32_t> tooLong(0);
+static std::atomic<uint32_t> poolDeferred(0);   // Sin buffer por encima de la reserva
+static std::atomic<uint32_t> writeErrors(0);
+static std::atomic<uint32_t> segmentsOpened(0);
+
+static void segmentPath(uint32_t sequence, char* path, size_t size) {
+  snprintf(path, size, "/cap%lu.bin", (unsigned long)(sequence % CAPTURE_SEGMENTS));
+}
+
+static bool readSegmentHeader(const char* path, CaptureSegmentHeader& header) {
+  File file = LittleFS.open(path, FILE_READ);
+  bool ok = file && file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            captureSegmentValid(header);
+  if (file) file.close();
+  return ok;
+}
+
+// ============================================================================
+//  Función: captureBegin()
+//  Descripción: Monta LittleFS y toma la secuencia más alta de las ranuras;
+//               el primer lote de este arranque ocupa la siguiente (la más
+//               vieja), que recién ahí se borra.
+// ============================================================================
+bool captureBegin() {
+  if (!CAPTURE_ENABLED) return false;
+  fsReady = LittleFS.begin(true);
+  if (!fsReady) {
+    logEvent(EV_CAPTURE_NO_FS);
+    return false;
+  }
+  char path[16];
+  uint8_t found = 0;
+  for (uint8_t slot = 0; slot < CAPTURE_SEGMENTS; slot++) {
+    CaptureSegmentHeader header;
+    segmentPath(slot, path, sizeof(path));
+    if (!readSegmentHeader(path, header)) continue;
+    found++;
+    if (header.sequence > segmentSequence) segmentSequence = header.sequence;
+  }
+  logEvent(EV_CAPTURE_READY, { (unsigned)found, (unsigned)CAPTURE_SEGMENTS,
+                               (unsigned)(CAPTURE_SEGMENT_BYTES / 1024) });
+  return true;
+}
+
+// ============================================================================
+//  Productores: solo encolan un buffer (sin flash ni bloqueos). Cola llena:
+//  queda en overflows().
+// ============================================================================
+void captureRx(PacketBuf* packet, uint8_t spreadingFactor) {
+  if (!fsReady) return;
+  CaptureEntry* entry = rfQueue.acquire();
+  if (entry == nullptr) return;
+  packetPool.retain(packet);
+  entry->packet = packet;
+  entry->direction = CAP_RF_RX;
+  entry->spreadingFactor = spreadingFactor;
+  rfQueue.publish();
+}
+
+// Copia a un buffer propio: TX y APRS-IS no llegan en uno del conjunto
+static PacketBuf* copyToPool(const char* data, size_t length, uint32_t timeMs) {
+  if (length > AX25_MAX_FRAME) {   // Una línea así tampoco podría salir por RF
+    tooLong++;
+    return nullptr;
+  }
+  PacketBuf* packet = packetPool.alloc(PACKET_POOL_RESERVE);
+  if (packet == nullptr) {
+    poolDeferred++;
+    return nullptr;
+  }
+  packet->rxMillis = timeMs;
+  packet->rxMicros = 0;
+  packet->rssi = 0;
+  packet->snr = 0.0f;
+  packet->length = (uint16_t)length;
+  memcpy(packet->data, data, length);
+  return packet;
+}
+
+void captureTx(const char* data, size_t length, uint8_t spreadingFactor, uint32_t timeMs) {
+  if (!fsReady) return;
+  CaptureEntry* entry = rfQueue.acquire();
+  if (entry == nullptr) return;
+  entry->packet = copyToPool(data, length, timeMs);
+  if (entry->packet == nullptr) return;
+  entry->direction = CAP_RF_TX;
+  entry->spreadingFactor = spreadingFactor;
+  rfQueue.publish();
+}
+
+void captureIs(const char* data, size_t length, uint32_t timeMs) {
+  if (!fsReady || !CAPTURE_IS_RX) return;
+  CaptureEntry* entry = isQueue.acquire();
+  if (entry == nullptr) return;
+  entry->packet = copyToPool(data, length, timeMs);
+  if (entry->packet == nullptr) return;
+  entry->direction = CAP_IS_RX;
+  entry->spreadingFactor = 0;
+  isQueue.publish();
+}
+
+// ============================================================================
+//  Función: writeBatch()
+//  Descripción: Escribe el lote en el segmento actual (abre el siguiente si
+//               no entra) y mide cuánto tardó la flash.
+// ============================================================================
+static void writeBatch() {
+  if (batch.empty()) return;
+  uint32_t start = micros();
+  char path[16];
+
+  if (!segmentOpen || segmentBytes + batch.size() > CAPTURE_SEGMENT_BYTES) {
+    segmentSequence++;
+    segmentPath(segmentSequence, path, sizeof(path));
+    CaptureSegmentHeader header;
+    captureSegmentHeader(header, segmentSequence, millis());
+    File file = LittleFS.open(path, FILE_WRITE);   // Trunca la ranura más vieja
+    bool ok = file && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    if (file) file.close();
+    segmentOpen = ok;
+    segmentBytes = ok ? sizeof(header) : 0;
+    segmentsOpened++;
+  }
+
+  segmentPath(segmentSequence, path, sizeof(path));
+  bool ok = false;
+  if (segmentOpen) {
+    File file = LittleFS.open(path, FILE_APPEND);
+    ok = file && file.write(batch.data(), batch.size()) == batch.size();
+    if (file) file.close();
+  }
+  uint32_t elapsed = micros() - start;
+
+  if (!ok) {
+    writeErrors++;
+    segmentOpen = false;   // El próximo lote prueba con un segmento nuevo
+    logEvent(EV_CAPTURE_WRITE_FAILED, { (unsigned)batch.records() });
+  } else {
+    segmentBytes += batch.size();
+    recordsWritten += batch.records();
+    bytesWritten += batch.size();
+    flushes++;
+    flushUsTotal += elapsed;
+    uint32_t perRecord = elapsed / batch.records();
+    if (elapsed > flushUsMax) {
+      flushUsMax = elapsed;
+      if (perRecord > CAPTURE_STALL_BUDGET_US) {
+        logEvent(EV_CAPTURE_STALL, { (unsigned)batch.records(), elapsed, perRecord,
+                                     CAPTURE_STALL_BUDGET_US });
+      }
+    }
+  }
+  batch.clear();
+}
+
+// Agrega la entrada al lote (lo escribe antes si no entra) y la libera
+// junto con su referencia al buffer
+template <typename Queue>
+static void take(Queue& queue, const CaptureEntry& entry) {
+  const PacketBuf& packet = *entry.packet;
+  if (!batch.fits(packet.length)) writeBatch();
+  CaptureRecord record;
+  record.timeMs = packet.rxMillis;
+  record.frequencyHz = entry.direction == CAP_IS_RX ? 0 : settings.frequencyHz;
+  record.rssi = packet.rssi;
+  record.snr = packet.snr;
+  record.direction = entry.direction;
+  record.spreadingFactor = entry.spreadingFactor;
+  record.length = packet.length;
+  record.data = packet.data;
+  batch.add(record);
+  packetPool.release(entry.packet);
+  queue.release();
+}
+
+// ============================================================================
+//  Función: captureService()
+//  Descripción: Pasa las colas al lote en orden de llegada (mezcla RF y
+//               APRS-IS por instante) y lo escribe si el registro más viejo
+//               ya esperó CAPTURE_FLUSH_MS o si se pide (force).
+// ============================================================================
+void captureService(bool force) {
+  if (!fsReady) return;
+  for (;;) {
+    CaptureEntry* rf = rfQueue.peek();
+    CaptureEntry* is = isQueue.peek();
+    if (rf == nullptr && is == nullptr) break;
+    bool rfFirst = is == nullptr ||
+                   (rf != nullptr && (int32_t)(rf->packet->rxMillis - is->packet->rxMillis) <= 0);
+    if (rfFirst) take(rfQueue, *rf);
+    else take(isQueue, *is);
+  }
+  if (!batch.empty() && (force || millis() - batch.oldestMs() >= CAPTURE_FLUSH_MS)) writeBatch();
+}
+
+// ============================================================================
+//  Función: captureDump()
+//  Descripción: Escribe el lote pendiente y recorre los segmentos del más
+//               viejo al más nuevo imprimiendo la traza de texto que lee
+//               bench/replay_bench.cpp. Los instantes de cada arranque se
+//               desplazan para que la traza quede en orden. Alimenta al
+//               perro guardián por registro.
+// ============================================================================
+void captureDump() {
+  if (!fsReady) return;
+  captureService(true);
+
+  static uint8_t raw[sizeof(CaptureRecordHeader) + CAPTURE_MAX_DATA];
+  static char    line[CAPTURE_MAX_DATA + 48];
+  uint32_t offsetMs = 0;
+  uint32_t lastMs = 0;
+
+  uint32_t last = segmentSequence;
+  uint32_t first = last >= CAPTURE_SEGMENTS ? last - CAPTURE_SEGMENTS + 1 : 1;
+  for (uint32_t seq = first; seq <= last; seq++) {
+    char path[16];
+    segmentPath(seq, path, sizeof(path));
+    File file = LittleFS.open(path, FILE_READ);
+    CaptureSegmentHeader header;
+    if (!file || file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        !captureSegmentValid(header) || header.sequence != seq) {
+      if (file) file.close();
+      continue;
+    }
+    if (header.startMs + offsetMs < lastMs) offsetMs = lastMs + 1000 - header.startMs;
+    Serial.printf("# segmento %lu, inicio %lu ms\n", (unsigned long)seq,
+                  (unsigned long)(header.startMs + offsetMs));
+
+    uint32_t records = 0;
+    bool torn = false;
+    CaptureRecord record;
+    while (file.available() > 0) {
+      torn = file.read(raw, sizeof(CaptureRecordHeader)) != sizeof(CaptureRecordHeader) ||
+             !captureDecodeHeader(raw, record) ||
+             file.read(raw + sizeof(CaptureRecordHeader), record.length) != record.length;
+      if (!torn) {
+        record.data = (const char*)raw + sizeof(CaptureRecordHeader);
+        torn = !captureVerify(raw, record);
+      }
+      if (torn) break;
+      size_t n = captureFormatTrace(record, offsetMs, line, sizeof(line) - 1);
+      line[n++] = '\n';
+      Serial.write((const uint8_t*)line, n);
+      esp_task_wdt_reset();   // El volcado completo tarda minutos por la UART
+      lastMs = record.timeMs + offsetMs;
+      records++;
+    }
+    file.close();
+    if (torn) logEvent(EV_CAPTURE_TORN, { (unsigned long)seq, records });
+  }
+}
+
+// ============================================================================
+//  Volumen escrito, ritmo desde el reporte anterior y tiempo de escritura
+//  en flash (por lote y por registro, contra CAPTURE_STALL_BUDGET_US)
+// ============================================================================
+void reportCaptureStats() {
+  if (!fsReady) return;
+  static unsigned long lastReport = 0;
+  static uint32_t lastBytes = 0;
+
+  unsigned long now = millis();
+  uint32_t bytes = bytesWritten;
+  uint32_t elapsed = now - lastReport;
+  float rate = (lastReport != 0 && elapsed > 0) ? (bytes - lastBytes) * 1000.0f / elapsed : 0.0f;
+  lastReport = now;
+  lastBytes = bytes;
+
+  uint32_t records = recordsWritten;
+  uint32_t n = flushes;
+  uint32_t usTotal = flushUsTotal;
+  uint32_t perRecord = records ? usTotal / records : 0;
+  Serial.printf("%sCAPTURE registros=%lu bytes=%lu ritmo=%.1f B/s lotes=%lu (%lu B/lote) "
+                "flash_us(prom/max)=%lu/%lu por_registro=%lu us (presupuesto %lu%s) "
+                "flash=%.0f KiB/s | segmento=%lu (%lu/%lu B) abiertos=%lu "
+                "descartes cola_rf=%lu cola_is=%lu buffers=%lu largos=%lu errores=%lu\n",
+                getTimestamp().c_str(), (unsigned long)records, (unsigned long)bytes, rate,
+                (unsigned long)n, (unsigned long)(n ? bytes / n : 0),
+                (unsigned long)(n ? usTotal / n : 0), (unsigned long)flushUsMax.load(),
+                (unsigned long)perRecord, (unsigned long)CAPTURE_STALL_BUDGET_US,
+                perRecord > CAPTURE_STALL_BUDGET_US ? ", excedido" : "",
+                usTotal ? bytes * 1000000.0f / 1024.0f / usTotal : 0.0f,
+                (unsigned long)segmentSequence.load(), (unsigned long)segmentBytes.load(),
+                (unsigned long)CAPTURE_SEGMENT_BYTES, (unsigned long)segmentsOpened.load(),
+                (unsigned long)rfQueue.overflows(), (unsigned long)isQueue.overflows(),
+                (unsigned long)poolDeferred.load(), (unsigned long)tooLong.load(), (unsigned long)writeErrors.load());
+}
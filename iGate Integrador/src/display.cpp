@@ -0,0 +1,285 @@
+// ============================================================================
+//  Tarea de pantalla y estadísticas: actualiza el OLED y reporta por Serial
+//  el estado de las tareas y colas. Corre con la menor prioridad para que
+//  el I2C nunca retrase al radio ni a la red. El OLED se refresca de forma
+//  incremental: solo las filas cuyo texto cambió, página por página.
+// ============================================================================
+#include "display.h"
+
+#include <WiFi.h>
+#include <Wire.h>             // Comunicación I2C (OLED)
+#include <Adafruit_GFX.h>     // Librería gráfica genérica
+#include <Adafruit_SSD1306.h> // Controlador de la pantalla OLED
+#include <algorithm>
+#include <stdarg.h>
+
+#include "capture.h"
+#include "config.h"
+#include "log.h"
+#include "network.h"
+#include "power.h"
+#include "radio.h"
+#include "settings.h"
+#include "stats.h"
+#include "uplink_backlog.h"
+#include "wifi_manager.h"
+
+static Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+
+// ============================================================================
+//  Filas de texto: con tamaño de letra 1 cada fila mide 8 px, justo una
+//  página del SSD1306. Se guarda el último texto dibujado por fila; solo se
+//  redibujan y transfieren las páginas cuyo texto cambió.
+// ============================================================================
+#define OLED_ROWS  (SCREEN_HEIGHT / 8)
+#define OLED_COLS  (SCREEN_WIDTH / 6)     // Fuente de 6 px de ancho
+#define OLED_CHUNK 64                     // Bytes de datos por transacción I2C
+
+static char    rowText[OLED_ROWS][OLED_COLS + 1];
+static uint8_t dirtyPages = 0;
+
+// Lecturas lentas: no se consultan en cada refresco
+static int16_t  cachedRssi = 0;
+static uint16_t cachedBatteryMv = 0;
+static uint32_t lastRssiRead = 0;
+static uint32_t lastBatteryRead = 0;
+
+// Métricas de refresco
+static uint32_t refreshes = 0;
+static uint32_t unchangedRefreshes = 0;
+static uint32_t pagesPushed = 0;
+static uint32_t bytesPushed = 0;
+static uint32_t renderMicrosTotal = 0;
+static uint32_t renderMicrosMax = 0;
+static uint32_t i2cMicrosTotal = 0;
+static uint32_t i2cMicrosMax = 0;
+
+// Apagado por inactividad (settings.displayTimeoutS)
+static bool     oledOn = true;
+static uint32_t oledOnSince = 0;
+static uint32_t oledOnTotalMs = 0;
+static uint32_t lastActivityMs = 0;
+static uint32_t lastActivityCount = 0;
+static bool     lastActivityLinks = false;
+
+static void setRow(uint8_t row, const char* format, ...) {
+  char text[OLED_COLS + 1];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+
+  if (strcmp(text, rowText[row]) == 0) return;
+  memcpy(rowText[row], text, sizeof(text));
+  dirtyPages |= (uint8_t)(1 << row);
+}
+
+static void invalidateRows() {
+  for (uint8_t r = 0; r < OLED_ROWS; r++) rowText[r][0] = '\0';
+  dirtyPages = 0xFF;
+}
+
+// ============================================================================
+//  Transferencia de una página: ventana de columnas/página en una sola
+//  transacción de comandos y los 128 bytes en bloques de OLED_CHUNK.
+//  Devuelve los bytes puestos en el bus (incluida la dirección).
+// ============================================================================
+static size_t pushPage(uint8_t page) {
+  static const uint8_t CONTROL_COMMAND = 0x00;
+  static const uint8_t CONTROL_DATA = 0x40;
+  size_t bytes = 0;
+
+  Wire.beginTransmission(OLED_ADDR);
+  Wire.write(CONTROL_COMMAND);
+  Wire.write(SSD1306_PAGEADDR);
+  Wire.write(page);
+  Wire.write(page);
+  Wire.write(SSD1306_COLUMNADDR);
+  Wire.write((uint8_t)0);
+  Wire.write((uint8_t)(SCREEN_WIDTH - 1));
+  Wire.endTransmission();
+  bytes += 8;
+
+  const uint8_t* data = display.getBuffer() + (size_t)page * SCREEN_WIDTH;
+  for (size_t offset = 0; offset < SCREEN_WIDTH; offset += OLED_CHUNK) {
+    size_t n = std::min<size_t>(OLED_CHUNK, SCREEN_WIDTH - offset);
+    Wire.beginTransmission(OLED_ADDR);
+    Wire.write(CONTROL_DATA);
+    Wire.write(data + offset, n);
+    Wire.endTransmission();
+    bytes += n + 2;
+  }
+  return bytes;
+}
+
+// ============================================================================
+//  Inicialización del OLED
+// ============================================================================
+bool displayBegin() {
+  Wire.begin(21, 22);
+  if(!display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDR)) {
+    Serial.println("❌ No se encontró OLED en dirección 0x3C");
+    return false;
+  }
+  display.clearDisplay();
+  display.println("Hola LilyGO LoRa32!");
+  display.display();
+
+  // Las transferencias por página no pasan por display(), que sube el
+  // reloj solo durante la escritura: se fija aquí para todo el bus
+  Wire.setClock(OLED_I2C_CLOCK);
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setTextWrap(false);
+  invalidateRows();
+  return true;
+}
+
+// ============================================================================
+//  Actualización de los datos en la pantalla OLED: arma el texto de cada
+//  fila, redibuja en el buffer solo las que cambiaron y transfiere solo
+//  esas páginas.
+// ============================================================================
+static void updateOLEDStatus() {
+  uint32_t start = micros();
+  uint32_t now = millis();
+  StatsSnapshot s = snapshotStats();
+  const char* ssid = wifiSsid();
+
+  if (ssid != nullptr && (lastRssiRead == 0 || now - lastRssiRead >= OLED_RSSI_INTERVAL)) {
+    cachedRssi = (int16_t)WiFi.RSSI();
+    lastRssiRead = now;
+  }
+  if (lastBatteryRead == 0 || now - lastBatteryRead >= OLED_BATTERY_INTERVAL) {
+    cachedBatteryMv = (uint16_t)(getBatteryVoltage() * 1000.0f + 0.5f);
+    lastBatteryRead = now;
+  }
+
+  setRow(0, "WiFi: %s", ssid != nullptr ? ssid : "DESCONECTADO");
+  if (ssid != nullptr) setRow(1, "RSSI: %d dBm", cachedRssi);
+  else setRow(1, "RSSI: --");
+  const char* server = networkServer();
+  setRow(2, "Srv: %s", (s.aprsConnected && server != nullptr) ? server : "DESCONECTADO");
+  setRow(3, "LoRa RX/TX: %lu/%lu", (unsigned long)s.loraRx, (unsigned long)s.loraTx);
+  setRow(4, "APRS TX/RX: %lu/%lu", (unsigned long)s.isTx, (unsigned long)s.isRx);
+  unsigned centivolts = (cachedBatteryMv + 5) / 10;
+  setRow(5, "Batt: %u.%02u V", centivolts / 100, centivolts % 100);
+  setRow(6, "Estado: %s", (ssid != nullptr && s.aprsConnected) ? "OPERATIVO"
+                          : (ssid != nullptr ? "WIFI-SOLO" : "OFFLINE"));
+
+  refreshes++;
+  if (dirtyPages == 0) {
+    unchangedRefreshes++;
+    return;
+  }
+
+  for (uint8_t r = 0; r < OLED_ROWS; r++) {
+    if (!(dirtyPages & (1 << r))) continue;
+    display.fillRect(0, r * 8, SCREEN_WIDTH, 8, SSD1306_BLACK);
+    display.setCursor(0, r * 8);
+    display.print(rowText[r]);
+  }
+  uint32_t drawn = micros();
+
+  for (uint8_t r = 0; r < OLED_ROWS; r++) {
+    if (!(dirtyPages & (1 << r))) continue;
+    bytesPushed += pushPage(r);
+    pagesPushed++;
+  }
+  dirtyPages = 0;
+
+  uint32_t end = micros();
+  uint32_t render = drawn - start;
+  uint32_t i2c = end - drawn;
+  renderMicrosTotal += render;
+  if (render > renderMicrosMax) renderMicrosMax = render;
+  i2cMicrosTotal += i2c;
+  if (i2c > i2cMicrosMax) i2cMicrosMax = i2c;
+}
+
+// Tiempo acumulado con el panel encendido, incluido el tramo en curso
+uint32_t displayOnTimeMs() {
+  return oledOnTotalMs + (oledOn ? millis() - oledOnSince : 0);
+}
+
+// ============================================================================
+//  Función: updateDisplayPower()
+//  Descripción: Con display.timeout > 0 apaga el panel (DISPLAYOFF, la RAM
+//               del SSD1306 conserva la imagen) tras ese tiempo sin tramas
+//               LoRa ni envíos a APRS-IS ni cambios de conexión, y lo vuelve
+//               a encender con la primera actividad. Apagado no se refresca.
+// ============================================================================
+static bool updateDisplayPower() {
+  if (settings.displayTimeoutS == 0) return true;
+
+  uint32_t now = millis();
+  StatsSnapshot s = snapshotStats();
+  uint32_t activity = s.loraRx + s.loraTx + s.isTx;
+  bool links = s.wifiConnected && s.aprsConnected;
+  if (activity != lastActivityCount || links != lastActivityLinks) {
+    lastActivityCount = activity;
+    lastActivityLinks = links;
+    lastActivityMs = now;
+  }
+
+  bool on = now - lastActivityMs < settings.displayTimeoutS * 1000UL;
+  if (on != oledOn) {
+    display.ssd1306_command(on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF);
+    if (on) oledOnSince = now;
+    else oledOnTotalMs += now - oledOnSince;
+    oledOn = on;
+    logEvent(on ? EV_DISPLAY_WAKE : EV_DISPLAY_BLANK);
+  }
+  return on;
+}
+
+// ============================================================================
+//  Estadísticas de la pantalla: refrescos sin cambios, páginas y bytes
+//  transferidos (una pantalla completa son ~1050 bytes) y tiempos
+// ============================================================================
+static void reportDisplayStats() {
+  uint32_t changed = refreshes - unchangedRefreshes;
+  Serial.printf("%sOLED refrescos=%lu sin_cambios=%lu paginas/refresco=%.2f bytes/refresco=%lu "
+                "render_us(prom/max)=%lu/%lu i2c_us(prom/max)=%lu/%lu reloj=%lu kHz\n",
+                getTimestamp().c_str(), (unsigned long)refreshes, (unsigned long)unchangedRefreshes,
+                refreshes ? (float)pagesPushed / refreshes : 0.0f,
+                (unsigned long)(refreshes ? bytesPushed / refreshes : 0),
+                (unsigned long)(changed ? renderMicrosTotal / changed : 0), (unsigned long)renderMicrosMax,
+                (unsigned long)(changed ? i2cMicrosTotal / changed : 0), (unsigned long)i2cMicrosMax,
+                (unsigned long)(OLED_I2C_CLOCK / 1000));
+}
+
+// ============================================================================
+//  Tarea de pantalla: OLED cada segundo, reporte de tareas cada minuto
+// ============================================================================
+void displayTask(void* param) {
+  TickType_t lastWake = xTaskGetTickCount();
+  unsigned long lastReport = millis();
+
+  for (;;) {
+    {
+      TaskBusy busy(TASK_UI);
+      taskSection(TASK_UI, SEC_UI_DISPLAY);
+      if (updateDisplayPower()) updateOLEDStatus();
+      taskSection(TASK_UI, SEC_UI_HEAP);
+      sampleHeap();
+
+      if (millis() - lastReport > TASK_REPORT_INTERVAL) {
+        taskSection(TASK_UI, SEC_UI_REPORTS);
+        lastReport = millis();
+        reportTaskStats();
+        reportTaskProfile();
+        reportMetrics();
+        reportWifiStats();
+        reportNetworkStats();
+        reportUplinkBacklogStats();
+        reportCaptureStats();
+        reportRadioStats();
+        reportLogStats();
+        reportDisplayStats();
+        reportPowerStats();
+      }
+    }
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(OLED_UPDATE_INTERVAL));
+  }
+}
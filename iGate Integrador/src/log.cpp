@@ -0,0 +1,247 @@
+// ============================================================================
+//  Registro de eventos por Serial
+// ============================================================================
+#include "log.h"
+
+#include "capture.h"
+#include "config.h"
+#include "power.h"
+#include "stats.h"
+
+// ============================================================================
+//  Tabla de eventos (mismo orden que LogEventId)
+// ============================================================================
+static const LogEventDef LOG_EVENTS[EV_COUNT] = {
+  // Arranque
+  { LOG_INFO,  "=== INICIANDO iGATE APRS ===" },
+  { LOG_ERROR, "✗ No se pudo crear la tarea %s" },
+  { LOG_ERROR, "✗ Error iniciando LoRa!" },
+  { LOG_INFO,  "✓ LoRa iniciado" },
+  { LOG_INFO,  "Exploración %s: CAD %u us, ventana %u us, peor hueco %u us" },
+  { LOG_INFO,  "Exploración %s: cobertura %u‰, %u‰ del tiempo" },
+  { LOG_WARN,  "⚠️  Exploración %s: el peor hueco supera la ventana, detección no garantizada" },
+  { LOG_ERROR, "✗ Exploración rechazada: %s perdería preámbulos (peor hueco %u us > ventana %u us), solo recepción continua" },
+  { LOG_INFO,  "✓ Exploración CAD de %u combinaciones, latencia de detección ≤ %u us" },
+
+  // Configuración (is-cfg.json / NVS)
+  { LOG_INFO,  "✓ Configuración: %s (%u us, %u campos, %u claves ignoradas)" },
+  { LOG_WARN,  "⚠️  Sin is-cfg.json en LittleFS" },
+  { LOG_ERROR, "✗ is-cfg.json: error de %s en línea %u, columna %u" },
+  { LOG_ERROR, "✗ is-cfg.json: %s: %s" },
+  { LOG_ERROR, "✗ is-cfg.json: %u problemas más" },
+
+  // Energía
+  { LOG_INFO,  "Energía: %s, WiFi %s, apagado del OLED a los %u s (0 = nunca)" },
+  { LOG_WARN,  "⚠️  Light sleep no disponible (%s)" },
+  { LOG_WARN,  "⚠️  Light sleep requiere modem sleep de WiFi, se usa el mínimo" },
+  { LOG_DEBUG, "Pantalla apagada por inactividad" },
+  { LOG_DEBUG, "Pantalla encendida" },
+
+  // Radio
+  { LOG_INFO,  "📡 LoRa_RX [%u] (%d dBm, %.1f dB): " },
+  { LOG_INFO,  "📡 LoRa_RX [%u] %s, solo APRS-IS (%d dBm, %.1f dB): " },
+  { LOG_DEBUG, "⚠️  Paquete duplicado ignorado" },
+  { LOG_INFO,  "🔁 Digipeando paquete (%s)..." },
+  { LOG_INFO,  "🔁 Digipeando paquete (%s, en %u ms)..." },
+  { LOG_WARN,  "✗ Cola de digipeat llena, trama descartada" },
+  { LOG_WARN,  "✗ Cola RF → APRS-IS llena, trama descartada" },
+  { LOG_INFO,  "📡 DIGI TX → LoRa (%u ms en el aire, %u ms en cola): " },
+  { LOG_INFO,  "⬅️ APRS-IS_TX→LoRa (%u ms en el aire, %u ms en cola): " },
+  { LOG_INFO,  "📍 BEACON TX → LoRa (%u ms en el aire, %u ms en cola): " },
+
+  // WiFi
+  { LOG_INFO,  "WiFi: caché RTC (BSSID, canal y concesión)" },
+  { LOG_INFO,  "WiFi: caché NVS (BSSID y canal)" },
+  { LOG_INFO,  "Conectando a WiFi: %s" },
+  { LOG_INFO,  "Conectando a WiFi: %s (canal %u)" },
+  { LOG_ERROR, "✗ Fallo conexión WiFi con todas las redes" },
+  { LOG_INFO,  "✓ WiFi conectado! (%u ms, %s)" },
+  { LOG_INFO,  "IP address: %u.%u.%u.%u" },
+  { LOG_WARN,  "WiFi: reconexión rápida fallida (motivo %u), escaneando..." },
+  { LOG_WARN,  "✗ Fallo conexión a %s (motivo %u)" },
+  { LOG_WARN,  "WiFi desconectado (motivo %u)" },
+
+  // APRS-IS
+  { LOG_ERROR, "✗ APRS-IS %s [%s]: %s" },
+  { LOG_INFO,  "APRS-IS %s: reintento en %u s" },
+  { LOG_INFO,  "Conectando a %s:%u" },
+  { LOG_INFO,  "✓ Conectado a APRS-IS (%u ms)" },
+  { LOG_INFO,  "SRV_INIT: " },
+  { LOG_WARN,  "Sin banner del servidor, se envía el login" },
+  { LOG_DEBUG, "AUTH_SEND: " },
+  { LOG_INFO,  "AUTH_RESP: " },
+  { LOG_WARN,  "⚠️  Login no verificado (passcode), solo recepción" },
+  { LOG_INFO,  "✓ Autenticación exitosa en %u ms, esperando tráfico..." },
+  { LOG_INFO,  "✓ Reserva APRS-IS lista en %s (login %u ms)" },
+  { LOG_DEBUG, "Sondeo APRS-IS %s: connect %u ms, login %u ms" },
+  { LOG_DEBUG, "APRS-IS %s %s: %s " },
+  { LOG_WARN,  "⚠️  APRS-IS %s %s [%s]: %s" },
+  { LOG_WARN,  "⚡ Failover APRS-IS a %s (%u ms sin sesión)" },
+  { LOG_INFO,  "APRS-IS: cambio a %s (login %u ms)" },
+  { LOG_DEBUG, "SRV_SYS: " },
+  { LOG_INFO,  "🎯 APRS_RX [%u]: " },
+  { LOG_INFO,  "Filtro APRS-IS → RF: \"%s\" (%u cláusulas)" },
+  { LOG_ERROR, "✗ Filtro APRS-IS → RF inválido: %s en la posición %u, se reenvía todo" },
+  { LOG_DEBUG, "Filtro APRS-IS → RF: descartada (cláusula %d): " },
+  { LOG_WARN,  "✗ Cola APRS-IS → RF llena, línea descartada" },
+  { LOG_INFO,  "➡️ Reenviado a APRS-IS [%u]" },
+  { LOG_INFO,  "➡️ Reenviado a APRS-IS [%u] (diferido %u s, pendientes %u)" },
+  { LOG_WARN,  "✗ Buffer de salida APRS-IS lleno, línea descartada: %s" },
+  { LOG_WARN,  "⚠️  APRS-IS: %u líneas sin enviar al cerrar la sesión (%u vuelven a la cola)" },
+  { LOG_DEBUG, "Preparando beacon..." },
+  { LOG_INFO,  "BEACON_TX: " },
+  { LOG_DEBUG, "BEACON_BYTES: %d" },
+  { LOG_INFO,  "✓ Beacon enviado correctamente" },
+  { LOG_INFO,  "TELEM_TX -> " },
+  { LOG_DEBUG, "TELEM_CFG -> Enviando %s" },
+  { LOG_INFO,  "📡 Telemetry definitions enviadas (intento)" },
+  { LOG_DEBUG, "Ping enviado al servidor" },
+  { LOG_INFO,  "METRICS_TX -> " },
+
+  // Cola RF → APRS-IS en LittleFS
+  { LOG_WARN,  "Cola RF → APRS-IS llena en RAM, derivando a LittleFS" },
+  { LOG_ERROR, "✗ Segmento LittleFS ilegible, %u tramas perdidas" },
+  { LOG_INFO,  "✓ Segmento LittleFS vaciado" },
+  { LOG_ERROR, "✗ LittleFS no disponible, cola RF → APRS-IS solo en RAM" },
+
+  // Captura en LittleFS
+  { LOG_INFO,  "✓ Captura en LittleFS: %u/%u segmentos previos de %u KiB" },
+  { LOG_ERROR, "✗ LittleFS no disponible, sin captura de tráfico" },
+  { LOG_ERROR, "✗ Captura: error de escritura, %u registros perdidos" },
+  { LOG_WARN,  "⚠️  Captura: lote de %u registros tardó %u us en flash (%u us por registro, presupuesto %u)" },
+  { LOG_WARN,  "⚠️  Captura: segmento %u cortado tras %u registros" },
+
+  // Perfil de tareas y perro guardián
+  { LOG_WARN,  "⚠️  Tarea %s bloqueada: iteración de %u us, sección %s %u us" },
+  { LOG_ERROR, "✗ Reinicio por perro guardián: tarea %s colgada en %s hace %u ms" },
+
+  // Log
+  { LOG_ERROR, "Nivel de log: %s" },   // Nivel máximo: siempre se muestra
+};
+
+EventLog eventLog(LOG_EVENTS, EV_COUNT, LOG_LEVEL);
+
+// ============================================================================
+//  Marca de tiempo "[mm:ss] " sin memoria dinámica
+// ============================================================================
+LogTimestamp formatTimestamp(uint32_t ms) {
+  unsigned long seconds = ms / 1000;
+  unsigned long minutes = seconds / 60;
+  seconds %= 60;
+  minutes %= 60;
+  LogTimestamp ts;
+  snprintf(ts.text, sizeof(ts.text), "[%02lu:%02lu] ", minutes, seconds);
+  return ts;
+}
+
+LogTimestamp getTimestamp() {
+  return formatTimestamp(millis());
+}
+
+// ============================================================================
+//  Comandos por Serial (línea terminada en '\n'):
+//    log <nivel>     cambia el nivel mínimo del registro
+//    metrics         imprime tasas, memoria e histogramas de latencia
+//    metrics reset   vacía los histogramas y el mínimo de bloque libre
+//    capture flush   escribe en LittleFS el lote de captura pendiente
+//    capture dump    exporta los segmentos de captura como traza de texto
+//    profile         imprime el perfil de iteraciones y secciones por tarea
+//    profile reset   vacía los histogramas del perfil y los bloqueos
+// ============================================================================
+static char    commandLine[24];
+static uint8_t commandLength = 0;
+
+static void handleCommand(const char* line) {
+  if (strncmp(line, "log ", 4) == 0) {
+    for (uint8_t l = 0; l < LOG_LEVEL_COUNT; l++) {
+      if (strcmp(line + 4, LOG_LEVEL_NAMES[l]) == 0) {
+        eventLog.setLevel((LogLevel)l);
+        logEvent(EV_LOG_LEVEL, { LOG_LEVEL_NAMES[l] });
+        return;
+      }
+    }
+  } else if (strcmp(line, "metrics") == 0) {
+    reportMetrics();
+  } else if (strcmp(line, "metrics reset") == 0) {
+    resetMetrics();
+    reportMetrics();
+  } else if (strcmp(line, "capture flush") == 0) {
+    captureService(true);
+  } else if (strcmp(line, "capture dump") == 0) {
+    captureDump();
+  } else if (strcmp(line, "profile") == 0) {
+    reportTaskProfile();
+  } else if (strcmp(line, "profile reset") == 0) {
+    resetTaskProfile();
+    reportTaskProfile();
+  }
+}
+
+static void readCommands() {
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (commandLength < sizeof(commandLine) - 1) commandLine[commandLength++] = c;
+      continue;
+    }
+    commandLine[commandLength] = '\0';
+    commandLength = 0;
+    handleCommand(commandLine);
+  }
+}
+
+// ============================================================================
+//  Tarea de log: vacía la cola cada LOG_TASK_PERIOD_MS. Una línea por
+//  escritura para que no se mezcle con los reportes de la tarea de pantalla.
+//  Es también la única que escribe la captura en flash: una escritura lenta
+//  retrasa el Serial, nunca a la radio ni a la red.
+// ============================================================================
+static uint32_t formatted = 0;
+static uint32_t formatMicrosTotal = 0;
+static uint32_t formatMicrosMax = 0;
+
+void logTask(void* param) {
+  static LogRecord record;
+  static char line[LOG_PAYLOAD_MAX + 160];
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(powerLightSleep() ? LOG_TASK_PERIOD_SLEEP_MS : LOG_TASK_PERIOD_MS));
+    TaskBusy busy(TASK_LOG);
+
+    taskSection(TASK_LOG, SEC_LOG_COMMANDS);
+    readCommands();
+    taskSection(TASK_LOG, SEC_LOG_CAPTURE);
+    captureService(false);
+    taskSection(TASK_LOG, SEC_LOG_FORMAT);
+    while (eventLog.pop(record)) {
+      uint32_t start = micros();
+      LogTimestamp ts = formatTimestamp(record.timeMs);
+      size_t n = strlen(ts.text);
+      memcpy(line, ts.text, n);
+      n += eventLog.format(record, line + n, sizeof(line) - n - 1);
+      line[n++] = '\n';
+      uint32_t elapsed = micros() - start;
+
+      formatted++;
+      formatMicrosTotal += elapsed;
+      if (elapsed > formatMicrosMax) formatMicrosMax = elapsed;
+      Serial.write((const uint8_t*)line, n);
+    }
+  }
+}
+
+// ============================================================================
+//  Estadísticas del registro
+// ============================================================================
+void reportLogStats() {
+  EventLogStats s = eventLog.stats();
+  Serial.printf("%sLOG nivel=%s registrados=%lu descartados=%lu filtrados=%lu recortados=%lu "
+                "cola=%u/%u max=%lu formato_us(prom/max)=%lu/%lu\n",
+                getTimestamp().c_str(), LOG_LEVEL_NAMES[eventLog.level()],
+                (unsigned long)s.recorded, (unsigned long)s.dropped, (unsigned long)s.filtered,
+                (unsigned long)s.truncated, (unsigned)eventLog.pending(),
+                (unsigned)eventLog.capacity(), (unsigned long)eventLog.highWater(),
+                (unsigned long)(formatted ? formatMicrosTotal / formatted : 0),
+                (unsigned long)formatMicrosMax);
+}
@@ -0,0 +1,727 @@
+// ============================================================================
+//  Tarea de red: conexión WiFi, sesión APRS-IS, beacon y telemetría.
+//  Es la única tarea que usa aprsClient; intercambia tramas con la tarea de
+//  radio a través de uplinkQueue y rfTxQueue.
+// ============================================================================
+#include "network.h"
+
+#include <WiFi.h>             // Librería para conexión WiFi
+#include <lwip/dns.h>         // Resolución DNS asíncrona
+#include <lwip/sockets.h>     // select() de la espera en reposo
+#include <esp_vfs_eventfd.h>   // Despertar el select() de la espera en reposo
+#include <unistd.h>
+#include <algorithm>
+#include <LineFramer.h>       // Separación de líneas sin copias
+#include <LineWriter.h>       // Salida agrupada por líneas, no bloqueante
+#include <AprsFilter.h>       // Filtro local APRS-IS → RF (sintaxis de aprsc)
+#include <AprsIsPool.h>       // Servidores APRS-IS con reserva y failover
+
+#include "capture.h"
+#include "config.h"
+#include "log.h"
+#include "power.h"
+#include "radio.h"
+#include "settings.h"
+#include "stats.h"
+#include "uplink_backlog.h"
+#include "wifi_manager.h"
+
+static WiFiClient aprsClient;
+static TaskHandle_t networkTaskHandle = nullptr;
+
+static unsigned long lastBeaconTime = 0;
+static unsigned long lastAPRSTrafficTime = 0;
+static unsigned long lastServerPing = 0;
+static unsigned long lastTelemetryTime = 0;
+static unsigned long lastMetricsStatus = 0;
+
+static int wakeFd = -1;   // eventfd: con light sleep la tarea espera en select()
+
+void networkWake() {
+  if (networkTaskHandle != nullptr) xTaskNotifyGive(networkTaskHandle);
+  if (wakeFd >= 0) {
+    uint64_t one = 1;
+    write(wakeFd, &one, sizeof(one));
+  }
+}
+
+// ============================================================================
+//  Sesión APRS-IS sobre un pool de servidores (AprsIsPool, no bloqueante):
+//  aprs_is.server:port y las alternativas de aprs_is.servers. El pool mide
+//  el RTT de connect() y la latencia de login de cada uno, abre la sesión
+//  en el mejor y mantiene una conexión de reserva autenticada en otro: si la
+//  sesión cae, la reserva la reemplaza en el mismo ciclo. La resolución DNS
+//  es asíncrona (un nombre por vez) y la sesión entregada pasa a aprsClient.
+// ============================================================================
+static AprsIsPool    aprsPool;
+static bool          aprsVerified = false;
+static bool          telemetryDefinitionsSent = false;
+static uint32_t      aprsSessionDrops = 0;
+
+// Resultado de la resolución DNS (lo escribe el hilo de lwIP)
+static volatile bool     dnsDone = false;
+static volatile uint32_t dnsAddress = 0;
+static volatile uint32_t dnsGeneration = 0;
+static int               dnsServer = -1;   // Servidor del pool en resolución
+static unsigned long     dnsStarted = 0;
+
+static void onDnsFound(const char* name, const ip_addr_t* ip, void* arg) {
+  if ((uint32_t)(uintptr_t)arg != dnsGeneration) return; // Respuesta de un intento viejo
+  dnsAddress = (ip != nullptr) ? ip_2_ip4(ip)->addr : 0;
+  dnsDone = true;
+}
+
+const char* networkServer() {
+  int active = aprsPool.active();
+  return active >= 0 ? aprsPool.host(active) : nullptr;
+}
+
+// ============================================================================
+//  Eventos del pool → registro. La sesión principal conserva los mensajes
+//  de siempre; reserva y sondeos van en DEBUG salvo fallas y failover.
+// ============================================================================
+static void onPoolEvent(const PoolEvent& e, void* context) {
+  const char* host = aprsPool.host(e.server);
+
+  if (e.role == POOL_ROLE_PRIMARY) {
+    switch (e.id) {
+      case POOL_EV_CONNECTING: logEvent(EV_APRSIS_CONNECTING, { host, e.value }); return;
+      case POOL_EV_CONNECTED:  logEvent(EV_APRSIS_CONNECTED, { e.value }); return;
+      case POOL_EV_BANNER:     logPacket(EV_APRSIS_BANNER, e.text, e.length); return;
+      case POOL_EV_NO_BANNER:  logEvent(EV_APRSIS_NO_BANNER); return;
+      case POOL_EV_LOGIN_SENT: logPacket(EV_APRSIS_AUTH_SEND, e.text, e.length); return;
+      case POOL_EV_LOGIN_RESP: logPacket(EV_APRSIS_AUTH_RESP, e.text, e.length); return;
+      case POOL_EV_READY:      logEvent(EV_APRSIS_VERIFIED, { e.value }); return;
+      case POOL_EV_FAIL:
+        logEvent(EV_APRSIS_FAIL, { host, POOL_STAGE_NAMES[e.stage], e.text });
+        logEvent(EV_APRSIS_RETRY, { host, e.value / 1000 });
+        return;
+      default: break;
+    }
+  }
+
+  switch (e.id) {
+    case POOL_EV_UNVERIFIED: logEvent(EV_APRSIS_UNVERIFIED); break;
+    case POOL_EV_READY:      logEvent(EV_APRSIS_STANDBY, { host, e.value }); break;
+    case POOL_EV_PROBED:
+      logEvent(EV_APRSIS_PROBE, { host, aprsPool.serverStats(e.server).lastConnectMs, e.value });
+      break;
+    case POOL_EV_FAIL:
+      logEvent(EV_APRSIS_POOL_FAIL, { host, POOL_ROLE_NAMES[e.role], POOL_STAGE_NAMES[e.stage], e.text });
+      break;
+    case POOL_EV_FAILOVER:   logEvent(EV_APRSIS_FAILOVER, { host, e.value }); break;
+    case POOL_EV_SWITCH:     logEvent(EV_APRSIS_SWITCH, { host, e.value }); break;
+    default:
+      logPacket(EV_APRSIS_POOL_STEP, e.text, e.length,
+                { POOL_ROLE_NAMES[e.role], host, POOL_EVENT_NAMES[e.id] });
+      break;
+  }
+}
+
+static void aprsPoolBegin() {
+  static_assert(POOL_MAX_SERVERS >= CONFIG_MAX_SERVERS + 1, "POOL_MAX_SERVERS muy chico");
+
+  PoolTimings t;
+  t.connectMs       = APRSIS_CONNECT_TIMEOUT;
+  t.bannerMs        = APRSIS_BANNER_TIMEOUT;
+  t.loginMs         = APRSIS_LOGIN_TIMEOUT;
+  t.backoffMinMs    = APRSIS_BACKOFF_MIN;
+  t.backoffMaxMs    = APRSIS_BACKOFF_MAX;
+  t.probeIntervalMs = APRSIS_PROBE_INTERVAL;
+  t.idleTimeoutMs   = APRS_TIMEOUT;
+  t.keepaliveMs     = APRSIS_STANDBY_KEEPALIVE;
+  t.switchMarginMs  = APRSIS_SWITCH_MARGIN;
+  aprsPool.setTimings(t);
+  aprsPool.setEventHandler(onPoolEvent, nullptr);
+  aprsPool.setLogin(settings.callsign, settings.passcode, "TTGO-LoRa-iGate 1.0", settings.filter);
+
+  char primary[CONFIG_HOST_LEN + 8];
+  snprintf(primary, sizeof(primary), "%s:%u", settings.server, settings.port);
+  aprsPool.addServer(primary, settings.port);
+  for (uint8_t i = 0; i < settings.serverCount; i++) aprsPool.addServer(settings.servers[i], settings.port);
+}
+
+// ============================================================================
+//  Resolución DNS de los servidores del pool, un nombre por vez
+// ============================================================================
+static void aprsResolveTick(unsigned long now) {
+  if (dnsServer >= 0) {
+    const char* reason = nullptr;
+    if (!dnsDone) {
+      if (now - dnsStarted <= APRSIS_DNS_TIMEOUT) return;
+      reason = "Timeout DNS";
+    } else if (dnsAddress == 0) {
+      reason = "Servidor no encontrado";
+    }
+    if (reason != nullptr) logEvent(EV_APRSIS_FAIL, { aprsPool.host(dnsServer), "DNS", reason });
+    aprsPool.setAddress(dnsServer, reason != nullptr ? 0 : dnsAddress, now);
+    dnsServer = -1;
+    return;
+  }
+
+  int i = aprsPool.needsAddress(now);
+  if (i < 0) return;
+
+  ip_addr_t addr;
+  uint32_t generation = dnsGeneration + 1;
+  dnsGeneration = generation;
+  dnsDone = false;
+  err_t err = dns_gethostbyname(aprsPool.host(i), &addr, onDnsFound, (void*)(uintptr_t)generation);
+  if (err == ERR_OK) {
+    aprsPool.setAddress(i, ip_2_ip4(&addr)->addr, now);
+  } else if (err != ERR_INPROGRESS) {
+    logEvent(EV_APRSIS_FAIL, { aprsPool.host(i), "DNS", "Error DNS" });
+    aprsPool.setAddress(i, 0, now);
+  } else {
+    dnsServer = i;
+    dnsStarted = now;
+  }
+}
+
+// ============================================================================
+//  Recepción por líneas: buffer fijo llenado con lecturas en bloque. Lo
+//  comparten el tráfico normal y drainAPRSServer().
+// ============================================================================
+static LineFramer aprsFramer;
+static uint32_t   aprsReadCalls = 0;   // Lecturas en bloque del socket
+static uint32_t   aprsReadMicros = 0;  // Llegada de la última lectura (origen IS → RF)
+
+static bool readAPRSLine(LineSlice& line) {
+  if (aprsFramer.next(line)) return true;
+
+  int available = aprsClient.available();
+  if (available <= 0) return false;
+
+  size_t room;
+  char* dst = aprsFramer.writePtr(room);
+  int n = aprsClient.read((uint8_t*)dst, std::min<size_t>(room, (size_t)available));
+  if (n <= 0) return false;
+  aprsReadCalls++;
+  aprsReadMicros = micros();
+  aprsFramer.commit((size_t)n);
+  return aprsFramer.next(line);
+}
+
+// ============================================================================
+//  Envío por líneas: todo lo que va hacia APRS-IS (tramas RF, beacon,
+//  telemetría, ping y estado) se escribe en aprsOut y sale agrupado en un
+//  solo send() no bloqueante, por tamaño o por plazo. Cada línea vuelve por
+//  onLineWritten() como enviada o perdida; las tramas RF perdidas al cerrar
+//  la sesión vuelven a la cola de almacenamiento y reenvío (al final).
+// ============================================================================
+enum OutKind : uint8_t {
+  OUT_UPLINK,      // stamp = rxMillis, origin = rxMicros
+  OUT_BEACON,
+  OUT_TELEMETRY,
+  OUT_PING,
+  OUT_STATUS,
+};
+
+static const char* const OUT_KIND_NAMES[] = { "trama RF", "beacon", "telemetría", "ping", "estado" };
+
+static LineWriter aprsOut;
+static uint32_t   aprsOutLost = 0;       // Perdidas al cerrar la última sesión
+static uint32_t   aprsOutRequeued = 0;   // De ellas, tramas RF devueltas a la cola
+
+static void onLineWritten(const WrittenLine& line, void* context) {
+  if (!line.sent) {
+    aprsOutLost++;
+    if (line.kind != OUT_UPLINK) return;
+    uplinkBacklogRequeue(line.data, line.length, line.stamp, line.origin);
+    aprsOutRequeued++;
+    return;
+  }
+
+  uint32_t sent = countTraffic(FLOW_IS_TX, line.length + 1);
+  if (line.kind == OUT_UPLINK) {
+    markStage(STAGE_RX_IS_WRITTEN, line.origin);
+    uint32_t age = millis() - line.stamp;
+    if (age >= 1000) {
+      logEvent(EV_UPLINK_SENT_DEFERRED, { sent, age / 1000, uplinkBacklogDepth() });
+    } else {
+      logEvent(EV_UPLINK_SENT, { sent });
+    }
+  } else if (line.kind == OUT_BEACON) {
+    logEvent(EV_BEACON_BYTES, { line.length + 1 });
+    logEvent(EV_BEACON_SENT);
+    lastAPRSTrafficTime = millis();
+  }
+}
+
+// Confirma una línea formateada en aprsOut.lineBuffer() (length = resultado
+// de snprintf); sin lugar se descarta
+static bool aprsOutCommit(int length, OutKind kind) {
+  if (length >= 0 && aprsOut.commitLine((size_t)length, millis(), kind)) return true;
+  logEvent(EV_APRSIS_TX_FULL, { OUT_KIND_NAMES[kind] });
+  return false;
+}
+
+// ============================================================================
+//  Cierra la sesión activa; el pool entrega la reserva en el próximo paso
+// ============================================================================
+static void aprsSessionClose(const char* reason) {
+  if (!aprsVerified) return;
+  if (reason != nullptr) {
+    logEvent(EV_APRSIS_FAIL, { networkServer(), "VERIFIED", reason });
+    aprsSessionDrops++;
+  }
+  aprsOutLost = aprsOutRequeued = 0;
+  aprsOut.detach(millis());
+  if (aprsOutLost > 0) logEvent(EV_APRSIS_TX_LOST, { aprsOutLost, aprsOutRequeued });
+  aprsClient.stop();
+  aprsPool.sessionClosed(millis());
+  aprsVerified = false;
+  stats.aprsConnected = false;
+}
+
+// ============================================================================
+//  Función: aprsSessionTick()
+//  Descripción: Avanza el pool (DNS, conexiones, reserva y sondeos), vigila
+//               la sesión activa y toma una nueva cuando no hay.
+// ============================================================================
+static void aprsSessionTick() {
+  unsigned long now = millis();
+
+  if (!wifiIsUp() || !settings.aprsIsActive) {
+    aprsSessionClose(wifiIsUp() ? nullptr : "WiFi desconectado");
+    aprsPool.stop();
+    return;
+  }
+
+  aprsResolveTick(now);
+  aprsPool.tick(now);
+
+  if (aprsVerified) {
+    // Verifica salud de la conexión APRS-IS
+    if (!aprsClient.connected()) aprsSessionClose("Conexión perdida");
+    else if (now - lastAPRSTrafficTime > APRS_TIMEOUT) aprsSessionClose("Timeout APRS-IS (sin tráfico)");
+    else if (aprsPool.switchPending()) {
+      aprsOut.flush(now);   // Cambio a un servidor mejor: sale lo que el socket acepte
+      aprsSessionClose(nullptr);
+    }
+    else return;
+  }
+
+  int fd = aprsPool.takeSession(millis());
+  if (fd < 0) return;
+
+  aprsClient = WiFiClient(fd); // El cliente pasa a ser dueño del socket
+  aprsFramer.reset();
+  aprsOut.attach(fd, millis());
+  lastAPRSTrafficTime = millis();
+  lastBeaconTime = 0;
+  telemetryDefinitionsSent = false;   // El servidor nuevo no las tiene
+  aprsVerified = true;
+  stats.aprsConnected = true;
+}
+
+// ============================================================================
+//  Envío hacia RF: la trama se encola para el planificador de la tarea de
+//  radio, que decide el momento según prioridad, presupuesto y canal libre
+// ============================================================================
+static void queueRfFrame(TxClass txClass, const char* data, size_t length,
+                         uint32_t originMicros = 0) {
+  RfTxFrame* frame = rfTxQueue.acquire();
+  if (frame == nullptr) {
+    stats.rfTxDropped++;
+    logEvent(EV_RFTX_QUEUE_FULL);
+    return;
+  }
+  length = std::min<size_t>(length, sizeof(frame->data));
+  memcpy(frame->data, data, length);
+  frame->length = (uint16_t)length;
+  frame->txClass = txClass;
+  frame->queuedMs = millis();
+  frame->originMicros = originMicros;
+  rfTxQueue.publish();
+  radioWake();
+  if (txClass == TX_CLASS_MESSAGE) markStage(STAGE_IS_RF_QUEUED, originMicros);
+}
+
+static void forwardAPRStoLoRa(const LineSlice& line) {
+  queueRfFrame(TX_CLASS_MESSAGE, line.data, line.length, aprsReadMicros);
+}
+
+// ============================================================================
+//  Filtro local APRS-IS → RF (aprs_is.rf_filter): se compila una vez al
+//  iniciar la tarea y se evalúa antes de ocupar un lugar en rfTxQueue. El
+//  tiempo de evaluación se mide en ciclos de CPU (una línea toma pocos µs).
+// ============================================================================
+static AprsFilter rfFilter;
+static uint64_t   rfFilterCycles = 0;
+static uint32_t   rfFilterMaxCycles = 0;
+
+static void rfFilterBegin() {
+  FilterError e = rfFilter.compile(settings.rfFilter);
+  if (e != FILTER_OK) {
+    logEvent(EV_RF_FILTER_INVALID, { FILTER_ERROR_NAMES[e], (unsigned)rfFilter.errorPosition() });
+  } else if (!rfFilter.empty()) {
+    logEvent(EV_RF_FILTER, { settings.rfFilter, (unsigned)rfFilter.clauseCount() });
+  }
+}
+
+static bool rfFilterPass(const LineSlice& line) {
+  uint32_t start = ESP.getCycleCount();
+  int clause;
+  bool pass = rfFilter.evaluate(line.data, line.length, &clause);
+  uint32_t cycles = ESP.getCycleCount() - start;
+  rfFilterCycles += cycles;
+  if (cycles > rfFilterMaxCycles) rfFilterMaxCycles = cycles;
+  if (!pass) logPacket(EV_RF_FILTER_REJECT, line.data, line.length, { clause });
+  return pass;
+}
+
+// ============================================================================
+//  Procesamiento del tráfico entrante desde APRS-IS
+// ============================================================================
+static void processAPRSTraffic() {
+  LineSlice line;
+  while (readAPRSLine(line)) {
+    if (line.length == 0) continue;
+    if (line.data[0] == '#') {
+      logPacket(EV_APRSIS_SYS, line.data, line.length);
+    } else {
+      uint32_t received = countTraffic(FLOW_IS_RX, line.length);
+      logPacket(EV_APRSIS_RX, line.data, line.length, { received });
+      lastAPRSTrafficTime = millis();
+      captureIs(line.data, line.length, lastAPRSTrafficTime);
+      if (rfFilterPass(line)) forwardAPRStoLoRa(line);
+    }
+  }
+}
+
+// ============================================================================
+//  Envío de beacon APRS estándar
+// ============================================================================
+static void sendBeacon() {
+  lastBeaconTime = millis();
+  if (!aprsVerified && !settings.beaconRf) return;
+
+  logEvent(EV_BEACON_PREPARE);
+
+  int lat_deg = abs((int)settings.beaconLat);
+  float lat_min = (fabsf(settings.beaconLat) - lat_deg) * 60.0;
+  char lat_dir = settings.beaconLat >= 0 ? 'N' : 'S';
+
+  int lon_deg = abs((int)settings.beaconLon);
+  float lon_min = (fabsf(settings.beaconLon) - lon_deg) * 60.0;
+  char lon_dir = settings.beaconLon >= 0 ? 'E' : 'W';
+
+  char position[30];
+  sprintf(position, "%02d%05.2f%c/%03d%05.2f%c", lat_deg, lat_min, lat_dir, lon_deg, lon_min, lon_dir);
+
+  if (settings.beaconRf) {
+    char rfBeacon[AX25_MAX_FRAME];
+    int length = snprintf(rfBeacon, sizeof(rfBeacon), "%s>APRS%s%s:=%s&%s",
+                          settings.callsign, settings.beaconRfPath[0] ? "," : "",
+                          settings.beaconRfPath, position, settings.beaconComment);
+    if (length > 0) queueRfFrame(TX_CLASS_BEACON, rfBeacon, std::min<size_t>(length, sizeof(rfBeacon) - 1));
+  }
+  if (!aprsVerified) return;
+
+  // Bytes enviados y confirmación en onLineWritten()
+  size_t room;
+  char* beacon = aprsOut.lineBuffer(room);
+  int n = snprintf(beacon, room, "%s>APRS,TCPIP:=%s&%s", settings.callsign, position,
+                   settings.beaconComment);
+  if (aprsOutCommit(n, OUT_BEACON)) logPacket(EV_BEACON_TX, beacon, n);
+}
+
+// ============================================================================
+//  Telemetría APRS (voltaje batería)
+// ============================================================================
+static void sendTelemetry() {
+  if (!aprsVerified) return;
+
+  float vbatt = getBatteryVoltage();
+  int vbatt_scaled = (int)(vbatt * 10.0 + 0.5); // Escalado para APRS T#
+
+  static int seq = 0;
+  seq = (seq + 1) % 1000;
+
+  // A2: consumo estimado (mA), A3: CPU despierta en pasos de 0.5 %
+  unsigned currentMa = std::min<unsigned>(powerAverageMa(), 255);
+  unsigned dutyHalfPct = std::min<unsigned>(powerDutyPermille() / 5, 200);
+
+  size_t room;
+  char* tpacket = aprsOut.lineBuffer(room);
+  int n = snprintf(tpacket, room, "%s>APRS,TCPIP*:T#%03d,%03d,%03u,%03u,000,000,Battery",
+                   settings.callsign, seq, vbatt_scaled, currentMa, dutyHalfPct);
+  if (aprsOutCommit(n, OUT_TELEMETRY)) logPacket(EV_TELEM_TX, tpacket, n);
+}
+
+// ============================================================================
+//  Estado de métricas como paquete de estado APRS (METRICS_STATUS_TO_APRSIS)
+// ============================================================================
+static void sendMetricsStatus() {
+  lastMetricsStatus = millis();
+  if (!METRICS_STATUS_TO_APRSIS || !aprsVerified) return;
+
+  size_t room;
+  char* status = aprsOut.lineBuffer(room);
+  int n = snprintf(status, room, "%s>APRS,TCPIP*:>", settings.callsign);
+  if (n > 0 && (size_t)n < room) n += formatMetricsStatus(status + n, room - n);
+  if (aprsOutCommit(n, OUT_STATUS)) logPacket(EV_METRICS_STATUS_TX, status, n);
+}
+
+// ============================================================================
+//  Definiciones de telemetría APRS: las cuatro líneas salen juntas en el
+//  mismo envío. false si no entraron en el buffer (se reintenta).
+// ============================================================================
+static bool sendTelemetryDefinitions() {
+  if (!aprsVerified) return false;
+
+  static const char* const DEFINITIONS[][2] = {
+    { "PARM", "PARM.Batt,Consumo,CPU,Unused4,Unused5,Unused6" },
+    { "UNIT", "UNIT.V,mA,%,none,none,none" },
+    { "EQNS", "EQNS.0,0.1,0,0,1,0,0,0.5,0,0,1,0,0,1,0,0,1,0" },
+    { "BITS", "BITS.00000000,UNUSED,UNUSED,UNUSED,UNUSED,UNUSED,UNUSED,UNUSED,UNUSED" },
+  };
+
+  for (size_t i = 0; i < sizeof(DEFINITIONS) / sizeof(DEFINITIONS[0]); i++) {
+    logEvent(EV_TELEM_CFG, { DEFINITIONS[i][0] });
+    size_t room;
+    char* line = aprsOut.lineBuffer(room);
+    int n = snprintf(line, room, "%s>APRS,TCPIP*:%s", settings.callsign, DEFINITIONS[i][1]);
+    if (!aprsOutCommit(n, OUT_TELEMETRY)) return false;
+  }
+
+  logEvent(EV_TELEM_CFG_DONE);
+  return true;
+}
+
+// ============================================================================
+//  Envío periódico de PING al servidor
+// ============================================================================
+static void sendServerPing() {
+  if (aprsVerified) {
+    size_t room;
+    char* ping = aprsOut.lineBuffer(room);
+    aprsOutCommit(snprintf(ping, room, "# Ping TTGO-iGate %lu", (unsigned long)millis()), OUT_PING);
+    logEvent(EV_SERVER_PING);
+    lastServerPing = millis();
+  }
+}
+
+// ============================================================================
+//  Reenvío LoRa → APRS-IS de las tramas encoladas por la tarea de radio.
+//  Todo pasa por la cola de almacenamiento y reenvío: sin sesión verificada
+//  las tramas esperan (RAM / LittleFS) y al reconectar se vacían a ritmo
+//  controlado hacia aprsOut. Con el buffer de salida lleno la trama sigue
+//  en la cola.
+// ============================================================================
+static void forwardUplinkQueue() {
+  PacketBuf** slot;
+  while ((slot = uplinkQueue.peek()) != nullptr) {
+    uplinkBacklogPush(*slot);   // La referencia pasa a la cola de reenvío
+    uplinkQueue.release();
+  }
+
+  unsigned long now = millis();
+  if (!aprsVerified) {
+    uplinkBacklogExpire(now);
+    return;
+  }
+
+  const PacketBuf* frame;
+  while ((frame = uplinkBacklogNext(now)) != nullptr) {
+    if (!aprsOut.append(frame->data, frame->length, now, OUT_UPLINK, frame->rxMillis,
+                        frame->rxMicros)) return;
+    uplinkBacklogRelease();
+  }
+}
+
+// Envía lo agrupado si corresponde; un error de send() cierra la sesión
+static void aprsOutTick() {
+  if (aprsOut.tick(millis()) == WRITE_ERROR) aprsSessionClose("Error de escritura");
+}
+
+// ============================================================================
+//  Métricas de la sesión APRS-IS
+// ============================================================================
+void reportNetworkStats() {
+  uint32_t now = millis();
+  const PoolStats& p = aprsPool.stats();
+  const char* active = networkServer();
+  Serial.printf("%sAPRSIS servidor=%s intentos=%lu caidas=%lu failover=%lu cambios=%lu "
+                "sin_reserva=%lu failover_ms(ult/max)=%lu/%lu sin_sesion_ms(ult/max)=%lu/%lu "
+                "fallos dns=%lu tcp=%lu banner=%lu login=%lu reserva=%lu\n",
+                getTimestamp().c_str(), active != nullptr ? active : "-",
+                (unsigned long)p.attempts, (unsigned long)aprsSessionDrops,
+                (unsigned long)p.failovers, (unsigned long)p.switches,
+                (unsigned long)p.coldStarts, (unsigned long)p.lastFailoverMs,
+                (unsigned long)p.maxFailoverMs, (unsigned long)p.lastGapMs,
+                (unsigned long)p.maxGapMs,
+                (unsigned long)p.failures[POOL_STAGE_IDLE],
+                (unsigned long)p.failures[POOL_STAGE_CONNECT],
+                (unsigned long)p.failures[POOL_STAGE_BANNER],
+                (unsigned long)p.failures[POOL_STAGE_LOGIN],
+                (unsigned long)p.failures[POOL_STAGE_READY]);
+
+  for (size_t i = 0; i < aprsPool.serverCount(); i++) {
+    const PoolServerStats& s = aprsPool.serverStats(i);
+    const char* role = (int)i == aprsPool.active()                          ? "sesion"
+                     : (int)i == aprsPool.linkServer(POOL_ROLE_STANDBY)     ? "reserva"
+                     : (int)i == aprsPool.linkServer(POOL_ROLE_PROBE)       ? "sondeo"
+                                                                            : "-";
+    Serial.printf("%s  %s:%u %-7s connect_ms=%lu login_ms=%lu uptime_s=%lu sesiones=%lu "
+                  "caidas=%lu failover=%lu fallos=%lu sondeos=%lu\n",
+                  getTimestamp().c_str(), aprsPool.host(i), aprsPool.port(i), role,
+                  (unsigned long)s.connectMs, (unsigned long)s.loginMs,
+                  (unsigned long)(aprsPool.uptime(i, now) / 1000), (unsigned long)s.sessions,
+                  (unsigned long)s.drops, (unsigned long)s.failovers,
+                  (unsigned long)s.failures, (unsigned long)s.probes);
+  }
+
+  const LineFramerStats& rx = aprsFramer.stats();
+  Serial.printf("%sAPRSIS_RX bytes=%lu lecturas=%lu lineas=%lu largas=%lu pendiente=%u\n",
+                getTimestamp().c_str(), (unsigned long)rx.bytes, (unsigned long)aprsReadCalls,
+                (unsigned long)rx.lines, (unsigned long)rx.oversized, (unsigned)aprsFramer.pending());
+
+  // Segmentos/s desde el reporte anterior (un send() por segmento con TCP_NODELAY)
+  static uint32_t lastTxReport = 0;
+  static uint32_t lastTxWrites = 0;
+  const LineWriterStats& tx = aprsOut.stats();
+  uint32_t elapsed = now - lastTxReport;
+  float segmentsPerSec = elapsed > 0 ? (tx.writes - lastTxWrites) * 1000.0f / elapsed : 0;
+  lastTxReport = now;
+  lastTxWrites = tx.writes;
+  Serial.printf("%sAPRSIS_TX lineas=%lu enviadas=%lu perdidas=%lu descartadas=%lu segmentos=%lu "
+                "seg/s=%.2f bytes/seg=%lu parciales=%lu por_tamano=%lu por_plazo=%lu "
+                "bloqueos=%lu bloqueo_ms(total/max)=%lu/%lu pendiente=%u max=%u\n",
+                getTimestamp().c_str(), (unsigned long)tx.lines, (unsigned long)tx.sent,
+                (unsigned long)tx.lost, (unsigned long)tx.rejected, (unsigned long)tx.writes,
+                segmentsPerSec, (unsigned long)(tx.writes ? tx.bytes / tx.writes : 0),
+                (unsigned long)tx.partial, (unsigned long)tx.bySize,
+                (unsigned long)tx.byDeadline, (unsigned long)tx.stalls,
+                (unsigned long)tx.stallMs, (unsigned long)tx.maxStallMs,
+                (unsigned)aprsOut.pending(), (unsigned)tx.maxPending);
+
+  if (rfFilter.empty()) return;
+  const FilterStats& f = rfFilter.stats();
+  uint32_t mhz = getCpuFrequencyMhz();
+  Serial.printf("%sFILTRO_RF lineas=%lu pasan=%lu rechazadas=%lu sin_coincidencia=%lu "
+                "eval_ns(media/max)=%lu/%lu\n",
+                getTimestamp().c_str(), (unsigned long)f.evaluated, (unsigned long)f.passed,
+                (unsigned long)f.rejected, (unsigned long)f.unmatched,
+                (unsigned long)(f.evaluated ? rfFilterCycles * 1000 / mhz / f.evaluated : 0),
+                (unsigned long)(rfFilterMaxCycles * 1000UL / mhz));
+  for (size_t i = 0; i < rfFilter.clauseCount(); i++) {
+    const FilterClause& c = rfFilter.clause(i);
+    Serial.printf("%s  %-24.*s %s=%lu\n", getTimestamp().c_str(), (int)c.length,
+                  rfFilter.text() + c.offset, c.exclude ? "rechaza" : "pasa",
+                  (unsigned long)c.hits);
+  }
+}
+
+// ============================================================================
+//  Función: networkWait()
+//  Descripción: Con light sleep y la sesión verificada sin nada pendiente,
+//               la tarea espera en select() sobre el socket APRS-IS y el
+//               eventfd de networkWake() hasta el próximo beacon, telemetría
+//               o ping (máximo NET_IDLE_MAX_WAIT); así la CPU duerme entre
+//               eventos. En cualquier otro caso revisa cada NET_TASK_PERIOD_MS.
+// ============================================================================
+static unsigned long untilDue(unsigned long last, unsigned long interval, unsigned long now) {
+  unsigned long elapsed = now - last;
+  return elapsed > interval ? 0 : interval - elapsed + 1;
+}
+
+static void networkWait() {
+  int fd = aprsClient.fd();
+  if (wakeFd < 0 || fd < 0 || !aprsVerified || uplinkBacklogDepth() > 0 ||
+      aprsOut.pending() > 0 || aprsClient.available() > 0) {
+    // Con líneas agrupadas se despierta al vencer el plazo de envío
+    unsigned long wait = std::min<unsigned long>(NET_TASK_PERIOD_MS, aprsOut.untilFlush(millis()));
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+    return;
+  }
+
+  unsigned long now = millis();
+  unsigned long wait = NET_IDLE_MAX_WAIT;
+  wait = std::min(wait, untilDue(lastBeaconTime, settings.beaconIntervalS * 1000UL, now));
+  wait = std::min(wait, untilDue(lastTelemetryTime, TELEMETRY_INTERVAL, now));
+  wait = std::min(wait, untilDue(lastServerPing, SERVER_PING_INTERVAL, now));
+  wait = std::min(wait, untilDue(lastMetricsStatus, METRICS_STATUS_INTERVAL, now));
+
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(fd, &readSet);
+  FD_SET(wakeFd, &readSet);
+  struct timeval timeout = { (time_t)(wait / 1000), (suseconds_t)((wait % 1000) * 1000) };
+  if (select(std::max(fd, wakeFd) + 1, &readSet, nullptr, nullptr, &timeout) > 0 &&
+      FD_ISSET(wakeFd, &readSet)) {
+    uint64_t count;
+    read(wakeFd, &count, sizeof(count));
+  }
+  ulTaskNotifyTake(pdTRUE, 0);   // Los avisos ya quedaron atendidos
+}
+
+// ============================================================================
+//  Tarea de red: reemplaza la parte de red del loop() original
+// ============================================================================
+void networkTask(void* param) {
+  networkTaskHandle = xTaskGetCurrentTaskHandle();
+
+  wifiBegin();
+  uplinkBacklogBegin();
+  rfFilterBegin();
+  aprsPoolBegin();
+  aprsOut.setPolicy(APRSIS_TX_FLUSH_BYTES, APRSIS_TX_COALESCE_MS);
+  aprsOut.setLineHandler(onLineWritten, nullptr);
+  if (powerLightSleep()) {
+    esp_vfs_eventfd_config_t config = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+    if (esp_vfs_eventfd_register(&config) == ESP_OK) wakeFd = eventfd(0, 0);
+  }
+
+  for (;;) {
+    {
+      TaskBusy busy(TASK_NET);
+
+      taskSection(TASK_NET, SEC_NET_WIFI);
+      wifiTick();
+      taskSection(TASK_NET, SEC_NET_SESSION);
+      aprsSessionTick();
+
+      if (aprsVerified) {
+
+        taskSection(TASK_NET, SEC_NET_TRAFFIC);
+        processAPRSTraffic();
+
+        // Las secciones poco frecuentes se abren solo cuando trabajan
+        if (!telemetryDefinitionsSent) {
+          taskSection(TASK_NET, SEC_NET_TELEMETRY);
+          telemetryDefinitionsSent = sendTelemetryDefinitions();
+        }
+
+        if (millis() - lastTelemetryTime > TELEMETRY_INTERVAL) {
+          taskSection(TASK_NET, SEC_NET_TELEMETRY);
+          sendTelemetry();
+          lastTelemetryTime = millis();
+        }
+
+        if (millis() - lastServerPing > SERVER_PING_INTERVAL) {
+          taskSection(TASK_NET, SEC_NET_STATUS);
+          sendServerPing();
+        }
+
+        if (millis() - lastMetricsStatus > METRICS_STATUS_INTERVAL) {
+          taskSection(TASK_NET, SEC_NET_STATUS);
+          sendMetricsStatus();
+        }
+      }
+
+      // El beacon por RF no depende de la sesión APRS-IS
+      if (millis() - lastBeaconTime > settings.beaconIntervalS * 1000UL) {
+        taskSection(TASK_NET, SEC_NET_BEACON);
+        sendBeacon();
+      }
+
+      taskSection(TASK_NET, SEC_NET_UPLINK);
+      forwardUplinkQueue();
+      taskSection(TASK_NET, SEC_NET_OUT);
+      aprsOutTick();
+    }
+    networkWait();
+  }
+}
@@ -0,0 +1,131 @@
+// ============================================================================
+//  Administración de energía
+// ============================================================================
+#include "power.h"
+
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <algorithm>
+#include <atomic>
+
+#include "config.h"
+#include "display.h"
+#include "log.h"
+#include "radio.h"
+#include "settings.h"
+#include "stats.h"
+
+static bool    lightSleep = false;
+static uint8_t wifiSleepMode = 1;   // Índice de POWER_WIFI_MA (0 = sin ahorro)
+
+static const char* const WIFI_SLEEP_NAMES[] = { "sin ahorro", "modem sleep mínimo", "modem sleep máximo" };
+
+// ============================================================================
+//  Función: powerBegin()
+//  Descripción: Aplica la configuración de energía. El light sleep necesita
+//               modem sleep (con el WiFi siempre encendido la CPU nunca
+//               duerme) y un framework con CONFIG_PM_ENABLE y tickless idle;
+//               si falta algo se avisa y se sigue sin light sleep. DIO0 se
+//               habilita como fuente de despertar en radioBegin().
+// ============================================================================
+void powerBegin() {
+  wifiSleepMode = settings.wifiSleep;
+  if (settings.lightSleep && wifiSleepMode == 0) {
+    logEvent(EV_POWER_WIFI_SLEEP_FORCED);
+    wifiSleepMode = 1;
+  }
+
+  if (settings.lightSleep) {
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    esp_pm_config_esp32_t pm;
+    pm.max_freq_mhz = 240;
+    pm.min_freq_mhz = 80;          // APB a 80 MHz: SPI e I2C no cambian de velocidad
+    pm.light_sleep_enable = true;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err == ESP_OK) {
+      esp_sleep_enable_gpio_wakeup();
+      lightSleep = true;
+    } else {
+      logEvent(EV_POWER_NO_LIGHT_SLEEP, { esp_err_to_name(err) });
+    }
+#else
+    logEvent(EV_POWER_NO_LIGHT_SLEEP, { "framework sin CONFIG_PM_ENABLE / tickless idle" });
+#endif
+  }
+
+  logEvent(EV_POWER_MODE, { lightSleep ? "light sleep" : "CPU siempre activa",
+                            WIFI_SLEEP_NAMES[wifiSleepMode], (unsigned)settings.displayTimeoutS });
+}
+
+bool powerLightSleep() { return lightSleep; }
+
+wifi_ps_type_t powerWifiSleep() {
+  if (wifiSleepMode == 0) return WIFI_PS_NONE;
+  return wifiSleepMode == 1 ? WIFI_PS_MIN_MODEM : WIFI_PS_MAX_MODEM;
+}
+
+// ============================================================================
+//  Estimación de consumo
+// ============================================================================
+static std::atomic<uint16_t> averageMa(0);
+static std::atomic<uint16_t> dutyPermille(0);
+
+uint16_t powerAverageMa() { return averageMa.load(std::memory_order_relaxed); }
+uint16_t powerDutyPermille() { return dutyPermille.load(std::memory_order_relaxed); }
+
+// ============================================================================
+//  Función: reportPowerStats()
+//  Descripción: Ciclo de trabajo de la CPU desde el reporte anterior (tiempo
+//               activo de las tareas más el costo de cada despertar) y
+//               consumo promedio: CPU activa / dormida, WiFi según el modo
+//               de ahorro, SX1276 en RX y en TX (tiempo en el aire real),
+//               OLED según el tiempo encendido y el resto de la placa.
+// ============================================================================
+void reportPowerStats() {
+  static uint32_t lastMs = 0, lastBusyUs = 0, lastIterations = 0;
+  static uint32_t lastAirtimeUs = 0, lastOledMs = 0;
+
+  uint32_t now = millis();
+  uint32_t busyUs = taskBusyTotalUs();
+  uint32_t iterations = taskIterationsTotal();
+  uint32_t airtimeUs = radioTxAirtimeUs();
+  uint32_t oledMs = displayOnTimeMs();
+  uint32_t elapsedMs = now - lastMs;
+  if (lastMs == 0 || elapsedMs == 0) {
+    lastMs = now;
+    lastBusyUs = busyUs;
+    lastIterations = iterations;
+    lastAirtimeUs = airtimeUs;
+    lastOledMs = oledMs;
+    return;
+  }
+
+  float elapsedUs = elapsedMs * 1000.0f;
+  uint32_t wakes = iterations - lastIterations;
+  float awakeUs = (float)(busyUs - lastBusyUs) + (lightSleep ? (float)wakes * POWER_WAKE_COST_US : 0.0f);
+  float duty = std::min(awakeUs / elapsedUs, 1.0f);
+  float txFraction = std::min((float)(airtimeUs - lastAirtimeUs) / elapsedUs, 1.0f);
+  float oledFraction = std::min((float)(oledMs - lastOledMs) / elapsedMs, 1.0f);
+
+  float cpuMa = duty * POWER_CPU_ACTIVE_MA +
+                (1.0f - duty) * (lightSleep ? POWER_CPU_SLEEP_MA : POWER_CPU_IDLE_MA);
+  float wifiMa = stats.wifiConnected.load() ? POWER_WIFI_MA[wifiSleepMode] : 0.0f;
+  float loraMa = txFraction * POWER_LORA_TX_MA + (1.0f - txFraction) * POWER_LORA_RX_MA;
+  float oledMa = oledFraction * POWER_OLED_MA;
+  float totalMa = cpuMa + wifiMa + loraMa + oledMa + POWER_BOARD_MA;
+
+  averageMa.store((uint16_t)(totalMa + 0.5f), std::memory_order_relaxed);
+  dutyPermille.store((uint16_t)(duty * 1000.0f + 0.5f), std::memory_order_relaxed);
+
+  Serial.printf("%sPOWER %s ciclo=%.1f%% despertares=%.1f/s tx=%.2f%% oled=%.0f%% | "
+                "prom=%.1f mA (cpu %.1f wifi %.1f lora %.1f oled %.1f placa %.1f) autonomia=%.0f h\n",
+                getTimestamp().c_str(), lightSleep ? "light_sleep" : "activa", duty * 100.0f,
+                wakes * 1000.0f / elapsedMs, txFraction * 100.0f, oledFraction * 100.0f, totalMa,
+                cpuMa, wifiMa, loraMa, oledMa, POWER_BOARD_MA, BATTERY_CAPACITY_MAH / totalMa);
+
+  lastMs = now;
+  lastBusyUs = busyUs;
+  lastIterations = iterations;
+  lastAirtimeUs = airtimeUs;
+  lastOledMs = oledMs;
+}
@@ -0,0 +1,795 @@
+// ============================================================================
+//  Tarea de radio: recepción LoRa por interrupción, supresión de duplicados,
+//  digipeating y transmisión planificada (prioridad, presupuesto de tiempo
+//  en el aire y escucha previa) sin bloquear durante el tiempo en el aire.
+//  Con lora.scan en la configuración, la recepción alterna CAD entre varias
+//  combinaciones SF/BW en lugar de quedar en recepción continua.
+// ============================================================================
+#include "radio.h"
+
+#include <SPI.h>              // Comunicación SPI para el módulo LoRa
+#include <LoRa.h>             // Librería para manejar el SX1276
+#include <algorithm>
+#include <atomic>
+#include <driver/gpio.h>
+#include <esp_timer.h>
+#include <hal/gpio_ll.h>      // Enmascarar DIO0 desde la ISR (IRAM)
+#include <CadScanner.h>       // Exploración de varias combinaciones SF/BW
+#include <IGatePipeline.h>    // Duplicados, estaciones escuchadas y digipeater
+
+#include "capture.h"
+#include "config.h"
+#include "log.h"
+#include "network.h"
+#include "power.h"
+#include "settings.h"
+#include "stats.h"
+
+PacketPool                              packetPool;   // Reservado una sola vez (estático)
+SpscRing<PacketBuf*, UPLINK_QUEUE_SIZE> uplinkQueue;
+SpscRing<RfTxFrame, RF_TX_QUEUE_SIZE>   rfTxQueue;
+
+static TaskHandle_t radioTaskHandle = nullptr;
+
+// ============================================================================
+//  Lógica del iGate (lib/IGatePipeline): tabla de duplicados (DUP_TABLE_SIZE
+//  y DUP_TIMEOUT en platformio.ini), estaciones escuchadas por RF que
+//  deciden qué mensajes APRS-IS → RF se transmiten, y reglas del digipeater
+// ============================================================================
+static IGatePipeline pipeline(HEARD_MAX_AGE);
+
+// ============================================================================
+//  Interrupción DIO0: RxDone en recepción, CadDone durante la exploración y
+//  la escucha previa y TxDone durante la transmisión (según radioMode).
+//  El ISR solo marca el evento pendiente, guarda su instante y despierta a
+//  la tarea de radio; el SPI del SX1276 no puede usarse dentro de una
+//  interrupción en el ESP32. En recepción la tarea vacía la FIFO en un
+//  buffer de packetPool (tag = combinación SF/BW de la exploración, 0 =
+//  principal) y lo encola en loraRxRing.
+// ============================================================================
+#ifndef LORA_RX_RING_SIZE
+#define LORA_RX_RING_SIZE 8   // Tramas en espera de procesamiento (potencia de 2)
+#endif
+
+static SpscRing<PacketBuf*, LORA_RX_RING_SIZE> loraRxRing;
+
+static volatile bool     loraIrqPending = false;
+static volatile uint32_t loraIrqMicros = 0;
+static volatile uint32_t loraIrqCount = 0;
+static uint32_t          loraRxEmptyIrq = 0;   // IRQ sin trama válida (CRC / timeout)
+static bool              loraIrqLevel = false; // Light sleep: DIO0 por nivel (ver radioBegin)
+
+static void IRAM_ATTR onLoRaDio0() {
+  // Por nivel la interrupción se repetiría mientras DIO0 siga alto: queda
+  // enmascarada hasta que serviceLoRaRadio() limpie la IRQ del SX1276
+  if (loraIrqLevel) gpio_ll_intr_disable(&GPIO, (gpio_num_t)LORA_IRQ);
+  loraIrqMicros = micros();
+  loraIrqCount++;
+  loraIrqPending = true;
+
+  if (radioTaskHandle != nullptr) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(radioTaskHandle, &woken);
+    if (woken == pdTRUE) portYIELD_FROM_ISR();
+  }
+}
+
+void radioWake() {
+  if (radioTaskHandle != nullptr) xTaskNotifyGive(radioTaskHandle);
+}
+
+// ============================================================================
+//  Acceso directo a registros del SX1276 para lo que la librería LoRa no
+//  expone (mapeo de DIO0, CAD y banderas de IRQ). Solo desde la tarea de
+//  radio, igual que el resto de accesos SPI al módulo.
+// ============================================================================
+#define SX1276_REG_OP_MODE       0x01
+#define SX1276_REG_IRQ_FLAGS     0x12
+#define SX1276_REG_MODEM_STAT    0x18
+#define SX1276_REG_DIO_MAPPING_1 0x40
+
+#define SX1276_MODE_LORA_STDBY   0x81
+#define SX1276_MODE_LORA_CAD     0x87
+
+#define SX1276_IRQ_CAD_DETECTED  0x01
+#define SX1276_IRQ_CAD_DONE      0x04
+#define SX1276_IRQ_TX_DONE       0x08
+#define SX1276_IRQ_VALID_HEADER  0x10
+
+#define SX1276_DIO0_RX_DONE      0x00
+#define SX1276_DIO0_TX_DONE      0x40
+#define SX1276_DIO0_CAD_DONE     0x80
+
+#define SX1276_MODEM_BUSY        0x0B   // Señal detectada / sincronizada / cabecera válida
+
+static const SPISettings sx1276Spi(8E6, MSBFIRST, SPI_MODE0);
+
+static uint8_t sx1276Transfer(uint8_t address, uint8_t value) {
+  SPI.beginTransaction(sx1276Spi);
+  digitalWrite(LORA_CS, LOW);
+  SPI.transfer(address);
+  uint8_t response = SPI.transfer(value);
+  digitalWrite(LORA_CS, HIGH);
+  SPI.endTransaction();
+  return response;
+}
+
+static uint8_t sx1276Read(uint8_t reg) { return sx1276Transfer(reg & 0x7F, 0x00); }
+static void sx1276Write(uint8_t reg, uint8_t value) { sx1276Transfer(reg | 0x80, value); }
+
+// ============================================================================
+//  Planificador de transmisión: prioridad por clase, presupuesto de tiempo
+//  en el aire (TX_DUTY_CYCLE_PERCENT) y espera aleatoria si el canal está
+//  ocupado
+// ============================================================================
+static LoRaModemParams loraModem = {   // SF/BW/CR se leen de settings en radioBegin
+  LORA_SPREADING_FACTOR, (uint32_t)LORA_BANDWIDTH, LORA_CODING_RATE4,
+  LORA_PREAMBLE_LENGTH, false /* CRC */, false /* cabecera explícita */
+};
+static const uint32_t TX_MAX_WAIT[TX_CLASS_COUNT] = {
+  TX_DIGI_MAX_WAIT, TX_MESSAGE_MAX_WAIT, TX_BEACON_MAX_WAIT
+};
+static TxScheduler txScheduler(loraModem, TX_DUTY_CYCLE_PERCENT * 600, TX_MAX_WAIT);
+
+enum RadioMode : uint8_t {
+  RADIO_RX,    // Recepción continua
+  RADIO_SCAN,  // CAD de exploración en una de las combinaciones SF/BW
+  RADIO_CAD,   // Detección de actividad antes de transmitir
+  RADIO_TX,    // Transmisión en curso (endPacket asíncrono)
+};
+
+static RadioMode     radioMode = RADIO_RX;
+static unsigned long radioModeSince = 0;
+static uint32_t      txStartMicros = 0;
+static uint32_t      txExpectedMs = 0;
+static uint32_t      txOriginMicros = 0;   // Origen de la trama en el aire
+static uint8_t       txClass = TX_CLASS_BEACON;
+static uint16_t      txLength = 0;
+
+// Métricas del transmisor
+static uint32_t lbtRssiBusy = 0;     // Canal ocupado por RSSI o recepción en curso
+static uint32_t lbtCadBusy = 0;      // Preámbulo detectado por CAD
+static uint32_t cadTimeouts = 0;
+static uint32_t txTimeouts = 0;
+static uint32_t txDurationLastUs = 0;
+static std::atomic<uint32_t> txAirtimeTotalUs(0);
+
+uint32_t radioTxAirtimeUs() { return txAirtimeTotalUs.load(std::memory_order_relaxed); }
+
+static void startReceive() {
+  sx1276Write(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_RX_DONE);
+  LoRa.receive();
+  radioMode = RADIO_RX;
+  radioModeSince = millis();
+}
+
+// ============================================================================
+//  Exploración CAD (lib/CadScanner): la principal (settings.spreadingFactor
+//  y bandwidthHz) es la combinación 0 y las de settings.scan son de solo
+//  recepción. Cada CAD sin detección pasa a la combinación de plazo más
+//  cercano; con detección el receptor se queda en esa combinación hasta la
+//  trama, o hasta lockTimeoutUs() sin cabecera válida (detección falsa).
+//  Se transmite siempre en la principal: su CAD libre hace de escucha previa.
+// ============================================================================
+static CadScanner scanner;
+static char       scanNames[SCAN_MAX_MODEMS][12];   // "SF12/125" para log y reporte
+static size_t     scanModem = 0;        // Combinación configurada en el SX1276
+static bool       scanLocked = false;   // Recepción tras una detección
+static bool       scanHeader = false;   // Cabecera válida durante el bloqueo
+static uint32_t   scanLockStartUs = 0;
+static uint32_t   scanLockLimitUs = 0;
+static uint32_t   scanTimeouts = 0;
+
+static void applyModem(size_t i) {
+  if (i == scanModem) return;
+  sx1276Write(SX1276_REG_OP_MODE, SX1276_MODE_LORA_STDBY);
+  LoRa.setSpreadingFactor(scanner.modem(i).spreadingFactor);
+  LoRa.setSignalBandwidth(scanner.modem(i).bandwidthHz);
+  scanModem = i;
+}
+
+static void startScanCad() {
+  applyModem(scanner.next(micros()));
+  sx1276Write(SX1276_REG_OP_MODE, SX1276_MODE_LORA_STDBY);
+  sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_CAD_DONE | SX1276_IRQ_CAD_DETECTED);
+  sx1276Write(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_CAD_DONE);
+  radioMode = RADIO_SCAN;
+  radioModeSince = millis();
+  sx1276Write(SX1276_REG_OP_MODE, SX1276_MODE_LORA_CAD);
+}
+
+// Preámbulo detectado: recepción continua en la combinación del CAD
+static void startLock(uint32_t irqMicros) {
+  sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_VALID_HEADER);
+  startReceive();
+  scanLocked = true;
+  scanHeader = false;
+  scanLockStartUs = irqMicros;
+  scanLockLimitUs = scanner.lockTimeoutUs(scanModem);
+}
+
+// Vuelta a la escucha después de una recepción, una transmisión o un CAD
+static void startListen() {
+  scanLocked = false;
+  if (scanner.active()) startScanCad();
+  else startReceive();
+}
+
+// ============================================================================
+//  Función: startTransmit()
+//  Descripción: Carga la trama de mayor prioridad en la FIFO y arranca la
+//               transmisión sin esperar su fin; DIO0 avisa con TxDone.
+// ============================================================================
+static void startTransmit() {
+  unsigned long now = millis();
+  const TxFrame* frame = txScheduler.next(now);
+  if (frame == nullptr) {   // Caducó durante el CAD
+    startListen();
+    return;
+  }
+
+  applyModem(0);
+  captureTx(frame->data, frame->length, scanner.modem(0).spreadingFactor, now);
+  LoRa.beginPacket();
+  LoRa.write((const uint8_t*)frame->data, frame->length);
+  sx1276Write(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_TX_DONE);
+  LoRa.endPacket(true);
+
+  txStartMicros = micros();
+  txExpectedMs = frame->airtimeMs;
+  txOriginMicros = frame->originMicros;
+  txClass = frame->txClass;
+  txLength = frame->length;
+  radioMode = RADIO_TX;
+  radioModeSince = now;
+
+  LogEventId event = EV_TX_BEACON;
+  if (frame->txClass == TX_CLASS_DIGI) event = EV_TX_DIGI;
+  else if (frame->txClass == TX_CLASS_MESSAGE) event = EV_TX_MESSAGE;
+  logPacket(event, frame->data, frame->length, { frame->airtimeMs, now - frame->enqueuedMs });
+
+  txScheduler.transmitting(now);
+}
+
+// ============================================================================
+//  Función: serviceTransmitter()
+//  Descripción: Escucha previa en dos pasos: primero el estado del módem y
+//               el RSSI instantáneo (no interrumpe una recepción en curso),
+//               luego un CAD que detecta preámbulos LoRa bajo el ruido.
+// ============================================================================
+static void serviceTransmitter() {
+  unsigned long now = millis();
+
+  if (radioMode == RADIO_CAD && now - radioModeSince > 50) {
+    cadTimeouts++;
+    startListen();
+  } else if (radioMode == RADIO_TX && now - radioModeSince > txExpectedMs + 500) {
+    txTimeouts++;
+    sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_TX_DONE);
+    startListen();
+  }
+
+  // Explorando, la escucha previa es el CAD de la principal (onScanCadDone)
+  if (radioMode != RADIO_RX || scanLocked || loraIrqPending) return;
+  if (txScheduler.next(now) == nullptr) return;
+
+  if ((sx1276Read(SX1276_REG_MODEM_STAT) & SX1276_MODEM_BUSY) != 0 ||
+      LoRa.rssi() > LBT_RSSI_THRESHOLD) {
+    lbtRssiBusy++;
+    txScheduler.channelBusy(now);
+    return;
+  }
+
+  sx1276Write(SX1276_REG_OP_MODE, SX1276_MODE_LORA_STDBY);
+  sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_CAD_DONE | SX1276_IRQ_CAD_DETECTED);
+  sx1276Write(SX1276_REG_DIO_MAPPING_1, SX1276_DIO0_CAD_DONE);
+  radioMode = RADIO_CAD;
+  radioModeSince = now;
+  sx1276Write(SX1276_REG_OP_MODE, SX1276_MODE_LORA_CAD);
+}
+
+static void onCadDone() {
+  uint8_t flags = sx1276Read(SX1276_REG_IRQ_FLAGS);
+  if (!(flags & SX1276_IRQ_CAD_DONE)) return;   // IRQ de un modo anterior: el CAD sigue
+  sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_CAD_DONE | SX1276_IRQ_CAD_DETECTED);
+
+  if (flags & SX1276_IRQ_CAD_DETECTED) {
+    lbtCadBusy++;
+    txScheduler.channelBusy(millis());
+    startReceive();
+    return;
+  }
+  startTransmit();
+}
+
+static void onScanCadDone(uint32_t irqMicros) {
+  uint8_t flags = sx1276Read(SX1276_REG_IRQ_FLAGS);
+  if (!(flags & SX1276_IRQ_CAD_DONE)) return;   // IRQ de un modo anterior: el CAD sigue
+  sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_CAD_DONE | SX1276_IRQ_CAD_DETECTED);
+
+  bool detected = (flags & SX1276_IRQ_CAD_DETECTED) != 0;
+  bool txPending = scanModem == 0 && txScheduler.next(millis()) != nullptr;
+  scanner.cadDone(scanModem, irqMicros, detected);
+  if (detected) {
+    if (txPending) {
+      lbtCadBusy++;
+      txScheduler.channelBusy(millis());
+    }
+    startLock(irqMicros);
+    return;
+  }
+  if (txPending) startTransmit();
+  else startScanCad();
+}
+
+// ============================================================================
+//  Función: serviceScan()
+//  Descripción: Supervisa el bloqueo tras una detección: con cabecera válida
+//               el plazo se extiende a la trama más larga posible en esa
+//               combinación (CR 4/8); vencido el plazo sin RxDone se cuenta
+//               como detección falsa (sin cabecera) o error de recepción y
+//               se retoma la exploración.
+// ============================================================================
+static void serviceScan() {
+  if (radioMode == RADIO_SCAN &&
+      millis() - radioModeSince > scanner.planned(scanModem).cadUs / 1000 + 50) {
+    scanTimeouts++;
+    startScanCad();
+    return;
+  }
+  if (radioMode != RADIO_RX || !scanLocked || loraIrqPending) return;
+
+  if (!scanHeader && (sx1276Read(SX1276_REG_IRQ_FLAGS) & SX1276_IRQ_VALID_HEADER)) {
+    LoRaModemParams longest = loraModem;
+    longest.spreadingFactor = scanner.modem(scanModem).spreadingFactor;
+    longest.bandwidthHz     = scanner.modem(scanModem).bandwidthHz;
+    longest.codingRate4     = 8;
+    scanHeader = true;
+    scanLockLimitUs += loraAirtimeUs(longest, AX25_MAX_FRAME);
+  }
+  if (micros() - scanLockStartUs < scanLockLimitUs) return;
+
+  if (scanHeader) scanner.rxError(scanModem);
+  else scanner.falseDetection(scanModem);
+  startListen();
+}
+
+static void onTxDone(uint32_t irqMicros) {
+  sx1276Write(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_TX_DONE);
+  txDurationLastUs = irqMicros - txStartMicros;
+  txAirtimeTotalUs.fetch_add(txDurationLastUs, std::memory_order_relaxed);
+  startListen();
+
+  countTraffic(FLOW_LORA_TX, txLength);
+  if (txClass == TX_CLASS_DIGI) markStage(STAGE_RX_DIGI_TX_DONE, txOriginMicros);
+  else if (txClass == TX_CLASS_MESSAGE) markStage(STAGE_IS_RF_TX_DONE, txOriginMicros);
+}
+
+// ============================================================================
+//  Función: serviceLoRaRadio()
+//  Descripción: Copia la trama pendiente (payload, RSSI, SNR y timestamps)
+//               desde la FIFO del SX1276 a un buffer del conjunto, lo encola
+//               y vuelve a recepción continua. Si la cola está llena la
+//               trama se descarta y queda contada en loraRxRing.overflows();
+//               sin buffer libre, en las estadísticas de packetPool. Con
+//               DIO0 por nivel, la interrupción se rearma cuando la IRQ del
+//               SX1276 ya se limpió.
+// ============================================================================
+static void handleLoRaIrq(uint32_t irqMicros) {
+  if (radioMode == RADIO_SCAN) {
+    onScanCadDone(irqMicros);
+    return;
+  }
+  if (radioMode == RADIO_CAD) {
+    onCadDone();
+    return;
+  }
+  if (radioMode == RADIO_TX) {
+    onTxDone(irqMicros);
+    return;
+  }
+
+  int packetSize = LoRa.parsePacket();
+  if (packetSize > 0) {
+    PacketBuf** slot = loraRxRing.acquire();
+    PacketBuf* frame = slot != nullptr ? packetPool.alloc() : nullptr;
+    if (frame != nullptr) {
+      uint16_t length = 0;
+      while (LoRa.available()) {
+        int b = LoRa.read();
+        if (length < AX25_MAX_FRAME) frame->data[length++] = (char)b;
+      }
+      frame->length   = length;
+      frame->tag      = (uint8_t)scanModem;
+      frame->rssi     = (int16_t)LoRa.packetRssi();
+      frame->snr      = LoRa.packetSnr();
+      frame->rxMicros = irqMicros;
+      frame->rxMillis = millis();
+      *slot = frame;
+      loraRxRing.publish();
+    }
+    if (scanLocked) scanner.received(scanModem);
+  } else {
+    loraRxEmptyIrq++;
+    if (scanLocked) scanner.rxError(scanModem);
+  }
+
+  startListen();
+}
+
+static void serviceLoRaRadio() {
+  if (!loraIrqPending) return;
+  loraIrqPending = false;
+  handleLoRaIrq(loraIrqMicros);
+  if (loraIrqLevel) gpio_intr_enable((gpio_num_t)LORA_IRQ);
+}
+
+// ============================================================================
+//  Digipeater: reglas compiladas en radioBegin (dentro de pipeline).
+//  Los digipeats con demora viscosa esperan en una tabla pequeña indexada
+//  por el hash de duplicados; si la misma trama vuelve a escucharse antes
+//  de su instante de salida, otro digipeater ya la cubrió y se cancela.
+// ============================================================================
+#ifndef DIGI_VISCOUS_SLOTS
+#define DIGI_VISCOUS_SLOTS 4
+#endif
+
+struct ViscousFrame {
+  uint32_t hash;       // dupeHash de la trama original
+  uint32_t rxMillis;
+  uint32_t rxMicros;
+  uint32_t dueMs;
+  uint16_t length;     // 0 = ranura libre
+  char     data[AX25_MAX_FRAME];
+};
+
+static ViscousFrame viscous[DIGI_VISCOUS_SLOTS];
+static uint32_t     viscousQueued = 0;
+static uint32_t     viscousCancelled = 0;
+static uint32_t     viscousSent = 0;
+static uint32_t     viscousFull = 0;
+
+static void enqueueDigipeat(const char* data, size_t length, uint32_t rxMillis,
+                            uint32_t rxMicros) {
+  if (!txScheduler.enqueue(TX_CLASS_DIGI, data, length, rxMillis, millis(), rxMicros)) {
+    logEvent(EV_DIGI_QUEUE_FULL);
+    return;
+  }
+  markStage(STAGE_RX_DIGI_QUEUED, rxMicros);
+}
+
+static void holdViscous(uint32_t hash, const DigiDecision& d, const char* frame,
+                        uint32_t rxMillis, uint32_t rxMicros) {
+  for (ViscousFrame& v : viscous) {
+    if (v.length != 0) continue;
+    v.hash = hash;
+    v.rxMillis = rxMillis;
+    v.rxMicros = rxMicros;
+    v.dueMs = rxMillis + d.delayMs;
+    v.length = (uint16_t)d.length;
+    memcpy(v.data, frame, d.length);
+    viscousQueued++;
+    return;
+  }
+  viscousFull++;   // Sin ranura: se descarta, igual que con la cola llena
+}
+
+// Otro digipeater repitió la trama: el digipeat retenido ya no hace falta
+static void cancelViscous(uint32_t hash) {
+  for (ViscousFrame& v : viscous) {
+    if (v.length != 0 && v.hash == hash) {
+      v.length = 0;
+      viscousCancelled++;
+    }
+  }
+}
+
+static void releaseViscous(uint32_t nowMs) {
+  for (ViscousFrame& v : viscous) {
+    if (v.length == 0 || (int32_t)(nowMs - v.dueMs) < 0) continue;
+    enqueueDigipeat(v.data, v.length, v.rxMillis, v.rxMicros);
+    v.length = 0;
+    viscousSent++;
+  }
+}
+
+// Latencia de las etapas de la trama en curso desde su flanco DIO0
+static void onPipelineStage(PipelineStage stage, void* context) {
+  const PacketBuf* frame = (const PacketBuf*)context;
+  if (frame == nullptr) return;
+  if (stage == PIPE_PARSED) markStage(STAGE_RX_PARSED, frame->rxMicros);
+  else if (stage == PIPE_DUP_CHECKED) markStage(STAGE_RX_DUP_CHECKED, frame->rxMicros);
+}
+
+// ============================================================================
+//  Procesa una trama recibida: duplicados, digipeating y encolado hacia
+//  APRS-IS (la tarea de red hace el envío). La captura y la cola hacia
+//  APRS-IS toman su propia referencia al buffer; la de la tarea de radio se
+//  suelta al volver.
+// ============================================================================
+static void handleLoRaFrame(PacketBuf* packet) {
+    const PacketBuf& frame = *packet;
+    captureRx(packet, scanner.modem(frame.tag).spreadingFactor);
+    pipeline.setStageHook(onPipelineStage, (void*)packet);
+    // Solo la principal cuenta como escuchada y se digipea: en las demás
+    // combinaciones no se transmite
+    bool primary = frame.tag == 0;
+    RfOutcome rf = pipeline.onRfFrame(frame.data, frame.length, frame.rssi, frame.snr,
+                                      frame.rxMillis, primary);
+    pipeline.setStageHook(nullptr, nullptr);
+    if (rf.verdict == RF_DUPLICATE) {
+        cancelViscous(rf.hash);
+        logEvent(EV_LORA_DUPLICATE);
+        return;
+    }
+
+    uint32_t received = countTraffic(FLOW_LORA_RX, frame.length);
+
+    if (primary) logPacket(EV_LORA_RX, frame.data, frame.length, { received, frame.rssi, frame.snr });
+    else logPacket(EV_LORA_RX_SCAN, frame.data, frame.length,
+                   { received, scanNames[frame.tag], frame.rssi, frame.snr });
+
+    if (rf.verdict == RF_OWN) return;
+
+    // Digipeating si alguna regla aplica
+    const DigiDecision& digi = rf.digi;
+    if (digi.length > 0) {
+        const char* rule = DIGI_RULE_NAMES[pipeline.digiEngine().rule(digi.rule).type];
+        if (digi.delayMs > 0) logEvent(EV_DIGI_DELAYED, { rule, digi.delayMs });
+        else logEvent(EV_DIGI, { rule });
+        if (digi.delayMs == 0) {
+            enqueueDigipeat(pipeline.digiFrame(), digi.length, frame.rxMillis, frame.rxMicros);
+        } else {
+            holdViscous(rf.hash, digi, pipeline.digiFrame(), frame.rxMillis, frame.rxMicros);
+        }
+    }
+
+    // Encolar para APRS-IS: la misma trama, sin copiarla
+    PacketBuf** up = uplinkQueue.acquire();
+    if (up == nullptr) {
+        stats.uplinkDropped++;
+        logEvent(EV_UPLINK_QUEUE_FULL);
+        return;
+    }
+    packetPool.retain(packet);
+    *up = packet;
+    uplinkQueue.publish();
+    networkWake();
+}
+
+// ============================================================================
+//  Paso de las tramas encoladas por la tarea de red al planificador
+// ============================================================================
+static void scheduleQueuedFrames() {
+  RfTxFrame* frame;
+  while ((frame = rfTxQueue.peek()) != nullptr) {
+    if (frame->txClass == TX_CLASS_MESSAGE &&
+        pipeline.gateToRf(frame->data, frame->length, HEARD_GATE_WINDOW, millis()) != GATE_PASS) {
+      rfTxQueue.release();
+      continue;
+    }
+    if (!txScheduler.enqueue((TxClass)frame->txClass, frame->data, frame->length,
+                             frame->queuedMs, millis(), frame->originMicros)) {
+      stats.rfTxDropped++;
+    }
+    rfTxQueue.release();
+  }
+}
+
+// ============================================================================
+//  Inicialización del SX1276 y de la interrupción DIO0
+// ============================================================================
+bool radioBegin() {
+  SPI.begin(LORA_SCK, LORA_MISO, LORA_MOSI, LORA_CS);
+  LoRa.setPins(LORA_CS, LORA_RST, LORA_IRQ);
+  if (!LoRa.begin(settings.frequencyHz)) {
+    logEvent(EV_LORA_INIT_FAILED);
+    return false;
+  }
+  // Después de begin(): el reset del módulo descarta la configuración previa
+  LoRa.setSignalBandwidth(settings.bandwidthHz);
+  LoRa.setSpreadingFactor(settings.spreadingFactor);
+  LoRa.setCodingRate4(settings.codingRate4);
+  LoRa.setPreambleLength(LORA_PREAMBLE_LENGTH);
+
+  loraModem.spreadingFactor = settings.spreadingFactor;
+  loraModem.bandwidthHz     = settings.bandwidthHz;
+  loraModem.codingRate4     = settings.codingRate4;
+  txScheduler.setModem(loraModem);
+  txScheduler.seed(esp_random());
+
+  scanner.add(ScanModem{ settings.spreadingFactor, settings.bandwidthHz });
+  for (uint8_t i = 0; i < settings.scanCount; i++) {
+    const LoraScanSettings& extra = settings.scan[i];
+    scanner.add(ScanModem{ extra.spreadingFactor,
+                           extra.bandwidthHz ? extra.bandwidthHz : settings.bandwidthHz });
+  }
+  bool scanAccepted = scanner.plan(LORA_PREAMBLE_LENGTH);
+  for (size_t i = 0; i < scanner.count(); i++) {
+    CadScanner::format(scanner.modem(i), scanNames[i], sizeof(scanNames[i]));
+  }
+
+  pipeline.begin(DigiConfig{ DIGI_OWN_CALL, DIGI_FILL_IN, DIGI_WIDE_MAX_HOPS,
+                             DIGI_VISCOUS_DELAY }, settings.callsign);
+
+  pinMode(LORA_IRQ, INPUT);
+  if (powerLightSleep()) {
+    // En light sleep solo se despierta por nivel: DIO0 alto despierta la CPU
+    // y la misma interrupción (enmascarada en la ISR) avisa a la tarea
+    loraIrqLevel = true;
+    attachInterrupt(digitalPinToInterrupt(LORA_IRQ), onLoRaDio0, ONHIGH);
+    gpio_wakeup_enable((gpio_num_t)LORA_IRQ, GPIO_INTR_HIGH_LEVEL);
+  } else {
+    attachInterrupt(digitalPinToInterrupt(LORA_IRQ), onLoRaDio0, RISING);
+  }
+  startListen();
+  logEvent(EV_LORA_READY);
+  if (!scanAccepted) {
+    const ScanPlan& p = scanner.rejected();
+    logEvent(EV_SCAN_REJECTED, { scanNames[0], p.worstGapUs, p.windowUs });
+  }
+  if (scanner.active()) {
+    for (size_t i = 0; i < scanner.count(); i++) {
+      const ScanPlan& p = scanner.planned(i);
+      logEvent(EV_SCAN_PLAN, { scanNames[i], p.cadUs, p.windowUs, p.worstGapUs });
+      logEvent(EV_SCAN_COVERAGE, { scanNames[i], (unsigned)p.coveragePermille,
+                                   (unsigned)p.dutyPermille });
+      if (!p.guaranteed) logEvent(EV_SCAN_UNGUARANTEED, { scanNames[i] });
+    }
+    logEvent(EV_SCAN_READY, { (uint32_t)scanner.count(), scanner.worstLatencyUs() });
+  }
+  return true;
+}
+
+// ============================================================================
+//  Espera de la tarea de radio: con light sleep, si no hay nada en el aire
+//  ni en cola, solo la despiertan DIO0 y radioWake() (con RADIO_IDLE_MAX_WAIT
+//  como resguardo); si no, revisa cada RADIO_TASK_PERIOD_MS.
+// ============================================================================
+static TickType_t radioWaitTicks() {
+  bool idle = powerLightSleep() && radioMode == RADIO_RX && !scanLocked && !loraIrqPending;
+  for (uint8_t c = 0; idle && c < TX_CLASS_COUNT; c++) idle = txScheduler.queued((TxClass)c) == 0;
+  for (const ViscousFrame& v : viscous) idle = idle && v.length == 0;
+  return pdMS_TO_TICKS(idle ? RADIO_IDLE_MAX_WAIT : RADIO_TASK_PERIOD_MS);
+}
+
+// ============================================================================
+//  Tarea de radio: espera la IRQ (o el periodo de revisión), vacía la FIFO,
+//  procesa las tramas recibidas y atiende al transmisor (CAD / TX en curso
+//  / siguiente trama del planificador).
+// ============================================================================
+void radioTask(void* param) {
+  radioTaskHandle = xTaskGetCurrentTaskHandle();
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, radioWaitTicks());
+    TaskBusy busy(TASK_RADIO);
+
+    taskSection(TASK_RADIO, SEC_RADIO_FIFO);
+    serviceLoRaRadio();
+
+    taskSection(TASK_RADIO, SEC_RADIO_FRAMES);
+    PacketBuf** slot;
+    while ((slot = loraRxRing.peek()) != nullptr) {
+      PacketBuf* frame = *slot;
+      handleLoRaFrame(frame);
+      markStage(STAGE_RX_HANDLED, frame->rxMicros);   // Incluye el despertar
+      packetPool.release(frame);
+      loraRxRing.release();
+      serviceLoRaRadio();
+    }
+
+    taskSection(TASK_RADIO, SEC_RADIO_VISCOUS);
+    releaseViscous(millis());
+    taskSection(TASK_RADIO, SEC_RADIO_SCHEDULE);
+    scheduleQueuedFrames();
+    taskSection(TASK_RADIO, SEC_RADIO_SCAN);
+    serviceScan();
+    taskSection(TASK_RADIO, SEC_RADIO_TX);
+    serviceTransmitter();
+  }
+}
+
+// ============================================================================
+//  Estadísticas de la cola de recepción y sus buffers, de la tabla de
+//  duplicados, de las estaciones escuchadas, del digipeater y del
+//  planificador de transmisión
+// ============================================================================
+void reportRadioStats() {
+  const DupeFilter& dupeFilter = pipeline.dupeFilter();
+  const DupeStats& dup = dupeFilter.stats();
+  Serial.printf("%sDUPES hits=%lu misses=%lu evict=%lu reused=%lu live=%u/%u\n",
+                getTimestamp().c_str(), (unsigned long)dup.hits, (unsigned long)dup.misses,
+                (unsigned long)dup.evictions, (unsigned long)dup.reused,
+                dupeFilter.liveEntries(millis()), (unsigned)DUP_TABLE_SIZE);
+  Serial.printf("%sLORA_RX irq=%lu vacias=%lu cola=%u/%u max=%lu desbordes=%lu\n",
+                getTimestamp().c_str(), (unsigned long)loraIrqCount, (unsigned long)loraRxEmptyIrq,
+                (unsigned)loraRxRing.size(), (unsigned)loraRxRing.capacity(),
+                (unsigned long)loraRxRing.highWater(), (unsigned long)loraRxRing.overflows());
+
+  // Exploración CAD: captura (tramas / detecciones) y cobertura por combinación
+  if (scanner.active()) {
+    uint64_t uptimeUs = (uint64_t)esp_timer_get_time();
+    for (size_t i = 0; i < scanner.count(); i++) {
+      const ScanStats& s = scanner.stats(i);
+      const ScanPlan& p = scanner.planned(i);
+      Serial.printf("%sSCAN %-9s cad=%lu detecciones=%lu tramas=%lu captura=%.0f%% falsas=%lu "
+                    "errores=%lu vencidas=%lu hueco_max=%lu/%lu us tiempo=%.1f%% "
+                    "| plan cobertura=%.1f%% latencia=%lu us\n",
+                    getTimestamp().c_str(), scanNames[i], (unsigned long)s.cads,
+                    (unsigned long)s.detections, (unsigned long)s.frames,
+                    s.detections ? s.frames * 100.0f / s.detections : 0.0f,
+                    (unsigned long)s.falseDetections, (unsigned long)s.rxErrors,
+                    (unsigned long)s.missedWindows, (unsigned long)s.maxGapUs,
+                    (unsigned long)p.windowUs, uptimeUs ? s.cadTimeUs * 100.0f / uptimeUs : 0.0f,
+                    p.coveragePermille / 10.0f, (unsigned long)p.worstLatencyUs);
+    }
+    if (scanTimeouts > 0) {
+      Serial.printf("%sSCAN timeouts=%lu\n", getTimestamp().c_str(), (unsigned long)scanTimeouts);
+    }
+  }
+  Serial.printf("%sCOLAS uplink=%u/%u max=%lu desbordes=%lu | rf_tx=%u/%u max=%lu desbordes=%lu\n",
+                getTimestamp().c_str(),
+                (unsigned)uplinkQueue.size(), (unsigned)uplinkQueue.capacity(),
+                (unsigned long)uplinkQueue.highWater(), (unsigned long)uplinkQueue.overflows(),
+                (unsigned)rfTxQueue.size(), (unsigned)rfTxQueue.capacity(),
+                (unsigned long)rfTxQueue.highWater(), (unsigned long)rfTxQueue.overflows());
+
+  // Buffers compartidos: agotado = tramas recibidas sin buffer libre;
+  // diferidos = captura o almacenamiento que cedieron la reserva
+  PacketPoolStats pool = packetPool.stats();
+  Serial.printf("%sPOOL en_uso=%u/%u max=%u reservas=%lu agotado=%lu diferidos=%lu "
+                "liberaciones_invalidas=%lu\n",
+                getTimestamp().c_str(), (unsigned)packetPool.inUse(), (unsigned)packetPool.capacity(),
+                (unsigned)packetPool.highWater(), (unsigned long)pool.allocs,
+                (unsigned long)pool.exhausted, (unsigned long)pool.deferred,
+                (unsigned long)pool.badReleases);
+
+  // Estaciones escuchadas y filtro IS → RF
+  HeardList& heardList = pipeline.heardList();
+  const HeardStats& heard = heardList.stats();
+  const GateStats& gate = pipeline.gateStats();
+  Serial.printf("%sHEARD estaciones=%u/%u busquedas=%lu aciertos=%.0f%% lru=%lu caducadas=%lu "
+                "| IS->RF pasan=%lu sin_escuchar=%lu no_mensaje=%lu\n",
+                getTimestamp().c_str(), (unsigned)heardList.size(), (unsigned)HEARD_TABLE_SIZE,
+                (unsigned long)heard.lookups,
+                heard.lookups ? heard.hits * 100.0f / heard.lookups : 0.0f,
+                (unsigned long)heard.evictedLru, (unsigned long)heard.expired,
+                (unsigned long)gate.passed, (unsigned long)gate.notHeard, (unsigned long)gate.notMessage);
+
+  // Digipeater: coincidencias por regla y motivos de descarte
+  const DigiEngine& digiEngine = pipeline.digiEngine();
+  const DigiStats& digi = digiEngine.stats();
+  Serial.printf("%sDIGI evaluadas=%lu", getTimestamp().c_str(), (unsigned long)digi.evaluated);
+  for (uint8_t r = 0; r < digiEngine.ruleCount(); r++) {
+    Serial.printf(" %s=%lu", DIGI_RULE_NAMES[digiEngine.rule(r).type], (unsigned long)digi.matched[r]);
+  }
+  Serial.printf(" sin_regla=%lu bloqueadas=%lu bucle=%lu limite=%lu invalidas=%lu "
+                "| viscoso retenidas=%lu canceladas=%lu enviadas=%lu llena=%lu\n",
+                (unsigned long)digi.noRule, (unsigned long)digi.blocked, (unsigned long)digi.loop,
+                (unsigned long)digi.hopCapped, (unsigned long)digi.invalid,
+                (unsigned long)viscousQueued, (unsigned long)viscousCancelled,
+                (unsigned long)viscousSent, (unsigned long)viscousFull);
+
+  // Planificador de transmisión
+  unsigned long now = millis();
+  const TxSchedulerStats& tx = txScheduler.stats();
+  for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+    const TxClassStats& cs = tx.classes[c];
+    Serial.printf("%sTX %-6s cola=%u enviadas=%lu lat_ms(prom/max)=%lu/%lu "
+                  "descartes llena=%lu vieja=%lu ocupado=%lu\n",
+                  getTimestamp().c_str(), TX_CLASS_NAMES[c], (unsigned)txScheduler.queued((TxClass)c),
+                  (unsigned long)cs.sent,
+                  (unsigned long)(cs.sent ? cs.latencySumMs / cs.sent : 0), (unsigned long)cs.latencyMaxMs,
+                  (unsigned long)cs.droppedFull, (unsigned long)cs.droppedStale,
+                  (unsigned long)cs.droppedBusy);
+  }
+  uint32_t used = txScheduler.airtimeLastMinute(now);
+  Serial.printf("%sTX aire=%lu/%lu ms/min (%.1f%%) total=%lu ms ult_tx=%lu us "
+                "lbt rssi=%lu cad=%lu presupuesto=%lu timeouts cad=%lu tx=%lu\n",
+                getTimestamp().c_str(), (unsigned long)used,
+                (unsigned long)txScheduler.budgetMsPerMinute(), used / 600.0f,
+                (unsigned long)tx.airtimeTotalMs, (unsigned long)txDurationLastUs,
+                (unsigned long)lbtRssiBusy, (unsigned long)lbtCadBusy,
+                (unsigned long)tx.budgetWaits, (unsigned long)cadTimeouts, (unsigned long)txTimeouts);
+}
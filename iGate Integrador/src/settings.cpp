@@ -0,0 +1,193 @@
+// ============================================================================
+//  Configuración de operación en tiempo de ejecución
+// ============================================================================
+#include "settings.h"
+
+#include <LittleFS.h>         // Archivo de configuración
+#include <Preferences.h>      // Copia binaria en NVS
+#include <algorithm>
+
+#include "config.h"
+#include "log.h"
+
+IGateConfig settings;
+
+#define CONFIG_FILE_PATH   "/is-cfg.json"
+#define CONFIG_CACHE_MAGIC 0x43464731UL   // "CFG1"
+#define CONFIG_READ_CHUNK  64             // Bytes por lectura del archivo
+
+enum ConfigSource : uint8_t {
+  CONFIG_SOURCE_DEFAULTS,
+  CONFIG_SOURCE_FILE,
+  CONFIG_SOURCE_CACHE,
+  CONFIG_SOURCE_CACHE_FALLBACK,   // El archivo tiene errores: última copia válida
+};
+
+static const char* const CONFIG_SOURCE_NAMES[] = {
+  "valores por defecto", "is-cfg.json", "caché NVS", "caché NVS (is-cfg.json con errores)"
+};
+
+// ============================================================================
+//  Copia en NVS
+// ============================================================================
+struct ConfigCache {
+  uint32_t    magic;
+  uint16_t    version;
+  uint16_t    size;          // sizeof(IGateConfig) del firmware que la escribió
+  uint32_t    sourceHash;    // FNV-1a del is-cfg.json del que salió
+  uint32_t    sourceSize;
+  IGateConfig config;
+  uint32_t    check;         // FNV-1a de los campos anteriores
+};
+
+static ConfigCache  cache;
+static ConfigReport report;   // Estático: los eventos de log apuntan a sus campos
+
+static uint32_t cacheChecksum(const ConfigCache& c) {
+  return configHash(CONFIG_HASH_SEED, (const char*)&c, offsetof(ConfigCache, check));
+}
+
+static bool loadCache() {
+  Preferences prefs;
+  if (!prefs.begin("config", true)) return false;
+  bool ok = prefs.getBytes("blob", &cache, sizeof(cache)) == sizeof(cache) &&
+            cache.magic == CONFIG_CACHE_MAGIC && cache.version == CONFIG_VERSION &&
+            cache.size == sizeof(IGateConfig) && cache.check == cacheChecksum(cache);
+  prefs.end();
+  return ok;
+}
+
+static void saveCache(const IGateConfig& config, uint32_t hash, uint32_t size) {
+  memset(&cache, 0, sizeof(cache));
+  cache.magic      = CONFIG_CACHE_MAGIC;
+  cache.version    = CONFIG_VERSION;
+  cache.size       = sizeof(IGateConfig);
+  cache.sourceHash = hash;
+  cache.sourceSize = size;
+  cache.config     = config;
+  cache.check      = cacheChecksum(cache);
+
+  Preferences prefs;
+  if (prefs.begin("config", false)) {
+    prefs.putBytes("blob", &cache, sizeof(cache));
+    prefs.end();
+  }
+}
+
+// ============================================================================
+//  Valores por defecto (config.h)
+// ============================================================================
+static void loadDefaults(IGateConfig& c) {
+  memset(&c, 0, sizeof(c));
+  strncpy(c.callsign, callsign, CONFIG_CALL_LEN);
+  c.aprsIsActive = true;
+  strncpy(c.passcode, passcode, CONFIG_PASSCODE_LEN);
+  strncpy(c.server, server, CONFIG_HOST_LEN);
+  c.port = (uint16_t)port;
+  c.serverCount = (uint8_t)std::min<size_t>(APRS_SERVER_COUNT, CONFIG_MAX_SERVERS);
+  for (uint8_t i = 0; i < c.serverCount; i++) strncpy(c.servers[i], APRS_SERVERS[i], CONFIG_HOST_LEN);
+  strncpy(c.filter, APRS_FILTER, CONFIG_FILTER_LEN);
+  strncpy(c.rfFilter, APRS_RF_FILTER, CONFIG_FILTER_LEN);
+
+  c.wifiActive = true;
+  c.apCount = (uint8_t)std::min<size_t>(WIFI_AP_COUNT, CONFIG_MAX_APS);
+  for (uint8_t i = 0; i < c.apCount; i++) {
+    strncpy(c.aps[i].ssid, WIFI_APS[i].ssid, CONFIG_SSID_LEN);
+    strncpy(c.aps[i].password, WIFI_APS[i].password, CONFIG_WIFI_PASS_LEN);
+  }
+
+  c.frequencyHz     = (uint32_t)LORA_BAND;
+  c.spreadingFactor = LORA_SPREADING_FACTOR;
+  c.bandwidthHz     = (uint32_t)LORA_BANDWIDTH;
+  c.codingRate4     = LORA_CODING_RATE4;
+  c.scanCount = (uint8_t)std::min<size_t>(LORA_SCAN_COUNT, CONFIG_MAX_SCAN);
+  for (uint8_t i = 0; i < c.scanCount; i++) {
+    c.scan[i].spreadingFactor = LORA_SCAN[i].spreadingFactor;
+    c.scan[i].bandwidthHz     = LORA_SCAN[i].bandwidthHz;
+  }
+
+  c.beaconLat       = BEACON_LAT;
+  c.beaconLon       = BEACON_LON;
+  strncpy(c.beaconComment, BEACON_COMMENT, CONFIG_COMMENT_LEN);
+  c.beaconIntervalS = BEACON_INTERVAL / 1000;
+  c.beaconRf        = BEACON_RF;
+  strncpy(c.beaconRfPath, BEACON_RF_PATH, CONFIG_PATH_LEN);
+
+  c.lightSleep      = POWER_LIGHT_SLEEP;
+  c.wifiSleep       = WIFI_SLEEP_MODE;
+  c.displayTimeoutS = DISPLAY_TIMEOUT_S;
+}
+
+static void reportIssues() {
+  if (report.jsonError != JSON_OK) {
+    logEvent(EV_CONFIG_SYNTAX, { JSON_ERROR_NAMES[report.jsonError], report.line, report.column });
+  }
+  uint16_t shown = std::min<uint16_t>(report.issueCount, CONFIG_MAX_ISSUES);
+  for (uint16_t i = 0; i < shown; i++) {
+    logEvent(EV_CONFIG_ISSUE, { report.issues[i].field, CONFIG_ISSUE_NAMES[report.issues[i].code] });
+  }
+  if (report.issueCount > shown) logEvent(EV_CONFIG_MORE_ISSUES, { report.issueCount - shown });
+}
+
+// ============================================================================
+//  Función: settingsBegin()
+//  Descripción: Primero solo se calcula el hash del archivo (lecturas de
+//               CONFIG_READ_CHUNK bytes); si coincide con el de la copia en
+//               NVS se usa la copia. Si no, se relee y se pasa por el lector
+//               JSON sobre los valores por defecto, se valida y, si no hubo
+//               problemas, se guarda la nueva copia.
+// ============================================================================
+void settingsBegin() {
+  uint32_t start = micros();
+  loadDefaults(settings);
+  ConfigSource source = CONFIG_SOURCE_DEFAULTS;
+  bool cached = loadCache();
+  memset(&report, 0, sizeof(report));
+
+  File file;
+  if (LittleFS.begin(false)) file = LittleFS.open(CONFIG_FILE_PATH, "r");
+
+  if (!file) {
+    logEvent(EV_CONFIG_NO_FILE);
+    if (cached) {
+      settings = cache.config;
+      source = CONFIG_SOURCE_CACHE;
+    }
+  } else {
+    char chunk[CONFIG_READ_CHUNK];
+    uint32_t hash = CONFIG_HASH_SEED;
+    uint32_t size = 0;
+    int n;
+    while ((n = file.read((uint8_t*)chunk, sizeof(chunk))) > 0) {
+      hash = configHash(hash, chunk, (size_t)n);
+      size += (uint32_t)n;
+    }
+
+    if (cached && cache.sourceHash == hash && cache.sourceSize == size) {
+      settings = cache.config;
+      source = CONFIG_SOURCE_CACHE;
+    } else {
+      static IGateConfig parsed;
+      parsed = settings;
+      ConfigParser parser(parsed, report);
+      file.seek(0);
+      while ((n = file.read((uint8_t*)chunk, sizeof(chunk))) > 0 && parser.feed(chunk, (size_t)n)) {
+      }
+      if (parser.finish()) {
+        settings = parsed;
+        source = CONFIG_SOURCE_FILE;
+        saveCache(parsed, hash, size);
+      } else {
+        reportIssues();
+        if (cached) {
+          settings = cache.config;
+          source = CONFIG_SOURCE_CACHE_FALLBACK;
+        }
+      }
+    }
+    file.close();
+  }
+
+  logEvent(EV_CONFIG_LOADED, { CONFIG_SOURCE_NAMES[source], micros() - start,
+                               (unsigned)report.assigned, (unsigned)report.unknownKeys });
+}
@@ -0,0 +1,413 @@
+// ============================================================================
+//  Métricas del sistema compartidas entre tareas
+// ============================================================================
+#include "stats.h"
+#include "config.h"
+#include "log.h"
+
+#include <LoopProfiler.h>
+#include <esp_heap_caps.h>
+#include <esp_rom_sys.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+
+SystemStats stats;
+
+const char* const STAGE_NAMES[STAGE_COUNT] = {
+  "rx>parsed", "rx>dup", "rx>handled", "rx>digi_q", "rx>digi_tx", "rx>is_tx", "is>rf_q", "is>rf_tx"
+};
+const char* const FLOW_NAMES[FLOW_COUNT] = { "lora_rx", "lora_tx", "is_rx", "is_tx" };
+
+StatsSnapshot snapshotStats() {
+  StatsSnapshot s;
+  s.loraRx        = stats.flows[FLOW_LORA_RX].totalPackets();
+  s.loraTx        = stats.flows[FLOW_LORA_TX].totalPackets();
+  s.isRx          = stats.flows[FLOW_IS_RX].totalPackets();
+  s.isTx          = stats.flows[FLOW_IS_TX].totalPackets();
+  s.uplinkDropped = stats.uplinkDropped.load();
+  s.rfTxDropped   = stats.rfTxDropped.load();
+  s.wifiConnected = stats.wifiConnected.load();
+  s.aprsConnected = stats.aprsConnected.load();
+  return s;
+}
+
+// ============================================================================
+//  Memoria dinámica
+// ============================================================================
+static std::atomic<uint32_t> heapLargestMin(UINT32_MAX);
+static std::atomic<uint32_t> heapLargestLast(0);
+static std::atomic<uint32_t> heapFreeLast(0);
+static std::atomic<uint32_t> heapAllocatedLast(0);
+static std::atomic<uint32_t> heapBlocksLast(0);
+
+// Régimen estable: lo asignado en la primera muestra después de
+// HEAP_STEADY_AFTER_MS es la base; con los buffers fijos (packetPool, colas)
+// el crecimiento desde ahí debería quedarse en cero
+static std::atomic<bool>     heapSteady(false);
+static std::atomic<uint32_t> heapSteadyBytes(0);
+static std::atomic<uint32_t> heapSteadyBlocks(0);
+static std::atomic<int32_t>  heapGrowthMax(0);
+
+void sampleHeap() {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  uint32_t largest = (uint32_t)info.largest_free_block;
+  heapLargestLast.store(largest, std::memory_order_relaxed);
+  if (largest < heapLargestMin.load(std::memory_order_relaxed))
+    heapLargestMin.store(largest, std::memory_order_relaxed);
+  heapFreeLast.store((uint32_t)info.total_free_bytes, std::memory_order_relaxed);
+  heapAllocatedLast.store((uint32_t)info.total_allocated_bytes, std::memory_order_relaxed);
+  heapBlocksLast.store((uint32_t)info.allocated_blocks, std::memory_order_relaxed);
+
+  if (!heapSteady.load(std::memory_order_relaxed)) {
+    if (millis() < HEAP_STEADY_AFTER_MS) return;
+    heapSteadyBytes.store((uint32_t)info.total_allocated_bytes, std::memory_order_relaxed);
+    heapSteadyBlocks.store((uint32_t)info.allocated_blocks, std::memory_order_relaxed);
+    heapSteady.store(true, std::memory_order_release);
+    return;
+  }
+  int32_t growth = (int32_t)(info.total_allocated_bytes - heapSteadyBytes.load(std::memory_order_relaxed));
+  if (growth > heapGrowthMax.load(std::memory_order_relaxed))
+    heapGrowthMax.store(growth, std::memory_order_relaxed);
+}
+
+// Fragmentación (1 - bloque más grande / libre) y crecimiento de lo asignado
+// desde la base del régimen estable
+static void reportHeapSteady() {
+  uint32_t free = heapFreeLast.load();
+  uint32_t largest = heapLargestLast.load();
+  unsigned frag = free ? (unsigned)(100 - (uint64_t)largest * 100 / free) : 0;
+  Serial.printf("%sHEAP_FRAG fragmentacion=%u%% asignado=%lu B en %lu bloques",
+                getTimestamp().c_str(), frag, (unsigned long)heapAllocatedLast.load(),
+                (unsigned long)heapBlocksLast.load());
+  if (!heapSteady.load(std::memory_order_acquire)) {
+    Serial.printf(" | estable desde %lu s\n", (unsigned long)(HEAP_STEADY_AFTER_MS / 1000));
+    return;
+  }
+  Serial.printf(" | estable: %+ld B %+ld bloques max=%+ld B\n",
+                (long)(int32_t)(heapAllocatedLast.load() - heapSteadyBytes.load()),
+                (long)(int32_t)(heapBlocksLast.load() - heapSteadyBlocks.load()),
+                (long)heapGrowthMax.load());
+}
+
+// ============================================================================
+//  Función: reportMetrics()
+//  Descripción: Una línea por flujo (tasas y totales), dos de memoria (libre
+//               y bloque más grande; fragmentación y crecimiento en régimen
+//               estable) y una por etapa con muestras, media, p50/p95/p99,
+//               máximo y las cubetas no vacías ("<límite:n").
+// ============================================================================
+void reportMetrics() {
+  uint32_t now = millis();
+  for (int f = 0; f < FLOW_COUNT; f++) {
+    const RateCounter& r = stats.flows[f];
+    Serial.printf("%sFLUJO %-7s %.2f pkt/s %.0f B/s total=%lu pkt %lu B\n",
+                  getTimestamp().c_str(), FLOW_NAMES[f], r.packetsPerSecond(now),
+                  r.bytesPerSecond(now), (unsigned long)r.totalPackets(),
+                  (unsigned long)r.totalBytes());
+  }
+  Serial.printf("%sHEAP libre=%lu min=%lu bloque=%lu bloque_min=%lu desc uplink=%lu rf_tx=%lu\n",
+                getTimestamp().c_str(), (unsigned long)ESP.getFreeHeap(),
+                (unsigned long)ESP.getMinFreeHeap(), (unsigned long)heapLargestLast.load(),
+                (unsigned long)heapLargestMin.load(), (unsigned long)stats.uplinkDropped.load(),
+                (unsigned long)stats.rfTxDropped.load());
+  reportHeapSteady();
+
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    const LatencyHistogram& h = stats.stages[s];
+    Serial.printf("%sLAT %-10s n=%lu prom=%lu p50=%lu p95=%lu p99=%lu max=%lu us |",
+                  getTimestamp().c_str(), STAGE_NAMES[s], (unsigned long)h.count(),
+                  (unsigned long)h.meanUs(), (unsigned long)h.percentileUs(50),
+                  (unsigned long)h.percentileUs(95), (unsigned long)h.percentileUs(99),
+                  (unsigned long)h.maxUs());
+    for (size_t b = 0; b < LATENCY_BUCKETS; b++) {
+      uint32_t n = h.bucket(b);
+      if (n == 0) continue;
+      if (b < LATENCY_BUCKETS - 1) Serial.printf(" <%lu:%lu", (unsigned long)LATENCY_BUCKET_LIMITS_US[b], (unsigned long)n);
+      else Serial.printf(" >=%lu:%lu", (unsigned long)LATENCY_BUCKET_LIMITS_US[b - 1], (unsigned long)n);
+    }
+    Serial.println();
+  }
+}
+
+void resetMetrics() {
+  for (int s = 0; s < STAGE_COUNT; s++) stats.stages[s].reset();
+  heapLargestMin.store(UINT32_MAX, std::memory_order_relaxed);
+}
+
+// ============================================================================
+//  Función: formatMetricsStatus()
+//  Descripción: Estado compacto para un paquete de estado APRS (">texto",
+//               máximo 62 caracteres): tasas por dirección, p95 de RF →
+//               APRS-IS y memoria libre mínima / bloque mínimo en KiB.
+// ============================================================================
+size_t formatMetricsStatus(char* out, size_t size) {
+  uint32_t now = millis();
+  int n = snprintf(out, size, "RF>IS %.1f/s p95 %lums IS>RF %.1f/s heap %luk/%luk",
+                   stats.flows[FLOW_IS_TX].packetsPerSecond(now),
+                   (unsigned long)(stats.stages[STAGE_RX_IS_WRITTEN].percentileUs(95) / 1000),
+                   stats.flows[FLOW_LORA_TX].packetsPerSecond(now),
+                   (unsigned long)(ESP.getMinFreeHeap() / 1024),
+                   (unsigned long)(heapLargestMin.load() == UINT32_MAX ? 0 : heapLargestMin.load() / 1024));
+  if (n < 0) return 0;
+  return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+// ============================================================================
+//  Conversión lectura del ADC → Voltaje real de la batería
+// ============================================================================
+float getBatteryVoltage() {
+  int raw = analogRead(BATTERY_ADC_PIN);
+  float voltage = ((float)raw / 4095.0) * 3.3 * 2; // Atenuación + divisor de voltaje
+  return voltage;
+}
+
+// ============================================================================
+//  Monitor de tareas
+// ============================================================================
+struct TaskMonitor {
+  const char*           name;
+  TaskHandle_t          handle;
+  uint8_t               core;
+  uint8_t               priority;
+  std::atomic<uint32_t> busyUs;      // Tiempo activo acumulado
+  std::atomic<uint32_t> iterations;  // Despertares atendidos
+  uint32_t              lastBusyUs;  // Valor en el reporte anterior
+#if (configGENERATE_RUN_TIME_STATS == 1) && (configUSE_TRACE_FACILITY == 1)
+  uint32_t              lastRunTime;
+#endif
+};
+
+static TaskMonitor tasks[TASK_COUNT];
+static uint32_t lastReportMs = 0;
+
+// Bloqueo que disparó el perro guardián, conservado en RTC hasta el
+// arranque siguiente (se registra al volver a crear esa tarea)
+#define TASK_HANG_MAGIC 0x48414E47UL  // "HANG"
+
+struct TaskHangRecord {
+  uint32_t magic;
+  uint8_t  task;
+  uint8_t  section;
+  uint32_t stuckMs;     // Tiempo en la sección al disparar
+  uint32_t check;
+};
+
+RTC_NOINIT_ATTR static TaskHangRecord hangRecord;
+static TaskHangRecord lastHang;
+static bool           lastHangPending = false;
+
+static const char* profileSectionName(TaskId id, uint8_t section);
+
+static uint32_t hangChecksum(const TaskHangRecord& r) {
+  return r.magic ^ ((uint32_t)r.task << 8 | r.section) ^ (r.stuckMs * 2654435761UL);
+}
+
+void taskRegister(TaskId id, const char* name, TaskHandle_t handle,
+                  uint8_t core, uint8_t priority) {
+  tasks[id].name = name;
+  tasks[id].handle = handle;
+  tasks[id].core = core;
+  tasks[id].priority = priority;
+  esp_task_wdt_add(handle);
+
+  if (lastHangPending && lastHang.task == id) {
+    lastHangPending = false;
+    logEvent(EV_TASK_HANG, { name, profileSectionName(id, lastHang.section), lastHang.stuckMs });
+  }
+}
+
+void taskAddBusy(TaskId id, uint32_t us) {
+  tasks[id].busyUs.fetch_add(us, std::memory_order_relaxed);
+  tasks[id].iterations.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t taskBusyTotalUs() {
+  uint32_t total = 0;
+  for (const TaskMonitor& t : tasks) total += t.busyUs.load(std::memory_order_relaxed);
+  return total;
+}
+
+uint32_t taskIterationsTotal() {
+  uint32_t total = 0;
+  for (const TaskMonitor& t : tasks) total += t.iterations.load(std::memory_order_relaxed);
+  return total;
+}
+
+// ============================================================================
+//  Función: reportTaskStats()
+//  Descripción: Imprime por tarea la pila mínima libre (bytes) y el
+//               porcentaje de tiempo activo desde el reporte anterior. Si
+//               FreeRTOS tiene estadísticas de ejecución habilitadas también
+//               imprime el tiempo real de CPU.
+// ============================================================================
+void reportTaskStats() {
+  uint32_t now = millis();
+  uint32_t elapsedUs = (now - lastReportMs) * 1000UL;
+  lastReportMs = now;
+  if (elapsedUs == 0) return;
+
+#if (configGENERATE_RUN_TIME_STATS == 1) && (configUSE_TRACE_FACILITY == 1)
+  static TaskStatus_t status[24];
+  static uint32_t lastTotal = 0;
+  uint32_t total = 0;
+  UBaseType_t count = uxTaskGetSystemState(status, 24, &total);
+  uint32_t totalDelta = total - lastTotal;
+  lastTotal = total;
+#endif
+
+  for (int i = 0; i < TASK_COUNT; i++) {
+    TaskMonitor& t = tasks[i];
+    if (t.handle == nullptr) continue;
+
+    uint32_t busy = t.busyUs.load(std::memory_order_relaxed);
+    float activePct = 100.0f * (float)(busy - t.lastBusyUs) / (float)elapsedUs;
+    t.lastBusyUs = busy;
+
+    Serial.printf("%sTASK %-5s core=%u prio=%u pila_min=%u B activo=%.1f%%",
+                  getTimestamp().c_str(), t.name, t.core, t.priority,
+                  (unsigned)uxTaskGetStackHighWaterMark(t.handle), activePct);
+
+#if (configGENERATE_RUN_TIME_STATS == 1) && (configUSE_TRACE_FACILITY == 1)
+    for (UBaseType_t k = 0; k < count; k++) {
+      if (status[k].xHandle != t.handle) continue;
+      uint32_t run = status[k].ulRunTimeCounter;
+      if (totalDelta > 0)
+        Serial.printf(" cpu=%.1f%%", 100.0f * (float)(run - t.lastRunTime) / (float)totalDelta);
+      t.lastRunTime = run;
+    }
+#endif
+    Serial.println();
+  }
+}
+
+// ============================================================================
+//  Perfil de iteraciones por tarea
+// ============================================================================
+static const char* const RADIO_SECTION_NAMES[SEC_RADIO_COUNT] = {
+  "fifo", "tramas", "viscosos", "cola_rf", "scan", "tx"
+};
+static const char* const NET_SECTION_NAMES[SEC_NET_COUNT] = {
+  "wifi", "sesion", "trafico", "telemetria", "estado", "beacon", "uplink", "salida"
+};
+static const char* const UI_SECTION_NAMES[SEC_UI_COUNT] = { "oled", "heap", "reportes" };
+static const char* const LOG_SECTION_NAMES[SEC_LOG_COUNT] = { "comandos", "captura", "formato" };
+
+static_assert(SEC_NET_COUNT <= PROFILER_MAX_SECTIONS, "PROFILER_MAX_SECTIONS insuficiente");
+
+// En el orden de TaskId
+static LoopProfiler profilers[TASK_COUNT] = {
+  { RADIO_SECTION_NAMES, SEC_RADIO_COUNT, RADIO_STALL_US },
+  { NET_SECTION_NAMES, SEC_NET_COUNT, NET_STALL_US },
+  { UI_SECTION_NAMES, SEC_UI_COUNT, UI_STALL_US },
+  { LOG_SECTION_NAMES, SEC_LOG_COUNT, LOG_STALL_US },
+};
+
+static const char* profileSectionName(TaskId id, uint8_t section) {
+  return profilers[id].sectionName(section);
+}
+
+void taskIterationBegin(TaskId id, uint32_t nowUs) {
+  esp_task_wdt_reset();   // Sin efecto hasta que taskRegister() la suscribe
+  profilers[id].begin(nowUs);
+}
+
+void taskSection(TaskId id, uint8_t section) {
+  profilers[id].enter(section, micros());
+}
+
+void taskIterationEnd(TaskId id, uint32_t nowUs) {
+  StallReport r;
+  if (!profilers[id].end(nowUs, r)) return;
+  logEvent(EV_TASK_STALL, { tasks[id].name ? tasks[id].name : "?", r.iterationUs,
+                            profilers[id].sectionName(r.section), r.sectionUs });
+}
+
+// ============================================================================
+//  Función: reportTaskProfile()
+//  Descripción: Por tarea, una línea con las iteraciones (n, p50/p95/p99,
+//               máximo y bloqueos sobre el umbral) y una por sección con
+//               muestras. Los percentiles son la cota de la cubeta del
+//               histograma (la primera es <100 us).
+// ============================================================================
+void reportTaskProfile() {
+  for (int i = 0; i < TASK_COUNT; i++) {
+    if (tasks[i].handle == nullptr) continue;
+    const LoopProfiler& p = profilers[i];
+    const LatencyHistogram& it = p.iterations();
+    Serial.printf("%sPERFIL %-5s %-10s n=%lu p50=%lu p95=%lu p99=%lu max=%lu us bloqueos=%lu (>%lu us)\n",
+                  getTimestamp().c_str(), tasks[i].name, "iteracion", (unsigned long)it.count(),
+                  (unsigned long)it.percentileUs(50), (unsigned long)it.percentileUs(95),
+                  (unsigned long)it.percentileUs(99), (unsigned long)it.maxUs(),
+                  (unsigned long)p.stalls(), (unsigned long)p.stallUs());
+    for (uint8_t s = 0; s < p.sectionCount(); s++) {
+      const LatencyHistogram& h = p.section(s);
+      if (h.count() == 0) continue;
+      Serial.printf("%sPERFIL %-5s %-10s n=%lu p50=%lu p95=%lu p99=%lu max=%lu us bloqueos=%lu\n",
+                    getTimestamp().c_str(), tasks[i].name, p.sectionName(s), (unsigned long)h.count(),
+                    (unsigned long)h.percentileUs(50), (unsigned long)h.percentileUs(95),
+                    (unsigned long)h.percentileUs(99), (unsigned long)h.maxUs(),
+                    (unsigned long)p.stallsIn(s));
+    }
+  }
+}
+
+void resetTaskProfile() {
+  for (LoopProfiler& p : profilers) p.reset();
+}
+
+// ============================================================================
+//  Función: taskWatchdogBegin()
+//  Descripción: Ajusta el perro guardián de tareas del IDF (ya iniciado por
+//               el framework) a TASK_WDT_TIMEOUT_S; cada tarea se suscribe
+//               en taskRegister() y lo alimenta al iniciar cada iteración.
+//               Si el reinicio anterior lo causó una tarea colgada, guarda
+//               el registro de RTC para informarlo al crearla de nuevo.
+// ============================================================================
+void taskWatchdogBegin() {
+  esp_task_wdt_init(TASK_WDT_TIMEOUT_S, TASK_WDT_PANIC);
+  if (hangRecord.magic == TASK_HANG_MAGIC && hangRecord.check == hangChecksum(hangRecord) &&
+      hangRecord.task < TASK_COUNT) {
+    lastHang = hangRecord;
+    lastHangPending = true;
+  }
+  hangRecord.magic = 0;
+}
+
+// ============================================================================
+//  Función: esp_task_wdt_isr_user_handler()
+//  Descripción: La llama el IDF desde la interrupción del perro guardián,
+//               antes del pánico. Imprime por la UART de la ROM (Serial no
+//               sirve aquí) la sección en curso de cada tarea y guarda en
+//               RTC la de la tarea con la iteración más larga en curso.
+// ============================================================================
+extern "C" void esp_task_wdt_isr_user_handler(void) {
+  uint32_t now = (uint32_t)esp_timer_get_time();
+  int worst = -1;
+  uint32_t worstUs = 0;
+
+  for (int i = 0; i < TASK_COUNT; i++) {
+    const LoopProfiler& p = profilers[i];
+    if (tasks[i].handle == nullptr) continue;
+    if (!p.inIteration()) {
+      esp_rom_printf("WDT tarea %s: esperando\n", tasks[i].name);
+      continue;
+    }
+    uint32_t iterationUs = now - p.iterationStartUs();
+    uint32_t sectionUs = now - p.currentSinceUs();
+    esp_rom_printf("WDT tarea %s: seccion %s hace %u ms (iteracion %u ms)\n", tasks[i].name,
+                   p.sectionName(p.current()), (unsigned)(sectionUs / 1000),
+                   (unsigned)(iterationUs / 1000));
+    if (worst < 0 || iterationUs > worstUs) {
+      worst = i;
+      worstUs = iterationUs;
+    }
+  }
+  if (worst < 0) return;
+
+  hangRecord.task = (uint8_t)worst;
+  hangRecord.section = profilers[worst].current();
+  hangRecord.stuckMs = (now - profilers[worst].currentSinceUs()) / 1000;
+  hangRecord.magic = TASK_HANG_MAGIC;
+  hangRecord.check = hangChecksum(hangRecord);
+}
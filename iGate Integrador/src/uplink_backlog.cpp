@@ -0,0 +1,264 @@
+// ============================================================================
+//  Cola de almacenamiento y reenvío RF → APRS-IS
+//  Orden FIFO estricto: mientras el segmento de LittleFS tenga tramas, las
+//  nuevas también se anexan al segmento (son más recientes que todo lo que
+//  hay en RAM). El segmento se borra cuando se termina de leer; el espacio
+//  de las tramas ya enviadas no se recupera antes.
+// ============================================================================
+#include "uplink_backlog.h"
+
+#include <LittleFS.h>         // Segmento de desborde en flash
+#include <algorithm>
+#include <atomic>
+
+#include "config.h"
+#include "log.h"
+#include "stats.h"
+
+#define UPLINK_SPILL_PATH  "/uplink.seg"
+#define UPLINK_SPILL_MAGIC 0xA55B
+
+// Cabecera de cada trama en el segmento (seguida de length bytes)
+struct SpillRecord {
+  uint16_t magic;
+  uint16_t length;
+  uint32_t rxMillis;
+  uint32_t rxMicros;
+};
+
+static SpscRing<PacketBuf*, UPLINK_BACKLOG_SIZE> ramQueue;  // Solo la tarea de red
+
+static bool     fsReady = false;
+static uint32_t spillWriteOffset = 0;   // Tamaño del segmento
+static uint32_t spillReadOffset = 0;    // Próxima trama a leer
+static std::atomic<uint32_t> spillRecords(0);
+
+// Trama del segmento cargada en RAM para enviarla (fuera del conjunto)
+static PacketBuf   spillHead;
+static bool        spillHeadLoaded = false;
+static uint32_t    spillHeadBytes = 0;
+static bool        headFromRam = false;
+
+// Ritmo de vaciado (cubeta de fichas, en milésimas de ficha)
+static uint32_t      drainTokens = UPLINK_DRAIN_BURST * 1000UL;
+static unsigned long drainRefillAt = 0;
+
+// Métricas (leídas por la tarea de pantalla)
+static std::atomic<uint32_t> backlogMaxDepth(0);
+static std::atomic<uint32_t> spillBytesTotal(0);
+static std::atomic<uint32_t> spillFileBytes(0);
+static std::atomic<uint32_t> drainedCount(0);
+static std::atomic<uint32_t> staleDropped(0);
+static std::atomic<uint32_t> fullDropped(0);
+static std::atomic<uint32_t> spillErrors(0);
+
+static void resetSpill() {
+  if (fsReady) LittleFS.remove(UPLINK_SPILL_PATH);
+  spillWriteOffset = spillReadOffset = 0;
+  spillRecords = 0;
+  spillFileBytes = 0;
+  spillHeadLoaded = false;
+}
+
+static void dropFrame(std::atomic<uint32_t>& reason) {
+  reason++;
+  stats.uplinkDropped++;
+}
+
+static void updateMaxDepth() {
+  uint32_t depth = uplinkBacklogDepth();
+  if (depth > backlogMaxDepth) backlogMaxDepth = depth;
+}
+
+// ============================================================================
+//  Función: spillAppend()
+//  Descripción: Anexa una trama al segmento de LittleFS. Si no hay sistema
+//               de archivos o el segmento alcanzó UPLINK_SPILL_MAX_BYTES, la
+//               trama se descarta.
+// ============================================================================
+static void spillAppend(const char* data, uint16_t length, uint32_t rxMillis, uint32_t rxMicros) {
+  uint32_t recordBytes = sizeof(SpillRecord) + length;
+  if (!fsReady || spillWriteOffset + recordBytes > UPLINK_SPILL_MAX_BYTES) {
+    dropFrame(fullDropped);
+    return;
+  }
+
+  if (spillRecords == 0) {
+    logEvent(EV_BACKLOG_SPILL);
+  }
+
+  SpillRecord header = { UPLINK_SPILL_MAGIC, length, rxMillis, rxMicros };
+  File file = LittleFS.open(UPLINK_SPILL_PATH, FILE_APPEND);
+  bool ok = file &&
+            file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            file.write((const uint8_t*)data, length) == length;
+  if (file) file.close();
+
+  if (!ok) {
+    spillErrors++;
+    dropFrame(fullDropped);
+    return;
+  }
+
+  spillWriteOffset += recordBytes;
+  spillRecords++;
+  spillBytesTotal += recordBytes;
+  spillFileBytes = spillWriteOffset;
+}
+
+// ============================================================================
+//  Función: loadSpillHead()
+//  Descripción: Lee la trama más antigua del segmento. Un registro corrupto
+//               invalida el resto del segmento (no hay forma de resincronizar).
+// ============================================================================
+static bool loadSpillHead() {
+  File file = LittleFS.open(UPLINK_SPILL_PATH, FILE_READ);
+  SpillRecord header;
+  bool ok = file && file.seek(spillReadOffset) &&
+            file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == UPLINK_SPILL_MAGIC && header.length <= AX25_MAX_FRAME &&
+            file.read((uint8_t*)spillHead.data, header.length) == header.length;
+  if (file) file.close();
+
+  if (!ok) {
+    uint32_t lost = spillRecords;
+    logEvent(EV_BACKLOG_SEGMENT_LOST, { lost });
+    spillErrors++;
+    for (uint32_t i = 0; i < lost; i++) dropFrame(fullDropped);
+    resetSpill();
+    return false;
+  }
+
+  spillHead.length   = header.length;
+  spillHead.rxMillis = header.rxMillis;
+  spillHead.rxMicros = header.rxMicros;
+  spillHeadBytes     = sizeof(header) + header.length;
+  spillHeadLoaded    = true;
+  return true;
+}
+
+// Trama más antigua de la cola (RAM primero, luego el segmento)
+static const PacketBuf* backlogHead() {
+  PacketBuf** head = ramQueue.peek();
+  if (head != nullptr) {
+    headFromRam = true;
+    return *head;
+  }
+  if (spillRecords == 0) return nullptr;
+  if (!spillHeadLoaded && !loadSpillHead()) return nullptr;
+  headFromRam = false;
+  return &spillHead;
+}
+
+static void backlogPopHead() {
+  if (headFromRam) {
+    packetPool.release(*ramQueue.peek());
+    ramQueue.release();
+    return;
+  }
+  spillReadOffset += spillHeadBytes;
+  spillHeadLoaded = false;
+  if (--spillRecords == 0) {
+    logEvent(EV_BACKLOG_SEGMENT_EMPTY);
+    resetSpill();
+  }
+}
+
+// ============================================================================
+//  API pública
+// ============================================================================
+bool uplinkBacklogBegin() {
+  fsReady = LittleFS.begin(true);
+  if (!fsReady) {
+    logEvent(EV_BACKLOG_NO_FS);
+    return false;
+  }
+  // Los instantes de recepción son millis() del arranque anterior: el
+  // segmento que haya quedado ya no tiene edad conocida.
+  resetSpill();
+  return true;
+}
+
+// En RAM solo si el conjunto conserva la reserva de la recepción: una caída
+// larga de APRS-IS pasa a flash en lugar de dejar a la radio sin buffers
+void uplinkBacklogPush(PacketBuf* packet) {
+  if (spillRecords == 0 && packetPool.available() > PACKET_POOL_RESERVE && ramQueue.push(packet)) {
+    updateMaxDepth();
+    return;
+  }
+  spillAppend(packet->data, packet->length, packet->rxMillis, packet->rxMicros);
+  packetPool.release(packet);
+  updateMaxDepth();
+}
+
+void uplinkBacklogRequeue(const char* data, size_t length, uint32_t rxMillis, uint32_t rxMicros) {
+  length = std::min<size_t>(length, AX25_MAX_FRAME);
+  PacketBuf* packet = spillRecords == 0 ? packetPool.alloc(PACKET_POOL_RESERVE) : nullptr;
+  if (packet == nullptr) {
+    spillAppend(data, (uint16_t)length, rxMillis, rxMicros);
+    updateMaxDepth();
+    return;
+  }
+  packet->rxMillis = rxMillis;
+  packet->rxMicros = rxMicros;
+  packet->rssi = 0;
+  packet->snr = 0.0f;
+  packet->length = (uint16_t)length;
+  memcpy(packet->data, data, length);
+  uplinkBacklogPush(packet);
+}
+
+void uplinkBacklogExpire(unsigned long now) {
+  const PacketBuf* head;
+  while ((head = backlogHead()) != nullptr && now - head->rxMillis > UPLINK_MAX_AGE) {
+    backlogPopHead();
+    dropFrame(staleDropped);
+  }
+}
+
+const PacketBuf* uplinkBacklogNext(unsigned long now) {
+  uplinkBacklogExpire(now);
+
+  uint32_t elapsed = now - drainRefillAt;
+  drainRefillAt = now;
+  uint32_t refill = std::min<uint32_t>(elapsed, 60000UL) * UPLINK_DRAIN_PER_SEC;
+  drainTokens = std::min<uint32_t>(drainTokens + refill, UPLINK_DRAIN_BURST * 1000UL);
+  if (drainTokens < 1000) return nullptr;
+
+  return backlogHead();
+}
+
+void uplinkBacklogRelease() {
+  if (drainTokens >= 1000) drainTokens -= 1000;
+  backlogPopHead();
+  drainedCount++;
+}
+
+uint32_t uplinkBacklogDepth() {
+  return ramQueue.size() + spillRecords;
+}
+
+// ============================================================================
+//  Profundidad, bytes derivados a flash y ritmo de vaciado medido desde el
+//  reporte anterior
+// ============================================================================
+void reportUplinkBacklogStats() {
+  static unsigned long lastReport = 0;
+  static uint32_t lastDrained = 0;
+
+  unsigned long now = millis();
+  uint32_t drained = drainedCount;
+  uint32_t elapsed = now - lastReport;
+  float rate = (lastReport != 0 && elapsed > 0) ? (drained - lastDrained) * 1000.0f / elapsed : 0.0f;
+  lastReport = now;
+  lastDrained = drained;
+
+  Serial.printf("%sBACKLOG cola=%lu (ram=%u seg=%lu) max=%lu seg_bytes=%lu derivados=%lu "
+                "vaciado=%.2f/s enviados=%lu viejos=%lu llenos=%lu errores_fs=%lu\n",
+                getTimestamp().c_str(), (unsigned long)uplinkBacklogDepth(),
+                (unsigned)ramQueue.size(), (unsigned long)spillRecords.load(),
+                (unsigned long)backlogMaxDepth.load(), (unsigned long)spillFileBytes.load(),
+                (unsigned long)spillBytesTotal.load(), rate, (unsigned long)drained,
+                (unsigned long)staleDropped.load(), (unsigned long)fullDropped.load(),
+                (unsigned long)spillErrors.load());
+}
@@ -0,0 +1,364 @@
+// ============================================================================
+//  Conexión WiFi asíncrona por eventos
+//  - La asociación nunca bloquea: WiFi.begin() / scanNetworks(async) se
+//    lanzan y los eventos del driver marcan el resultado.
+//  - Reconexión rápida: se reutilizan BSSID y canal de la última conexión
+//    buena (sin escaneo). Si la caché viene de la RTC (reinicio en caliente)
+//    o de esta misma sesión, también se reutiliza la concesión DHCP.
+//  - Si la reconexión rápida falla se escanea y se prueban todas las redes
+//    configuradas ordenadas por el último RSSI observado.
+// ============================================================================
+#include "wifi_manager.h"
+
+#include <WiFi.h>
+#include <Preferences.h>      // Caché persistente en NVS
+#include <atomic>
+
+#include "config.h"
+#include "log.h"
+#include "power.h"
+#include "settings.h"
+#include "stats.h"
+
+// ============================================================================
+//  Caché de la última conexión buena
+// ============================================================================
+#define WIFI_CACHE_MAGIC 0x57494643UL  // "WIFC"
+
+struct WifiCache {
+  uint32_t magic;
+  uint8_t  apIndex;     // Índice en settings.aps
+  uint8_t  channel;
+  uint8_t  bssid[6];
+  uint32_t ip;          // Concesión DHCP
+  uint32_t gateway;
+  uint32_t mask;
+  uint32_t dns;
+  uint32_t check;       // FNV-1a de los campos anteriores
+};
+
+RTC_NOINIT_ATTR static WifiCache rtcCache;   // Sobrevive a reinicios en caliente
+static WifiCache cache;
+static bool      cacheValid = false;
+static bool      leaseUsable = false;        // Concesión aún confiable
+
+static uint32_t cacheChecksum(const WifiCache& c) {
+  const uint8_t* p = (const uint8_t*)&c;
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < offsetof(WifiCache, check); i++) {
+    h ^= p[i];
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+static bool cacheIsValid(const WifiCache& c) {
+  return c.magic == WIFI_CACHE_MAGIC && c.check == cacheChecksum(c) &&
+         c.apIndex < settings.apCount && c.channel >= 1 && c.channel <= 14;
+}
+
+static void loadCache() {
+  if (cacheIsValid(rtcCache)) {
+    cache = rtcCache;
+    cacheValid = leaseUsable = true;
+    logEvent(EV_WIFI_CACHE_RTC);
+    return;
+  }
+
+  Preferences prefs;
+  if (prefs.begin("wifi", true)) {
+    WifiCache stored;
+    if (prefs.getBytes("cache", &stored, sizeof(stored)) == sizeof(stored) && cacheIsValid(stored)) {
+      cache = stored;
+      cacheValid = true;
+      leaseUsable = false;  // Tras un arranque en frío la concesión pudo expirar
+      logEvent(EV_WIFI_CACHE_NVS);
+    }
+    prefs.end();
+  }
+}
+
+static void saveCache(uint8_t apIndex) {
+  WifiCache c;
+  memset(&c, 0, sizeof(c));
+  c.magic   = WIFI_CACHE_MAGIC;
+  c.apIndex = apIndex;
+  c.channel = (uint8_t)WiFi.channel();
+  memcpy(c.bssid, WiFi.BSSID(), sizeof(c.bssid));
+  c.ip      = (uint32_t)WiFi.localIP();
+  c.gateway = (uint32_t)WiFi.gatewayIP();
+  c.mask    = (uint32_t)WiFi.subnetMask();
+  c.dns     = (uint32_t)WiFi.dnsIP();
+  c.check   = cacheChecksum(c);
+
+  // NVS solo cuando cambia el punto de acceso (desgaste de flash)
+  bool apChanged = !cacheValid || cache.apIndex != c.apIndex ||
+                   cache.channel != c.channel || memcmp(cache.bssid, c.bssid, 6) != 0;
+
+  cache = rtcCache = c;
+  cacheValid = leaseUsable = true;
+
+  if (apChanged) {
+    Preferences prefs;
+    if (prefs.begin("wifi", false)) {
+      prefs.putBytes("cache", &c, sizeof(c));
+      prefs.end();
+    }
+  }
+}
+
+// ============================================================================
+//  Máquina de estados
+// ============================================================================
+enum WifiState : uint8_t {
+  WIFI_DOWN,      // Sin conexión, esperando reintento
+  WIFI_FAST,      // Reconexión rápida desde caché
+  WIFI_SCAN,      // Escaneo asíncrono en curso
+  WIFI_JOIN,      // Asociación con una red del escaneo
+  WIFI_UP,        // Con IP
+};
+
+static const char* const WIFI_STATE_NAMES[] = { "DOWN", "FAST", "SCAN", "JOIN", "UP" };
+
+static WifiState     wifiState = WIFI_DOWN;
+static unsigned long wifiStateSince = 0;
+static unsigned long wifiAttemptStart = 0;
+static unsigned long wifiRetryAt = 0;
+static unsigned long lastLedToggle = 0;
+static bool          attemptFromCache = false;
+
+// Candidatos ordenados por RSSI y último RSSI visto por red
+static int8_t  lastSeenRssi[CONFIG_MAX_APS];
+static uint8_t candidates[CONFIG_MAX_APS];
+static uint8_t candidateChannel[CONFIG_MAX_APS];
+static uint8_t candidateBssid[CONFIG_MAX_APS][6];
+static bool    candidateSeen[CONFIG_MAX_APS];
+static size_t  candidateCount = 0;
+static size_t  candidateNext = 0;
+static uint8_t joiningAp = 0;
+
+// Banderas escritas por el hilo de eventos del driver
+static std::atomic<bool>    evGotIp(false);
+static std::atomic<bool>    evDisconnected(false);
+static std::atomic<uint8_t> evDisconnectReason(0);
+
+// Métricas de tiempo hasta IP
+static uint32_t coldCount = 0, coldLastMs = 0, coldTotalMs = 0;
+static uint32_t cachedCount = 0, cachedLastMs = 0, cachedTotalMs = 0;
+static uint32_t fastFailures = 0, joinFailures = 0, disconnects = 0;
+
+static void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      evGotIp = true;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      evDisconnectReason = info.wifi_sta_disconnected.reason;
+      evDisconnected = true;
+      break;
+    default:
+      break;
+  }
+}
+
+static void setWifiState(WifiState next) {
+  wifiState = next;
+  wifiStateSince = millis();
+  stats.wifiConnected = (next == WIFI_UP);
+}
+
+static void startJoin(uint8_t apIndex, uint8_t channel, const uint8_t* bssid, bool useLease) {
+  const WifiApSettings& ap = settings.aps[apIndex];
+  joiningAp = apIndex;
+  evGotIp = false;
+  evDisconnected = false;
+
+  if (useLease) {
+    WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+                IPAddress(cache.mask), IPAddress(cache.dns));
+  } else {
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);  // DHCP
+  }
+
+  if (bssid != nullptr) logEvent(EV_WIFI_CONNECTING_CHANNEL, { ap.ssid, channel });
+  else logEvent(EV_WIFI_CONNECTING, { ap.ssid });
+
+  WiFi.begin(ap.ssid, ap.password, channel, bssid, true);
+}
+
+static void startScan() {
+  WiFi.scanDelete();
+  WiFi.scanNetworks(true /* async */, false, false, 120);
+  setWifiState(WIFI_SCAN);
+}
+
+// Ordena las redes configuradas por RSSI del escaneo (las no vistas al final,
+// por si tienen SSID oculto) y prepara la lista de intentos.
+static void rankCandidates(int16_t found) {
+  for (size_t i = 0; i < settings.apCount; i++) candidateSeen[i] = false;
+
+  for (int16_t n = 0; n < found; n++) {
+    String foundSsid = WiFi.SSID(n);
+    int32_t rssi = WiFi.RSSI(n);
+    for (size_t i = 0; i < settings.apCount; i++) {
+      if (strcmp(foundSsid.c_str(), settings.aps[i].ssid) != 0) continue;
+      if (candidateSeen[i] && rssi <= lastSeenRssi[i]) continue;  // Mejor BSSID de ese SSID
+      candidateSeen[i] = true;
+      lastSeenRssi[i] = (int8_t)rssi;
+      candidateChannel[i] = (uint8_t)WiFi.channel(n);
+      memcpy(candidateBssid[i], WiFi.BSSID(n), 6);
+    }
+  }
+  WiFi.scanDelete();
+
+  candidateCount = 0;
+  for (size_t i = 0; i < settings.apCount; i++) candidates[candidateCount++] = (uint8_t)i;
+  for (size_t i = 1; i < candidateCount; i++) {          // Inserción: N es pequeño
+    uint8_t c = candidates[i];
+    size_t j = i;
+    while (j > 0 && lastSeenRssi[candidates[j - 1]] < lastSeenRssi[c]) {
+      candidates[j] = candidates[j - 1];
+      j--;
+    }
+    candidates[j] = c;
+  }
+  candidateNext = 0;
+}
+
+static void joinNextCandidate() {
+  if (candidateNext >= candidateCount) {
+    logEvent(EV_WIFI_ALL_FAILED);
+    digitalWrite(LED_PIN, LOW);
+    WiFi.disconnect();
+    wifiRetryAt = millis() + WIFI_RECONNECT_INTERVAL;
+    setWifiState(WIFI_DOWN);
+    return;
+  }
+  uint8_t ap = candidates[candidateNext++];
+  attemptFromCache = false;
+  startJoin(ap, candidateSeen[ap] ? candidateChannel[ap] : 0,
+            candidateSeen[ap] ? candidateBssid[ap] : nullptr, false);
+  setWifiState(WIFI_JOIN);
+}
+
+static void onConnected() {
+  uint32_t elapsed = millis() - wifiAttemptStart;
+  if (attemptFromCache) {
+    cachedCount++; cachedLastMs = elapsed; cachedTotalMs += elapsed;
+  } else {
+    coldCount++; coldLastMs = elapsed; coldTotalMs += elapsed;
+  }
+
+  saveCache(joiningAp);
+  lastSeenRssi[joiningAp] = (int8_t)WiFi.RSSI();
+
+  IPAddress ip = WiFi.localIP();
+  logEvent(EV_WIFI_CONNECTED, { elapsed, attemptFromCache ? "caché" : "escaneo" });
+  logEvent(EV_WIFI_IP, { ip[0], ip[1], ip[2], ip[3] });
+  digitalWrite(LED_PIN, HIGH);
+  setWifiState(WIFI_UP);
+}
+
+// ============================================================================
+//  API pública
+// ============================================================================
+void wifiBegin() {
+  for (size_t i = 0; i < settings.apCount; i++) lastSeenRssi[i] = INT8_MIN;
+
+  WiFi.persistent(false);         // La caché propia reemplaza la del driver
+  WiFi.mode(WIFI_STA);
+  WiFi.setSleep(powerWifiSleep());   // Modem sleep: despierta en cada DTIM
+  WiFi.setAutoReconnect(false);   // La reconexión la decide wifiTick()
+  WiFi.onEvent(onWifiEvent);
+  loadCache();
+  setWifiState(WIFI_DOWN);
+}
+
+bool wifiIsUp() { return wifiState == WIFI_UP; }
+
+const char* wifiSsid() { return wifiState == WIFI_UP ? settings.aps[joiningAp].ssid : nullptr; }
+
+void wifiTick() {
+  unsigned long now = millis();
+  unsigned long inState = now - wifiStateSince;
+
+  // Parpadeo del LED mientras se conecta
+  if (wifiState != WIFI_UP && wifiState != WIFI_DOWN && now - lastLedToggle > 500) {
+    lastLedToggle = now;
+    digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+  }
+
+  switch (wifiState) {
+    case WIFI_DOWN:
+      if (!settings.wifiActive) return;   // wifi.active = false en is-cfg.json
+      if ((long)(now - wifiRetryAt) < 0) return;
+      wifiAttemptStart = now;
+      if (cacheValid) {
+        attemptFromCache = true;
+        startJoin(cache.apIndex, cache.channel, cache.bssid, leaseUsable);
+        setWifiState(WIFI_FAST);
+      } else {
+        startScan();
+      }
+      break;
+
+    case WIFI_FAST:
+      if (evGotIp) {
+        onConnected();
+      } else if (evDisconnected || inState > WIFI_FAST_TIMEOUT) {
+        fastFailures++;
+        leaseUsable = false;
+        logEvent(EV_WIFI_FAST_FAILED, { evDisconnectReason.load() });
+        WiFi.disconnect();
+        startScan();
+      }
+      break;
+
+    case WIFI_SCAN: {
+      int16_t found = WiFi.scanComplete();
+      if (found == WIFI_SCAN_RUNNING) {
+        if (inState > WIFI_SCAN_TIMEOUT) {
+          WiFi.scanDelete();
+          rankCandidates(0);
+          joinNextCandidate();
+        }
+        return;
+      }
+      rankCandidates(found < 0 ? 0 : found);
+      joinNextCandidate();
+      break;
+    }
+
+    case WIFI_JOIN:
+      if (evGotIp) {
+        onConnected();
+      } else if (evDisconnected || inState > WIFI_JOIN_TIMEOUT) {
+        joinFailures++;
+        logEvent(EV_WIFI_JOIN_FAILED, { settings.aps[joiningAp].ssid, evDisconnectReason.load() });
+        WiFi.disconnect();
+        joinNextCandidate();
+      }
+      break;
+
+    case WIFI_UP:
+      if (evDisconnected || WiFi.status() != WL_CONNECTED) {
+        disconnects++;
+        logEvent(EV_WIFI_DISCONNECTED, { evDisconnectReason.load() });
+        digitalWrite(LED_PIN, LOW);
+        wifiRetryAt = now;   // Reintento inmediato con la caché
+        setWifiState(WIFI_DOWN);
+      }
+      break;
+  }
+}
+
+void reportWifiStats() {
+  Serial.printf("%sWIFI estado=%s ip_ms frio(ult/prom)=%lu/%lu n=%lu cache(ult/prom)=%lu/%lu n=%lu "
+                "fallos rapida=%lu red=%lu desconexiones=%lu\n",
+                getTimestamp().c_str(), WIFI_STATE_NAMES[wifiState],
+                (unsigned long)coldLastMs, (unsigned long)(coldCount ? coldTotalMs / coldCount : 0),
+                (unsigned long)coldCount,
+                (unsigned long)cachedLastMs, (unsigned long)(cachedCount ? cachedTotalMs / cachedCount : 0),
+                (unsigned long)cachedCount,
+                (unsigned long)fastFailures, (unsigned long)joinFailures, (unsigned long)disconnects);
+}